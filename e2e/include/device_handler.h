@@ -7,6 +7,10 @@
 #ifndef DEVICE_HANDLER_H
 #define DEVICE_HANDLER_H
 
+#include <stddef.h>
+
+#include <edgehog_device/device.h>
+
 #include "utilities.h"
 
 void setup_device();
@@ -14,5 +18,7 @@ void free_device();
 void wait_for_device_connection();
 void disconnect_device();
 void wait_for_device_disconnection();
+edgehog_device_handle_t get_device_handle();
+void preload_loopback_file(size_t size);
 
 #endif /* DEVICE_HANDLER_H */
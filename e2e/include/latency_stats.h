@@ -0,0 +1,46 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+
+/** @brief Tracked latency distributions. */
+typedef enum
+{
+    /** @brief Command handling round trips. */
+    LATENCY_TRACKER_COMMAND = 0,
+    /** @brief OTA state transition intervals, observed on the zbus OTA channel. */
+    LATENCY_TRACKER_OTA,
+    /** @brief Telemetry request to publish latencies. */
+    LATENCY_TRACKER_TELEMETRY,
+    /** @brief Number of trackers. */
+    LATENCY_TRACKER_COUNT,
+} latency_tracker_t;
+
+/**
+ * @brief Record a latency sample into a tracker histogram.
+ *
+ * @details Safe to call from any context, including zbus listeners.
+ *
+ * @param tracker The tracker to record into.
+ * @param sample_ms The latency sample in milliseconds, negative samples are discarded.
+ */
+void latency_stats_record(latency_tracker_t tracker, int64_t sample_ms);
+
+/**
+ * @brief Log one machine-parsable `latstat,...` line per tracker.
+ *
+ * @details Each line reports the sample count, the minimum and maximum, and the p50/p95/p99
+ * percentiles estimated from the histogram buckets, see latency_stats.c for the format.
+ */
+void latency_stats_report(void);
+
+/** @brief Reset all the tracker histograms. */
+void latency_stats_reset(void);
+
+#endif /* LATENCY_STATS_H */
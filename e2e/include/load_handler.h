@@ -0,0 +1,39 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LOAD_HANDLER_H
+#define LOAD_HANDLER_H
+
+#include <stdint.h>
+
+/** @brief Load generation targets. */
+typedef enum
+{
+    /** @brief Flood the telemetry request queue at the configured rate. */
+    LOAD_MODE_TELEMETRY = 0,
+    /** @brief Flood the command event handler at the configured rate. */
+    LOAD_MODE_COMMAND,
+    /** @brief Drive back to back loopback file transfers at the configured rate. */
+    LOAD_MODE_TRANSFER,
+} load_mode_t;
+
+/**
+ * @brief Start a load generation run on a dedicated thread.
+ *
+ * @details The run drives the selected target at the requested sustained rate for the requested
+ * duration, recording issue/drop counters and latency statistics on the device. At the end of the
+ * run a single machine-parsable `loadstat,...` line is logged, see load_handler.c for the format.
+ *
+ * @param mode The load generation target.
+ * @param rate_hz Requests per second to sustain, must be greater than zero.
+ * @param duration_s Duration of the run in seconds, must be greater than zero.
+ * @param url Upload URL for the transfer mode, ignored by the other modes.
+ * @return 0 when the run has been started, -1 when a run is already in progress or the
+ * parameters are invalid.
+ */
+int load_generation_start(load_mode_t mode, uint32_t rate_hz, uint32_t duration_s, const char *url);
+
+#endif /* LOAD_HANDLER_H */
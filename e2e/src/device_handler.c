@@ -158,6 +158,20 @@ void wait_for_device_disconnection()
     }
 }
 
+edgehog_device_handle_t get_device_handle()
+{
+    return device_handle;
+}
+
+void preload_loopback_file(size_t size)
+{
+    loopback_file_size = MIN(size, (size_t) MAX_LOOPBACK_FILE_SIZE);
+    // Mildly repetitive content, compressible but not trivial
+    for (size_t i = 0; i < loopback_file_size; i++) {
+        loopback_file_buffer[i] = (uint8_t) ((i * 31U) ^ (i >> 3U));
+    }
+}
+
 /************************************************
  *         Static functions definitions         *
  ***********************************************/
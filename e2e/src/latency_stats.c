@@ -0,0 +1,179 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "latency_stats.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/spinlock.h>
+
+#include <edgehog_device/ota_event.h>
+
+LOG_MODULE_REGISTER(latency_stats, CONFIG_LATENCY_STATS_LOG_LEVEL);
+
+/************************************************
+ *   Constants, static variables and defines    *
+ ***********************************************/
+
+/* Power-of-two histogram buckets, bucket i covers [2^i, 2^(i+1)) ms up to ~2.3 hours */
+#define LATENCY_BUCKETS 24
+
+#define PERCENT_50 50
+#define PERCENT_95 95
+#define PERCENT_99 99
+#define PERCENT_100 100
+
+/** @brief Histogram and extrema for a single tracker. */
+typedef struct
+{
+    /** @brief Per-bucket sample counts. */
+    uint32_t buckets[LATENCY_BUCKETS];
+    /** @brief Total number of recorded samples. */
+    uint32_t count;
+    /** @brief Smallest recorded sample in milliseconds. */
+    int64_t min_ms;
+    /** @brief Largest recorded sample in milliseconds. */
+    int64_t max_ms;
+} latency_histogram_t;
+
+static const char *const tracker_names[LATENCY_TRACKER_COUNT] = {
+    [LATENCY_TRACKER_COMMAND] = "command",
+    [LATENCY_TRACKER_OTA] = "ota",
+    [LATENCY_TRACKER_TELEMETRY] = "telemetry",
+};
+
+static latency_histogram_t histograms[LATENCY_TRACKER_COUNT];
+// Samples come from zbus listeners and the load thread concurrently
+static struct k_spinlock histograms_lock;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
+// Uptime of the previous OTA event, 0 before the first one is observed
+static int64_t last_ota_event_ms;
+#endif
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+static uint32_t bucket_index(int64_t sample_ms);
+static int64_t percentile_bound(const latency_histogram_t *histogram, uint32_t percent);
+
+/************************************************
+ *     Callbacks definition and declaration     *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
+
+// Each OTA event marks a state transition, the interval between two consecutive events is the
+// time spent in the previous state
+static void ota_event_listener_cb(const struct zbus_channel *chan)
+{
+    ARG_UNUSED(chan);
+
+    int64_t now_ms = k_uptime_get();
+    if (last_ota_event_ms > 0) {
+        latency_stats_record(LATENCY_TRACKER_OTA, now_ms - last_ota_event_ms);
+    }
+    last_ota_event_ms = now_ms;
+}
+
+ZBUS_LISTENER_DEFINE(latency_ota_event_listener, ota_event_listener_cb);
+ZBUS_CHAN_ADD_OBS(edgehog_ota_chan, latency_ota_event_listener, 0);
+
+#endif /* CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT */
+
+/************************************************
+ *         Global functions definition          *
+ ***********************************************/
+
+void latency_stats_record(latency_tracker_t tracker, int64_t sample_ms)
+{
+    if ((tracker >= LATENCY_TRACKER_COUNT) || (sample_ms < 0)) {
+        return;
+    }
+
+    latency_histogram_t *histogram = &histograms[tracker];
+
+    K_SPINLOCK(&histograms_lock)
+    {
+        histogram->buckets[bucket_index(sample_ms)]++;
+        if ((histogram->count == 0) || (sample_ms < histogram->min_ms)) {
+            histogram->min_ms = sample_ms;
+        }
+        if ((histogram->count == 0) || (sample_ms > histogram->max_ms)) {
+            histogram->max_ms = sample_ms;
+        }
+        histogram->count++;
+    }
+}
+
+void latency_stats_report(void)
+{
+    for (size_t i = 0; i < LATENCY_TRACKER_COUNT; i++) {
+        latency_histogram_t snapshot;
+
+        K_SPINLOCK(&histograms_lock)
+        {
+            snapshot = histograms[i];
+        }
+
+        // One machine-parsable line per tracker:
+        // latstat,<name>,<count>,<min_ms>,<p50_ms>,<p95_ms>,<p99_ms>,<max_ms>
+        // Percentiles are the upper bound of the histogram bucket holding the percentile
+        LOG_INF("latstat,%s,%u,%lld,%lld,%lld,%lld,%lld", tracker_names[i], snapshot.count,
+            (long long) ((snapshot.count > 0) ? snapshot.min_ms : 0),
+            (long long) percentile_bound(&snapshot, PERCENT_50),
+            (long long) percentile_bound(&snapshot, PERCENT_95),
+            (long long) percentile_bound(&snapshot, PERCENT_99),
+            (long long) ((snapshot.count > 0) ? snapshot.max_ms : 0));
+    }
+}
+
+void latency_stats_reset(void)
+{
+    K_SPINLOCK(&histograms_lock)
+    {
+        memset(histograms, 0, sizeof(histograms));
+    }
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
+    last_ota_event_ms = 0;
+#endif
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static uint32_t bucket_index(int64_t sample_ms)
+{
+    uint32_t index = 0;
+    uint64_t value = (uint64_t) sample_ms;
+    while ((value >>= 1U) != 0) {
+        index++;
+    }
+    return MIN(index, (uint32_t) (LATENCY_BUCKETS - 1));
+}
+
+static int64_t percentile_bound(const latency_histogram_t *histogram, uint32_t percent)
+{
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    // Number of samples at or below the percentile, rounding up so p100 needs them all
+    uint32_t threshold = ((histogram->count * percent) + PERCENT_100 - 1) / PERCENT_100;
+    uint32_t cumulative = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        cumulative += histogram->buckets[i];
+        if (cumulative >= threshold) {
+            // Upper bound of bucket i, clamped to the largest recorded sample
+            return MIN((int64_t) ((UINT64_C(1) << (i + 1)) - 1), histogram->max_ms);
+        }
+    }
+    return histogram->max_ms;
+}
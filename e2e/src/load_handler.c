@@ -0,0 +1,331 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "load_handler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/uuid.h>
+
+#include <edgehog_device/device.h>
+#include <edgehog_device/file_transfer.h>
+#include <edgehog_device/result.h>
+#include <edgehog_device/sdk_event.h>
+
+#include "command.h"
+#include "edgehog_private.h"
+#include "file_transfer/core.h"
+#include "file_transfer/upload.h"
+#include "heap.h"
+#include "telemetry_private.h"
+
+#include "device_handler.h"
+#include "latency_stats.h"
+
+LOG_MODULE_REGISTER(load_handler, CONFIG_LOAD_HANDLER_LOG_LEVEL);
+
+/************************************************
+ *   Constants, static variables and defines    *
+ ***********************************************/
+
+#define LOAD_THREAD_STACK_SIZE 4096
+#define MSEC_PER_SEC_U32 1000U
+
+/* Settle time at the end of a run, lets in-flight publishes drain before reporting */
+#define LOAD_SETTLE_TIME_MS 500
+
+/* Size of the synthetic loopback payload driven by the transfer mode */
+#define LOAD_TRANSFER_PAYLOAD_SIZE 32768
+
+/** @brief Telemetry types cycled through by the telemetry flood. */
+static const edgehog_telemetry_type_t load_telemetry_types[] = {
+    EDGEHOG_TELEMETRY_SYSTEM_STATUS,
+    EDGEHOG_TELEMETRY_HW_INFO,
+    EDGEHOG_TELEMETRY_STORAGE_USAGE,
+};
+
+/** @brief Parameters and counters for a load generation run. */
+typedef struct
+{
+    /** @brief The load generation target. */
+    load_mode_t mode;
+    /** @brief Requests per second to sustain. */
+    uint32_t rate_hz;
+    /** @brief Duration of the run in seconds. */
+    uint32_t duration_s;
+    /** @brief Upload URL, only used by the transfer mode. */
+    char url[CONFIG_E2E_LOAD_URL_MAX_LEN];
+    /** @brief Requests issued by the generator. */
+    uint32_t issued;
+    /** @brief Requests rejected or failed synchronously. */
+    uint32_t errors;
+    /** @brief Latency samples accumulated in the run. */
+    uint32_t latency_samples;
+    /** @brief Sum of the latency samples in milliseconds. */
+    int64_t latency_sum_ms;
+    /** @brief Minimum latency sample in milliseconds. */
+    int64_t latency_min_ms;
+    /** @brief Maximum latency sample in milliseconds. */
+    int64_t latency_max_ms;
+} load_run_t;
+
+K_THREAD_STACK_DEFINE(load_thread_stack_area, LOAD_THREAD_STACK_SIZE);
+static struct k_thread load_thread_data;
+static atomic_t load_running;
+
+// Single run state, a new run is rejected while one is in progress
+static load_run_t load_run;
+
+// Counters fed by the zbus SDK event listener during a run
+static atomic_t observed_published;
+static atomic_t observed_completed;
+static atomic_t observed_failed;
+static atomic_t observed_bytes;
+// Uptime of the most recent telemetry request, used for the request-to-publish latency
+static atomic_t last_request_ms;
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+static void load_thread_entry_point(void *unused1, void *unused2, void *unused3);
+static void record_latency(load_run_t *run, int64_t sample_ms);
+static void run_telemetry_tick(load_run_t *run);
+static void run_command_tick(load_run_t *run);
+static void run_transfer_tick(load_run_t *run);
+static char *load_strdup(const char *src);
+
+/************************************************
+ *     Callbacks definition and declaration     *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+
+static void sdk_event_listener_cb(const struct zbus_channel *chan)
+{
+    const edgehog_sdk_chan_event_t *event = zbus_chan_const_msg(chan);
+
+    if (!atomic_get(&load_running)) {
+        return;
+    }
+
+    switch (event->event) {
+        case EDGEHOG_SDK_TELEMETRY_PUBLISHED_EVENT: {
+            atomic_inc(&observed_published);
+            // Approximate request-to-publish latency against the most recent request. With
+            // coalescing the true latency of a dropped duplicate is unobservable, this tracks
+            // the freshest outstanding request which is the one the publish satisfies.
+            int64_t sample_ms = k_uptime_get() - (int64_t) atomic_get(&last_request_ms);
+            record_latency(&load_run, sample_ms);
+            latency_stats_record(LATENCY_TRACKER_TELEMETRY, sample_ms);
+            break;
+        }
+        case EDGEHOG_SDK_TRANSFER_COMPLETED_EVENT:
+            atomic_inc(&observed_completed);
+            atomic_add(&observed_bytes, (atomic_val_t) event->bytes);
+            break;
+        case EDGEHOG_SDK_TRANSFER_FAILED_EVENT:
+            atomic_inc(&observed_failed);
+            break;
+        default:
+            break;
+    }
+}
+
+ZBUS_LISTENER_DEFINE(load_sdk_event_listener, sdk_event_listener_cb);
+ZBUS_CHAN_ADD_OBS(edgehog_sdk_chan, load_sdk_event_listener, 0);
+
+#endif /* CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS */
+
+/************************************************
+ *         Global functions definition          *
+ ***********************************************/
+
+int load_generation_start(load_mode_t mode, uint32_t rate_hz, uint32_t duration_s, const char *url)
+{
+    if ((rate_hz == 0) || (duration_s == 0)) {
+        LOG_ERR("Load generation needs a non zero rate and duration");
+        return -1;
+    }
+    if ((mode == LOAD_MODE_TRANSFER)
+        && (!url || (strlen(url) == 0) || (strlen(url) >= sizeof(load_run.url)))) {
+        LOG_ERR("Load generation in transfer mode needs an URL shorter than %zu characters",
+            sizeof(load_run.url));
+        return -1;
+    }
+    if (atomic_test_and_set_bit(&load_running, 0)) {
+        LOG_ERR("A load generation run is already in progress");
+        return -1;
+    }
+
+    memset(&load_run, 0, sizeof(load_run));
+    load_run.mode = mode;
+    load_run.rate_hz = rate_hz;
+    load_run.duration_s = duration_s;
+    load_run.latency_min_ms = INT64_MAX;
+    if (mode == LOAD_MODE_TRANSFER) {
+        // NOLINTNEXTLINE(cert-err33-c)
+        snprintf(load_run.url, sizeof(load_run.url), "%s", url);
+        preload_loopback_file(LOAD_TRANSFER_PAYLOAD_SIZE);
+    }
+
+    atomic_set(&observed_published, 0);
+    atomic_set(&observed_completed, 0);
+    atomic_set(&observed_failed, 0);
+    atomic_set(&observed_bytes, 0);
+
+    k_thread_create(&load_thread_data, load_thread_stack_area,
+        K_THREAD_STACK_SIZEOF(load_thread_stack_area), load_thread_entry_point, NULL, NULL, NULL,
+        CONFIG_E2E_DEVICE_THREAD_PRIORITY, 0, K_NO_WAIT);
+
+    return 0;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void load_thread_entry_point(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    load_run_t *run = &load_run;
+    uint32_t period_ms = MAX(MSEC_PER_SEC_U32 / run->rate_hz, 1U);
+    uint32_t total_ticks = run->duration_s * MSEC_PER_SEC_U32 / period_ms;
+
+    LOG_INF("Load generation started: mode %d, %u req/s for %u s", (int) run->mode, run->rate_hz,
+        run->duration_s);
+
+    for (uint32_t tick = 0; tick < total_ticks; tick++) {
+        k_timepoint_t timepoint = sys_timepoint_calc(K_MSEC(period_ms));
+
+        switch (run->mode) {
+            case LOAD_MODE_TELEMETRY:
+                run_telemetry_tick(run);
+                break;
+            case LOAD_MODE_COMMAND:
+                run_command_tick(run);
+                break;
+            case LOAD_MODE_TRANSFER:
+                run_transfer_tick(run);
+                break;
+            default:
+                break;
+        }
+
+        k_sleep(sys_timepoint_timeout(timepoint));
+    }
+
+    // Let in-flight work drain before collecting the observer counters
+    k_sleep(K_MSEC(LOAD_SETTLE_TIME_MS));
+
+    int64_t lat_min = (run->latency_samples > 0) ? run->latency_min_ms : 0;
+    int64_t lat_avg
+        = (run->latency_samples > 0) ? (run->latency_sum_ms / run->latency_samples) : 0;
+
+    // Single machine-parsable result line:
+    // loadstat,<mode>,<rate_hz>,<duration_s>,<issued>,<errors>,<published>,<completed>,<failed>,
+    // <bytes>,<lat_min_ms>,<lat_avg_ms>,<lat_max_ms>
+    LOG_INF("loadstat,%d,%u,%u,%u,%u,%ld,%ld,%ld,%ld,%lld,%lld,%lld", (int) run->mode,
+        run->rate_hz, run->duration_s, run->issued, run->errors,
+        (long) atomic_get(&observed_published), (long) atomic_get(&observed_completed),
+        (long) atomic_get(&observed_failed), (long) atomic_get(&observed_bytes),
+        (long long) lat_min, (long long) lat_avg, (long long) run->latency_max_ms);
+
+    atomic_clear_bit(&load_running, 0);
+    LOG_INF("Load generation run complete");
+}
+
+static void record_latency(load_run_t *run, int64_t sample_ms)
+{
+    run->latency_samples++;
+    run->latency_sum_ms += sample_ms;
+    run->latency_min_ms = MIN(run->latency_min_ms, sample_ms);
+    run->latency_max_ms = MAX(run->latency_max_ms, sample_ms);
+}
+
+static void run_telemetry_tick(load_run_t *run)
+{
+    edgehog_device_handle_t device = get_device_handle();
+    if (!device || !device->telemetry) {
+        run->errors++;
+        return;
+    }
+
+    edgehog_telemetry_type_t type
+        = load_telemetry_types[run->issued % ARRAY_SIZE(load_telemetry_types)];
+    atomic_set(&last_request_ms, (atomic_val_t) k_uptime_get());
+    run->issued++;
+    if (edgehog_telemetry_request(device->telemetry, type) != EDGEHOG_RESULT_OK) {
+        run->errors++;
+    }
+}
+
+static void run_command_tick(load_run_t *run)
+{
+    // A command unknown to the handler, exercising the full dispatch without side effects
+    astarte_device_datastream_individual_event_t event = {
+        .data = astarte_data_from_string("LoadGeneration"),
+    };
+
+    int64_t start_ms = k_uptime_get();
+    run->issued++;
+    edgehog_result_t eres = edgehog_command_event(&event);
+    int64_t sample_ms = k_uptime_get() - start_ms;
+    record_latency(run, sample_ms);
+    latency_stats_record(LATENCY_TRACKER_COMMAND, sample_ms);
+    if ((eres != EDGEHOG_RESULT_OK) && (eres != EDGEHOG_RESULT_COMMAND_INVALID_REQUEST)) {
+        run->errors++;
+    }
+}
+
+static void run_transfer_tick(load_run_t *run)
+{
+    edgehog_device_handle_t device = get_device_handle();
+    if (!device) {
+        run->errors++;
+        return;
+    }
+
+    // The message strings are released by the handler with edgehog_free
+    edgehog_ft_msg_t msg = { 0 };
+    (void) uuid_generate_v4(&msg.id);
+    msg.url = load_strdup(run->url);
+    msg.encoding = EDGEHOG_FT_ENCODING_NONE;
+    msg.location_type = EDGEHOG_FT_LOCATION_TYPE_STREAMING;
+    msg.location = load_strdup("loopback");
+    msg.type = EDGEHOG_FT_TYPE_DEVICE_TO_SERVER;
+    if (!msg.url || !msg.location) {
+        edgehog_free(msg.url);
+        edgehog_free(msg.location);
+        run->errors++;
+        return;
+    }
+
+    // The handler blocks until the transfer completes, back to back calls measure the
+    // saturation throughput of the upload lane
+    int64_t start_ms = k_uptime_get();
+    run->issued++;
+    edgehog_ft_handle_device_to_server(device, &msg);
+    record_latency(run, k_uptime_get() - start_ms);
+}
+
+static char *load_strdup(const char *src)
+{
+    size_t size = strlen(src) + 1;
+    char *dup = edgehog_malloc(size);
+    if (dup) {
+        memcpy(dup, src, size);
+    }
+    return dup;
+}
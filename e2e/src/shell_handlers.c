@@ -6,6 +6,7 @@
 
 #include "shell_handlers.h"
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -14,6 +15,8 @@
 #include <zephyr/sys/base64.h>
 
 #include "device_handler.h"
+#include "latency_stats.h"
+#include "load_handler.h"
 #include "utilities.h"
 
 LOG_MODULE_REGISTER(shell_handlers, CONFIG_SHELL_HANDLERS_LOG_LEVEL);
@@ -25,17 +28,34 @@ LOG_MODULE_REGISTER(shell_handlers, CONFIG_SHELL_HANDLERS_LOG_LEVEL);
 #define DISCONNECT_CMD dvcshellcmd_disconnect
 #define DISCONNECT_HELP "Disconnect the device and end the executable"
 
+#define LOAD_CMD dvcshellcmd_load
+#define LOAD_HELP                                                                                  \
+    "Start a load generation run: <telemetry|command|transfer> <rate_hz> <duration_s> [url]"
+#define LOAD_MIN_ARGS 4
+#define LOAD_MAX_ARGS 5
+
+#define LATSTAT_CMD dvcshellcmd_latstat
+#define LATSTAT_HELP "Report the latency histograms, pass 'reset' to also clear them"
+#define LATSTAT_MIN_ARGS 1
+#define LATSTAT_MAX_ARGS 2
+
 /************************************************
  *         Static functions declaration         *
  ***********************************************/
 
 static int cmd_disconnect(const struct shell *sh, size_t argc, char **argv);
+static int cmd_load(const struct shell *sh, size_t argc, char **argv);
+static int cmd_latstat(const struct shell *sh, size_t argc, char **argv);
 
 /************************************************
  *          Shell commands declaration          *
  ***********************************************/
 
 SHELL_CMD_REGISTER(DISCONNECT_CMD, NULL, DISCONNECT_HELP, cmd_disconnect);
+SHELL_CMD_ARG_REGISTER(
+    LOAD_CMD, NULL, LOAD_HELP, cmd_load, LOAD_MIN_ARGS, LOAD_MAX_ARGS - LOAD_MIN_ARGS);
+SHELL_CMD_ARG_REGISTER(LATSTAT_CMD, NULL, LATSTAT_HELP, cmd_latstat, LATSTAT_MIN_ARGS,
+    LATSTAT_MAX_ARGS - LATSTAT_MIN_ARGS);
 
 /************************************************
  *         Static functions definitions         *
@@ -52,3 +72,41 @@ static int cmd_disconnect(const struct shell *sh, size_t argc, char **argv)
     disconnect_device();
     return 0;
 }
+
+static int cmd_load(const struct shell *sh, size_t argc, char **argv)
+{
+    load_mode_t mode = LOAD_MODE_TELEMETRY;
+    if (strcmp(argv[1], "telemetry") == 0) {
+        mode = LOAD_MODE_TELEMETRY;
+    } else if (strcmp(argv[1], "command") == 0) {
+        mode = LOAD_MODE_COMMAND;
+    } else if (strcmp(argv[1], "transfer") == 0) {
+        mode = LOAD_MODE_TRANSFER;
+    } else {
+        shell_error(sh, "Unknown load mode '%s'", argv[1]);
+        return -EINVAL;
+    }
+
+    uint32_t rate_hz = (uint32_t) strtoul(argv[2], NULL, 10);
+    uint32_t duration_s = (uint32_t) strtoul(argv[3], NULL, 10);
+    const char *url = (argc > 4) ? argv[4] : NULL;
+
+    LOG_INF("Load command handler");
+    if (load_generation_start(mode, rate_hz, duration_s, url) != 0) {
+        shell_error(sh, "Failed to start the load generation run");
+        return -EINVAL;
+    }
+    return 0;
+}
+
+static int cmd_latstat(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(sh);
+
+    LOG_INF("Latency statistics command handler");
+    latency_stats_report();
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        latency_stats_reset();
+    }
+    return 0;
+}
@@ -56,15 +56,67 @@ typedef struct
     edgehog_battery_state_t battery_state;
 } edgehog_battery_status_t;
 
+/** @brief Maximum number of battery status sources that can be registered. */
+#define EDGEHOG_BATTERY_STATUS_MAX_SOURCES 4
+
+/**
+ * @brief Callback sampling the status of a single battery slot.
+ *
+ * @param[out] battery_status Battery status struct to fill with the sampled data, the battery
+ * slot name is already set.
+ * @param[in] user_data User data provided during the source registration.
+ * @return #EDGEHOG_RESULT_OK when the sample is valid, an error code to skip the slot.
+ */
+typedef edgehog_result_t (*edgehog_battery_status_source_cbk_t)(
+    edgehog_battery_status_t *battery_status, void *user_data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Register a battery status source for a battery slot.
+ *
+ * @details Registered sources are sampled in one pass by #edgehog_battery_status_publish_all.
+ * Sources should be registered before starting the Edgehog device.
+ *
+ * @note Requires @c CONFIG_EDGEHOG_DEVICE_BATTERY_STATUS, the battery status functionality is not
+ * compiled in otherwise.
+ *
+ * @param battery_slot Name of the battery slot, the pointed string must remain valid for the
+ * whole device lifetime.
+ * @param source_cbk Callback sampling the slot status.
+ * @param user_data User data passed back to the callback, might be NULL.
+ *
+ * @return #EDGEHOG_RESULT_OK if the source has been registered, an error code otherwise.
+ */
+edgehog_result_t edgehog_battery_status_source_register(
+    const char *battery_slot, edgehog_battery_status_source_cbk_t source_cbk, void *user_data);
+
+/**
+ * @brief Sample all registered battery status sources and publish the results.
+ *
+ * @details All the registered sources are sampled in a single pass and the resulting statuses
+ * are published back-to-back. A slot whose status did not change since the last publish is
+ * skipped when the telemetry change detection is enabled.
+ *
+ * @note Requires @c CONFIG_EDGEHOG_DEVICE_BATTERY_STATUS, the battery status functionality is not
+ * compiled in otherwise.
+ *
+ * @param edgehog_device A valid Edgehog device handle.
+ *
+ * @return #EDGEHOG_RESULT_OK if all the publishes have been successful, an error code otherwise.
+ */
+edgehog_result_t edgehog_battery_status_publish_all(edgehog_device_handle_t edgehog_device);
+
 /**
  * @brief Publish battery status info.
  *
  * @details This function publishes to Edgehog all available battery status updates.
  *
+ * @note Requires @c CONFIG_EDGEHOG_DEVICE_BATTERY_STATUS, the battery status functionality is not
+ * compiled in otherwise.
+ *
  * @param edgehog_device A valid Edgehog device handle.
  * @param battery_status A battery status structure that contains the current battery status. It can
  * be safely allocated on the stack, a copy of it is created internally.
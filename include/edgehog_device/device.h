@@ -70,6 +70,10 @@ typedef struct
     edgehog_ft_filesystem_partition_t *file_transfer_partitions;
     /** @brief The length of the file_transfer_partitions array. */
     size_t file_transfer_partitions_len;
+    /** @brief The raw flash partitions explicitly allowed for file transfers. */
+    edgehog_ft_flash_partition_t *file_transfer_flash_partitions;
+    /** @brief The length of the file_transfer_flash_partitions array. */
+    size_t file_transfer_flash_partitions_len;
     /**
      * @brief The file transfer callbacks configured by the user.
      * @details Provides the application-level hooks needed to accept or reject
@@ -110,6 +114,28 @@ extern "C" {
 edgehog_result_t edgehog_device_new(
     edgehog_device_config_t *config, edgehog_device_handle_t *edgehog_handle);
 
+/**
+ * @brief Create an Edgehog device instance in statically allocated storage.
+ *
+ * @details Behaves like #edgehog_device_new but places the whole Edgehog device context,
+ * including the telemetry service context, in internal static storage instead of the heap. This
+ * gives a deterministic startup memory footprint, visible in the map file, with no heap demand
+ * from the Edgehog library.
+ *
+ * A single static instance is available, creating a second one fails until the first is released
+ * with #edgehog_device_destroy.
+ *
+ * @note The internal Astarte device is created through the Astarte device SDK and follows its
+ * own allocation strategy.
+ *
+ * @param[in] config The configuration for the Edgehog instance to create.
+ * @param[out] edgehog_handle Handle to the created device instance. If the function returns an
+ * error this parameter is left unchanges, a call to #edgehog_device_destroy is not required.
+ * @return #EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_device_new_static(
+    edgehog_device_config_t *config, edgehog_device_handle_t *edgehog_handle);
+
 /**
  * @brief Destroy an Edgehog device.
  *
@@ -136,6 +162,9 @@ edgehog_result_t edgehog_device_start(edgehog_device_handle_t edgehog_device);
  *
  * @details This function should be periodically called to poll the Edgehog device.
  *
+ * @note When @c CONFIG_EDGEHOG_DEVICE_POLL_THREAD is enabled an internal thread pumps the device
+ * and this function should not be called by the application.
+ *
  * @param[inout] edgehog_device A valid Edgehog device handle.
  * @return #EDGEHOG_RESULT_OK on success, an error code otherwise.
  */
@@ -178,6 +207,40 @@ astarte_device_handle_t edgehog_device_get_astarte_device(edgehog_device_handle_
  */
 astarte_result_t edgehog_device_get_astarte_error(edgehog_device_handle_t edgehog_device);
 
+/**
+ * @brief Defer any running or future OTA download.
+ *
+ * @note Intended to keep the radio free for latency sensitive traffic, for example by limiting
+ * OTA transfers to configured time windows. A running download blocks at the next received
+ * chunk and stays deferred until #edgehog_device_ota_transfer_resume is called. If the deferral
+ * outlives the HTTP timeout the connection is dropped and, once resumed, the download restarts
+ * from the last flash-committed offset.
+ *
+ * @param[inout] edgehog_device A valid Edgehog device handle.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_device_ota_transfer_pause(edgehog_device_handle_t edgehog_device);
+
+/**
+ * @brief Resume OTA downloads previously deferred with #edgehog_device_ota_transfer_pause.
+ *
+ * @param[inout] edgehog_device A valid Edgehog device handle.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_device_ota_transfer_resume(edgehog_device_handle_t edgehog_device);
+
+/**
+ * @brief Hint that the network transport is currently awake.
+ *
+ * @note Only meaningful with CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED. Applications aware
+ * of radio activity outside the SDK, for example an own publish or a modem wakeup event, can
+ * call this to let held telemetry entries piggyback on the active transport instead of forcing
+ * a later radio wakeup. A no-op when the option is disabled or no telemetry entry is being held.
+ *
+ * @param[inout] edgehog_device A valid Edgehog device handle.
+ */
+void edgehog_device_telemetry_transport_hint(edgehog_device_handle_t edgehog_device);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,8 +8,11 @@
 #define EDGEHOG_DEVICE_FILE_TRANSFER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <zephyr/kernel.h>
 
+#include "edgehog_device/result.h"
+
 /**
  * @file file_transfer.h
  */
@@ -41,6 +44,35 @@ typedef enum
     EDGEHOG_FT_TYPE_DEVICE_TO_SERVER
 } edgehog_ft_type_t;
 
+/** @brief Watermark events reported for a streaming transfer pipe. */
+typedef enum
+{
+    /**
+     * @brief The pipe filled up, the side opposite to the library is the bottleneck.
+     * @details For a server-to-device transfer the application/storage is not keeping up with
+     * the network, for a device-to-server transfer the network is not keeping up with the
+     * application.
+     */
+    EDGEHOG_FT_STREAM_WATERMARK_HIGH = 0,
+    /**
+     * @brief The pipe drained, the library side is the bottleneck.
+     * @details For a server-to-device transfer the network is not keeping up with the
+     * application/storage, for a device-to-server transfer the application is not keeping up
+     * with the network.
+     */
+    EDGEHOG_FT_STREAM_WATERMARK_LOW,
+} edgehog_ft_stream_watermark_t;
+
+/**
+ * @brief Callback invoked when a streaming transfer pipe crosses a watermark.
+ * @details Invoked from the file transfer service thread, it should not block.
+ *
+ * @param[in] watermark The watermark that has been crossed.
+ * @param[in,out] user_data User data configured alongside the callback.
+ */
+typedef void (*edgehog_ft_stream_watermark_cbk_t)(
+    edgehog_ft_stream_watermark_t watermark, void *user_data);
+
 /** @brief Stream resources provided to the application by the file transfer */
 typedef struct
 {
@@ -48,6 +80,29 @@ typedef struct
     struct k_pipe *pipe;
     /** @brief Pointer to the Zephyr event used for signaling and transfer synchronization. */
     struct k_event *event;
+    /**
+     * @brief Pipe buffer size for this transfer, in bytes.
+     * @details Pre-filled with the default from
+     * EDGEHOG_DEVICE_FILE_TRANSFER_STREAM_PIPE_MAX_SIZE. The application may lower it in the
+     * stream transfer start callback to trade throughput for memory, values outside the
+     * supported bounds are clamped.
+     */
+    size_t pipe_buffer_size;
+    /** @brief Optional watermark callback for this transfer, NULL to disable the reports. */
+    edgehog_ft_stream_watermark_cbk_t watermark_cbk;
+    /** @brief User data passed to the watermark callback. */
+    void *watermark_user_data;
+    /**
+     * @brief Optional memory-mapped source region for a device-to-server transfer.
+     * @details When set in the stream transfer start callback the content is served with
+     * zero-copy spans pointing directly into this region and the pipe goes unused, eliminating
+     * the bounce buffer and the copy for assets resident in memory-mapped flash. The region must
+     * remain valid and unchanged until the transfer completes. Ignored for server-to-device
+     * transfers.
+     */
+    const uint8_t *direct_region;
+    /** @brief Size of the direct source region in bytes, 0 when unused. */
+    size_t direct_region_size;
 } edgehog_ft_stream_t;
 
 /** @brief File transfer file system permissions for a given partition. */
@@ -75,6 +130,21 @@ typedef struct
     edgehog_ft_filesystem_permission_t permissions;
 } edgehog_ft_filesystem_partition_t;
 
+/** @brief Configuration for an allowed raw flash partition. */
+typedef struct
+{
+    /**
+     * @brief Name matched against the location of partition transfers.
+     * @details E.g., "crashdump". The name is chosen by the integrator and is the identifier the
+     * server uses as the transfer location, it does not need to match the devicetree label.
+     */
+    const char *name;
+    /** @brief Fixed partition identifier, e.g. FIXED_PARTITION_ID(crashdump_partition). */
+    uint8_t id;
+    /** @brief Allowed transfer operations on this partition. */
+    edgehog_ft_filesystem_permission_t permissions;
+} edgehog_ft_flash_partition_t;
+
 /** @brief Callbacks for an Edgehog file transfer. */
 typedef struct
 {
@@ -86,8 +156,8 @@ typedef struct
      * @param[in] name The path/name of the requested stream.
      * @param[in] type The direction of the transfer.
      * @param[inout] expected_size A pointer to the size of the file (0 if unknown).
-     * @param[in] stream Pointer to a struct where the library provides the allocated pipe and
-     * event.
+     * @param[inout] stream Pointer to a struct where the library provides the allocated pipe and
+     * event. The application may adjust the per-transfer tuning fields before returning.
      * @return true if the application accepts the transfer, false to reject it.
      */
     bool (*on_stream_transfer_start)(const char *name, edgehog_ft_type_t type,
@@ -102,6 +172,24 @@ typedef struct
     void (*on_filesystem_transfer_done)(edgehog_ft_type_t type, const char *file_path);
 } edgehog_ft_cbks_t;
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+/**
+ * @brief Load a preset dictionary for compressed device-to-server transfers.
+ * @details The dictionary primes the LZ4 match window at the start of every compressed upload,
+ * improving both ratio and speed when packing many small similar files such as configuration
+ * snippets or logs. The dictionary content is digested internally, the buffer can be released
+ * after this call.
+ *
+ * @warning Must not be called while a device-to-server transfer is in progress.
+ *
+ * @param[in] dictionary Pointer to the dictionary content, NULL to clear the current dictionary.
+ * @param[in] dictionary_size Size of the dictionary content in bytes, 0 to clear it.
+ * @return EDGEHOG_RESULT_OK on success, otherwise an error code.
+ */
+edgehog_result_t edgehog_ft_compression_set_dictionary(
+    const uint8_t *dictionary, size_t dictionary_size);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
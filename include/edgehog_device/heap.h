@@ -0,0 +1,63 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EDGEHOG_DEVICE_HEAP_H
+#define EDGEHOG_DEVICE_HEAP_H
+
+/**
+ * @file heap.h
+ */
+
+/**
+ * @defgroup heap Heap statistics
+ * @brief API for the dedicated Edgehog heap statistics.
+ * @ingroup edgehog_device
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "edgehog_device/result.h"
+
+/** @brief Usage statistics for the dedicated Edgehog heap. */
+typedef struct
+{
+    /** @brief Bytes currently allocated from the heap. */
+    size_t allocated_bytes;
+    /** @brief Bytes currently available in the heap. */
+    size_t free_bytes;
+    /** @brief High watermark of allocated bytes since boot. */
+    size_t max_allocated_bytes;
+    /** @brief Number of allocation requests that failed since boot. */
+    uint32_t failed_allocations;
+} edgehog_heap_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the usage statistics of the dedicated Edgehog heap.
+ *
+ * @details The high watermark and failure count can be used to size
+ * @c CONFIG_EDGEHOG_DEVICE_HEAP_SIZE for a specific product configuration.
+ *
+ * @param[out] stats Statistics struct filled in by this function.
+ * @return #EDGEHOG_RESULT_OK if successful, #EDGEHOG_RESULT_NOT_SUPPORTED when
+ * @c CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP is disabled, otherwise an error code.
+ */
+edgehog_result_t edgehog_heap_stats_get(edgehog_heap_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif // EDGEHOG_DEVICE_HEAP_H
@@ -114,6 +114,8 @@ typedef enum
     EDGEHOG_RESULT_FLASH_ERROR = 42,
     /** @brief A generic error occurred when dealing with ZMS. */
     EDGEHOG_RESULT_ZMS_ERROR = 43,
+    /** @brief The requested functionality is not enabled in the build configuration. */
+    EDGEHOG_RESULT_NOT_SUPPORTED = 44,
 } edgehog_result_t;
 
 /**
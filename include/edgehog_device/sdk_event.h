@@ -0,0 +1,79 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EDGEHOG_DEVICE_SDK_EVENT_H
+#define EDGEHOG_DEVICE_SDK_EVENT_H
+
+/**
+ * @file sdk_event.h
+ */
+
+/**
+ * @defgroup sdk_event SDK event
+ * @brief API for SDK-wide lifecycle events.
+ * @ingroup edgehog_device
+ * @{
+ */
+
+#include <stddef.h>
+
+#include "edgehog_device/result.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+#include <zephyr/zbus/zbus.h>
+#endif
+
+/** @brief Edgehog SDK event codes. */
+typedef enum
+{
+    /** @brief An invalid event. */
+    EDGEHOG_SDK_INVALID_EVENT = 0,
+    /** @brief The device connected to Astarte. */
+    EDGEHOG_SDK_CONNECTED_EVENT,
+    /** @brief The device disconnected from Astarte. */
+    EDGEHOG_SDK_DISCONNECTED_EVENT,
+    /** @brief A telemetry publish pass completed. */
+    EDGEHOG_SDK_TELEMETRY_PUBLISHED_EVENT,
+    /** @brief A file transfer started. */
+    EDGEHOG_SDK_TRANSFER_STARTED_EVENT,
+    /** @brief A file transfer completed successfully. */
+    EDGEHOG_SDK_TRANSFER_COMPLETED_EVENT,
+    /** @brief A file transfer failed. */
+    EDGEHOG_SDK_TRANSFER_FAILED_EVENT
+} edgehog_sdk_event_t;
+
+/**
+ * @brief SDK event.
+ *
+ * @details Defines a lifecycle event of the SDK, used as the type of the zbus Edgehog SDK channel.
+ * @note Since the zbus channel definition accepts only struct or union, mirroring the OTA channel
+ * this struct wraps the event code together with its context fields.
+ */
+typedef struct
+{
+    /** @brief Edgehog SDK event. */
+    edgehog_sdk_event_t event;
+    /** @brief Result associated with the event, #EDGEHOG_RESULT_OK when not meaningful. */
+    edgehog_result_t result;
+    /** @brief Number of bytes moved, valid for the file transfer events, zero otherwise. */
+    size_t bytes;
+} edgehog_sdk_chan_event_t;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+/**
+ * @brief Declaration for the zbus SDK channel.
+ *
+ * @details The variable @p edgehog_sdk_chan is defined within the Edgehog device. It should be
+ * used to add observers, for example using ZBUS_CHAN_ADD_OBS.
+ */
+ZBUS_CHAN_DECLARE(edgehog_sdk_chan);
+#endif
+
+/**
+ * @}
+ */
+
+#endif // EDGEHOG_DEVICE_SDK_EVENT_H
@@ -43,6 +43,10 @@ typedef enum
     EDGEHOG_TELEMETRY_SYSTEM_STATUS,
     /** @brief Storage usage telemetry type. */
     EDGEHOG_TELEMETRY_STORAGE_USAGE,
+    /** @brief System status burst flush, driven internally by the burst telemetry mode. */
+    EDGEHOG_TELEMETRY_SYSTEM_STATUS_BURST,
+    /** @brief Self-profiling metrics of the SDK internals. */
+    EDGEHOG_TELEMETRY_SDK_METRICS,
     /** @brief Don't use it, It is a placeholder for the enum len. */
     EDGEHOG_TELEMETRY_LEN
 } edgehog_telemetry_type_t;
@@ -0,0 +1,71 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EDGEHOG_DEVICE_TELEMETRY_BURST_H
+#define EDGEHOG_DEVICE_TELEMETRY_BURST_H
+
+/**
+ * @file telemetry_burst.h
+ */
+
+/**
+ * @defgroup telemetry_burst Burst telemetry
+ * @brief API for high frequency burst telemetry.
+ * @details
+ * The periodic telemetry service cannot sample faster than the network can publish. During a
+ * burst window the system status is instead sampled at high frequency into a RAM ring buffer,
+ * and the buffered samples are uploaded as one batch carrying their original timestamps. This
+ * gives incident-level diagnostic resolution without a publish per sample.
+ * @ingroup edgehog_device
+ * @{
+ */
+
+#include <stdint.h>
+
+#include "edgehog_device/device.h"
+#include "edgehog_device/result.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
+/**
+ * @brief Start a burst telemetry window.
+ *
+ * @details Sampling starts immediately at the configured rate and stops when the window
+ * expires, the buffered samples are flushed by the telemetry service thread when the buffer
+ * fills up and when the window ends. Calling this function while a window is active extends it.
+ *
+ * @note The telemetry service must be running for the flush to be performed.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle.
+ * @param[in] duration_seconds Length of the burst window in seconds.
+ *
+ * @return #EDGEHOG_RESULT_OK if the window has been started, an error code otherwise.
+ */
+edgehog_result_t edgehog_telemetry_burst_start(
+    edgehog_device_handle_t edgehog_device, int32_t duration_seconds);
+
+/**
+ * @brief Stop the burst telemetry window.
+ *
+ * @details Sampling stops immediately and the samples still buffered are flushed.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle.
+ */
+void edgehog_telemetry_burst_stop(edgehog_device_handle_t edgehog_device);
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif // EDGEHOG_DEVICE_TELEMETRY_BURST_H
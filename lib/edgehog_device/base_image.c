@@ -20,19 +20,7 @@
 EDGEHOG_LOG_MODULE_REGISTER(base_image, CONFIG_EDGEHOG_DEVICE_BASE_IMAGE_LOG_LEVEL);
 
 /************************************************
- *         Static functions declarations        *
- ***********************************************/
-
-static void publish_fingerprint(edgehog_device_handle_t edgehog_device);
-
-static void publish_name(edgehog_device_handle_t edgehog_device);
-
-static void publish_version(edgehog_device_handle_t edgehog_device);
-
-static void publish_build_id(edgehog_device_handle_t edgehog_device);
-
-/************************************************
- *             Constants and defines            *
+ *        Defines, constants and typedef        *
  ***********************************************/
 
 #define FINGERPRINT_PROP "/fingerprint"
@@ -40,100 +28,56 @@ static void publish_build_id(edgehog_device_handle_t edgehog_device);
 #define VERSION_PROP "/version"
 #define BUILD_ID_PROP "/buildId"
 
-/************************************************
- *         Global functions definition          *
- ***********************************************/
-
-void publish_base_image(edgehog_device_handle_t edgehog_device)
-{
-    EDGEHOG_LOG_DBG("Publishing Edgehog device base image properties");
-    publish_fingerprint(edgehog_device);
-    publish_name(edgehog_device);
-    publish_version(edgehog_device);
-    publish_build_id(edgehog_device);
-}
-
-/************************************************
- *         Static functions definitions         *
- ***********************************************/
-
-static void publish_fingerprint(edgehog_device_handle_t edgehog_device)
+/** @brief A base image property and the value to publish for it. */
+typedef struct
 {
+    /** @brief Path of the property in the BaseImage interface. */
+    const char *prop;
+    /** @brief Value of the property, known at build time. */
+    const char *value;
+} base_image_prop_t;
+
+// All the base image metadata is baked in at build time, the running image only changes across
+// a reboot. Publishes walk this table, no data is gathered at publish time.
+static const base_image_prop_t base_image_props[] = {
 #ifdef APP_BUILD_VERSION
-    const char *hash = STRINGIFY(APP_BUILD_VERSION);
-
-    if (strcmp(hash, "") == 0) {
-        EDGEHOG_LOG_WRN("The property '%s' of interface '%s' is empty", FINGERPRINT_PROP,
-            io_edgehog_devicemanager_BaseImage.name);
-        return;
-    }
-
-    astarte_result_t res = astarte_device_set_property(edgehog_device->astarte_device,
-        io_edgehog_devicemanager_BaseImage.name, FINGERPRINT_PROP, astarte_data_from_string(hash));
-
-    if (res != ASTARTE_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to publish " FINGERPRINT_PROP);
-        return;
-    }
+    { .prop = FINGERPRINT_PROP, .value = STRINGIFY(APP_BUILD_VERSION) },
 #endif
-}
-
-static void publish_name(edgehog_device_handle_t edgehog_device)
-{
 #ifdef CONFIG_KERNEL_BIN_NAME
-    if (strcmp(CONFIG_KERNEL_BIN_NAME, "") == 0) {
-        EDGEHOG_LOG_WRN("The property '%s' of interface '%s' is empty", NAME_PROP,
-            io_edgehog_devicemanager_BaseImage.name);
-        return;
-    }
-
-    astarte_result_t res = astarte_device_set_property(edgehog_device->astarte_device,
-        io_edgehog_devicemanager_BaseImage.name, NAME_PROP,
-        astarte_data_from_string(CONFIG_KERNEL_BIN_NAME));
-
-    if (res != ASTARTE_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to publish " NAME_PROP);
-        return;
-    }
+    { .prop = NAME_PROP, .value = CONFIG_KERNEL_BIN_NAME },
 #endif
-}
-
-static void publish_version(edgehog_device_handle_t edgehog_device)
-{
 #ifdef APP_VERSION_STRING
-    if (strcmp(APP_VERSION_STRING, "") == 0) {
-        EDGEHOG_LOG_WRN("The property '%s' of interface '%s' is empty", VERSION_PROP,
-            io_edgehog_devicemanager_BaseImage.name);
-        return;
-    }
-
-    astarte_result_t res = astarte_device_set_property(edgehog_device->astarte_device,
-        io_edgehog_devicemanager_BaseImage.name, VERSION_PROP,
-        astarte_data_from_string(APP_VERSION_STRING));
-
-    if (res != ASTARTE_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to publish " VERSION_PROP);
-        return;
-    }
+    { .prop = VERSION_PROP, .value = APP_VERSION_STRING },
 #endif
-}
+#ifdef CMAKE_BUILD_DATE_TIME
+    { .prop = BUILD_ID_PROP, .value = CMAKE_BUILD_DATE_TIME },
+#endif
+};
 
-static void publish_build_id(edgehog_device_handle_t edgehog_device)
+/************************************************
+ *         Global functions definition          *
+ ***********************************************/
+
+void publish_base_image(edgehog_device_handle_t edgehog_device)
 {
-#ifdef CMAKE_BUILD_DATE_TIME
-    if (strcmp(CMAKE_BUILD_DATE_TIME, "") == 0) {
-        EDGEHOG_LOG_WRN("The property '%s' of interface '%s' is empty", BUILD_ID_PROP,
-            io_edgehog_devicemanager_BaseImage.name);
-        return;
-    }
+    EDGEHOG_LOG_DBG("Publishing Edgehog device base image properties");
 
-    astarte_result_t res = astarte_device_set_property(edgehog_device->astarte_device,
-        io_edgehog_devicemanager_BaseImage.name, BUILD_ID_PROP,
-        astarte_data_from_string(CMAKE_BUILD_DATE_TIME));
+    for (size_t i = 0; i < ARRAY_SIZE(base_image_props); i++) {
+        const base_image_prop_t *entry = &base_image_props[i];
 
-    if (res != ASTARTE_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to publish " BUILD_ID_PROP);
-        return;
+        if (strcmp(entry->value, "") == 0) {
+            EDGEHOG_LOG_WRN("The property '%s' of interface '%s' is empty", entry->prop,
+                io_edgehog_devicemanager_BaseImage.name);
+            continue;
+        }
+
+        astarte_result_t res
+            = astarte_device_set_property(edgehog_device->astarte_device,
+                io_edgehog_devicemanager_BaseImage.name, entry->prop,
+                astarte_data_from_string(entry->value));
+
+        if (res != ASTARTE_RESULT_OK) {
+            EDGEHOG_LOG_ERR("Unable to publish %s", entry->prop);
+        }
     }
-#endif
 }
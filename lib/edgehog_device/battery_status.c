@@ -9,6 +9,7 @@
 #include "edgehog_private.h"
 #include "generated_interfaces.h"
 #include "system_time.h"
+#include "telemetry_delta.h"
 
 #include <astarte_device_sdk/device.h>
 #include <astarte_device_sdk/result.h>
@@ -16,6 +17,38 @@
 #include "log.h"
 EDGEHOG_LOG_MODULE_REGISTER(battery_status, CONFIG_EDGEHOG_DEVICE_BATTERY_STATUS_LOG_LEVEL);
 
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Registered battery status source for a single slot. */
+typedef struct
+{
+    /** @brief Name of the battery slot. */
+    const char *battery_slot;
+    /** @brief Callback sampling the slot status. */
+    edgehog_battery_status_source_cbk_t source_cbk;
+    /** @brief User data passed back to the callback. */
+    void *user_data;
+} battery_status_source_t;
+
+/** @brief Fields of a battery status compared by the change detection, the slot name is the key
+ * and timestamps are excluded. */
+typedef struct
+{
+    /** @brief Charge level. */
+    double level_percentage;
+    /** @brief Charge level absolute error. */
+    double level_absolute_error;
+    /** @brief Battery state code. */
+    edgehog_battery_state_t battery_state;
+} battery_delta_payload_t;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static battery_status_source_t battery_sources[EDGEHOG_BATTERY_STATUS_MAX_SOURCES];
+static size_t battery_sources_len;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /************************************************
  *         Static functions declaration         *
  ***********************************************/
@@ -31,6 +64,80 @@ static const char *edgehog_battery_to_code(edgehog_battery_state_t state);
  *         Global functions definitions         *
  ***********************************************/
 
+edgehog_result_t edgehog_battery_status_source_register(
+    const char *battery_slot, edgehog_battery_status_source_cbk_t source_cbk, void *user_data)
+{
+    if (!battery_slot || !source_cbk) {
+        EDGEHOG_LOG_ERR("Unable to register battery status source, slot or callback undefined");
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    for (size_t i = 0; i < battery_sources_len; i++) {
+        if (strcmp(battery_sources[i].battery_slot, battery_slot) == 0) {
+            EDGEHOG_LOG_ERR("Battery status source for slot '%s' already registered",
+                battery_slot);
+            return EDGEHOG_RESULT_INVALID_PARAM;
+        }
+    }
+
+    if (battery_sources_len >= EDGEHOG_BATTERY_STATUS_MAX_SOURCES) {
+        EDGEHOG_LOG_ERR("Unable to register battery status source, all slots in use");
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
+    }
+
+    battery_sources[battery_sources_len] = (battery_status_source_t){
+        .battery_slot = battery_slot,
+        .source_cbk = source_cbk,
+        .user_data = user_data,
+    };
+    battery_sources_len++;
+
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t edgehog_battery_status_publish_all(edgehog_device_handle_t edgehog_device)
+{
+    if (!edgehog_device) {
+        EDGEHOG_LOG_ERR("Unable to publish battery status, Edgehog device undefined");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+
+    // All the sources are sampled in one pass and the changed slots published back-to-back
+    for (size_t i = 0; i < battery_sources_len; i++) {
+        const battery_status_source_t *source = &battery_sources[i];
+        edgehog_battery_status_t battery_status = { .battery_slot = source->battery_slot };
+
+        edgehog_result_t sample_res = source->source_cbk(&battery_status, source->user_data);
+        if (sample_res != EDGEHOG_RESULT_OK) {
+            EDGEHOG_LOG_WRN("Battery status source for slot '%s' failed, skipping",
+                source->battery_slot);
+            continue;
+        }
+
+        // Zeroing the struct first makes the padding bytes deterministic for the hashing
+        battery_delta_payload_t delta_payload;
+        memset(&delta_payload, 0, sizeof(delta_payload));
+        delta_payload.level_percentage = battery_status.level_percentage;
+        delta_payload.level_absolute_error = battery_status.level_absolute_error;
+        delta_payload.battery_state = battery_status.battery_state;
+        if (!telemetry_delta_should_publish(
+                source->battery_slot, &delta_payload, sizeof(delta_payload))) {
+            continue;
+        }
+
+        edgehog_result_t publish_res
+            = edgehog_battery_status_publish(edgehog_device, &battery_status);
+        if (publish_res != EDGEHOG_RESULT_OK) {
+            telemetry_delta_invalidate(source->battery_slot);
+            eres = publish_res;
+        }
+    }
+
+    return eres;
+}
+
 edgehog_result_t edgehog_battery_status_publish(
     edgehog_device_handle_t edgehog_device, const edgehog_battery_status_t *battery_status)
 {
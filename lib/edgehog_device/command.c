@@ -12,18 +12,45 @@
 #include "log.h"
 EDGEHOG_LOG_MODULE_REGISTER(command, CONFIG_EDGEHOG_DEVICE_COMMAND_LOG_LEVEL);
 
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define COMMAND_REBOOT_DELAY_S 1
+
+/************************************************
+ *       Callbacks declaration/definition       *
+ ***********************************************/
+
+static void reboot_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    EDGEHOG_LOG_INF("Device restart now");
+    sys_reboot(SYS_REBOOT_WARM);
+}
+
+// The Astarte callback only schedules the reboot, the delay runs on the system workqueue so
+// MQTT reception is never blocked waiting for it
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static K_WORK_DELAYABLE_DEFINE(reboot_work, reboot_work_handler);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
 edgehog_result_t edgehog_command_event(astarte_device_datastream_individual_event_t *event_request)
 {
     astarte_data_t command_data = event_request->data;
 
     if (strcmp(command_data.data.string, "Reboot") == 0) {
-        EDGEHOG_LOG_INF("Device restart in 1 second");
-        k_sleep(K_SECONDS(1));
-        EDGEHOG_LOG_INF("Device restart now");
-        sys_reboot(SYS_REBOOT_WARM);
-    } else {
-        EDGEHOG_LOG_ERR(
-            "Unable to handle command event, command %s unsupported", command_data.data.string);
-        return EDGEHOG_RESULT_COMMAND_INVALID_REQUEST;
+        EDGEHOG_LOG_INF("Device restart in %d second(s)", COMMAND_REBOOT_DELAY_S);
+        k_work_schedule(&reboot_work, K_SECONDS(COMMAND_REBOOT_DELAY_S));
+        return EDGEHOG_RESULT_OK;
     }
+
+    EDGEHOG_LOG_ERR(
+        "Unable to handle command event, command %s unsupported", command_data.data.string);
+    return EDGEHOG_RESULT_COMMAND_INVALID_REQUEST;
 }
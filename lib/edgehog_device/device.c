@@ -14,18 +14,23 @@
 #include "file_transfer/upload.h"
 #include "generated_interfaces.h"
 #include "hardware_info.h"
+#include "heap.h"
+#include "http.h"
 #include "led.h"
 #include "log.h"
 #include "network_properties.h"
 #include "os_info.h"
 #include "runtime_info.h"
+#include "sdk_event.h"
 #include "settings.h"
 #include "storage_usage.h"
+#include "string_hash.h"
 #include "system_info.h"
 #include "system_status.h"
 #include "wifi_scan.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/util.h>
@@ -34,16 +39,149 @@
 #include <astarte_device_sdk/device.h>
 #include <astarte_device_sdk/interface.h>
 
+#ifdef CONFIG_EDGEHOG_DEVICE_WARM_START
+#include <app_version.h>
+#endif
+
 #define COMMANDS_REQUEST_PATH "/request"
 #define OTA_REQUEST_PATH "/request"
 #define FT_REQUEST_PATH "/request"
 
+#ifdef CONFIG_EDGEHOG_DEVICE_WARM_START
+// Settings location of the introspection fingerprint persisted after a full initial publish
+#define SETTINGS_DEVICE_KEY "device"
+#define SETTINGS_INTROSPECTION_FP_KEY "intro_fp"
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+#define POLL_THREAD_RUNNING_BIT (1)
+#define POLL_THREAD_ERROR_BACKOFF_MS 100
+#endif
+
 EDGEHOG_LOG_MODULE_REGISTER(edgehog_device, CONFIG_EDGEHOG_DEVICE_DEVICE_LOG_LEVEL);
 
 // function pointer representing the callback to synchronize using the sync_ota_ft_sem semaphore
 typedef edgehog_result_t (*datastream_obj_event_handler_cb_t)(
     edgehog_device_handle_t, astarte_device_datastream_object_event_t *);
 
+// function pointer representing the handler of a routed datastream individual event
+typedef edgehog_result_t (*datastream_individual_event_handler_cb_t)(
+    edgehog_device_handle_t, astarte_device_datastream_individual_event_t *);
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+/** @brief All the interfaces the library registers on the Astarte device. */
+static const astarte_interface_t *const edgehog_interfaces[] = {
+    &io_edgehog_devicemanager_HardwareInfo,
+    &io_edgehog_devicemanager_OSInfo,
+    &io_edgehog_devicemanager_SystemInfo,
+    &io_edgehog_devicemanager_OTAEvent,
+    &io_edgehog_devicemanager_OTARequest,
+    &io_edgehog_devicemanager_BaseImage,
+    &io_edgehog_devicemanager_Commands,
+    &io_edgehog_devicemanager_RuntimeInfo,
+    &io_edgehog_devicemanager_SystemStatus,
+    &io_edgehog_devicemanager_StorageUsage,
+    &io_edgehog_devicemanager_NetworkInterfaceProperties,
+#ifdef CONFIG_EDGEHOG_DEVICE_BATTERY_STATUS
+    &io_edgehog_devicemanager_BatteryStatus,
+#endif
+#if DT_NODE_HAS_STATUS(EDGEHOG_LED_NODE, okay)
+    &io_edgehog_devicemanager_LedBehavior,
+#endif
+#ifdef CONFIG_WIFI
+    &io_edgehog_devicemanager_WiFiScanResults,
+#endif
+    &io_edgehog_devicemanager_config_Telemetry,
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
+    &io_edgehog_devicemanager_fileTransfer_Capabilities,
+    &io_edgehog_devicemanager_fileTransfer_ServerToDevice,
+    &io_edgehog_devicemanager_fileTransfer_Response,
+    &io_edgehog_devicemanager_fileTransfer_Progress,
+    &io_edgehog_devicemanager_fileTransfer_DeviceToServer,
+#endif
+};
+
+/**
+ * @brief Routed handler adapting #edgehog_command_event, which takes no device handle.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle, unused.
+ * @param[in] event The Astarte datastream individual event to handle.
+ * @return EDGEHOG_RESULT_OK if successful, an edgehog_result_t otherwise.
+ */
+static edgehog_result_t commands_event_handler(
+    edgehog_device_handle_t edgehog_device, astarte_device_datastream_individual_event_t *event);
+
+// The routing tables below map the Edgehog owned interfaces to their event handlers. The name
+// hashes are filled in on the first event, routing then hashes the incoming interface name once
+// and only strcmp-confirms the entry whose hash matches, keeping the MQTT reception path flat
+// under command bursts.
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static struct
+{
+    /** @brief The routed Astarte interface. */
+    const astarte_interface_t *interface;
+    /** @brief The expected common path of the requests. */
+    const char *request_path;
+    /** @brief The handler for events of this interface. */
+    datastream_individual_event_handler_cb_t handler;
+    /** @brief Short request name for the log messages. */
+    const char *name;
+    /** @brief Hash of the interface name, 0 until computed. */
+    uint32_t name_hash;
+} individual_routes[] = {
+    { .interface = &io_edgehog_devicemanager_Commands,
+        .request_path = COMMANDS_REQUEST_PATH,
+        .handler = commands_event_handler,
+        .name = "Command" },
+#if DT_NODE_HAS_STATUS(EDGEHOG_LED_NODE, okay)
+    { .interface = &io_edgehog_devicemanager_LedBehavior,
+        .request_path = "/indicator/behavior",
+        .handler = edgehog_led_event,
+        .name = "LED event" },
+#endif
+};
+
+static struct
+{
+    /** @brief The routed Astarte interface. */
+    const astarte_interface_t *interface;
+    /** @brief The expected common path of the requests. */
+    const char *request_path;
+    /** @brief The handler for events of this interface. */
+    datastream_obj_event_handler_cb_t handler;
+    /** @brief Short request name for the log messages. */
+    const char *name;
+    /** @brief Hash of the interface name, 0 until computed. */
+    uint32_t name_hash;
+} object_routes[] = {
+    { .interface = &io_edgehog_devicemanager_OTARequest,
+        .request_path = OTA_REQUEST_PATH,
+        .handler = edgehog_ota_event,
+        .name = "OTA update" },
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
+    { .interface = &io_edgehog_devicemanager_fileTransfer_ServerToDevice,
+        .request_path = FT_REQUEST_PATH,
+        .handler = edgehog_ft_server_to_device_event,
+        .name = "FT server to device" },
+    { .interface = &io_edgehog_devicemanager_fileTransfer_DeviceToServer,
+        .request_path = FT_REQUEST_PATH,
+        .handler = edgehog_ft_device_to_server_event,
+        .name = "FT device to server" },
+#endif
+};
+
+// Storage backing the instance created by edgehog_device_new_static
+static struct edgehog_device static_device;
+static atomic_t static_device_in_use;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+K_THREAD_STACK_DEFINE(poll_thread_stack_area, CONFIG_EDGEHOG_DEVICE_POLL_THREAD_STACK_SIZE);
+#endif
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
@@ -52,10 +190,97 @@ static edgehog_result_t add_interfaces(astarte_device_handle_t astarte_device);
 
 static void edgehog_initial_publish(edgehog_device_handle_t edgehog_device);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_WARM_START
+/**
+ * @brief Compute the fingerprint of the introspection and the running image.
+ *
+ * @details Folds the name and version of every registered interface together with the build
+ * identity of the running image. Any firmware change touching either yields a new fingerprint
+ * and re-enables the full initial publish.
+ *
+ * @return The fingerprint.
+ */
+static uint32_t introspection_fingerprint(void);
+
+/**
+ * @brief Loader callback reading the persisted introspection fingerprint.
+ *
+ * @param[in] key the name with skipped part that was used as name in handler registration.
+ * @param[in] len the size of the data found in the backend.
+ * @param[in] read_cb function provided to read the data from the backend.
+ * @param[inout] cb_arg arguments for the read function provided by the backend.
+ * @param[inout] param pointer to the uint32_t receiving the stored fingerprint.
+ *
+ * @return 0 when the fingerprint has been read, a negative value otherwise.
+ */
+static int warm_start_settings_loader(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param);
+#endif
+
+/**
+ * @brief Handler for #initial_publish_work, runs the initial publish from the system workqueue.
+ *
+ * @param[in] work The work item contained in the Edgehog device struct.
+ */
+static void initial_publish_work_handler(struct k_work *work);
+
+/**
+ * @brief Initialize an Edgehog device instance in caller provided storage.
+ *
+ * @param[in] config The configuration for the Edgehog instance to create.
+ * @param[in] edgehog_device The zeroed storage for the instance to initialize.
+ * @param[in] statically_allocated True when the storage is the internal static instance.
+ * @param[out] edgehog_handle Handle to the created device instance, set on success only.
+ * @return #EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+static edgehog_result_t device_init(edgehog_device_config_t *config,
+    edgehog_device_handle_t edgehog_device, bool statically_allocated,
+    edgehog_device_handle_t *edgehog_handle);
+
+/**
+ * @brief Fill in the interface name hashes of the routing tables on the first event.
+ *
+ * @details A race between the first events is benign since every writer stores the same values.
+ */
+static void routes_hashes_init(void);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+/**
+ * @brief Entry point of the thread pumping the Astarte connection.
+ *
+ * @param[in] device_ptr A valid Edgehog device handle, cast to a void pointer.
+ * @param[in] unused1 Unused parameter.
+ * @param[in] unused2 Unused parameter.
+ */
+static void poll_thread_entry_point(void *device_ptr, void *unused1, void *unused2);
+#endif
+
 /************************************************
  *       Callbacks declaration/definition       *
  ***********************************************/
 
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+/**
+ * @brief Let held telemetry ride on the transport activity implied by an Astarte event.
+ *
+ * @details Every callback from the Astarte device means the transport is awake right now, the
+ * cheapest moment to flush telemetry entries held by the radio-aligned scheduler.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle.
+ */
+static void note_transport_activity(edgehog_device_handle_t edgehog_device)
+{
+    if (edgehog_device->telemetry) {
+        edgehog_telemetry_transport_active(edgehog_device->telemetry);
+    }
+}
+#else
+static void note_transport_activity(edgehog_device_handle_t edgehog_device)
+{
+    ARG_UNUSED(edgehog_device);
+}
+#endif
+
 static void astarte_connection_cbk(astarte_device_connection_event_t event)
 {
     EDGEHOG_LOG_DBG("Astarte device connected");
@@ -64,6 +289,10 @@ static void astarte_connection_cbk(astarte_device_connection_event_t event)
 
     edgehog_device->state = EDGEHOG_DEVICE_CONNECTED;
 
+    note_transport_activity(edgehog_device);
+
+    sdk_event_publish(EDGEHOG_SDK_CONNECTED_EVENT, EDGEHOG_RESULT_OK, 0);
+
     if (edgehog_device->user_connection_cbk) {
         event.user_data = edgehog_device->user_cbk_user_data;
         edgehog_device->user_connection_cbk(event);
@@ -80,6 +309,8 @@ static void astarte_disconnection_cbk(astarte_device_disconnection_event_t event
         edgehog_device->state = EDGEHOG_DEVICE_STARTED;
     }
 
+    sdk_event_publish(EDGEHOG_SDK_DISCONNECTED_EVENT, EDGEHOG_RESULT_OK, 0);
+
     if (edgehog_device->user_disconnection_cbk) {
         event.user_data = edgehog_device->user_cbk_user_data;
         edgehog_device->user_disconnection_cbk(event);
@@ -92,20 +323,20 @@ static void astarte_datastream_individual_cbk(astarte_device_datastream_individu
     astarte_device_data_event_t base_event = event.base_event;
     edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) base_event.user_data;
 
-    if ((strcmp(base_event.interface_name, io_edgehog_devicemanager_Commands.name) == 0)
-        && (strcmp(base_event.path, COMMANDS_REQUEST_PATH) == 0)) {
-        edgehog_result_t ota_result = edgehog_command_event(&event);
-        if (ota_result != EDGEHOG_RESULT_OK) {
-            EDGEHOG_LOG_ERR("Unable to handle Command request");
+    note_transport_activity(edgehog_device);
+    routes_hashes_init();
+
+    uint32_t name_hash = edgehog_string_hash(base_event.interface_name);
+    for (size_t i = 0; i < ARRAY_SIZE(individual_routes); i++) {
+        if ((individual_routes[i].name_hash != name_hash)
+            || (strcmp(base_event.interface_name, individual_routes[i].interface->name) != 0)
+            || (strcmp(base_event.path, individual_routes[i].request_path) != 0)) {
+            continue;
         }
-        return;
-    }
 
-    if ((strcmp(base_event.interface_name, io_edgehog_devicemanager_LedBehavior.name) == 0)
-        && (strcmp(base_event.path, "/indicator/behavior") == 0)) {
-        edgehog_result_t led_result = edgehog_led_event(edgehog_device, &event);
-        if (led_result != EDGEHOG_RESULT_OK) {
-            EDGEHOG_LOG_ERR("Unable to handle LED event request");
+        edgehog_result_t eres = individual_routes[i].handler(edgehog_device, &event);
+        if (eres != EDGEHOG_RESULT_OK) {
+            EDGEHOG_LOG_ERR("Unable to handle %s request", individual_routes[i].name);
         }
         return;
     }
@@ -122,57 +353,28 @@ static void astarte_datastream_object_cbk(astarte_device_datastream_object_event
     astarte_device_data_event_t base_event = event.base_event;
     edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) base_event.user_data;
 
-    if (strcmp(base_event.interface_name, io_edgehog_devicemanager_OTARequest.name) == 0) {
-        if (strcmp(base_event.path, OTA_REQUEST_PATH) != 0) {
-            EDGEHOG_LOG_ERR("Received OTA request on incorrect common path: '%s'", base_event.path);
-            return;
-        }
+    note_transport_activity(edgehog_device);
+    routes_hashes_init();
 
-        edgehog_result_t ota_result = edgehog_ota_event(edgehog_device, &event);
-        if (ota_result != EDGEHOG_RESULT_OK) {
-            EDGEHOG_LOG_ERR("Unable to handle OTA update request");
+    uint32_t name_hash = edgehog_string_hash(base_event.interface_name);
+    for (size_t i = 0; i < ARRAY_SIZE(object_routes); i++) {
+        if ((object_routes[i].name_hash != name_hash)
+            || (strcmp(base_event.interface_name, object_routes[i].interface->name) != 0)) {
+            continue;
         }
 
-        return;
-    }
-
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
-    if (strcmp(base_event.interface_name, io_edgehog_devicemanager_fileTransfer_ServerToDevice.name)
-        == 0) {
-        EDGEHOG_LOG_INF("Received file transfer server to device event");
-
-        if (strcmp(base_event.path, FT_REQUEST_PATH) != 0) {
-            EDGEHOG_LOG_ERR(
-                "Received file transfer request on incorrect common path: '%s'", base_event.path);
+        if (strcmp(base_event.path, object_routes[i].request_path) != 0) {
+            EDGEHOG_LOG_ERR("Received %s request on incorrect common path: '%s'",
+                object_routes[i].name, base_event.path);
             return;
         }
 
-        edgehog_result_t ft_result = edgehog_ft_server_to_device_event(edgehog_device, &event);
-        if (ft_result != EDGEHOG_RESULT_OK) {
-            EDGEHOG_LOG_ERR("Unable to handle FT server to device request");
-        }
-
-        return;
-    }
-
-    if (strcmp(base_event.interface_name, io_edgehog_devicemanager_fileTransfer_DeviceToServer.name)
-        == 0) {
-        EDGEHOG_LOG_INF("Received file transfer device to server event");
-
-        if (strcmp(base_event.path, FT_REQUEST_PATH) != 0) {
-            EDGEHOG_LOG_ERR(
-                "Received file transfer request on incorrect common path: '%s'", base_event.path);
-            return;
-        }
-
-        edgehog_result_t ft_result = edgehog_ft_device_to_server_event(edgehog_device, &event);
-        if (ft_result != EDGEHOG_RESULT_OK) {
-            EDGEHOG_LOG_ERR("Unable to handle FT device to server request");
+        edgehog_result_t eres = object_routes[i].handler(edgehog_device, &event);
+        if (eres != EDGEHOG_RESULT_OK) {
+            EDGEHOG_LOG_ERR("Unable to handle %s request", object_routes[i].name);
         }
-
         return;
     }
-#endif
 
     if (edgehog_device->user_datastream_object_cbk) {
         event.base_event.user_data = edgehog_device->user_cbk_user_data;
@@ -187,6 +389,8 @@ static void astarte_property_set_cbk(astarte_device_property_set_event_t event)
     astarte_device_data_event_t base_event = event.base_event;
     edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) base_event.user_data;
 
+    note_transport_activity(edgehog_device);
+
     if (strcmp(base_event.interface_name, io_edgehog_devicemanager_config_Telemetry.name) == 0) {
         edgehog_result_t eres
             = edgehog_telemetry_config_set_event(edgehog_device->telemetry, &event);
@@ -208,6 +412,8 @@ static void astarte_property_unset_cbk(astarte_device_data_event_t event)
 
     edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) event.user_data;
 
+    note_transport_activity(edgehog_device);
+
     if (strcmp(event.interface_name, io_edgehog_devicemanager_config_Telemetry.name) == 0) {
         edgehog_result_t eres
             = edgehog_telemetry_config_unset_event(edgehog_device->telemetry, &event);
@@ -230,136 +436,44 @@ static void astarte_property_unset_cbk(astarte_device_data_event_t event)
 edgehog_result_t edgehog_device_new(
     edgehog_device_config_t *config, edgehog_device_handle_t *edgehog_handle)
 {
-    edgehog_device_handle_t edgehog_device = NULL;
-    astarte_device_handle_t astarte_device = NULL;
-    edgehog_result_t eres = EDGEHOG_RESULT_OK;
-    astarte_result_t ares = ASTARTE_RESULT_OK;
-
     if (!config || !edgehog_handle) {
         EDGEHOG_LOG_ERR("Unable to init Edgehog device, missing config or device handle.");
         return EDGEHOG_RESULT_INVALID_PARAM;
     }
 
-    // Step 1: Initialize the Edgehog settings
-    eres = edgehog_settings_init();
-    if (eres != EDGEHOG_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Edgehog Settings Init failed");
-        goto failure;
-    }
-
-    // Step 2: Allocate space for the Edgehog device
-    edgehog_device = calloc(1, sizeof(struct edgehog_device));
+    // Allocate space for the Edgehog device
+    edgehog_device_handle_t edgehog_device = edgehog_calloc(1, sizeof(struct edgehog_device));
     if (!edgehog_device) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
-        eres = EDGEHOG_RESULT_OUT_OF_MEMORY;
-        goto failure;
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
 
-    // Step 3: Initialize the Astarte device
-    astarte_device_config_t *astarte_device_config = &config->astarte_device_config;
-    astarte_device_connection_cbk_t user_connection_cbk = astarte_device_config->connection_cbk;
-    astarte_device_disconnection_cbk_t user_disconnection_cbk
-        = astarte_device_config->disconnection_cbk;
-    astarte_device_datastream_individual_cbk_t user_datastream_individual_cbk
-        = astarte_device_config->datastream_individual_cbk;
-    astarte_device_datastream_object_cbk_t user_datastream_object_cbk
-        = astarte_device_config->datastream_object_cbk;
-    astarte_device_property_set_cbk_t user_property_set_cbk
-        = astarte_device_config->property_set_cbk;
-    astarte_device_property_unset_cbk_t user_property_unset_cbk
-        = astarte_device_config->property_unset_cbk;
-    void *user_cbk_user_data = astarte_device_config->cbk_user_data;
-
-    astarte_device_config->connection_cbk = astarte_connection_cbk;
-    astarte_device_config->disconnection_cbk = astarte_disconnection_cbk;
-    astarte_device_config->datastream_individual_cbk = astarte_datastream_individual_cbk;
-    astarte_device_config->datastream_object_cbk = astarte_datastream_object_cbk;
-    astarte_device_config->property_set_cbk = astarte_property_set_cbk;
-    astarte_device_config->property_unset_cbk = astarte_property_unset_cbk;
-    astarte_device_config->cbk_user_data = edgehog_device;
-
-    ares = astarte_device_new(&config->astarte_device_config, &astarte_device);
-    if (ares != ASTARTE_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Astarte device creation error: %s", astarte_result_to_name(ares));
-        eres = EDGEHOG_RESULT_ASTARTE_ERROR;
-        goto failure;
-    }
-
-    // Step 4: Add the edgehog interfaces to the Astarte device
-    eres = add_interfaces(astarte_device);
+    edgehog_result_t eres = device_init(config, edgehog_device, false, edgehog_handle);
     if (eres != EDGEHOG_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to add interface into Astarte Device SDK");
-        goto failure;
+        edgehog_free(edgehog_device);
     }
+    return eres;
+}
 
-    // Step 5: Initialize the Edgehog device boot ID
-    struct uuid boot_id = { 0 };
-    char boot_id_str[UUID_STR_LEN] = { 0 };
-    int res = uuid_generate_v4(&boot_id);
-    if (res != 0) {
-        EDGEHOG_LOG_ERR("Unable to generate Edgehog boot ID: %d", res);
-        goto failure;
-    }
-    res = uuid_to_string(&boot_id, boot_id_str);
-    if (res != 0) {
-        EDGEHOG_LOG_ERR("Unable to generate Edgehog boot ID: %d", res);
-        goto failure;
+edgehog_result_t edgehog_device_new_static(
+    edgehog_device_config_t *config, edgehog_device_handle_t *edgehog_handle)
+{
+    if (!config || !edgehog_handle) {
+        EDGEHOG_LOG_ERR("Unable to init Edgehog device, missing config or device handle.");
+        return EDGEHOG_RESULT_INVALID_PARAM;
     }
 
-    // Step 6: Initialize the telemetry for the Edgehog device
-    edgehog_telemetry_t *telemetry
-        = edgehog_telemetry_new(config->telemetry_config, config->telemetry_config_len);
-    if (!telemetry) {
-        EDGEHOG_LOG_ERR("Unable to create edgehog telemetry update");
-        goto failure;
+    // Claim the static instance storage
+    if (!atomic_cas(&static_device_in_use, 0, 1)) {
+        EDGEHOG_LOG_ERR("The static Edgehog device instance is already in use");
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
 
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
-    // Step 7: Initialize the file transfer for the Edgehog device
-    edgehog_ft_t *file_transfer = edgehog_ft_new(config->file_transfer_cbks,
-        config->file_transfer_partitions, config->file_transfer_partitions_len);
-    if (!file_transfer) {
-        EDGEHOG_LOG_ERR("Unable to create edgehog file transfer");
-        goto failure;
+    memset(&static_device, 0, sizeof(static_device));
+    edgehog_result_t eres = device_init(config, &static_device, true, edgehog_handle);
+    if (eres != EDGEHOG_RESULT_OK) {
+        atomic_clear(&static_device_in_use);
     }
-#endif
-
-    // Fill in the Edgehog device struct
-    *edgehog_device = (struct edgehog_device){
-        .state = EDGEHOG_DEVICE_STOPPED,
-        .initial_publish = false,
-        .astarte_device = astarte_device,
-        .astarte_error = ASTARTE_RESULT_OK,
-        .user_connection_cbk = user_connection_cbk,
-        .user_disconnection_cbk = user_disconnection_cbk,
-        .user_datastream_individual_cbk = user_datastream_individual_cbk,
-        .user_datastream_object_cbk = user_datastream_object_cbk,
-        .user_property_set_cbk = user_property_set_cbk,
-        .user_property_unset_cbk = user_property_unset_cbk,
-        .user_cbk_user_data = user_cbk_user_data,
-        .telemetry = telemetry,
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
-        .file_transfer = file_transfer,
-#endif
-        .storage_partitions = config->storage_partitions,
-        .storage_partitions_len = config->storage_partitions_len,
-    };
-
-    k_sem_init(&edgehog_device->sync_ota_ft_sem, 1, 1);
-
-    memcpy(edgehog_device->boot_id, boot_id_str, UUID_STR_LEN);
-    *edgehog_handle = edgehog_device;
-
-    // Step 8: Initialize the WiFi scan driver
-#ifdef CONFIG_WIFI
-    edgehog_wifi_scan_init(edgehog_device);
-#endif
-
-    return eres;
-
-failure:
-    astarte_device_destroy(astarte_device);
-    free(edgehog_device);
     return eres;
 }
 
@@ -368,6 +482,8 @@ void edgehog_device_destroy(edgehog_device_handle_t edgehog_device)
     if (!edgehog_device) {
         return;
     }
+    struct k_work_sync work_sync = { 0 };
+    k_work_cancel_sync(&edgehog_device->initial_publish_work, &work_sync);
     astarte_result_t ares = astarte_device_destroy(edgehog_device->astarte_device);
     if (ares != ASTARTE_RESULT_OK) {
         edgehog_device->astarte_error = ares;
@@ -377,7 +493,11 @@ void edgehog_device_destroy(edgehog_device_handle_t edgehog_device)
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
     edgehog_ft_destroy(edgehog_device->file_transfer);
 #endif
-    free(edgehog_device);
+    if (edgehog_device->statically_allocated) {
+        atomic_clear(&static_device_in_use);
+    } else {
+        edgehog_free(edgehog_device);
+    }
 }
 
 edgehog_result_t edgehog_device_start(edgehog_device_handle_t edgehog_device)
@@ -389,6 +509,27 @@ edgehog_result_t edgehog_device_start(edgehog_device_handle_t edgehog_device)
         return EDGEHOG_RESULT_ASTARTE_ERROR;
     }
     edgehog_device->state = EDGEHOG_DEVICE_STARTED;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+    if (!atomic_test_and_set_bit(&edgehog_device->poll_thread_state, POLL_THREAD_RUNNING_BIT)) {
+        k_tid_t thread_id = k_thread_create(&edgehog_device->poll_thread, poll_thread_stack_area,
+            CONFIG_EDGEHOG_DEVICE_POLL_THREAD_STACK_SIZE, poll_thread_entry_point,
+            (void *) edgehog_device, NULL, NULL, CONFIG_EDGEHOG_DEVICE_POLL_THREAD_PRIORITY, 0,
+            K_NO_WAIT);
+        if (!thread_id) {
+            EDGEHOG_LOG_ERR("Unable to start the Astarte pump thread");
+            atomic_clear_bit(&edgehog_device->poll_thread_state, POLL_THREAD_RUNNING_BIT);
+            return EDGEHOG_RESULT_THREAD_CREATE_ERROR;
+        }
+#ifdef CONFIG_THREAD_NAME
+        int ret = k_thread_name_set(thread_id, "edgehog_astarte_pump");
+        if (ret != 0) {
+            EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
+        }
+#endif
+    }
+#endif // CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+
     return EDGEHOG_RESULT_OK;
 }
 
@@ -404,8 +545,10 @@ edgehog_result_t edgehog_device_poll(edgehog_device_handle_t edgehog_device)
     edgehog_result_t eres = EDGEHOG_RESULT_OK;
     if (edgehog_device->state == EDGEHOG_DEVICE_CONNECTED) {
         if (!edgehog_device->initial_publish) {
-            edgehog_initial_publish(edgehog_device);
+            // The initial publish is a long burst of blocking transmissions. Running it from the
+            // system workqueue returns this poll path to handling inbound requests right away.
             edgehog_device->initial_publish = true;
+            k_work_submit(&edgehog_device->initial_publish_work);
         }
 
         edgehog_telemetry_t *telemetry = edgehog_device->telemetry;
@@ -432,7 +575,20 @@ edgehog_result_t edgehog_device_poll(edgehog_device_handle_t edgehog_device)
 
 edgehog_result_t edgehog_device_stop(edgehog_device_handle_t edgehog_device, k_timeout_t timeout)
 {
-    edgehog_result_t eres = edgehog_telemetry_stop(edgehog_device->telemetry, timeout);
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+    // Request the pump thread to stop and wait for the poll in flight to return
+    if (atomic_test_bit(&edgehog_device->poll_thread_state, POLL_THREAD_RUNNING_BIT)) {
+        atomic_clear_bit(&edgehog_device->poll_thread_state, POLL_THREAD_RUNNING_BIT);
+        if (k_thread_join(&edgehog_device->poll_thread, timeout) != 0) {
+            EDGEHOG_LOG_ERR("Unable to stop the Astarte pump thread within the timeout");
+            return EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+    }
+#endif
+
+    eres = edgehog_telemetry_stop(edgehog_device->telemetry, timeout);
     if (eres != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("Unable to stop the Edgehog device within the timeout");
         return eres;
@@ -476,62 +632,295 @@ astarte_result_t edgehog_device_get_astarte_error(edgehog_device_handle_t edgeho
 
 static edgehog_result_t add_interfaces(astarte_device_handle_t astarte_device)
 {
-    const astarte_interface_t *const interfaces[] = {
-        &io_edgehog_devicemanager_HardwareInfo,
-        &io_edgehog_devicemanager_OSInfo,
-        &io_edgehog_devicemanager_SystemInfo,
-        &io_edgehog_devicemanager_OTAEvent,
-        &io_edgehog_devicemanager_OTARequest,
-        &io_edgehog_devicemanager_BaseImage,
-        &io_edgehog_devicemanager_Commands,
-        &io_edgehog_devicemanager_RuntimeInfo,
-        &io_edgehog_devicemanager_SystemStatus,
-        &io_edgehog_devicemanager_StorageUsage,
-        &io_edgehog_devicemanager_NetworkInterfaceProperties,
-#if DT_NODE_HAS_STATUS(EDGEHOG_LED_NODE, okay)
-        &io_edgehog_devicemanager_LedBehavior,
-#endif
-#ifdef CONFIG_WIFI
-        &io_edgehog_devicemanager_WiFiScanResults,
+    for (int i = 0; i < ARRAY_SIZE(edgehog_interfaces); i++) {
+        astarte_result_t ret = astarte_device_add_interface(astarte_device, edgehog_interfaces[i]);
+        if (ret != ASTARTE_RESULT_OK) {
+            EDGEHOG_LOG_ERR("Unable to add Astarte interface ( %s ): %s",
+                edgehog_interfaces[i]->name, astarte_result_to_name(ret));
+            return EDGEHOG_RESULT_ASTARTE_ERROR;
+        }
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t device_init(edgehog_device_config_t *config,
+    edgehog_device_handle_t edgehog_device, bool statically_allocated,
+    edgehog_device_handle_t *edgehog_handle)
+{
+    astarte_device_handle_t astarte_device = NULL;
+    edgehog_telemetry_t *telemetry = NULL;
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    astarte_result_t ares = ASTARTE_RESULT_OK;
+
+    // Step 1: Initialize the Edgehog settings
+    eres = edgehog_settings_init();
+    if (eres != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Edgehog Settings Init failed");
+        goto failure;
+    }
+
+    // Step 2: Initialize the Astarte device
+    astarte_device_config_t *astarte_device_config = &config->astarte_device_config;
+    astarte_device_connection_cbk_t user_connection_cbk = astarte_device_config->connection_cbk;
+    astarte_device_disconnection_cbk_t user_disconnection_cbk
+        = astarte_device_config->disconnection_cbk;
+    astarte_device_datastream_individual_cbk_t user_datastream_individual_cbk
+        = astarte_device_config->datastream_individual_cbk;
+    astarte_device_datastream_object_cbk_t user_datastream_object_cbk
+        = astarte_device_config->datastream_object_cbk;
+    astarte_device_property_set_cbk_t user_property_set_cbk
+        = astarte_device_config->property_set_cbk;
+    astarte_device_property_unset_cbk_t user_property_unset_cbk
+        = astarte_device_config->property_unset_cbk;
+    void *user_cbk_user_data = astarte_device_config->cbk_user_data;
+
+    astarte_device_config->connection_cbk = astarte_connection_cbk;
+    astarte_device_config->disconnection_cbk = astarte_disconnection_cbk;
+    astarte_device_config->datastream_individual_cbk = astarte_datastream_individual_cbk;
+    astarte_device_config->datastream_object_cbk = astarte_datastream_object_cbk;
+    astarte_device_config->property_set_cbk = astarte_property_set_cbk;
+    astarte_device_config->property_unset_cbk = astarte_property_unset_cbk;
+    astarte_device_config->cbk_user_data = edgehog_device;
+
+    ares = astarte_device_new(&config->astarte_device_config, &astarte_device);
+    if (ares != ASTARTE_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Astarte device creation error: %s", astarte_result_to_name(ares));
+        eres = EDGEHOG_RESULT_ASTARTE_ERROR;
+        goto failure;
+    }
+
+    // Step 3: Add the edgehog interfaces to the Astarte device
+    eres = add_interfaces(astarte_device);
+    if (eres != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Unable to add interface into Astarte Device SDK");
+        goto failure;
+    }
+
+    // Step 4: Initialize the Edgehog device boot ID
+    struct uuid boot_id = { 0 };
+    char boot_id_str[UUID_STR_LEN] = { 0 };
+    int res = uuid_generate_v4(&boot_id);
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Unable to generate Edgehog boot ID: %d", res);
+        eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+        goto failure;
+    }
+    res = uuid_to_string(&boot_id, boot_id_str);
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Unable to generate Edgehog boot ID: %d", res);
+        eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+        goto failure;
+    }
+
+    // Step 5: Initialize the telemetry for the Edgehog device
+    telemetry = statically_allocated
+        ? edgehog_telemetry_new_static(config->telemetry_config, config->telemetry_config_len)
+        : edgehog_telemetry_new(config->telemetry_config, config->telemetry_config_len);
+    if (!telemetry) {
+        EDGEHOG_LOG_ERR("Unable to create edgehog telemetry update");
+        eres = EDGEHOG_RESULT_OUT_OF_MEMORY;
+        goto failure;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
+    // Step 6: Initialize the file transfer for the Edgehog device
+    edgehog_ft_t *file_transfer = edgehog_ft_new(config->file_transfer_cbks,
+        config->file_transfer_partitions, config->file_transfer_partitions_len,
+        config->file_transfer_flash_partitions, config->file_transfer_flash_partitions_len);
+    if (!file_transfer) {
+        EDGEHOG_LOG_ERR("Unable to create edgehog file transfer");
+        eres = EDGEHOG_RESULT_OUT_OF_MEMORY;
+        goto failure;
+    }
 #endif
-        &io_edgehog_devicemanager_config_Telemetry,
+
+    // Fill in the Edgehog device struct
+    *edgehog_device = (struct edgehog_device){
+        .state = EDGEHOG_DEVICE_STOPPED,
+        .initial_publish = false,
+        .statically_allocated = statically_allocated,
+        .astarte_device = astarte_device,
+        .astarte_error = ASTARTE_RESULT_OK,
+        .user_connection_cbk = user_connection_cbk,
+        .user_disconnection_cbk = user_disconnection_cbk,
+        .user_datastream_individual_cbk = user_datastream_individual_cbk,
+        .user_datastream_object_cbk = user_datastream_object_cbk,
+        .user_property_set_cbk = user_property_set_cbk,
+        .user_property_unset_cbk = user_property_unset_cbk,
+        .user_cbk_user_data = user_cbk_user_data,
+        .telemetry = telemetry,
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
-        &io_edgehog_devicemanager_fileTransfer_Capabilities,
-        &io_edgehog_devicemanager_fileTransfer_ServerToDevice,
-        &io_edgehog_devicemanager_fileTransfer_Response,
-        &io_edgehog_devicemanager_fileTransfer_Progress,
-        &io_edgehog_devicemanager_fileTransfer_DeviceToServer,
+        .file_transfer = file_transfer,
 #endif
+        .storage_partitions = config->storage_partitions,
+        .storage_partitions_len = config->storage_partitions_len,
     };
 
-    for (int i = 0; i < ARRAY_SIZE(interfaces); i++) {
-        astarte_result_t ret = astarte_device_add_interface(astarte_device, interfaces[i]);
-        if (ret != ASTARTE_RESULT_OK) {
-            EDGEHOG_LOG_ERR("Unable to add Astarte interface ( %s ): %s", interfaces[i]->name,
-                astarte_result_to_name(ret));
-            return EDGEHOG_RESULT_ASTARTE_ERROR;
+    // Each file transfer lane holds one permit for the duration of a transfer, an OTA update
+    // drains all of them to run exclusively
+    k_sem_init(&edgehog_device->sync_ota_ft_sem, EDGEHOG_FT_LANE_COUNT, EDGEHOG_FT_LANE_COUNT);
+
+    k_work_init(&edgehog_device->initial_publish_work, initial_publish_work_handler);
+
+    memcpy(edgehog_device->boot_id, boot_id_str, UUID_STR_LEN);
+    *edgehog_handle = edgehog_device;
+
+    // Step 7: Initialize the WiFi scan driver
+#ifdef CONFIG_WIFI
+    edgehog_wifi_scan_init(edgehog_device);
+#endif
+
+    // Step 8: Snapshot the runtime-formatted device info, the initial publish reads from the
+    // cached strings
+    os_info_snapshot();
+    runtime_info_snapshot();
+
+    // Step 9: Probe the TLS credentials for the transfer sockets, a missing certificate
+    // surfaces now instead of at the first OTA or file transfer request
+    if (edgehog_http_tls_credentials_check() != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Transfer TLS credentials missing, register them before the first OTA");
+    }
+
+    return eres;
+
+failure:
+    if (telemetry) {
+        edgehog_telemetry_destroy(telemetry);
+    }
+    astarte_device_destroy(astarte_device);
+    return eres;
+}
+
+static edgehog_result_t commands_event_handler(
+    edgehog_device_handle_t edgehog_device, astarte_device_datastream_individual_event_t *event)
+{
+    ARG_UNUSED(edgehog_device);
+    return edgehog_command_event(event);
+}
+
+static void routes_hashes_init(void)
+{
+    if (individual_routes[0].name_hash != 0) {
+        return;
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(individual_routes); i++) {
+        individual_routes[i].name_hash = edgehog_string_hash(individual_routes[i].interface->name);
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(object_routes); i++) {
+        object_routes[i].name_hash = edgehog_string_hash(object_routes[i].interface->name);
+    }
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+static void poll_thread_entry_point(void *device_ptr, void *unused1, void *unused2)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+
+    edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) device_ptr;
+
+    // The Astarte device SDK blocks on the MQTT socket inside the poll for up to its configured
+    // timeout, so polling back to back wakes on socket readiness without spinning.
+    while (atomic_test_bit(&edgehog_device->poll_thread_state, POLL_THREAD_RUNNING_BIT)) {
+        edgehog_result_t eres = edgehog_device_poll(edgehog_device);
+        if (eres != EDGEHOG_RESULT_OK) {
+            // Back off shortly so a persistent failure does not turn the loop into a busy wait
+            // while the Astarte device reconnects.
+            k_sleep(K_MSEC(POLL_THREAD_ERROR_BACKOFF_MS));
         }
     }
+}
+#endif
 
-    return EDGEHOG_RESULT_OK;
+static void initial_publish_work_handler(struct k_work *work)
+{
+    edgehog_device_handle_t edgehog_device
+        = CONTAINER_OF(work, struct edgehog_device, initial_publish_work);
+    edgehog_initial_publish(edgehog_device);
 }
 
 static void edgehog_initial_publish(edgehog_device_handle_t edgehog_device)
 {
     EDGEHOG_LOG_DBG("Initial publish for the edgehog device");
     edgehog_ota_init(edgehog_device);
-    publish_hardware_info(edgehog_device);
-    publish_os_info(edgehog_device);
-    publish_system_info(edgehog_device);
-    publish_base_image(edgehog_device);
-    publish_runtime_info(edgehog_device);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_WARM_START
+    // After a reboot with an unchanged introspection and image, as following a clean OTA swap,
+    // the build-time properties published by the previous boot are still valid on Astarte and
+    // republishing them only delays the operational state.
+    uint32_t fingerprint = introspection_fingerprint();
+    uint32_t stored_fingerprint = 0;
+    edgehog_settings_load(SETTINGS_DEVICE_KEY, warm_start_settings_loader, &stored_fingerprint);
+    bool warm_start = (stored_fingerprint == fingerprint);
+    if (warm_start) {
+        EDGEHOG_LOG_INF("Warm start, skipping the unchanged build-time property publishes");
+    }
+#else
+    bool warm_start = false;
+#endif
+
+    if (!warm_start) {
+        publish_hardware_info(edgehog_device);
+        publish_os_info(edgehog_device);
+        publish_system_info(edgehog_device);
+        publish_base_image(edgehog_device);
+        publish_runtime_info(edgehog_device);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
+        edgeghog_ft_publish_capabilities(edgehog_device);
+#endif
+    }
+
     publish_system_status(edgehog_device);
     publish_storage_usage(edgehog_device);
     publish_network_properties(edgehog_device);
 #ifdef CONFIG_WIFI
     edgehog_wifi_scan_start(edgehog_device);
 #endif
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER
-    edgeghog_ft_publish_capabilities(edgehog_device);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_WARM_START
+    if (!warm_start) {
+        edgehog_settings_save(SETTINGS_DEVICE_KEY, SETTINGS_INTROSPECTION_FP_KEY, &fingerprint,
+            sizeof(fingerprint));
+    }
+#endif
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_WARM_START
+static uint32_t introspection_fingerprint(void)
+{
+    // FNV-1a style fold, matching the constants of edgehog_string_hash
+    uint32_t fingerprint = 2166136261U;
+    for (size_t i = 0; i < ARRAY_SIZE(edgehog_interfaces); i++) {
+        fingerprint = (fingerprint * 16777619U) ^ edgehog_string_hash(edgehog_interfaces[i]->name);
+        fingerprint = (fingerprint * 16777619U) ^ (uint32_t) edgehog_interfaces[i]->major_version;
+        fingerprint = (fingerprint * 16777619U) ^ (uint32_t) edgehog_interfaces[i]->minor_version;
+    }
+#ifdef APP_BUILD_VERSION
+    fingerprint = (fingerprint * 16777619U) ^ edgehog_string_hash(STRINGIFY(APP_BUILD_VERSION));
+#elif defined(APP_VERSION_STRING)
+    fingerprint = (fingerprint * 16777619U) ^ edgehog_string_hash(APP_VERSION_STRING);
 #endif
+    return fingerprint;
+}
+
+static int warm_start_settings_loader(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param)
+{
+    const char *next = NULL;
+    uint32_t *dest = (uint32_t *) param;
+
+    size_t key_len = settings_name_next(key, &next);
+    if (!next && (strncmp(key, SETTINGS_INTROSPECTION_FP_KEY, key_len) == 0)
+        && (len == sizeof(*dest))) {
+        int res = read_cb(cb_arg, dest, sizeof(*dest));
+        if (res < 0) {
+            EDGEHOG_LOG_ERR("Unable to read the introspection fingerprint from settings: %d", res);
+            return res;
+        }
+        return 0;
+    }
+
+    return -ENOENT;
 }
+#endif // CONFIG_EDGEHOG_DEVICE_WARM_START
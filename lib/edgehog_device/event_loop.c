@@ -0,0 +1,51 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "event_loop.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(event_loop, CONFIG_EDGEHOG_DEVICE_EVENT_LOOP_LOG_LEVEL);
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_THREAD_STACK_DEFINE(event_loop_stack, CONFIG_EDGEHOG_DEVICE_EVENT_LOOP_STACK_SIZE);
+static struct k_work_q event_loop_queue;
+// True once the queue thread has been started, starting happens only once
+static bool event_loop_started;
+static K_MUTEX_DEFINE(event_loop_mutex);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+struct k_work_q *edgehog_event_loop_get(void)
+{
+    k_mutex_lock(&event_loop_mutex, K_FOREVER);
+    if (!event_loop_started) {
+        EDGEHOG_LOG_DBG("Starting the shared SDK event-loop thread");
+        k_work_queue_init(&event_loop_queue);
+        struct k_work_queue_config config = {
+#ifdef CONFIG_THREAD_NAME
+            .name = "edgehog_loop",
+#endif
+        };
+        k_work_queue_start(&event_loop_queue, event_loop_stack,
+            K_THREAD_STACK_SIZEOF(event_loop_stack), CONFIG_EDGEHOG_DEVICE_EVENT_LOOP_PRIORITY,
+            &config);
+        event_loop_started = true;
+    }
+    k_mutex_unlock(&event_loop_mutex);
+
+    return &event_loop_queue;
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
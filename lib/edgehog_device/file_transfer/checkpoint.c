@@ -0,0 +1,210 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+
+#include "file_transfer/checkpoint.h"
+
+#include "settings.h"
+#include "string_hash.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/uuid.h>
+
+#include "log.h"
+
+EDGEHOG_LOG_MODULE_REGISTER(
+    file_transfer_checkpoint, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Settings subtree holding the file transfer persistent state. */
+#define SETTINGS_FT_KEY "ft"
+/** @brief Settings key holding the single resume checkpoint slot. */
+#define SETTINGS_CHECKPOINT_KEY "checkpoint"
+/** @brief The checkpoint is persisted after this many received bytes. */
+#define CHECKPOINT_INTERVAL_BYTES CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME_CHECKPOINT_BYTES
+/** @brief Read buffer size used while re-hashing the stored prefix of a resumed file. */
+#define CHECKPOINT_REHASH_BUF_SIZE 1024
+
+/** @brief Persistent image of a transfer checkpoint, a single slot is kept in the settings. */
+typedef struct
+{
+    /** @brief Transfer ID the checkpoint belongs to. */
+    uint8_t id[UUID_SIZE];
+    /** @brief Hash of the download URL, guards against resuming from a different source. */
+    uint32_t url_hash;
+    /** @brief Hash of the destination location, guards against resuming a different file. */
+    uint32_t location_hash;
+    /** @brief Bytes of the file received when the checkpoint was persisted. */
+    uint64_t offset;
+} ft_checkpoint_t;
+
+/** @brief Destination of the settings loader, tracks whether the slot was actually present. */
+struct checkpoint_load_ctx
+{
+    /** @brief The loaded checkpoint. */
+    ft_checkpoint_t ckpt;
+    /** @brief True when a stored checkpoint was found. */
+    bool found;
+};
+
+/************************************************
+ *         Static functions declarations        *
+ ***********************************************/
+
+static edgehog_result_t checkpoint_persist(const edgehog_ft_http_cbk_data_t *data);
+static int checkpoint_settings_loader(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void edgehog_ft_checkpoint_resume_offset(const edgehog_ft_msg_t *msg, size_t *resume_offset)
+{
+    *resume_offset = 0;
+
+    struct checkpoint_load_ctx load_ctx = { 0 };
+    edgehog_result_t eres
+        = edgehog_settings_load(SETTINGS_FT_KEY, checkpoint_settings_loader, &load_ctx);
+    if ((eres != EDGEHOG_RESULT_OK) || !load_ctx.found) {
+        return;
+    }
+
+    if ((memcmp(load_ctx.ckpt.id, msg->id.val, UUID_SIZE) != 0)
+        || (load_ctx.ckpt.url_hash != edgehog_string_hash(msg->url))
+        || (load_ctx.ckpt.location_hash != edgehog_string_hash(msg->location))) {
+        EDGEHOG_LOG_DBG("Stored checkpoint does not match the requested transfer");
+        return;
+    }
+
+    // Clamp to the bytes that actually reached the filesystem, the checkpoint may have been
+    // persisted ahead of the last sync or the file may have lost its tail on power failure
+    struct fs_dirent entry = { 0 };
+    if ((fs_stat(msg->location, &entry) != 0) || (entry.type != FS_DIR_ENTRY_FILE)) {
+        EDGEHOG_LOG_DBG("No stored partial file for the checkpointed transfer");
+        return;
+    }
+    *resume_offset = (size_t) MIN(load_ctx.ckpt.offset, (uint64_t) entry.size);
+}
+
+void edgehog_ft_checkpoint_begin(
+    edgehog_ft_http_cbk_data_t *data, const edgehog_ft_msg_t *msg, size_t resume_offset)
+{
+    data->ckpt_url_hash = edgehog_string_hash(msg->url);
+    data->ckpt_location_hash = edgehog_string_hash(msg->location);
+    data->ckpt_offset = resume_offset;
+    data->ckpt_next_save = resume_offset + CHECKPOINT_INTERVAL_BYTES;
+    data->ckpt_active = true;
+
+    // Claim the slot right away so a stale checkpoint of another transfer cannot survive
+    if (checkpoint_persist(data) != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to persist the transfer checkpoint");
+    }
+}
+
+void edgehog_ft_checkpoint_note(edgehog_ft_http_cbk_data_t *data, size_t bytes)
+{
+    if (!data->ckpt_active) {
+        return;
+    }
+
+    data->ckpt_offset += bytes;
+    if (data->ckpt_offset < data->ckpt_next_save) {
+        return;
+    }
+
+    if (checkpoint_persist(data) != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_WRN("Unable to persist the transfer checkpoint");
+    }
+    data->ckpt_next_save = data->ckpt_offset + CHECKPOINT_INTERVAL_BYTES;
+}
+
+void edgehog_ft_checkpoint_clear(edgehog_ft_http_cbk_data_t *data)
+{
+    if (!data || !data->ckpt_active) {
+        return;
+    }
+    data->ckpt_active = false;
+    edgehog_settings_delete(SETTINGS_FT_KEY, SETTINGS_CHECKPOINT_KEY);
+}
+
+edgehog_result_t edgehog_ft_checkpoint_rehash(const char *path, size_t length,
+    edgehog_ft_rehash_cbk_t update, edgehog_ft_http_cbk_data_t *data)
+{
+    struct fs_file_t file;
+    fs_file_t_init(&file);
+
+    if (fs_open(&file, path, FS_O_READ) != 0) {
+        EDGEHOG_LOG_ERR("Unable to open the stored partial file for re-hashing");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    uint8_t buf[CHECKPOINT_REHASH_BUF_SIZE];
+    size_t hashed = 0;
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    while (hashed < length) {
+        size_t to_read = MIN(sizeof(buf), length - hashed);
+        ssize_t read_bytes = fs_read(&file, buf, to_read);
+        if (read_bytes <= 0) {
+            EDGEHOG_LOG_ERR("Unable to read the stored partial file for re-hashing");
+            eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+            break;
+        }
+        eres = update(data, buf, (size_t) read_bytes);
+        if (eres != EDGEHOG_RESULT_OK) {
+            break;
+        }
+        hashed += (size_t) read_bytes;
+    }
+
+    fs_close(&file);
+    return eres;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static edgehog_result_t checkpoint_persist(const edgehog_ft_http_cbk_data_t *data)
+{
+    ft_checkpoint_t ckpt = { 0 };
+    memcpy(ckpt.id, data->id->val, UUID_SIZE);
+    ckpt.url_hash = data->ckpt_url_hash;
+    ckpt.location_hash = data->ckpt_location_hash;
+    ckpt.offset = data->ckpt_offset;
+    return edgehog_settings_save(SETTINGS_FT_KEY, SETTINGS_CHECKPOINT_KEY, &ckpt, sizeof(ckpt));
+}
+
+static int checkpoint_settings_loader(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param)
+{
+    const char *next = NULL;
+    struct checkpoint_load_ctx *dest = (struct checkpoint_load_ctx *) param;
+
+    size_t key_len = settings_name_next(key, &next);
+    if (!next && (strncmp(key, SETTINGS_CHECKPOINT_KEY, key_len) == 0)
+        && (len == sizeof(dest->ckpt))) {
+        int res = read_cb(cb_arg, &dest->ckpt, sizeof(dest->ckpt));
+        if (res < 0) {
+            EDGEHOG_LOG_ERR("Unable to read the transfer checkpoint from settings: %d", res);
+            return res;
+        }
+        dest->found = true;
+        return 0;
+    }
+
+    return -ENOENT;
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
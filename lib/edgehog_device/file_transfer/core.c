@@ -7,11 +7,13 @@
 #include "file_transfer/core.h"
 
 #include "edgehog_private.h"
+#include "event_loop.h"
 #include "file_transfer/download.h"
 #include "file_transfer/upload.h"
 #include "file_transfer/utils.h"
 #include "generated_interfaces.h"
 #include "log.h"
+#include "thread_placement.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,26 +21,60 @@
 
 EDGEHOG_LOG_MODULE_REGISTER(file_transfer, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_LOG_LEVEL);
 
+BUILD_ASSERT(sizeof(edgehog_ft_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The file transfer service data doesn't fit a per-transfer context slab block");
+
 /************************************************
  *        Defines, constants and typedef        *
  ***********************************************/
 
 #define THREAD_STACK_SIZE 8192
+#ifdef CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT
+#define THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_PRIORITY
+#else
 #define THREAD_PRIORITY 5
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_CPU_MASK
+#define THREAD_CPU_MASK CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_CPU_MASK
+#else
+#define THREAD_CPU_MASK 0
+#endif
 #define THREAD_RUNNING_BIT (1)
 
+#ifndef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
-K_THREAD_STACK_DEFINE(file_transfer_service_thread_stack_area, THREAD_STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(
+    file_transfer_lane_stack_areas, EDGEHOG_FT_LANE_COUNT, THREAD_STACK_SIZE);
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
+#ifdef CONFIG_THREAD_NAME
+static const char *const lane_thread_names[EDGEHOG_FT_LANE_COUNT] = {
+    [EDGEHOG_FT_LANE_DOWNLOAD] = "file_transfer_dl",
+    [EDGEHOG_FT_LANE_UPLOAD] = "file_transfer_ul",
+};
+#endif
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
 
-static void thread_entry_point(void *device_ptr, void *unused1, void *unused2);
-static edgehog_ft_filesystem_partition_t *duplicate_partitions(
-    edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len);
-static void free_partitions(edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len);
+/**
+ * @brief Take the OTA synchronization semaphore and perform one transfer.
+ *
+ * @details Shared by the lane service threads and the event-loop work handlers. The message is
+ * destroyed before returning when the service is stopped while waiting for the semaphore.
+ *
+ * @param[in] edgehog_device Handle to the device owning the file transfer service.
+ * @param[inout] msg The transfer request to serve, ownership is taken.
+ */
+static void process_transfer_msg(edgehog_device_handle_t edgehog_device, edgehog_ft_msg_t *msg);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+static void lane_work_handler(struct k_work *work);
+#else
+static void thread_entry_point(void *device_ptr, void *lane_ptr, void *unused);
+#endif
 
 /************************************************
  *         Global functions definitions         *
@@ -125,8 +161,14 @@ void edgeghog_ft_publish_capabilities(edgehog_device_handle_t edgehog_device)
         return;
     }
 
-    // Possible values: [storage, streaming, filesystem]
-    const char *supported_targets[] = { "streaming", "filesystem" };
+    // Possible values: [storage, streaming, filesystem, partition]
+    const char *supported_targets[] = {
+        "streaming",
+        "filesystem",
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION
+        "partition",
+#endif
+    };
     size_t supported_targets_len = ARRAY_SIZE(supported_targets);
     res = astarte_device_set_property(edgehog_device->astarte_device,
         io_edgehog_devicemanager_fileTransfer_Capabilities.name, "/transfer/serverToDevice/targets",
@@ -144,39 +186,39 @@ void edgeghog_ft_publish_capabilities(edgehog_device_handle_t edgehog_device)
     }
 }
 
-edgehog_ft_t *edgehog_ft_new(
-    edgehog_ft_cbks_t cbks, edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len)
+edgehog_ft_t *edgehog_ft_new(edgehog_ft_cbks_t cbks,
+    edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len,
+    edgehog_ft_flash_partition_t *flash_partitions, size_t flash_partitions_len)
 {
     // Allocate space for the file transfer internal struct
-    edgehog_ft_t *data = k_calloc(1, sizeof(edgehog_ft_t));
+    edgehog_ft_t *data = edgehog_ft_ctx_alloc(sizeof(edgehog_ft_t));
     if (!data) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         goto error;
     }
 
+    // The configuration lifetime contract requires the partition array to outlive the device,
+    // so it is referenced directly instead of deep copied to the heap
     if (partitions && partitions_len > 0) {
-        data->partitions = duplicate_partitions(partitions, partitions_len);
-        if (!data->partitions) {
-            EDGEHOG_LOG_ERR("Failed to duplicate partitions");
-            goto error;
-        }
+        data->partitions = partitions;
         data->partitions_len = partitions_len;
     }
+    if (flash_partitions && flash_partitions_len > 0) {
+        data->flash_partitions = flash_partitions;
+        data->flash_partitions_len = flash_partitions_len;
+    }
     data->cbks = cbks;
 
     return data;
 
 error:
-    k_free(data);
+    edgehog_ft_ctx_free(data);
     return NULL;
 }
 
 void edgehog_ft_destroy(edgehog_ft_t *file_transfer)
 {
-    if (file_transfer && file_transfer->partitions) {
-        free_partitions(file_transfer->partitions, file_transfer->partitions_len);
-    }
-    k_free(file_transfer);
+    edgehog_ft_ctx_free(file_transfer);
 }
 
 edgehog_result_t edgehog_ft_start(edgehog_device_handle_t device)
@@ -193,37 +235,58 @@ edgehog_result_t edgehog_ft_start(edgehog_device_handle_t device)
         return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
     }
 
-    if (k_msgq_alloc_init(&file_transfer->msgq, sizeof(edgehog_ft_msg_t),
-            CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_QUEUE_SIZE)
-        != 0) {
-        EDGEHOG_LOG_ERR("Unable to allocate and init file transfer message queue");
-        atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-        return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
-    }
-
-    k_tid_t thread_id = k_thread_create(&file_transfer->thread,
-        file_transfer_service_thread_stack_area, THREAD_STACK_SIZE, thread_entry_point,
-        (void *) device, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    // Start one message queue and one service thread or work item per transfer lane
+    int lane = 0;
+    for (lane = 0; lane < EDGEHOG_FT_LANE_COUNT; lane++) {
+        if (k_msgq_alloc_init(&file_transfer->msgq[lane], sizeof(edgehog_ft_msg_t),
+                CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_QUEUE_SIZE)
+            != 0) {
+            EDGEHOG_LOG_ERR("Unable to allocate and init file transfer message queue");
+            goto failure;
+        }
 
-    if (!thread_id) {
-        EDGEHOG_LOG_ERR("Unable to start file transfer message thread");
-        k_msgq_cleanup(&file_transfer->msgq);
-        atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-        return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
-    }
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+        file_transfer->lane_work[lane].lane = lane;
+        file_transfer->lane_work[lane].device = device;
+        k_work_init(&file_transfer->lane_work[lane].work, lane_work_handler);
+#else
+        k_tid_t thread_id = k_thread_create(&file_transfer->thread[lane],
+            file_transfer_lane_stack_areas[lane], THREAD_STACK_SIZE, thread_entry_point,
+            (void *) device, INT_TO_POINTER(lane), NULL, THREAD_PRIORITY, 0,
+            EDGEHOG_THREAD_START_DELAY);
+
+        if (!thread_id) {
+            EDGEHOG_LOG_ERR("Unable to start file transfer message thread");
+            k_msgq_cleanup(&file_transfer->msgq[lane]);
+            goto failure;
+        }
 
 #ifdef CONFIG_THREAD_NAME
-    int ret = k_thread_name_set(thread_id, "file_transfer");
-    if (ret != 0) {
-        EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
-        k_thread_abort(thread_id);
-        k_msgq_cleanup(&file_transfer->msgq);
-        atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-        return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
-    }
+        int ret = k_thread_name_set(thread_id, lane_thread_names[lane]);
+        if (ret != 0) {
+            EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
+            k_thread_abort(thread_id);
+            k_msgq_cleanup(&file_transfer->msgq[lane]);
+            goto failure;
+        }
 #endif
 
+        edgehog_thread_placement_start(thread_id, THREAD_CPU_MASK);
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+    }
+
     return EDGEHOG_RESULT_OK;
+
+failure:
+    // Unwind the lanes already started, the running bit is cleared so they self exit
+    atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
+    for (int started = 0; started < lane; started++) {
+#ifndef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+        k_thread_join(&file_transfer->thread[started], K_FOREVER);
+#endif
+        k_msgq_cleanup(&file_transfer->msgq[started]);
+    }
+    return EDGEHOG_RESULT_FILE_TRANSFER_START_FAIL;
 }
 
 edgehog_result_t edgehog_ft_stop(edgehog_ft_t *file_transfer, k_timeout_t timeout)
@@ -238,29 +301,40 @@ edgehog_result_t edgehog_ft_stop(edgehog_ft_t *file_transfer, k_timeout_t timeou
         EDGEHOG_LOG_WRN("Stopping edgehog file transfer while not running");
         return EDGEHOG_RESULT_OK;
     }
-    // Request the thread to self exit
+    // Request the lane threads to self exit
     atomic_clear_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT);
-    // Wait for the thread to self exit
-    int res = k_thread_join(&file_transfer->thread, timeout);
-    switch (res) {
-        case 0:
-            break;
-        case -EAGAIN:
-            // Force stop the thread, this will likely leak memory and resources
-            k_thread_abort(&file_transfer->thread);
-            eres = EDGEHOG_RESULT_FILE_TRANSFER_STOP_TIMEOUT;
-            break;
-        default:
-            EDGEHOG_LOG_ERR("Failed to stop file transfer thread, error %d", res);
-            eres = EDGEHOG_RESULT_INTERNAL_ERROR;
-    }
-    // Empty the message queue from leftovers
-    edgehog_ft_msg_t msg_rcv;
-    while (k_msgq_get(&file_transfer->msgq, &msg_rcv, K_NO_WAIT) == 0) {
-        edgehog_ft_msg_destroy(&msg_rcv);
+    for (int lane = 0; lane < EDGEHOG_FT_LANE_COUNT; lane++) {
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+        // The running bit is cleared so a handler in progress finishes its current transfer and
+        // drains nothing further, the cancel waits for it. An event-loop work item cannot be
+        // aborted mid-transfer, the stop timeout does not apply in this mode.
+        ARG_UNUSED(timeout);
+        struct k_work_sync sync = { 0 };
+        k_work_cancel_sync(&file_transfer->lane_work[lane].work, &sync);
+#else
+        // Wait for the lane thread to self exit
+        int res = k_thread_join(&file_transfer->thread[lane], timeout);
+        switch (res) {
+            case 0:
+                break;
+            case -EAGAIN:
+                // Force stop the thread, this will likely leak memory and resources
+                k_thread_abort(&file_transfer->thread[lane]);
+                eres = EDGEHOG_RESULT_FILE_TRANSFER_STOP_TIMEOUT;
+                break;
+            default:
+                EDGEHOG_LOG_ERR("Failed to stop file transfer thread, error %d", res);
+                eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+        // Empty the message queue from leftovers
+        edgehog_ft_msg_t msg_rcv;
+        while (k_msgq_get(&file_transfer->msgq[lane], &msg_rcv, K_NO_WAIT) == 0) {
+            edgehog_ft_msg_destroy(&msg_rcv);
+        }
+        // Safely free the message queue's internal buffer
+        k_msgq_cleanup(&file_transfer->msgq[lane]);
     }
-    // Safely free the message queue's internal buffer
-    k_msgq_cleanup(&file_transfer->msgq);
 
     return eres;
 }
@@ -302,12 +376,22 @@ edgehog_result_t edgehog_ft_process_event(edgehog_device_handle_t device,
         goto failure;
     }
 
-    if (k_msgq_put(&device->file_transfer->msgq, &msg, K_NO_WAIT) != 0) {
+    // Route the request to the lane serving its transfer direction
+    enum edgehog_ft_lane lane = (type == EDGEHOG_FT_TYPE_DEVICE_TO_SERVER)
+        ? EDGEHOG_FT_LANE_UPLOAD
+        : EDGEHOG_FT_LANE_DOWNLOAD;
+    if (k_msgq_put(&device->file_transfer->msgq[lane], &msg, K_NO_WAIT) != 0) {
         EDGEHOG_LOG_ERR("Unable to send file transfer data to the handler task");
         eres = EDGEHOG_RESULT_FILE_TRANSFER_QUEUE_ERROR;
         goto failure;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+    // Wake the lane drainer, submitting while it runs schedules one more pass
+    k_work_submit_to_queue(
+        edgehog_event_loop_get(), &device->file_transfer->lane_work[lane].work);
+#endif
+
     return eres;
 
 failure:
@@ -328,101 +412,76 @@ failure:
  *         Static functions definitions         *
  ***********************************************/
 
-static void thread_entry_point(void *device_ptr, void *unused1, void *unused2)
+static void process_transfer_msg(edgehog_device_handle_t edgehog_device, edgehog_ft_msg_t *msg)
 {
-    EDGEHOG_LOG_DBG("File transfer thread entry point.");
-    ARG_UNUSED(unused1);
-    ARG_UNUSED(unused2);
-
-    edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) device_ptr;
     edgehog_ft_t *file_transfer = edgehog_device->file_transfer;
-    struct k_msgq *msgq = &file_transfer->msgq;
 
-    edgehog_ft_msg_t msg_rcv = { 0 };
+    // Wait for OTA semaphore with a timeout to prevent deadlocks during shutdown
+    bool sem_taken = false;
     while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)) {
-        if (k_msgq_get(msgq, &msg_rcv, K_MSEC(100)) == 0) {
-
-            // Wait for OTA semaphore with a timeout to prevent deadlocks during shutdown
-            bool sem_taken = false;
-            while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)) {
-                if (k_sem_take(&edgehog_device->sync_ota_ft_sem, K_MSEC(100)) == 0) {
-                    sem_taken = true;
-                    break;
-                }
-            }
-
-            // If the thread was stopped while waiting, clean up the popped message and exit
-            if (!sem_taken) {
-                edgehog_ft_msg_destroy(&msg_rcv);
-                break;
-            }
-
-            // Proceed with the transfer since we hold the semaphore
-            char id_str[UUID_STR_LEN] = { 0 };
-            uuid_to_string(&msg_rcv.id, id_str);
-            if (msg_rcv.type == EDGEHOG_FT_TYPE_SERVER_TO_DEVICE) {
-                EDGEHOG_LOG_DBG("Server to device file transfer: %s", id_str);
-                edgehog_ft_handle_server_to_device(edgehog_device, &msg_rcv);
-            } else if (msg_rcv.type == EDGEHOG_FT_TYPE_DEVICE_TO_SERVER) {
-                EDGEHOG_LOG_DBG("Device to server file transfer: %s", id_str);
-                edgehog_ft_handle_device_to_server(edgehog_device, &msg_rcv);
-            }
-
-            k_sem_give(&edgehog_device->sync_ota_ft_sem);
+        if (k_sem_take(&edgehog_device->sync_ota_ft_sem, K_MSEC(100)) == 0) {
+            sem_taken = true;
+            break;
         }
     }
 
-    EDGEHOG_LOG_DBG("Exiting file transfer thread");
-}
-
-static edgehog_ft_filesystem_partition_t *duplicate_partitions(
-    edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len)
-{
-    edgehog_ft_filesystem_partition_t *dup = NULL;
-    if (!partitions || (partitions_len == 0)) {
-        goto error;
+    // If the service was stopped while waiting, clean up the popped message
+    if (!sem_taken) {
+        edgehog_ft_msg_destroy(msg);
+        return;
     }
 
-    // Initialize the array of partition structures
-    dup = k_calloc(partitions_len, sizeof(edgehog_ft_filesystem_partition_t));
-    if (!dup) {
-        EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
-        goto error;
+    // Proceed with the transfer since we hold the semaphore
+    char id_str[UUID_STR_LEN] = { 0 };
+    uuid_to_string(&msg->id, id_str);
+    if (msg->type == EDGEHOG_FT_TYPE_SERVER_TO_DEVICE) {
+        EDGEHOG_LOG_DBG("Server to device file transfer: %s", id_str);
+        edgehog_ft_handle_server_to_device(edgehog_device, msg);
+    } else if (msg->type == EDGEHOG_FT_TYPE_DEVICE_TO_SERVER) {
+        EDGEHOG_LOG_DBG("Device to server file transfer: %s", id_str);
+        edgehog_ft_handle_device_to_server(edgehog_device, msg);
     }
 
-    // Initialize each partition structure in the array
-    for (size_t i = 0; i < partitions_len; i++) {
-        // Deep copy the partition name string
-        size_t mount_point_size = strlen(partitions[i].mount_point) + 1;
-        char *mount_point = k_malloc(mount_point_size);
-        if (!mount_point) {
-            EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
-            goto error;
-        }
-        dup[i].mount_point = memcpy(mount_point, partitions[i].mount_point, mount_point_size);
-        dup[i].permissions = partitions[i].permissions;
-    }
+    k_sem_give(&edgehog_device->sync_ota_ft_sem);
+}
 
-    return dup;
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
 
-error:
-    if (dup) {
-        for (size_t i = 0; dup[i].mount_point; i++) {
-            k_free((void *) dup[i].mount_point);
-        }
+static void lane_work_handler(struct k_work *work)
+{
+    edgehog_ft_lane_work_t *lane_work = CONTAINER_OF(work, edgehog_ft_lane_work_t, work);
+    edgehog_device_handle_t edgehog_device = lane_work->device;
+    edgehog_ft_t *file_transfer = edgehog_device->file_transfer;
+    struct k_msgq *msgq = &file_transfer->msgq[lane_work->lane];
+
+    // Drain every request queued on the lane, one transfer at a time
+    edgehog_ft_msg_t msg_rcv = { 0 };
+    while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)
+        && (k_msgq_get(msgq, &msg_rcv, K_NO_WAIT) == 0)) {
+        process_transfer_msg(edgehog_device, &msg_rcv);
     }
-    k_free(dup);
-    return NULL;
 }
 
-static void free_partitions(edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len)
+#else
+
+static void thread_entry_point(void *device_ptr, void *lane_ptr, void *unused)
 {
-    if (!partitions) {
-        return;
-    }
+    EDGEHOG_LOG_DBG("File transfer thread entry point.");
+    ARG_UNUSED(unused);
+
+    edgehog_device_handle_t edgehog_device = (edgehog_device_handle_t) device_ptr;
+    edgehog_ft_t *file_transfer = edgehog_device->file_transfer;
+    struct k_msgq *msgq = &file_transfer->msgq[POINTER_TO_INT(lane_ptr)];
 
-    for (size_t i = 0; i < partitions_len; i++) {
-        k_free((void *) partitions[i].mount_point);
+    edgehog_ft_msg_t msg_rcv = { 0 };
+    while (atomic_test_bit(&file_transfer->thread_state, THREAD_RUNNING_BIT)) {
+        if (k_msgq_get(msgq, &msg_rcv, K_MSEC(100)) == 0) {
+            process_transfer_msg(edgehog_device, &msg_rcv);
+        }
     }
-    k_free(partitions);
+
+    EDGEHOG_LOG_DBG("Exiting file transfer thread");
 }
+
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+
@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <zephyr/kernel.h>
+
 EDGEHOG_LOG_MODULE_REGISTER(
     decompression, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DECOMPRESSION_LOG_LEVEL);
 
@@ -20,6 +22,14 @@ EDGEHOG_LOG_MODULE_REGISTER(
 
 #define DECOMP_BUF_SIZE 4096
 
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/** @brief Dedicated static pool for the decompression buffers, kept away from the libc heap so
+ * long-running deployments can't fragment it mid-transfer. */
+K_HEAP_DEFINE(decomp_buf_pool, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DECOMPRESSION_POOL_SIZE);
+/** @brief Bytes currently allocated from the decompression buffer pool. */
+static atomic_t decomp_pool_used;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /************************************************
  *         Global functions definition          *
  ***********************************************/
@@ -39,11 +49,12 @@ int file_transfer_decompression_init(file_transfer_decompression_ctx_t *ctx,
     LZ4F_dctx *lz4_dctx = NULL;
     uint8_t *decomp_buf = NULL;
 
-    decomp_buf = malloc(DECOMP_BUF_SIZE);
+    decomp_buf = k_heap_alloc(&decomp_buf_pool, DECOMP_BUF_SIZE, K_NO_WAIT);
     if (!decomp_buf) {
-        EDGEHOG_LOG_ERR("Failed to allocate decompression buffer");
+        EDGEHOG_LOG_ERR("Failed to allocate decompression buffer from the static pool");
         goto failure;
     }
+    atomic_add(&decomp_pool_used, DECOMP_BUF_SIZE);
 
     size_t ret = LZ4F_createDecompressionContext(&lz4_dctx, LZ4F_VERSION);
     if (LZ4F_isError(ret)) {
@@ -58,7 +69,10 @@ int file_transfer_decompression_init(file_transfer_decompression_ctx_t *ctx,
     return 0;
 
 failure:
-    free(decomp_buf);
+    if (decomp_buf) {
+        k_heap_free(&decomp_buf_pool, decomp_buf);
+        atomic_sub(&decomp_pool_used, DECOMP_BUF_SIZE);
+    }
     if (lz4_dctx) {
         LZ4F_freeDecompressionContext(lz4_dctx);
     }
@@ -118,11 +132,19 @@ void file_transfer_decompression_free(file_transfer_decompression_ctx_t *ctx)
 {
     if (ctx) {
         EDGEHOG_LOG_DBG("Freeing decompression context");
-        free(ctx->decomp_buf);
-        ctx->decomp_buf = NULL;
+        if (ctx->decomp_buf) {
+            k_heap_free(&decomp_buf_pool, ctx->decomp_buf);
+            atomic_sub(&decomp_pool_used, DECOMP_BUF_SIZE);
+            ctx->decomp_buf = NULL;
+        }
         if (ctx->lz4_dctx) {
             LZ4F_freeDecompressionContext(ctx->lz4_dctx);
             ctx->lz4_dctx = NULL;
         }
     }
 }
+
+size_t file_transfer_decompression_pool_usage(void)
+{
+    return (size_t) atomic_get(&decomp_pool_used);
+}
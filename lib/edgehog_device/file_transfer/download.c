@@ -10,14 +10,36 @@
 #include "file_transfer/core.h"
 #include "file_transfer/decompression.h"
 #include "file_transfer/filesystem.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION
+#include "file_transfer/partition.h"
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+#include "file_transfer/checkpoint.h"
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENTED
+#include "file_transfer/segmented.h"
+#endif
 #include "file_transfer/stream.h"
 #include "file_transfer/utils.h"
 #include "http.h"
 #include "log.h"
+#include "sdk_event.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+#include "thread_placement.h"
+#endif
+#include "trace.h"
 
 #include <psa/crypto.h>
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+#include <zephyr/net/http/status.h>
+#endif
 #include <zephyr/sys/util.h>
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+#include <zephyr/crypto/crypto.h>
+#include <zephyr/devicetree.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,6 +55,58 @@ EDGEHOG_LOG_MODULE_REGISTER(file_transfer_download, CONFIG_EDGEHOG_DEVICE_FILE_T
 #define SHA256_BYTES_LEN 32
 #define SHA256_HEX_STR_LEN (SHA256_BYTES_LEN * 2)
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+/** @brief Devicetree alias for the hardware hash engine. */
+#define EDGEHOG_FT_HASH_NODE DT_ALIAS(edgehog_hash)
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+/** @brief Buffer size for the formatted Range header of a resumed download. */
+#define RESUME_RANGE_HEADER_BUF_SIZE 48
+/** @brief Maximum request header fields a resumed download may carry, Range and NULL included. */
+#define RESUME_MAX_HEADER_FIELDS 16
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+// Stack size for the digest pipeline worker thread
+#define DIGEST_PIPELINE_STACK_SIZE 2048
+// Priority for the digest pipeline worker thread, same as the file transfer thread
+#ifdef CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT
+#define DIGEST_PIPELINE_THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_PRIORITY
+#else
+#define DIGEST_PIPELINE_THREAD_PRIORITY 5
+#endif
+// CPU mask for the digest pipeline worker thread, same as the file transfer thread
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_CPU_MASK
+#define DIGEST_PIPELINE_CPU_MASK CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_CPU_MASK
+#else
+#define DIGEST_PIPELINE_CPU_MASK 0
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/** @brief Worker thread hashing a chunk while the same buffer is written to storage. A single
+ * set of state is sufficient since downloads are serialized on the file transfer thread. */
+static struct k_thread digest_pipeline_thread;
+K_THREAD_STACK_DEFINE(digest_pipeline_stack, DIGEST_PIPELINE_STACK_SIZE);
+/** @brief Given by the consumer when a chunk is ready to hash. */
+static struct k_sem digest_pipeline_req_sem;
+/** @brief Given by the worker when the submitted chunk has been hashed. */
+static struct k_sem digest_pipeline_done_sem;
+/** @brief HTTP callback data of the transfer owning the submitted chunk. */
+static edgehog_ft_http_cbk_data_t *digest_pipeline_data;
+/** @brief Start of the submitted chunk. */
+static const uint8_t *digest_pipeline_buf;
+/** @brief Length of the submitted chunk. */
+static size_t digest_pipeline_len;
+/** @brief Result of the last digest update run by the worker. */
+static edgehog_result_t digest_pipeline_result;
+/** @brief Set to make the worker exit at the next request hand-off. */
+static atomic_t digest_pipeline_exit;
+/** @brief Tracks if the pipeline worker is currently running. */
+static bool digest_pipeline_started;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
@@ -47,10 +121,26 @@ static edgehog_result_t process_tar_chunk(
 #endif
 static edgehog_result_t process_uncompressed_chunk(
     edgehog_ft_http_cbk_data_t *data, const edgehog_http_response_chunk_t *response_chunk);
+static edgehog_result_t process_response_chunk(
+    edgehog_ft_http_cbk_data_t *data, edgehog_http_response_chunk_t *response_chunk);
 static const edgehog_ft_file_write_cbks_t *get_callbacks(
     enum edgehog_ft_location_type destination_type);
 static edgehog_result_t setup_digest(edgehog_ft_http_cbk_data_t *data);
+static edgehog_result_t digest_update(
+    edgehog_ft_http_cbk_data_t *data, const uint8_t *buf, size_t len);
 static int verify_digest(edgehog_ft_http_cbk_data_t *data, const char *expected_digest);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+static edgehog_result_t resume_restart_from_scratch(
+    const edgehog_ft_msg_t *msg, edgehog_ft_http_cbk_data_t *data);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+static void digest_pipeline_start(void);
+static void digest_pipeline_stop(void);
+static void digest_pipeline_submit(
+    edgehog_ft_http_cbk_data_t *data, const uint8_t *buf, size_t len);
+static edgehog_result_t digest_pipeline_join(void);
+static void digest_pipeline_worker(void *unused1, void *unused2, void *unused3);
+#endif
 
 /************************************************
  *     Callbacks definition and declaration     *
@@ -143,29 +233,50 @@ static edgehog_result_t http_get_server_to_device_request_cbk(
     EDGEHOG_LOG_HEXDUMP_DBG(response_chunk->chunk_start_addr, response_chunk->chunk_size,
         "[server-to-device] raw chunk data");
 
+    EDGEHOG_TRACE(EDGEHOG_TRACE_FT_CHUNK);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    if (data->ckpt_resumed && (response_chunk->status_code != HTTP_206_PARTIAL_CONTENT)) {
+        // The body is the full file and can't be appended to the already stored prefix
+        EDGEHOG_LOG_WRN("Server ignored the Range header, restarting the transfer from scratch");
+        data->ckpt_range_ignored = true;
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+    bool digest_pipelined = false;
+#endif
     if (data->expected_digest && response_chunk->chunk_size > 0) {
-        psa_status_t status = psa_hash_update(
-            &data->hash_operation, response_chunk->chunk_start_addr, response_chunk->chunk_size);
-        if (status != PSA_SUCCESS) {
-            data->posix_errno = EIO;
-            data->message = "Failed to update file digest";
-            return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+        EDGEHOG_TRACE(EDGEHOG_TRACE_FT_DIGEST_UPDATE);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+        // Hand the chunk to the digest stage, it is hashed while the same buffer is
+        // decompressed and written to storage below. Both stages only read the chunk.
+        digest_pipeline_submit(
+            data, response_chunk->chunk_start_addr, response_chunk->chunk_size);
+        digest_pipelined = true;
+#else
+        edgehog_result_t dres = digest_update(
+            data, response_chunk->chunk_start_addr, response_chunk->chunk_size);
+        if (dres != EDGEHOG_RESULT_OK) {
+            return dres;
         }
+#endif
     }
 
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
-    if (data->encoding == EDGEHOG_FT_ENCODING_LZ4) {
-        return process_compressed_chunk(data, response_chunk);
-    }
-#endif
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
-    if (data->encoding == EDGEHOG_FT_ENCODING_TAR) {
-        return process_tar_chunk(data, response_chunk);
+    edgehog_result_t eres = process_response_chunk(data, response_chunk);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+    // Rendezvous with the digest stage before the HTTP layer reuses the response buffer
+    if (digest_pipelined) {
+        edgehog_result_t dres = digest_pipeline_join();
+        if (dres != EDGEHOG_RESULT_OK) {
+            return dres;
+        }
     }
 #endif
 
-    // Fallthrough for uncompressed, or if compression is disabled
-    return process_uncompressed_chunk(data, response_chunk);
+    return eres;
 }
 
 /************************************************
@@ -226,6 +337,9 @@ void edgehog_ft_handle_server_to_device(
     http_cbk_user_data->message = message;
     http_cbk_user_data->expected_digest = msg->digest;
 
+    sdk_event_publish(
+        EDGEHOG_SDK_TRANSFER_STARTED_EVENT, EDGEHOG_RESULT_OK, (size_t) msg->file_size_bytes);
+
     if (setup_digest(http_cbk_user_data) != EDGEHOG_RESULT_OK) {
         posix_errno = EIO;
         message = "Failed to initialize crypto subsystem";
@@ -234,21 +348,127 @@ void edgehog_ft_handle_server_to_device(
     }
     digest_active = true;
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+    if (msg->digest) {
+        digest_pipeline_start();
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    size_t resume_offset = 0;
+    char range_header[RESUME_RANGE_HEADER_BUF_SIZE] = { 0 };
+    const char *resume_headers[RESUME_MAX_HEADER_FIELDS] = { 0 };
+    size_t header_count = 0;
+    while (msg->http_headers && msg->http_headers[header_count]) {
+        header_count++;
+    }
+    // Only an unencoded filesystem download can be resumed: encoded transfers carry decoder
+    // state that cannot be checkpointed, and the stored prefix must be re-hashable from disk
+    if ((msg->encoding == EDGEHOG_FT_ENCODING_NONE)
+        && (msg->location_type == EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM) && file_cbks->file_resume
+        && (header_count + 2 <= RESUME_MAX_HEADER_FIELDS)) {
+        edgehog_ft_checkpoint_resume_offset(msg, &resume_offset);
+        if (resume_offset > 0) {
+            eres = file_cbks->file_resume(file_cbks_ctx, resume_offset);
+            if ((eres == EDGEHOG_RESULT_OK) && msg->digest) {
+                // Feed the stored prefix back into the streaming digest, the hash context
+                // itself cannot be serialized across reboots
+                eres = edgehog_ft_checkpoint_rehash(
+                    msg->location, resume_offset, digest_update, http_cbk_user_data);
+            }
+            int ret = snprintf(
+                range_header, sizeof(range_header), "Range: bytes=%zu-\r\n", resume_offset);
+            if ((eres != EDGEHOG_RESULT_OK) || (ret < 0) || (ret >= sizeof(range_header))) {
+                posix_errno = EIO;
+                message = "Failed to resume checkpointed file transfer";
+                file_cbks->file_abort(file_cbks_ctx);
+                goto exit;
+            }
+            for (size_t i = 0; i < header_count; i++) {
+                resume_headers[i] = msg->http_headers[i];
+            }
+            resume_headers[header_count] = range_header;
+            http_cbk_user_data->transferred_bytes = resume_offset;
+            http_cbk_user_data->ckpt_resumed = true;
+            EDGEHOG_LOG_INF("Resuming file transfer from checkpointed offset %zu", resume_offset);
+        }
+        edgehog_ft_checkpoint_begin(http_cbk_user_data, msg, resume_offset);
+    }
+#endif
+
     // Initialize the HTTP get msg
     edgehog_http_get_data_t http_get_data = {
         .url = msg->url,
         .header_fields = (const char **) msg->http_headers,
         .timeout_ms = EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS,
+        .profile = EDGEHOG_HTTP_PROFILE_BULK,
         .response_cbk = http_get_server_to_device_request_cbk,
         .user_data = http_cbk_user_data,
     };
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    if (resume_offset > 0) {
+        http_get_data.header_fields = resume_headers;
+    }
+#endif
     // Perform the HTTP get request to fetch the file
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENTED
+    bool segmented
+        = (msg->file_size_bytes >= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENTED_MIN_FILE_SIZE);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    // A resumed download already pins its own Range header, keep it on a single stream
+    if (resume_offset > 0) {
+        segmented = false;
+    }
+#endif
+    if (segmented) {
+        edgehog_ft_segmented_params_t segmented_params = {
+            .url = msg->url,
+            .header_fields = (const char **) msg->http_headers,
+            .file_size = (size_t) msg->file_size_bytes,
+            .response_cbk = http_get_server_to_device_request_cbk,
+            .user_data = http_cbk_user_data,
+        };
+        bool range_unsupported = false;
+        eres = edgehog_ft_segmented_download(&segmented_params, &range_unsupported);
+        if (range_unsupported) {
+            EDGEHOG_LOG_WRN("Server does not support range requests, using a single stream");
+            segmented = false;
+        }
+    }
+    if (!segmented) {
+        eres = edgehog_http_get(&http_get_data);
+    }
+#else
     eres = edgehog_http_get(&http_get_data);
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    if ((eres != EDGEHOG_RESULT_OK) && http_cbk_user_data->ckpt_range_ignored) {
+        // The server sent the whole body instead of honouring the Range header, drop the
+        // stored prefix and take the transfer from byte zero on a plain request
+        eres = resume_restart_from_scratch(msg, http_cbk_user_data);
+        if (eres != EDGEHOG_RESULT_OK) {
+            posix_errno = EIO;
+            message = "Failed to restart a resumed file transfer";
+            edgehog_ft_checkpoint_clear(http_cbk_user_data);
+            file_cbks->file_abort(file_cbks_ctx);
+            goto exit;
+        }
+        http_get_data.header_fields = (const char **) msg->http_headers;
+        eres = edgehog_http_get(&http_get_data);
+    }
+#endif
     if (eres != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("File transfer HTTP get failure: %d.", eres);
         posix_errno = http_cbk_user_data->posix_errno;
         message = http_cbk_user_data->message;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+        // Keep the partial file and its checkpoint, a retried request can pick them up
+        if (http_cbk_user_data->ckpt_active && file_cbks->file_park) {
+            file_cbks->file_park(file_cbks_ctx);
+            goto exit;
+        }
+#endif
         file_cbks->file_abort(file_cbks_ctx);
         goto exit;
     }
@@ -260,6 +480,9 @@ void edgehog_ft_handle_server_to_device(
             posix_errno = verify_res;
             message = (verify_res == EINVAL) ? "File digest mismatch"
                                              : "Failed to finalize file digest";
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+            edgehog_ft_checkpoint_clear(http_cbk_user_data);
+#endif
             file_cbks->file_abort(file_cbks_ctx);
             goto exit;
         }
@@ -270,15 +493,37 @@ void edgehog_ft_handle_server_to_device(
     if (eres != EDGEHOG_RESULT_OK) {
         posix_errno = EIO;
         message = "Failed to finalize file transfer";
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+        edgehog_ft_checkpoint_clear(http_cbk_user_data);
+#endif
         file_cbks->file_abort(file_cbks_ctx);
         goto exit;
     }
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    edgehog_ft_checkpoint_clear(http_cbk_user_data);
+#endif
 
 exit:
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+    digest_pipeline_stop();
+#endif
     if (http_cbk_user_data && msg->digest && posix_errno != 0 && digest_active) {
-        psa_hash_abort(&http_cbk_user_data->hash_operation);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+        if (http_cbk_user_data->hw_digest) {
+            hash_free_session(
+                http_cbk_user_data->hw_hash_ctx.device, &http_cbk_user_data->hw_hash_ctx);
+        } else
+#endif
+        {
+            psa_hash_abort(&http_cbk_user_data->hash_operation);
+        }
     }
 
+    sdk_event_publish(((posix_errno == 0) && (eres == EDGEHOG_RESULT_OK))
+            ? EDGEHOG_SDK_TRANSFER_COMPLETED_EVENT
+            : EDGEHOG_SDK_TRANSFER_FAILED_EVENT,
+        eres, http_cbk_user_data ? http_cbk_user_data->transferred_bytes : 0);
+
     edgehog_ft_http_cbk_data_destroy(http_cbk_user_data);
     edgehog_ft_send_response(
         edgehog_device, &msg->id, EDGEHOG_FT_TYPE_SERVER_TO_DEVICE, posix_errno, message, eres);
@@ -390,17 +635,56 @@ static edgehog_result_t process_uncompressed_chunk(
         return eres;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    edgehog_ft_checkpoint_note(data, response_chunk->chunk_size);
+#endif
+
     edgehog_ft_update_progress(data, response_chunk->chunk_size, response_chunk->last_chunk);
 
     return EDGEHOG_RESULT_OK;
 }
 
+static edgehog_result_t process_response_chunk(
+    edgehog_ft_http_cbk_data_t *data, edgehog_http_response_chunk_t *response_chunk)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+    if (data->encoding == EDGEHOG_FT_ENCODING_LZ4) {
+        return process_compressed_chunk(data, response_chunk);
+    }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
+    if (data->encoding == EDGEHOG_FT_ENCODING_TAR) {
+        return process_tar_chunk(data, response_chunk);
+    }
+#endif
+
+    // Fallthrough for uncompressed, or if compression is disabled
+    return process_uncompressed_chunk(data, response_chunk);
+}
+
 static edgehog_result_t setup_digest(edgehog_ft_http_cbk_data_t *data)
 {
     if (!data->expected_digest) {
         return EDGEHOG_RESULT_OK;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+    data->hw_digest = false;
+#if DT_NODE_EXISTS(EDGEHOG_FT_HASH_NODE)
+    const struct device *hash_dev = DEVICE_DT_GET(EDGEHOG_FT_HASH_NODE);
+    if (device_is_ready(hash_dev)) {
+        memset(&data->hw_hash_ctx, 0, sizeof(data->hw_hash_ctx));
+        data->hw_hash_ctx.flags = CAP_SYNC_OPS | CAP_SEPARATE_IO_BUFS;
+        int ret = hash_begin_session(hash_dev, &data->hw_hash_ctx, CRYPTO_HASH_ALGO_SHA256);
+        if (ret == 0) {
+            data->hw_digest = true;
+            return EDGEHOG_RESULT_OK;
+        }
+        EDGEHOG_LOG_WRN("Hardware hash session setup failed: %d, using the software hash", ret);
+    }
+#endif
+#endif
+
     // initialize PSA
     psa_status_t status = psa_crypto_init();
     if (status != PSA_SUCCESS) {
@@ -417,6 +701,94 @@ static edgehog_result_t setup_digest(edgehog_ft_http_cbk_data_t *data)
     return EDGEHOG_RESULT_OK;
 }
 
+static edgehog_result_t digest_update(
+    edgehog_ft_http_cbk_data_t *data, const uint8_t *buf, size_t len)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+    if (data->hw_digest) {
+        struct hash_pkt pkt = {
+            .in_buf = (uint8_t *) buf,
+            .in_len = len,
+        };
+        if (hash_update(&data->hw_hash_ctx, &pkt) != 0) {
+            data->posix_errno = EIO;
+            data->message = "Failed to update file digest";
+            return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+        }
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
+    psa_status_t status = psa_hash_update(&data->hash_operation, buf, len);
+    if (status != PSA_SUCCESS) {
+        data->posix_errno = EIO;
+        data->message = "Failed to update file digest";
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+    return EDGEHOG_RESULT_OK;
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_DIGEST_PIPELINE
+static void digest_pipeline_start(void)
+{
+    k_sem_init(&digest_pipeline_req_sem, 0, 1);
+    k_sem_init(&digest_pipeline_done_sem, 0, 1);
+    atomic_clear(&digest_pipeline_exit);
+
+    k_thread_create(&digest_pipeline_thread, digest_pipeline_stack, DIGEST_PIPELINE_STACK_SIZE,
+        digest_pipeline_worker, NULL, NULL, NULL, DIGEST_PIPELINE_THREAD_PRIORITY, 0,
+        EDGEHOG_THREAD_START_DELAY);
+    k_thread_name_set(&digest_pipeline_thread, "edgehog_ft_hash");
+    edgehog_thread_placement_start(&digest_pipeline_thread, DIGEST_PIPELINE_CPU_MASK);
+
+    digest_pipeline_started = true;
+}
+
+static void digest_pipeline_stop(void)
+{
+    if (!digest_pipeline_started) {
+        return;
+    }
+
+    // No chunk is in flight here, every submit is joined before the HTTP callback returns
+    atomic_set(&digest_pipeline_exit, 1);
+    k_sem_give(&digest_pipeline_req_sem);
+    k_thread_join(&digest_pipeline_thread, K_FOREVER);
+    digest_pipeline_started = false;
+}
+
+static void digest_pipeline_submit(edgehog_ft_http_cbk_data_t *data, const uint8_t *buf, size_t len)
+{
+    digest_pipeline_data = data;
+    digest_pipeline_buf = buf;
+    digest_pipeline_len = len;
+    k_sem_give(&digest_pipeline_req_sem);
+}
+
+static edgehog_result_t digest_pipeline_join(void)
+{
+    k_sem_take(&digest_pipeline_done_sem, K_FOREVER);
+    return digest_pipeline_result;
+}
+
+static void digest_pipeline_worker(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    while (true) {
+        k_sem_take(&digest_pipeline_req_sem, K_FOREVER);
+        if (atomic_get(&digest_pipeline_exit) != 0) {
+            return;
+        }
+        digest_pipeline_result
+            = digest_update(digest_pipeline_data, digest_pipeline_buf, digest_pipeline_len);
+        k_sem_give(&digest_pipeline_done_sem);
+    }
+}
+#endif
+
 static int verify_digest(edgehog_ft_http_cbk_data_t *data, const char *expected_digest)
 {
     // Verify the expected_digest has the correct prefix and length
@@ -440,6 +812,25 @@ static int verify_digest(edgehog_ft_http_cbk_data_t *data, const char *expected_
         return EINVAL;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+    if (data->hw_digest) {
+        uint8_t computed_hash[SHA256_BYTES_LEN] = { 0 };
+        struct hash_pkt pkt = { .in_buf = NULL, .in_len = 0, .out_buf = computed_hash };
+        int hres = hash_compute(&data->hw_hash_ctx, &pkt);
+        hash_free_session(data->hw_hash_ctx.device, &data->hw_hash_ctx);
+        data->hw_digest = false;
+        if (hres != 0) {
+            EDGEHOG_LOG_ERR("Hardware hash finalization failed: %d", hres);
+            return EIO;
+        }
+        if (memcmp(computed_hash, expected_hash_bytes, sizeof(expected_hash_bytes)) != 0) {
+            EDGEHOG_LOG_ERR("Digest mismatch.");
+            return EINVAL;
+        }
+        return 0;
+    }
+#endif
+
     // Let the PSA cryptography API securely verify the digest
     psa_status_t status
         = psa_hash_verify(&data->hash_operation, expected_hash_bytes, sizeof(expected_hash_bytes));
@@ -462,5 +853,59 @@ const edgehog_ft_file_write_cbks_t *get_callbacks(enum edgehog_ft_location_type
     } else if (destination_type == EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM) {
         file_cbks = &edgehog_ft_filesystem_write_cbks;
     }
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION
+    else if (destination_type == EDGEHOG_FT_LOCATION_TYPE_PARTITION) {
+        file_cbks = &edgehog_ft_partition_write_cbks;
+    }
+#endif
     return file_cbks;
 }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+/**
+ * @brief Rewind a resumed transfer to byte zero after the server ignored the Range header.
+ *
+ * @details Truncates the stored partial file, restarts the streaming digest that already
+ * covered the re-hashed prefix, and re-claims the checkpoint slot from offset zero so the
+ * follow-up plain request starts from a clean state.
+ *
+ * @param[in] msg The transfer request being served.
+ * @param[in,out] data The HTTP callback data of the transfer to rewind.
+ * @return EDGEHOG_RESULT_OK on success, otherwise an error code.
+ */
+static edgehog_result_t resume_restart_from_scratch(
+    const edgehog_ft_msg_t *msg, edgehog_ft_http_cbk_data_t *data)
+{
+    const edgehog_ft_file_write_cbks_t *file_cbks
+        = (const edgehog_ft_file_write_cbks_t *) data->file_cbks;
+
+    data->ckpt_range_ignored = false;
+    data->ckpt_resumed = false;
+
+    // Drop the stored prefix, the server is going to send the whole body again
+    edgehog_result_t eres = file_cbks->file_resume(data->file_cbks_ctx, 0);
+    if (eres != EDGEHOG_RESULT_OK) {
+        return eres;
+    }
+
+    // The digest accumulated over the re-hashed prefix no longer matches the stream
+    if (data->expected_digest) {
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+        if (data->hw_digest) {
+            hash_free_session(data->hw_hash_ctx.device, &data->hw_hash_ctx);
+        } else
+#endif
+        {
+            psa_hash_abort(&data->hash_operation);
+        }
+        eres = setup_digest(data);
+        if (eres != EDGEHOG_RESULT_OK) {
+            return eres;
+        }
+    }
+
+    data->transferred_bytes = 0;
+    edgehog_ft_checkpoint_begin(data, msg, 0);
+    return EDGEHOG_RESULT_OK;
+}
+#endif
@@ -8,6 +8,7 @@
 
 #include "edgehog_device/file_transfer.h"
 #include "file_transfer/filesystem_utils.h"
+#include "heap.h"
 
 #include <limits.h>
 #include <stdlib.h>
@@ -17,6 +18,7 @@
 #include <zephyr/kernel.h>
 
 #include "file_transfer/core.h"
+#include "file_transfer/utils.h"
 #include "log.h"
 
 EDGEHOG_LOG_MODULE_REGISTER(
@@ -31,8 +33,25 @@ EDGEHOG_LOG_MODULE_REGISTER(
 /* Maximum path length, necessary to avoid large memory allocations from very long paths. */
 /* Includes the NULL terminator */
 #define MAX_PATH_SIZE 256
-/* Buffer for reading chunks of a file */
-#define FS_READ_BUFFER_SIZE 4096
+/* Write-behind buffer, flushed to the filesystem only when full or at end of file */
+#define FS_WRITE_BUFFER_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_WRITE_BUFFER_SIZE
+/* Batched sync policy: commit to stable storage every so many bytes or milliseconds, 0 disables */
+#define FS_SYNC_BYTES CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_SYNC_BYTES
+#define FS_SYNC_INTERVAL_MS CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_SYNC_INTERVAL_MS
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE
+/** @brief Aggregate roughly this many milliseconds of arriving data per filesystem write. */
+#define FS_ADAPTIVE_WINDOW_MS CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE_WINDOW_MS
+/** @brief Lower clamp for the adaptive flush threshold, writes never get smaller than this. */
+#define FS_ADAPTIVE_MIN_WRITE 512
+/** @brief EMA weight denominator, a new sample contributes one part in this many. */
+#define FS_ADAPTIVE_EMA_WEIGHT 4
+/** @brief Arrival throughput is sampled over periods of at least this many milliseconds. */
+#define FS_ADAPTIVE_SAMPLE_MS 500
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+/* Read-ahead buffer, prefetched on the system workqueue while the previous block is consumed */
+#define FS_READ_AHEAD_BUFFER_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD_BUFFER_SIZE
+#endif
 
 /** @brief Context structure for write operations. */
 typedef struct
@@ -47,6 +66,24 @@ typedef struct
     bool is_tar;
     /** @brief Tracks if a file is currently open inside the context. */
     bool file_open;
+    /** @brief Write-behind buffer, coalesces small chunks into full-buffer writes. */
+    uint8_t wb_buf[FS_WRITE_BUFFER_SIZE] __aligned(sizeof(void *));
+    /** @brief Number of bytes currently pending in the write-behind buffer. */
+    size_t wb_len;
+    /** @brief Bytes written to the open file since the last sync to stable storage. */
+    size_t bytes_since_sync;
+    /** @brief Uptime of the last sync to stable storage, in milliseconds. */
+    uint32_t last_sync_ms;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE
+    /** @brief Flush threshold derived from the measured arrival throughput. */
+    size_t aw_threshold;
+    /** @brief Rolling arrival throughput in bytes per second, zero until the first sample. */
+    uint32_t aw_throughput;
+    /** @brief Bytes received since the current sample period started. */
+    size_t aw_sample_bytes;
+    /** @brief Uptime at which the current sample period started, in milliseconds. */
+    uint32_t aw_sample_start_ms;
+#endif
 } write_ctx_t;
 
 /** @brief Context structure for read operations. */
@@ -70,10 +107,32 @@ typedef struct
     const char *path;
     /** @brief Pointer to the file transfer callback structure. */
     edgehog_ft_cbks_t *cbks;
-    /** @brief Buffer used to hold the data chunks read from the file. */
-    uint8_t buffer[FS_READ_BUFFER_SIZE];
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+    /** @brief Read-ahead buffer, the next block is prefetched here while the previous one is
+     * consumed by compression or HTTP. */
+    uint8_t ra_buf[FS_READ_AHEAD_BUFFER_SIZE];
+    /** @brief Number of valid bytes in the read-ahead buffer. */
+    size_t ra_len;
+    /** @brief Consumer offset into the read-ahead buffer. */
+    size_t ra_off;
+    /** @brief Result of the last prefetch. */
+    edgehog_result_t ra_result;
+    /** @brief True when the prefetch reached the end of the open file. */
+    bool ra_eof;
+    /** @brief True while a prefetch work item is pending or running. */
+    bool ra_pending;
+    /** @brief Work item performing the prefetch on the system workqueue. */
+    struct k_work ra_work;
+    /** @brief Given by the work item when the prefetch completes. */
+    struct k_sem ra_done;
+#endif
 } read_ctx_t;
 
+BUILD_ASSERT(sizeof(write_ctx_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The filesystem write context doesn't fit a per-transfer context slab block");
+BUILD_ASSERT(sizeof(read_ctx_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The filesystem read context doesn't fit a per-transfer context slab block");
+
 typedef void (*fs_walk_cb_t)(const char *path, struct fs_dirent *entry, void *user_data);
 
 /************************************************
@@ -84,18 +143,31 @@ static edgehog_result_t write_init(
     void **ctx, edgehog_ft_cbks_t *cbks, size_t expected_file_size, char *destination, bool is_tar);
 static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name);
 static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_t chunk_size);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE
+static void write_adaptive_update(write_ctx_t *wctx, size_t chunk_size);
+#endif
+static edgehog_result_t write_flush(write_ctx_t *wctx);
 static edgehog_result_t write_complete(void *ctx);
 static void write_abort(void *ctx);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+static edgehog_result_t write_resume(void *ctx, size_t resume_offset);
+static void write_park(void *ctx);
+#endif
 
 static edgehog_result_t read_init(
     void **ctx, edgehog_ft_cbks_t *cbks, char *source, size_t *out_file_size, bool is_tar);
 static edgehog_result_t read_get_next_entry(
     void *ctx, char *file_name, size_t file_name_size, size_t *file_size, bool *has_next);
 static edgehog_result_t read_chunk(
-    void *ctx, size_t max_length, uint8_t **chunk_data, size_t *chunk_size, bool *last_chunk);
+    void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk);
 static edgehog_result_t read_complete(void *ctx);
 static void read_abort(void *ctx);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+static void read_ahead_start(read_ctx_t *rctx);
+static void read_ahead_finish(read_ctx_t *rctx);
+#endif
+
 static void tar_ascend_directory(read_ctx_t *rctx);
 static edgehog_result_t tar_build_entry_path(
     read_ctx_t *rctx, const char *entry_name, size_t *out_base_len);
@@ -114,6 +186,36 @@ void delete_files_callback(const char *path, struct fs_dirent *entry, void *user
     fs_unlink(path);
 }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+/**
+ * @brief Work handler prefetching the next block of the open file.
+ *
+ * @details Runs on the system workqueue while the file transfer thread compresses, packs or
+ * transmits the previously prefetched block, overlapping the filesystem read latency with the
+ * network transfer.
+ *
+ * @param[in] work Pointer to the work item embedded in the read context.
+ */
+static void read_ahead_work_handler(struct k_work *work)
+{
+    read_ctx_t *rctx = CONTAINER_OF(work, read_ctx_t, ra_work);
+
+    ssize_t res = fs_read(&rctx->file, rctx->ra_buf, sizeof(rctx->ra_buf));
+    if (res < 0) {
+        EDGEHOG_LOG_ERR("Failed to prefetch chunk from file, err %zd", res);
+        rctx->ra_result = EDGEHOG_RESULT_INTERNAL_ERROR;
+        rctx->ra_len = 0;
+        rctx->ra_eof = true;
+    } else {
+        rctx->ra_result = EDGEHOG_RESULT_OK;
+        rctx->ra_len = (size_t) res;
+        rctx->ra_eof = ((size_t) res < sizeof(rctx->ra_buf));
+    }
+
+    k_sem_give(&rctx->ra_done);
+}
+#endif
+
 /************************************************
  *         Global variables definitions         *
  ***********************************************/
@@ -122,7 +224,12 @@ const edgehog_ft_file_write_cbks_t edgehog_ft_filesystem_write_cbks = { .file_in
     .file_append_next_entry = write_append_next_entry,
     .file_append_chunk = write_append,
     .file_complete = write_complete,
-    .file_abort = write_abort };
+    .file_abort = write_abort,
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    .file_resume = write_resume,
+    .file_park = write_park,
+#endif
+};
 const edgehog_ft_file_read_cbks_t edgehog_ft_filesystem_read_cbks = { .file_init = read_init,
     .file_get_next_entry = read_get_next_entry,
     .file_read_chunk = read_chunk,
@@ -152,7 +259,7 @@ static edgehog_result_t write_init(
         goto error;
     }
 
-    wctx = k_malloc(sizeof(write_ctx_t));
+    wctx = edgehog_ft_ctx_alloc(sizeof(write_ctx_t));
     if (!wctx) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         eres = EDGEHOG_RESULT_OUT_OF_MEMORY;
@@ -164,6 +271,16 @@ static edgehog_result_t write_init(
     wctx->path = destination;
     wctx->is_tar = is_tar;
     wctx->file_open = false;
+    wctx->wb_len = 0;
+    wctx->bytes_since_sync = 0;
+    wctx->last_sync_ms = k_uptime_get_32();
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE
+    // Keep full-buffer writes until the first throughput sample is in
+    wctx->aw_threshold = FS_WRITE_BUFFER_SIZE;
+    wctx->aw_throughput = 0;
+    wctx->aw_sample_bytes = 0;
+    wctx->aw_sample_start_ms = k_uptime_get_32();
+#endif
 
     // Only open the file immediately if we are NOT extracting a TAR.
     // If it is a TAR, the files will be opened in write_append_next_entry.
@@ -185,7 +302,7 @@ static edgehog_result_t write_init(
     return EDGEHOG_RESULT_OK;
 
 error:
-    k_free(wctx);
+    edgehog_ft_ctx_free(wctx);
     return eres;
 }
 
@@ -201,8 +318,12 @@ static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name
         goto exit;
     }
 
-    // Close the previous file handled during the last TAR iteration
+    // Flush and close the previous file handled during the last TAR iteration
     if (wctx->file_open) {
+        eres = write_flush(wctx);
+        if (eres != EDGEHOG_RESULT_OK) {
+            goto exit;
+        }
         fs_close(&wctx->file);
         wctx->file_open = false;
     }
@@ -214,7 +335,7 @@ static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name
         goto exit;
     }
 
-    full_path = k_calloc(full_path_size, sizeof(char));
+    full_path = edgehog_calloc(full_path_size, sizeof(char));
     if (!full_path) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         eres = EDGEHOG_RESULT_OUT_OF_MEMORY;
@@ -243,27 +364,90 @@ static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name
         goto exit;
     }
     wctx->file_open = true;
+    wctx->bytes_since_sync = 0;
+    wctx->last_sync_ms = k_uptime_get_32();
 
     EDGEHOG_LOG_DBG("Appended a new entry to a TAR destionation.");
     EDGEHOG_LOG_DBG("Base path: %s, full file path: %s", wctx->path, full_path);
 
 exit:
-    k_free(full_path);
+    edgehog_free(full_path);
     return eres;
 }
 
 static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_t chunk_size)
 {
     write_ctx_t *wctx = (write_ctx_t *) ctx;
-    size_t total_written = 0;
+    size_t consumed = 0;
 
     if (!wctx->file_open) {
         EDGEHOG_LOG_ERR("Attempted to write chunk but no file is open");
         return EDGEHOG_RESULT_INTERNAL_ERROR;
     }
 
-    while (total_written < chunk_size) {
-        ssize_t res = fs_write(&wctx->file, chunk_data + total_written, chunk_size - total_written);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE
+    write_adaptive_update(wctx, chunk_size);
+    size_t flush_threshold = wctx->aw_threshold;
+#else
+    size_t flush_threshold = FS_WRITE_BUFFER_SIZE;
+#endif
+
+    // Accumulate into the write-behind buffer so the filesystem only sees full-threshold
+    // sequential writes, independently of the received chunk sizes.
+    while (consumed < chunk_size) {
+        size_t copy_size = MIN(FS_WRITE_BUFFER_SIZE - wctx->wb_len, chunk_size - consumed);
+        memcpy(&wctx->wb_buf[wctx->wb_len], chunk_data + consumed, copy_size);
+        wctx->wb_len += copy_size;
+        consumed += copy_size;
+
+        if (wctx->wb_len >= flush_threshold) {
+            edgehog_result_t eres = write_flush(wctx);
+            if (eres != EDGEHOG_RESULT_OK) {
+                return eres;
+            }
+        }
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_ADAPTIVE_WRITE
+static void write_adaptive_update(write_ctx_t *wctx, size_t chunk_size)
+{
+    uint32_t now_ms = k_uptime_get_32();
+
+    wctx->aw_sample_bytes += chunk_size;
+    uint32_t elapsed_ms = now_ms - wctx->aw_sample_start_ms;
+    if (elapsed_ms < FS_ADAPTIVE_SAMPLE_MS) {
+        return;
+    }
+
+    uint32_t sample = (uint32_t) ((wctx->aw_sample_bytes * MSEC_PER_SEC) / elapsed_ms);
+    if (wctx->aw_throughput == 0) {
+        wctx->aw_throughput = sample;
+    } else {
+        wctx->aw_throughput = ((wctx->aw_throughput * (FS_ADAPTIVE_EMA_WEIGHT - 1)) + sample)
+            / FS_ADAPTIVE_EMA_WEIGHT;
+    }
+    wctx->aw_sample_bytes = 0;
+    wctx->aw_sample_start_ms = now_ms;
+
+    // Flush once the buffer holds roughly FS_ADAPTIVE_WINDOW_MS worth of data at the measured
+    // rate: fast links keep full-buffer writes, slow links commit smaller aggregates instead
+    // of buffering many seconds of download before anything reaches the filesystem.
+    size_t threshold = ((size_t) wctx->aw_throughput * FS_ADAPTIVE_WINDOW_MS) / MSEC_PER_SEC;
+    wctx->aw_threshold
+        = CLAMP(threshold, (size_t) FS_ADAPTIVE_MIN_WRITE, (size_t) FS_WRITE_BUFFER_SIZE);
+}
+#endif
+
+static edgehog_result_t write_flush(write_ctx_t *wctx)
+{
+    size_t total_written = 0;
+
+    while (total_written < wctx->wb_len) {
+        ssize_t res
+            = fs_write(&wctx->file, &wctx->wb_buf[total_written], wctx->wb_len - total_written);
         if (res < 0) {
             EDGEHOG_LOG_ERR("Failed to append chunk to file, err %zd", res);
             return EDGEHOG_RESULT_INTERNAL_ERROR;
@@ -275,6 +459,26 @@ static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_
         total_written += (size_t) res;
     }
 
+    wctx->bytes_since_sync += wctx->wb_len;
+    wctx->wb_len = 0;
+
+    // Batched sync policy: commit to stable storage only every FS_SYNC_BYTES written or
+    // FS_SYNC_INTERVAL_MS elapsed, so large downloads aren't bounded by the filesystem commit
+    // frequency. Closing the file performs the final durable commit.
+    uint32_t now_ms = k_uptime_get_32();
+    bool sync_for_bytes = (FS_SYNC_BYTES > 0) && (wctx->bytes_since_sync >= FS_SYNC_BYTES);
+    bool sync_for_time
+        = (FS_SYNC_INTERVAL_MS > 0) && ((now_ms - wctx->last_sync_ms) >= FS_SYNC_INTERVAL_MS);
+    if (sync_for_bytes || sync_for_time) {
+        int res = fs_sync(&wctx->file);
+        if (res < 0) {
+            EDGEHOG_LOG_ERR("Failed to sync file to storage, err %d", res);
+            return EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+        wctx->bytes_since_sync = 0;
+        wctx->last_sync_ms = now_ms;
+    }
+
     return EDGEHOG_RESULT_OK;
 }
 
@@ -287,8 +491,13 @@ static edgehog_result_t write_complete(void *ctx)
     }
 
     if (wctx->file_open) {
+        edgehog_result_t eres = write_flush(wctx);
         fs_close(&wctx->file);
         wctx->file_open = false;
+        if (eres != EDGEHOG_RESULT_OK) {
+            edgehog_ft_ctx_free(ctx);
+            return eres;
+        }
     }
 
     EDGEHOG_LOG_DBG("File write has been completed.");
@@ -297,7 +506,7 @@ static edgehog_result_t write_complete(void *ctx)
         wctx->cbks->on_filesystem_transfer_done(EDGEHOG_FT_TYPE_SERVER_TO_DEVICE, wctx->path);
     }
 
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
     return EDGEHOG_RESULT_OK;
 }
 
@@ -332,9 +541,58 @@ static void write_abort(void *ctx)
 
     EDGEHOG_LOG_ERR("File write has been aborted.");
 
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+static edgehog_result_t write_resume(void *ctx, size_t resume_offset)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx || !wctx->file_open || wctx->is_tar) {
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    // Drop any stored bytes past the resume point, they are not covered by the checkpoint
+    int res = fs_truncate(&wctx->file, (off_t) resume_offset);
+    if (res == 0) {
+        res = fs_seek(&wctx->file, (off_t) resume_offset, FS_SEEK_SET);
+    }
+    if (res != 0) {
+        EDGEHOG_LOG_ERR("Failed to reposition file for resume, err %d", res);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    wctx->wb_len = 0;
+    wctx->bytes_since_sync = 0;
+    wctx->last_sync_ms = k_uptime_get_32();
+
+    EDGEHOG_LOG_DBG("Resuming file write at offset %zu.", resume_offset);
+    return EDGEHOG_RESULT_OK;
 }
 
+static void write_park(void *ctx)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx) {
+        return;
+    }
+
+    // Best effort: on restore the checkpoint offset is clamped to the durable file size anyway
+    if (wctx->file_open) {
+        (void) write_flush(wctx);
+        fs_sync(&wctx->file);
+        fs_close(&wctx->file);
+        wctx->file_open = false;
+    }
+
+    EDGEHOG_LOG_DBG("Parked partial file for a later resume.");
+
+    edgehog_ft_ctx_free(ctx);
+}
+#endif
+
 static edgehog_result_t read_init(
     void **ctx, edgehog_ft_cbks_t *cbks, char *source, size_t *out_file_size, bool is_tar)
 {
@@ -353,7 +611,7 @@ static edgehog_result_t read_init(
         goto error;
     }
 
-    rctx = k_malloc(sizeof(read_ctx_t));
+    rctx = edgehog_ft_ctx_alloc(sizeof(read_ctx_t));
     if (!rctx) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         return EDGEHOG_RESULT_OUT_OF_MEMORY;
@@ -363,6 +621,11 @@ static edgehog_result_t read_init(
     rctx->cbks = cbks;
     rctx->path = source;
     rctx->file_open = false;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+    k_work_init(&rctx->ra_work, read_ahead_work_handler);
+    k_sem_init(&rctx->ra_done, 0, 1);
+    rctx->ra_pending = false;
+#endif
 
     if (is_tar) {
         rctx->is_dir = true;
@@ -402,6 +665,9 @@ static edgehog_result_t read_init(
             goto error;
         }
         rctx->file_open = true;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+        read_ahead_start(rctx);
+#endif
     }
 
     EDGEHOG_LOG_DBG("Initialized a file transfer file system read context.");
@@ -411,7 +677,7 @@ static edgehog_result_t read_init(
     return EDGEHOG_RESULT_OK;
 
 error:
-    k_free(rctx);
+    edgehog_ft_ctx_free(rctx);
     return eres;
 }
 
@@ -428,6 +694,9 @@ static edgehog_result_t read_get_next_entry(
 
     // Close the previous file handled during the last TAR iteration
     if (rctx->file_open) {
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+        read_ahead_finish(rctx);
+#endif
         fs_close(&rctx->file);
         rctx->file_open = false;
     }
@@ -477,22 +746,48 @@ static edgehog_result_t read_get_next_entry(
 }
 
 static edgehog_result_t read_chunk(
-    void *ctx, size_t max_length, uint8_t **chunk_data, size_t *chunk_size, bool *last_chunk)
+    void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk)
 {
     read_ctx_t *rctx = (read_ctx_t *) ctx;
 
-    size_t bytes_to_read = MIN(FS_READ_BUFFER_SIZE, max_length);
-    ssize_t res = fs_read(&rctx->file, rctx->buffer, bytes_to_read);
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+    // Serve from the read-ahead buffer, the prefetch ran while the caller consumed the previous
+    // block. Requests larger than the buffer are served in buffer sized slices, the callers
+    // already handle short reads.
+    read_ahead_finish(rctx);
+    if (rctx->ra_result != EDGEHOG_RESULT_OK) {
+        return rctx->ra_result;
+    }
+
+    size_t available = rctx->ra_len - rctx->ra_off;
+    size_t out_size = MIN(available, max_length);
+    memcpy(buffer, &rctx->ra_buf[rctx->ra_off], out_size);
+    rctx->ra_off += out_size;
+
+    // Kick off the next prefetch as soon as the buffer is drained, it overlaps with the
+    // consumption of the bytes just handed out
+    bool drained = (rctx->ra_off == rctx->ra_len);
+    if (drained && !rctx->ra_eof) {
+        read_ahead_start(rctx);
+    }
+
+    *chunk_size = out_size;
+    *last_chunk = drained && rctx->ra_eof;
+
+    return EDGEHOG_RESULT_OK;
+#else
+    // Fill the caller provided buffer directly, no intermediate copy is required
+    ssize_t res = fs_read(&rctx->file, buffer, max_length);
     if (res < 0) {
         EDGEHOG_LOG_ERR("Failed to read chunk from file, err %zd", res);
         return EDGEHOG_RESULT_INTERNAL_ERROR;
     }
 
-    *chunk_data = rctx->buffer;
     *chunk_size = (size_t) res;
-    *last_chunk = (res < bytes_to_read);
+    *last_chunk = ((size_t) res < max_length);
 
     return EDGEHOG_RESULT_OK;
+#endif
 }
 
 static edgehog_result_t read_complete(void *ctx)
@@ -504,6 +799,9 @@ static edgehog_result_t read_complete(void *ctx)
     }
 
     if (rctx->file_open) {
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+        read_ahead_finish(rctx);
+#endif
         fs_close(&rctx->file);
     }
     if (rctx->is_dir) {
@@ -517,7 +815,7 @@ static edgehog_result_t read_complete(void *ctx)
         rctx->cbks->on_filesystem_transfer_done(EDGEHOG_FT_TYPE_DEVICE_TO_SERVER, rctx->path);
     }
 
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
     return EDGEHOG_RESULT_OK;
 }
 
@@ -530,6 +828,9 @@ static void read_abort(void *ctx)
     }
 
     if (rctx->file_open) {
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+        read_ahead_finish(rctx);
+#endif
         fs_close(&rctx->file);
     }
     if (rctx->is_dir) {
@@ -539,8 +840,39 @@ static void read_abort(void *ctx)
         }
     }
 
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+/**
+ * @brief Submit a prefetch of the next block of the open file.
+ *
+ * @param[in] rctx A valid read context with an open file.
+ */
+static void read_ahead_start(read_ctx_t *rctx)
+{
+    rctx->ra_len = 0;
+    rctx->ra_off = 0;
+    rctx->ra_pending = true;
+    k_work_submit(&rctx->ra_work);
+}
+
+/**
+ * @brief Wait for an in-flight prefetch to complete.
+ *
+ * @details Must be called before reading the prefetched block and before closing the file the
+ * work item reads from.
+ *
+ * @param[in] rctx A valid read context.
+ */
+static void read_ahead_finish(read_ctx_t *rctx)
+{
+    if (rctx->ra_pending) {
+        k_sem_take(&rctx->ra_done, K_FOREVER);
+        rctx->ra_pending = false;
+    }
 }
+#endif
 
 static void tar_ascend_directory(read_ctx_t *rctx)
 {
@@ -610,6 +942,9 @@ static edgehog_result_t tar_handle_file_entry(
     }
 
     rctx->file_open = true;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_FS_READ_AHEAD
+    read_ahead_start(rctx);
+#endif
     strncpy(file_name, rel_path, file_name_size - 1);
     file_name[file_name_size - 1] = '\0';
 
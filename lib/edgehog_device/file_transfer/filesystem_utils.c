@@ -14,6 +14,8 @@
 #include <zephyr/fs/fs.h>
 
 #define MAX_PATH_SIZE 256
+/* Maximum directory depth for the iterative filesystem walk */
+#define FS_WALK_MAX_DEPTH 10
 
 EDGEHOG_LOG_MODULE_REGISTER(
     file_transfer_filesystem_utils, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_LOG_LEVEL);
@@ -23,11 +25,22 @@ EDGEHOG_LOG_MODULE_REGISTER(
  ***********************************************/
 
 static bool is_dir_empty(const char *destination);
-static int walk_recursive(char path[static MAX_PATH_SIZE], fs_walk_cb_t cbk, void *user_data);
+static int walk_pop(char path[static MAX_PATH_SIZE], struct fs_dir_t *dirs,
+    const size_t *path_lens, int depth, fs_walk_cb_t cbk, void *user_data);
 static bool is_valid_tar_destination(
     const char *destination, int stat_res, struct fs_dirent *entry);
 static bool is_valid_file_destination(const char *destination, int stat_res);
 
+/************************************************
+ *        Static variables declarations         *
+ ***********************************************/
+
+// Last directory chain verified by mkdir_recursive. Extracting an archive creates the parent
+// directories once per file, this cache avoids re-stating every path component each time.
+// Only accessed from the file transfer thread.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static char last_verified_dir[MAX_PATH_SIZE];
+
 /************************************************
  *     Callbacks definition and declaration     *
  ***********************************************/
@@ -260,7 +273,8 @@ size_t calculate_tar_directory_size(const char *dir)
 
 int fs_walk(const char *base_path, fs_walk_cb_t cbk, void *user_data)
 {
-    if (strlen(base_path) >= MAX_PATH_SIZE) {
+    size_t base_len = strlen(base_path);
+    if (base_len >= MAX_PATH_SIZE) {
         return -ENAMETOOLONG;
     }
 
@@ -268,7 +282,90 @@ int fs_walk(const char *base_path, fs_walk_cb_t cbk, void *user_data)
     strncpy(path, base_path, MAX_PATH_SIZE - 1);
     path[MAX_PATH_SIZE - 1] = '\0';
 
-    return walk_recursive(path, cbk, user_data);
+    // Explicit work stack replacing recursion, one open directory handle per level
+    struct fs_dir_t dirs[FS_WALK_MAX_DEPTH];
+    size_t path_lens[FS_WALK_MAX_DEPTH];
+    int depth = 0;
+
+    fs_dir_t_init(&dirs[0]);
+    int err = fs_opendir(&dirs[0], path);
+    if (err < 0) {
+        return err;
+    }
+    path_lens[0] = base_len;
+
+    struct fs_dirent entry = { 0 };
+    while (depth >= 0) {
+        size_t path_len = path_lens[depth];
+        err = fs_readdir(&dirs[depth], &entry);
+        if (err < 0) {
+            break;
+        }
+
+        // End of this directory, unwind to the parent level
+        if (entry.name[0] == '\0') {
+            depth = walk_pop(path, dirs, path_lens, depth, cbk, user_data);
+            continue;
+        }
+
+        // Ignore standard current/parent directory links
+        if (strcmp(entry.name, ".") == 0 || strcmp(entry.name, "..") == 0) {
+            continue;
+        }
+
+        // Calculate lengths to safely construct the new path
+        size_t name_len = strlen(entry.name);
+        size_t slash_len = (path[path_len - 1] != '/') ? 1 : 0;
+
+        // A path too long to represent stops this directory but not its parents, matching the
+        // error tolerance of the previous recursive walk
+        if (path_len + slash_len + name_len >= MAX_PATH_SIZE) {
+            depth = walk_pop(path, dirs, path_lens, depth, cbk, user_data);
+            if (depth < 0) {
+                err = -ENAMETOOLONG;
+            }
+            continue;
+        }
+
+        // Append the current entry name to the path buffer
+        if (slash_len != 0) {
+            path[path_len] = '/';
+        }
+        strncpy(&path[path_len + slash_len], entry.name, MAX_PATH_SIZE - path_len - slash_len - 1);
+        path[MAX_PATH_SIZE - 1] = '\0';
+
+        // Directories get pushed on the work stack and visited post-order when popped
+        if (entry.type == FS_DIR_ENTRY_DIR) {
+            if (depth + 1 >= FS_WALK_MAX_DEPTH) {
+                err = -E2BIG;
+                break;
+            }
+            depth++;
+            fs_dir_t_init(&dirs[depth]);
+            err = fs_opendir(&dirs[depth], path);
+            if (err < 0) {
+                // The failed handle is not open, leave it out of the unwind below
+                depth--;
+                break;
+            }
+            path_lens[depth] = path_len + slash_len + name_len;
+            continue;
+        }
+
+        // Execute the user callback
+        cbk(path, &entry, user_data);
+
+        // Restore the path buffer back to the current directory level
+        path[path_len] = '\0';
+    }
+
+    // Close any directory handles still open after an aborted walk
+    while (depth >= 0) {
+        fs_closedir(&dirs[depth]);
+        depth--;
+    }
+
+    return err;
 }
 
 int mkdir_recursive(const char *path, bool is_file_path)
@@ -288,6 +385,16 @@ int mkdir_recursive(const char *path, bool is_file_path)
         *last_slash = '\0';
     }
 
+    // Fast path: the same directory chain was verified by the previous call, a single stat of
+    // the leaf confirms it is still there instead of one per path component
+    if ((temp_path[0] != '\0') && (strcmp(temp_path, last_verified_dir) == 0)) {
+        struct fs_dirent entry;
+        if (fs_stat(temp_path, &entry) == 0) {
+            return 0;
+        }
+        last_verified_dir[0] = '\0';
+    }
+
     // Traverse the path and create missing directories at each '/'
     for (char *ptr = temp_path + 1; *ptr; ptr++) {
         if (*ptr == '/') {
@@ -310,6 +417,7 @@ int mkdir_recursive(const char *path, bool is_file_path)
         }
     }
 
+    strncpy(last_verified_dir, temp_path, MAX_PATH_SIZE);
     return 0;
 }
 
@@ -376,67 +484,26 @@ static bool is_valid_file_destination(const char *destination, int stat_res)
     return true;
 }
 
-// Unfortunately a recursive chain seems the best way to perform a file system walk
-// NOLINTNEXTLINE(misc-no-recursion)
-static int walk_recursive(char path[static MAX_PATH_SIZE], fs_walk_cb_t cbk, void *user_data)
+static int walk_pop(char path[static MAX_PATH_SIZE], struct fs_dir_t *dirs,
+    const size_t *path_lens, int depth, fs_walk_cb_t cbk, void *user_data)
 {
-    struct fs_dir_t dir = { 0 };
-    struct fs_dirent entry = { 0 };
-    int err = 0;
-
-    fs_dir_t_init(&dir);
-    err = fs_opendir(&dir, path);
-    if (err < 0) {
-        return err;
-    }
-
-    size_t path_len = strlen(path);
-
-    while (true) {
-        err = fs_readdir(&dir, &entry);
-        if (err < 0 || entry.name[0] == '\0') {
-            break;
-        }
-
-        // Ignore standard current/parent directory links
-        if (strcmp(entry.name, ".") == 0 || strcmp(entry.name, "..") == 0) {
-            continue;
-        }
-
-        // Calculate lengths to safely construct the new path
-        size_t name_len = strlen(entry.name);
-        bool needs_slash = path[path_len - 1] != '/';
-
-        // Ensure we don't overflow the shared path buffer
-        if (path_len + (needs_slash ? 1 : 0) + name_len >= MAX_PATH_SIZE) {
-            err = -ENAMETOOLONG;
-            break;
-        }
-
-        // Append the current entry name to the path buffer
-        if (needs_slash) {
-            path[path_len] = '/';
-            strncpy(&path[path_len + 1], entry.name, MAX_PATH_SIZE - path_len - 2);
-        } else {
-            strncpy(&path[path_len], entry.name, MAX_PATH_SIZE - path_len - 1);
-        }
-        path[MAX_PATH_SIZE - 1] = '\0';
-
-        // If the entry is a directory, recurse into it
-        if (entry.type == FS_DIR_ENTRY_DIR) {
-            err = walk_recursive(path, cbk, user_data);
-            if (err < 0 && err != -ENAMETOOLONG) {
-                break;
-            }
-        }
-
-        // Execute the user callback
-        cbk(path, &entry, user_data);
-
-        // Restore the path buffer back to the current directory level
-        path[path_len] = '\0';
-    }
-
-    fs_closedir(&dir);
-    return err;
+    fs_closedir(&dirs[depth]);
+    depth--;
+    // The base path itself does not get a callback
+    if (depth < 0) {
+        return depth;
+    }
+
+    // Directories are visited post-order, after their content. The original readdir entry is
+    // gone by now so it is synthesized from the path, no in-tree callback inspects the size of
+    // a directory entry.
+    struct fs_dirent dir_entry = { 0 };
+    dir_entry.type = FS_DIR_ENTRY_DIR;
+    const char *name = strrchr(path, '/');
+    strncpy(dir_entry.name, name ? name + 1 : path, sizeof(dir_entry.name) - 1);
+    cbk(path, &dir_entry, user_data);
+
+    // Restore the path buffer back to the parent directory level
+    path[path_lens[depth]] = '\0';
+    return depth;
 }
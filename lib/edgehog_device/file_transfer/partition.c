@@ -0,0 +1,420 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "file_transfer/partition.h"
+
+#include "edgehog_device/file_transfer.h"
+#include "file_transfer/core.h"
+#include "file_transfer/utils.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#include "log.h"
+
+EDGEHOG_LOG_MODULE_REGISTER(file_transfer_partition, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/* Block size for partition I/O, the flash driver only sees whole aligned blocks */
+#define PARTITION_BLOCK_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION_BLOCK_SIZE
+/* Value flash cells hold after an erase, used to pad the trailing partial block of a write */
+#define PARTITION_PAD_BYTE 0xFF
+
+/** @brief Context structure for partition write operations. */
+typedef struct
+{
+    /** @brief Flash area the data is written to. */
+    const struct flash_area *fa;
+    /** @brief Configured name of the destination partition. */
+    const char *name;
+    /** @brief Pointer to the file transfer callback structure. */
+    edgehog_ft_cbks_t *cbks;
+    /** @brief Write offset into the flash area for the next block. */
+    size_t offset;
+    /** @brief Block buffer, coalesces chunks into aligned full-block programs. */
+    uint8_t block_buf[PARTITION_BLOCK_SIZE] __aligned(sizeof(void *));
+    /** @brief Number of bytes currently pending in the block buffer. */
+    size_t block_len;
+} write_ctx_t;
+
+/** @brief Context structure for partition read operations. */
+typedef struct
+{
+    /** @brief Flash area the data is read from. */
+    const struct flash_area *fa;
+    /** @brief Configured name of the source partition. */
+    const char *name;
+    /** @brief Pointer to the file transfer callback structure. */
+    edgehog_ft_cbks_t *cbks;
+    /** @brief Read offset into the flash area for the next chunk. */
+    size_t offset;
+    /** @brief Total number of bytes to read, the full flash area size. */
+    size_t total_size;
+} read_ctx_t;
+
+BUILD_ASSERT(sizeof(write_ctx_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The partition write context doesn't fit a per-transfer context slab block");
+BUILD_ASSERT(sizeof(read_ctx_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The partition read context doesn't fit a per-transfer context slab block");
+
+/************************************************
+ *         Static functions declarations        *
+ ***********************************************/
+
+static const edgehog_ft_flash_partition_t *partition_lookup(
+    edgehog_ft_cbks_t *cbks, const char *name, edgehog_ft_filesystem_permission_t req_perm);
+
+static edgehog_result_t write_init(
+    void **ctx, edgehog_ft_cbks_t *cbks, size_t expected_file_size, char *destination, bool is_tar);
+static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name);
+static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_t chunk_size);
+static edgehog_result_t write_flush(write_ctx_t *wctx);
+static edgehog_result_t write_complete(void *ctx);
+static void write_abort(void *ctx);
+
+static edgehog_result_t read_init(
+    void **ctx, edgehog_ft_cbks_t *cbks, char *source, size_t *out_file_size, bool is_tar);
+static edgehog_result_t read_get_next_entry(
+    void *ctx, char *file_name, size_t file_name_size, size_t *file_size, bool *has_next);
+static edgehog_result_t read_chunk(
+    void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk);
+static edgehog_result_t read_complete(void *ctx);
+static void read_abort(void *ctx);
+
+/************************************************
+ *         Global variables definitions         *
+ ***********************************************/
+
+const edgehog_ft_file_write_cbks_t edgehog_ft_partition_write_cbks = { .file_init = write_init,
+    .file_append_next_entry = write_append_next_entry,
+    .file_append_chunk = write_append,
+    .file_complete = write_complete,
+    .file_abort = write_abort };
+const edgehog_ft_file_read_cbks_t edgehog_ft_partition_read_cbks = { .file_init = read_init,
+    .file_get_next_entry = read_get_next_entry,
+    .file_read_chunk = read_chunk,
+    .file_complete = read_complete,
+    .file_abort = read_abort };
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static const edgehog_ft_flash_partition_t *partition_lookup(
+    edgehog_ft_cbks_t *cbks, const char *name, edgehog_ft_filesystem_permission_t req_perm)
+{
+    if (!cbks || !name) {
+        EDGEHOG_LOG_ERR("Missing file transfer callbacks or partition name.");
+        return NULL;
+    }
+
+    edgehog_ft_t *file_transfer = CONTAINER_OF(cbks, edgehog_ft_t, cbks);
+    for (size_t i = 0; i < file_transfer->flash_partitions_len; i++) {
+        const edgehog_ft_flash_partition_t *partition = &file_transfer->flash_partitions[i];
+        if (strcmp(partition->name, name) != 0) {
+            continue;
+        }
+        if ((partition->permissions & req_perm) != req_perm) {
+            EDGEHOG_LOG_ERR("Permission denied for partition %s", name);
+            return NULL;
+        }
+        return partition;
+    }
+
+    EDGEHOG_LOG_ERR("Partition %s is not in the allowed partition list", name);
+    return NULL;
+}
+
+static edgehog_result_t write_init(
+    void **ctx, edgehog_ft_cbks_t *cbks, size_t expected_file_size, char *destination, bool is_tar)
+{
+    edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    write_ctx_t *wctx = NULL;
+    const struct flash_area *fa = NULL;
+
+    // Raw partitions hold a single opaque blob, archives require a filesystem destination
+    if (is_tar) {
+        EDGEHOG_LOG_ERR("TAR archives can't be extracted to a raw partition");
+        return EDGEHOG_RESULT_INVALID_CONFIGURATION;
+    }
+
+    const edgehog_ft_flash_partition_t *partition
+        = partition_lookup(cbks, destination, EDGEHOG_FT_FILESYSTEM_PERM_WRITE);
+    if (!partition) {
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    int ret = flash_area_open(partition->id, &fa);
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR(
+            "Failed to open flash area %u for %s, err %d", partition->id, destination, ret);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    if ((expected_file_size > 0) && (expected_file_size > fa->fa_size)) {
+        EDGEHOG_LOG_ERR("File of %zu bytes doesn't fit partition %s of %zu bytes",
+            expected_file_size, destination, (size_t) fa->fa_size);
+        eres = EDGEHOG_RESULT_INVALID_PARAM;
+        goto error;
+    }
+
+    // Full-buffer flushes rely on the block size being a multiple of the write alignment
+    if ((PARTITION_BLOCK_SIZE % flash_area_align(fa)) != 0) {
+        EDGEHOG_LOG_ERR("Partition block size isn't a multiple of the flash write alignment");
+        eres = EDGEHOG_RESULT_INVALID_CONFIGURATION;
+        goto error;
+    }
+
+    // Erase the whole area up front, a single bulk erase is cheaper than interleaving page
+    // erases with the incoming network chunks
+    ret = flash_area_erase(fa, 0, fa->fa_size);
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR("Failed to erase partition %s, err %d", destination, ret);
+        eres = EDGEHOG_RESULT_INTERNAL_ERROR;
+        goto error;
+    }
+
+    wctx = edgehog_ft_ctx_alloc(sizeof(write_ctx_t));
+    if (!wctx) {
+        EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
+        eres = EDGEHOG_RESULT_OUT_OF_MEMORY;
+        goto error;
+    }
+
+    wctx->fa = fa;
+    wctx->name = destination;
+    wctx->cbks = cbks;
+    wctx->offset = 0;
+    wctx->block_len = 0;
+
+    EDGEHOG_LOG_DBG("Initialized a file transfer partition write context.");
+    EDGEHOG_LOG_DBG("Destination partition: %s", destination);
+
+    *ctx = wctx;
+    return EDGEHOG_RESULT_OK;
+
+error:
+    flash_area_close(fa);
+    return eres;
+}
+
+static edgehog_result_t write_append_next_entry(void *ctx, const char *file_name)
+{
+    ARG_UNUSED(ctx);
+    ARG_UNUSED(file_name);
+    EDGEHOG_LOG_ERR("Attempted to append a file entry to a raw partition");
+    return EDGEHOG_RESULT_INVALID_CONFIGURATION;
+}
+
+static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_t chunk_size)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+    size_t consumed = 0;
+
+    // Accumulate into the block buffer so the flash driver only sees aligned full-block
+    // programs, independently of the received chunk sizes.
+    while (consumed < chunk_size) {
+        size_t copy_size = MIN(PARTITION_BLOCK_SIZE - wctx->block_len, chunk_size - consumed);
+        memcpy(&wctx->block_buf[wctx->block_len], chunk_data + consumed, copy_size);
+        wctx->block_len += copy_size;
+        consumed += copy_size;
+
+        if (wctx->block_len == PARTITION_BLOCK_SIZE) {
+            edgehog_result_t eres = write_flush(wctx);
+            if (eres != EDGEHOG_RESULT_OK) {
+                return eres;
+            }
+        }
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t write_flush(write_ctx_t *wctx)
+{
+    if (wctx->block_len == 0) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    // Pad a trailing partial block up to the flash write alignment with the erased value
+    size_t write_size = ROUND_UP(wctx->block_len, flash_area_align(wctx->fa));
+    memset(&wctx->block_buf[wctx->block_len], PARTITION_PAD_BYTE, write_size - wctx->block_len);
+
+    if (wctx->offset + write_size > wctx->fa->fa_size) {
+        EDGEHOG_LOG_ERR("Partition %s is full", wctx->name);
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    int ret = flash_area_write(wctx->fa, wctx->offset, wctx->block_buf, write_size);
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR("Failed to program block to partition %s, err %d", wctx->name, ret);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    wctx->offset += wctx->block_len;
+    wctx->block_len = 0;
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t write_complete(void *ctx)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    edgehog_result_t eres = write_flush(wctx);
+    flash_area_close(wctx->fa);
+    if (eres != EDGEHOG_RESULT_OK) {
+        edgehog_ft_ctx_free(ctx);
+        return eres;
+    }
+
+    EDGEHOG_LOG_DBG("Partition write has been completed.");
+
+    if (wctx->cbks && wctx->cbks->on_filesystem_transfer_done) {
+        wctx->cbks->on_filesystem_transfer_done(EDGEHOG_FT_TYPE_SERVER_TO_DEVICE, wctx->name);
+    }
+
+    edgehog_ft_ctx_free(ctx);
+    return EDGEHOG_RESULT_OK;
+}
+
+static void write_abort(void *ctx)
+{
+    write_ctx_t *wctx = (write_ctx_t *) ctx;
+
+    if (!wctx) {
+        return;
+    }
+
+    // The partially written content is left in place, the next write erases the area again
+    flash_area_close(wctx->fa);
+
+    EDGEHOG_LOG_ERR("Partition write has been aborted.");
+
+    edgehog_ft_ctx_free(ctx);
+}
+
+static edgehog_result_t read_init(
+    void **ctx, edgehog_ft_cbks_t *cbks, char *source, size_t *out_file_size, bool is_tar)
+{
+    read_ctx_t *rctx = NULL;
+    const struct flash_area *fa = NULL;
+
+    // Raw partitions hold a single opaque blob, archives require a filesystem source
+    if (is_tar) {
+        EDGEHOG_LOG_ERR("TAR archives can't be packed from a raw partition");
+        return EDGEHOG_RESULT_INVALID_CONFIGURATION;
+    }
+
+    const edgehog_ft_flash_partition_t *partition
+        = partition_lookup(cbks, source, EDGEHOG_FT_FILESYSTEM_PERM_READ);
+    if (!partition) {
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    int ret = flash_area_open(partition->id, &fa);
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR("Failed to open flash area %u for %s, err %d", partition->id, source, ret);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    rctx = edgehog_ft_ctx_alloc(sizeof(read_ctx_t));
+    if (!rctx) {
+        EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
+        flash_area_close(fa);
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
+    }
+
+    rctx->fa = fa;
+    rctx->name = source;
+    rctx->cbks = cbks;
+    rctx->offset = 0;
+    // Raw partitions carry no length metadata, the whole partition content is transferred
+    rctx->total_size = fa->fa_size;
+
+    if (out_file_size) {
+        *out_file_size = rctx->total_size;
+    }
+
+    EDGEHOG_LOG_DBG("Initialized a file transfer partition read context.");
+    EDGEHOG_LOG_DBG("Source partition: %s", source);
+
+    *ctx = rctx;
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t read_get_next_entry(
+    void *ctx, char *file_name, size_t file_name_size, size_t *file_size, bool *has_next)
+{
+    ARG_UNUSED(ctx);
+    ARG_UNUSED(file_name);
+    ARG_UNUSED(file_name_size);
+    ARG_UNUSED(file_size);
+    *has_next = false;
+    EDGEHOG_LOG_ERR("Attempted to get next file entry from a raw partition");
+    return EDGEHOG_RESULT_INTERNAL_ERROR;
+}
+
+static edgehog_result_t read_chunk(
+    void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk)
+{
+    read_ctx_t *rctx = (read_ctx_t *) ctx;
+
+    // Fill the caller provided buffer directly from the flash area, no intermediate copy
+    size_t read_size = MIN(max_length, rctx->total_size - rctx->offset);
+    if (read_size > 0) {
+        int ret = flash_area_read(rctx->fa, rctx->offset, buffer, read_size);
+        if (ret != 0) {
+            EDGEHOG_LOG_ERR("Failed to read chunk from partition %s, err %d", rctx->name, ret);
+            return EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+        rctx->offset += read_size;
+    }
+
+    *chunk_size = read_size;
+    *last_chunk = (rctx->offset == rctx->total_size);
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t read_complete(void *ctx)
+{
+    read_ctx_t *rctx = (read_ctx_t *) ctx;
+    EDGEHOG_LOG_DBG("Partition read has been completed, freeing context.");
+    if (!rctx) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    flash_area_close(rctx->fa);
+
+    if (rctx->cbks && rctx->cbks->on_filesystem_transfer_done) {
+        rctx->cbks->on_filesystem_transfer_done(EDGEHOG_FT_TYPE_DEVICE_TO_SERVER, rctx->name);
+    }
+
+    edgehog_ft_ctx_free(ctx);
+    return EDGEHOG_RESULT_OK;
+}
+
+static void read_abort(void *ctx)
+{
+    read_ctx_t *rctx = (read_ctx_t *) ctx;
+    EDGEHOG_LOG_DBG("Partition read has been aborted.");
+    if (!rctx) {
+        return;
+    }
+
+    flash_area_close(rctx->fa);
+
+    edgehog_ft_ctx_free(ctx);
+}
@@ -0,0 +1,330 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENTED
+
+#include "file_transfer/segmented.h"
+
+#include "http.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/status.h>
+#include <zephyr/sys/util.h>
+
+EDGEHOG_LOG_MODULE_REGISTER(
+    file_transfer_segmented, CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SEGMENT_COUNT CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENTS
+#define STRIPE_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENT_STRIPE_SIZE
+#define SLOT_COUNT (2 * SEGMENT_COUNT)
+#define WORKER_STACK_SIZE 4096
+#define RANGE_HEADER_BUF_SIZE 64
+#define EXTRA_HEADERS_MAX 8
+#define SEGMENTED_HTTP_REQ_TIMEOUT_MS (60 * 1000)
+#define WRITER_POLL_TIMEOUT K_SECONDS(1)
+
+/** @brief A stripe buffer slot, filled by a worker thread and drained in order by the caller. */
+struct stripe_slot
+{
+    /** @brief Stripe payload bytes. */
+    uint8_t buf[STRIPE_SIZE];
+    /** @brief Number of valid bytes in the buffer. */
+    size_t len;
+    /** @brief Set when the worker failed to download the stripe. */
+    bool failed;
+    /** @brief Given by the worker once the stripe is downloaded. */
+    struct k_sem ready;
+    /** @brief Given by the caller once the stripe has been consumed. */
+    struct k_sem free;
+};
+
+/** @brief Per-worker download state, passed to the stripe response callback. */
+struct stripe_download
+{
+    /** @brief Slot the stripe is being downloaded into. */
+    struct stripe_slot *slot;
+    /** @brief Expected size of the stripe in bytes. */
+    size_t expected;
+};
+
+/** @brief State for the single segmented download instance. */
+struct segmented_state
+{
+    /** @brief Parameters of the running download. */
+    const edgehog_ft_segmented_params_t *params;
+    /** @brief Stripe buffer slots, indexed by stripe number modulo #SLOT_COUNT. */
+    struct stripe_slot slots[SLOT_COUNT];
+    /** @brief Number of stripes the file is divided into. */
+    size_t stripe_count;
+    /** @brief Set to stop all the workers and the caller loop. */
+    atomic_t abort;
+    /** @brief Latch ensuring only the first error is recorded. */
+    atomic_t error_latched;
+    /** @brief Set when the server answered a range request with a full body. */
+    atomic_t range_unsupported;
+    /** @brief First error reported by a worker thread. */
+    edgehog_result_t worker_result;
+    /** @brief Worker thread handles. */
+    struct k_thread threads[SEGMENT_COUNT];
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_THREAD_STACK_ARRAY_DEFINE(segmented_worker_stacks, SEGMENT_COUNT, WORKER_STACK_SIZE);
+static struct segmented_state state;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Worker thread entry function, downloads every stripe assigned to the worker.
+ */
+static void segmented_worker_entry_point(void *idx_ptr, void *ptr2, void *ptr3);
+
+/**
+ * @brief HTTP response callback accumulating a stripe into its slot buffer.
+ */
+static edgehog_result_t stripe_response_cbk(
+    edgehog_http_response_chunk_t *response_chunk, void *user_data);
+
+/**
+ * @brief Record the first error hit by a worker and stop the download.
+ *
+ * @param[in] result Error to record.
+ */
+static void latch_worker_error(edgehog_result_t result);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+edgehog_result_t edgehog_ft_segmented_download(
+    const edgehog_ft_segmented_params_t *params, bool *range_unsupported)
+{
+    *range_unsupported = false;
+
+    if (!params || !params->response_cbk || (params->file_size == 0)) {
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    state.params = params;
+    state.stripe_count = DIV_ROUND_UP(params->file_size, STRIPE_SIZE);
+    atomic_clear(&state.abort);
+    atomic_clear(&state.error_latched);
+    atomic_clear(&state.range_unsupported);
+    state.worker_result = EDGEHOG_RESULT_OK;
+
+    for (size_t i = 0; i < SLOT_COUNT; i++) {
+        state.slots[i].len = 0;
+        state.slots[i].failed = false;
+        k_sem_init(&state.slots[i].ready, 0, K_SEM_MAX_LIMIT);
+        k_sem_init(&state.slots[i].free, 1, K_SEM_MAX_LIMIT);
+    }
+
+    for (size_t i = 0; i < SEGMENT_COUNT; i++) {
+        k_tid_t thread_id = k_thread_create(&state.threads[i], segmented_worker_stacks[i],
+            WORKER_STACK_SIZE, segmented_worker_entry_point, (void *) i, NULL, NULL,
+            K_HIGHEST_THREAD_PRIO, 0, K_NO_WAIT);
+        if (!thread_id) {
+            EDGEHOG_LOG_ERR("Segmented download worker thread creation failed.");
+            atomic_set(&state.abort, 1);
+            for (size_t j = 0; j < i; j++) {
+                k_thread_join(&state.threads[j], K_FOREVER);
+            }
+            return EDGEHOG_RESULT_THREAD_CREATE_ERROR;
+        }
+#ifdef CONFIG_THREAD_NAME
+        char thread_name[CONFIG_THREAD_MAX_NAME_LEN] = { 0 };
+        // NOLINTNEXTLINE(cert-err33-c)
+        snprintf(thread_name, sizeof(thread_name), "edgehog_ft_seg%zu", i);
+        int name_ret = k_thread_name_set(thread_id, thread_name);
+        if (name_ret != 0) {
+            EDGEHOG_LOG_ERR("Failed to set thread name, error %d", name_ret);
+        }
+#endif
+    }
+
+    // Drain the stripes strictly in file order so the callback sees a sequential stream
+    edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
+    size_t delivered = 0;
+    for (size_t stripe = 0; stripe < state.stripe_count; stripe++) {
+        struct stripe_slot *slot = &state.slots[stripe % SLOT_COUNT];
+
+        while (k_sem_take(&slot->ready, WRITER_POLL_TIMEOUT) != 0) {
+            if (atomic_get(&state.abort)) {
+                break;
+            }
+        }
+        if (atomic_get(&state.abort) || slot->failed) {
+            edgehog_result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+            break;
+        }
+
+        edgehog_http_response_chunk_t response_chunk = {
+            .chunk_start_addr = slot->buf,
+            .chunk_size = slot->len,
+            .response_size = params->file_size,
+            .status_code = HTTP_206_PARTIAL_CONTENT,
+            .last_chunk = (stripe == state.stripe_count - 1),
+        };
+        edgehog_result = params->response_cbk(&response_chunk, params->user_data);
+        if (edgehog_result != EDGEHOG_RESULT_OK) {
+            break;
+        }
+
+        delivered++;
+        slot->len = 0;
+        k_sem_give(&slot->free);
+    }
+
+    // Unblock and collect the workers, whatever state they are in
+    atomic_set(&state.abort, 1);
+    for (size_t i = 0; i < SLOT_COUNT; i++) {
+        k_sem_give(&state.slots[i].free);
+    }
+    for (size_t i = 0; i < SEGMENT_COUNT; i++) {
+        k_thread_join(&state.threads[i], K_FOREVER);
+    }
+
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        if (state.worker_result != EDGEHOG_RESULT_OK) {
+            edgehog_result = state.worker_result;
+        }
+        // Fall back to the single-stream path only if the callback never saw any data
+        if (atomic_get(&state.range_unsupported) && (delivered == 0)) {
+            *range_unsupported = true;
+        }
+    }
+
+    return edgehog_result;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void segmented_worker_entry_point(void *idx_ptr, void *ptr2, void *ptr3)
+{
+    ARG_UNUSED(ptr2);
+    ARG_UNUSED(ptr3);
+
+    size_t worker_idx = (size_t) idx_ptr;
+    char range_header[RANGE_HEADER_BUF_SIZE] = { 0 };
+    const char *header_fields[EXTRA_HEADERS_MAX + 2] = { 0 };
+
+    // The range header comes first, followed by the caller provided headers
+    header_fields[0] = range_header;
+    size_t extra_count = 0;
+    if (state.params->header_fields) {
+        while (state.params->header_fields[extra_count]) {
+            if (extra_count >= EXTRA_HEADERS_MAX) {
+                EDGEHOG_LOG_ERR("Too many extra headers for the segmented download");
+                latch_worker_error(EDGEHOG_RESULT_INTERNAL_ERROR);
+                return;
+            }
+            header_fields[1 + extra_count] = state.params->header_fields[extra_count];
+            extra_count++;
+        }
+    }
+
+    for (size_t stripe = worker_idx; stripe < state.stripe_count; stripe += SEGMENT_COUNT) {
+        struct stripe_slot *slot = &state.slots[stripe % SLOT_COUNT];
+
+        k_sem_take(&slot->free, K_FOREVER);
+        if (atomic_get(&state.abort)) {
+            return;
+        }
+
+        size_t start = stripe * STRIPE_SIZE;
+        size_t end = MIN(state.params->file_size, start + STRIPE_SIZE);
+        struct stripe_download download = { .slot = slot, .expected = end - start };
+        slot->len = 0;
+        slot->failed = false;
+
+        int ret = snprintf(
+            range_header, sizeof(range_header), "Range: bytes=%zu-%zu\r\n", start, end - 1);
+        if ((ret < 0) || (ret >= sizeof(range_header))) {
+            EDGEHOG_LOG_ERR("Error formatting the Range header");
+            latch_worker_error(EDGEHOG_RESULT_INTERNAL_ERROR);
+            slot->failed = true;
+            k_sem_give(&slot->ready);
+            return;
+        }
+
+        edgehog_http_get_data_t http_get_data = { .url = state.params->url,
+            .header_fields = header_fields,
+            .timeout_ms = SEGMENTED_HTTP_REQ_TIMEOUT_MS,
+            .profile = EDGEHOG_HTTP_PROFILE_BULK,
+            .response_cbk = stripe_response_cbk,
+            .user_data = &download };
+
+        edgehog_result_t eres = edgehog_http_get(&http_get_data);
+        if ((eres != EDGEHOG_RESULT_OK) || (slot->len != download.expected)) {
+            if (!atomic_get(&state.range_unsupported)) {
+                EDGEHOG_LOG_ERR("Stripe %zu download failed: %d (got %zu of %zu bytes)", stripe,
+                    eres, slot->len, download.expected);
+            }
+            latch_worker_error(
+                (eres != EDGEHOG_RESULT_OK) ? eres : EDGEHOG_RESULT_HTTP_REQUEST_ERROR);
+            slot->failed = true;
+            k_sem_give(&slot->ready);
+            return;
+        }
+
+        k_sem_give(&slot->ready);
+    }
+}
+
+static edgehog_result_t stripe_response_cbk(
+    edgehog_http_response_chunk_t *response_chunk, void *user_data)
+{
+    struct stripe_download *download = (struct stripe_download *) user_data;
+
+    if (!response_chunk) {
+        EDGEHOG_LOG_ERR("Unable to read chunk, It is empty");
+        return EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    }
+
+    if (atomic_get(&state.abort)) {
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+
+    if (response_chunk->status_code != HTTP_206_PARTIAL_CONTENT) {
+        // The body is the full file, stripes can't be reassembled from it
+        atomic_set(&state.range_unsupported, 1);
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+
+    if (download->slot->len + response_chunk->chunk_size > download->expected) {
+        EDGEHOG_LOG_ERR("Server sent more bytes than requested for the stripe");
+        return EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+    }
+
+    memcpy(&download->slot->buf[download->slot->len], response_chunk->chunk_start_addr,
+        response_chunk->chunk_size);
+    download->slot->len += response_chunk->chunk_size;
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static void latch_worker_error(edgehog_result_t result)
+{
+    if (atomic_cas(&state.error_latched, 0, 1)) {
+        state.worker_result = result;
+    }
+    atomic_set(&state.abort, 1);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_SEGMENTED
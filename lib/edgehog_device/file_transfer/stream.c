@@ -7,6 +7,7 @@
 #include "file_transfer/stream.h"
 
 #include "edgehog_device/file_transfer.h"
+#include "file_transfer/utils.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -24,10 +25,10 @@ EDGEHOG_LOG_MODULE_REGISTER(file_transfer_stream, CONFIG_EDGEHOG_DEVICE_FILE_TRA
 #define PIPE_TIMEOUT_MS 2000
 /* The timeout for event operations. This assumes a reasonable delay for event operations. */
 #define EVENT_TIMEOUT_MS 2000
-/* Define an internal buffer size for chunks read from the pipe during uploads */
-#define READ_BUFFER_SIZE 1024
-/* Buffer size for the dynamically allocated stream pipe */
-#define STREAM_PIPE_BUFFER_SIZE 1024
+/* Upper bound and default for the per-transfer stream pipe buffer */
+#define STREAM_PIPE_MAX_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_STREAM_PIPE_MAX_SIZE
+/* Lower bound for the per-transfer stream pipe buffer */
+#define STREAM_PIPE_MIN_SIZE 64
 /* Simple macro for 100% */
 #define ONE_HUNDRED_PERCENT 100
 
@@ -36,14 +37,20 @@ typedef struct
 {
     /** @brief Zephyr pipe used for writing stream data. */
     struct k_pipe pipe;
-    /** @brief Internal buffer backing the write pipe. */
-    uint8_t __aligned(4) pipe_buffer[STREAM_PIPE_BUFFER_SIZE];
+    /** @brief Internal buffer backing the write pipe, only the configured size is used. */
+    uint8_t __aligned(4) pipe_buffer[STREAM_PIPE_MAX_SIZE];
     /** @brief Event used to signal the end of the file/stream. */
     struct k_event eof_event;
     /** @brief Expected total size of the file being written. */
     size_t total_size;
     /** @brief Number of bytes successfully transferred so far. */
     size_t transferred_size;
+    /** @brief Optional watermark callback configured by the application. */
+    edgehog_ft_stream_watermark_cbk_t watermark_cbk;
+    /** @brief User data for the watermark callback. */
+    void *watermark_user_data;
+    /** @brief Tracks whether the last reported watermark was the high one. */
+    bool above_high_watermark;
 } write_ctx_t;
 
 /** @brief Context structure for stream read operations. */
@@ -51,16 +58,33 @@ typedef struct
 {
     /** @brief Zephyr pipe used for reading stream data. */
     struct k_pipe pipe;
-    /** @brief Internal buffer backing the read pipe. */
-    uint8_t pipe_buffer[STREAM_PIPE_BUFFER_SIZE];
+    /** @brief Internal buffer backing the read pipe, only the configured size is used. */
+    uint8_t pipe_buffer[STREAM_PIPE_MAX_SIZE];
     /** @brief Event used to signal the end of the file/stream. */
     struct k_event eof_event;
-    /** @brief Buffer used to read chunks of data from the pipe. */
-    uint8_t read_buffer[READ_BUFFER_SIZE];
     /** @brief Total file size. */
     size_t total_size;
+    /** @brief Configured size of the pipe buffer for this transfer. */
+    size_t pipe_size;
+    /** @brief Optional watermark callback configured by the application. */
+    edgehog_ft_stream_watermark_cbk_t watermark_cbk;
+    /** @brief User data for the watermark callback. */
+    void *watermark_user_data;
+    /** @brief Tracks whether the last reported watermark was the high one. */
+    bool above_high_watermark;
+    /** @brief Memory-mapped region served with zero-copy spans, NULL for pipe transfers. */
+    const uint8_t *direct_region;
+    /** @brief Size of the direct region in bytes. */
+    size_t direct_size;
+    /** @brief Read offset into the direct region for the next span. */
+    size_t direct_offset;
 } read_ctx_t;
 
+BUILD_ASSERT(sizeof(write_ctx_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The stream write context doesn't fit a per-transfer context slab block");
+BUILD_ASSERT(sizeof(read_ctx_t) <= CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE,
+    "The stream read context doesn't fit a per-transfer context slab block");
+
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
@@ -77,10 +101,15 @@ static edgehog_result_t read_init(
 static edgehog_result_t read_get_next_entry(
     void *ctx, char *file_name, size_t name_len, size_t *file_size, bool *has_next);
 static edgehog_result_t read_chunk(
-    void *ctx, size_t max_length, uint8_t **chunk_data, size_t *chunk_size, bool *last_chunk);
+    void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk);
+static edgehog_result_t read_span(
+    void *ctx, const uint8_t **span, size_t max_length, size_t *chunk_size, bool *last_chunk);
 static edgehog_result_t read_complete(void *ctx);
 static void read_abort(void *ctx);
 
+static void report_watermark(edgehog_ft_stream_watermark_cbk_t cbk, void *user_data,
+    bool *above_high_watermark, bool high);
+
 /************************************************
  *         Global variables definitions         *
  ***********************************************/
@@ -93,6 +122,7 @@ const edgehog_ft_file_write_cbks_t edgehog_ft_stream_write_cbks = { .file_init =
 const edgehog_ft_file_read_cbks_t edgehog_ft_stream_read_cbks = { .file_init = read_init,
     .file_get_next_entry = read_get_next_entry,
     .file_read_chunk = read_chunk,
+    .file_read_span = read_span,
     .file_complete = read_complete,
     .file_abort = read_abort };
 
@@ -103,37 +133,48 @@ const edgehog_ft_file_read_cbks_t edgehog_ft_stream_read_cbks = { .file_init = r
 static edgehog_result_t write_init(void **ctx, edgehog_ft_cbks_t *cbks, size_t expected_file_size,
     char *destination, bool /*is_tar*/)
 {
-    write_ctx_t *wctx = k_malloc(sizeof(write_ctx_t));
+    write_ctx_t *wctx = edgehog_ft_ctx_alloc(sizeof(write_ctx_t));
     if (!wctx) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
 
-    k_pipe_init(&wctx->pipe, wctx->pipe_buffer, STREAM_PIPE_BUFFER_SIZE);
+    k_pipe_init(&wctx->pipe, wctx->pipe_buffer, STREAM_PIPE_MAX_SIZE);
     k_event_init(&wctx->eof_event);
 
     // Check if callbacks are valid
     if (!cbks || !cbks->on_stream_transfer_start) {
         EDGEHOG_LOG_ERR("Invalid callbacks provided for stream write");
-        k_free(wctx);
+        edgehog_ft_ctx_free(wctx);
         return EDGEHOG_RESULT_INVALID_PARAM;
     }
 
     // TODO: evaluate if destination might need some parsing or validation.
 
-    edgehog_ft_stream_t stream = { .pipe = &wctx->pipe, .event = &wctx->eof_event };
+    edgehog_ft_stream_t stream = { .pipe = &wctx->pipe,
+        .event = &wctx->eof_event,
+        .pipe_buffer_size = STREAM_PIPE_MAX_SIZE };
 
     // Trigger the callback to notify the app and provide resources
     bool accepted = cbks->on_stream_transfer_start(
         destination, EDGEHOG_FT_TYPE_SERVER_TO_DEVICE, &expected_file_size, &stream);
     if (!accepted) {
         EDGEHOG_LOG_ERR("File transfer rejected for: %s", destination);
-        k_free(wctx);
+        edgehog_ft_ctx_free(wctx);
         return EDGEHOG_RESULT_INVALID_PARAM;
     }
 
+    // Apply the pipe size chosen by the application, nothing has been queued in the pipe yet
+    size_t pipe_size = CLAMP(stream.pipe_buffer_size, STREAM_PIPE_MIN_SIZE, STREAM_PIPE_MAX_SIZE);
+    if (pipe_size != STREAM_PIPE_MAX_SIZE) {
+        k_pipe_init(&wctx->pipe, wctx->pipe_buffer, pipe_size);
+    }
+
     wctx->total_size = expected_file_size;
     wctx->transferred_size = 0;
+    wctx->watermark_cbk = stream.watermark_cbk;
+    wctx->watermark_user_data = stream.watermark_user_data;
+    wctx->above_high_watermark = false;
 
     *ctx = wctx;
     return EDGEHOG_RESULT_OK;
@@ -172,6 +213,16 @@ static edgehog_result_t write_append(void *ctx, const uint8_t *chunk_data, size_
             return EDGEHOG_RESULT_INTERNAL_ERROR;
         }
 
+        // A write that does not fully fit means the pipe filled up and the application is the
+        // bottleneck, a fully accepted one means it has drained back below the watermark
+        if ((ret > 0) && ((size_t) ret == remaining)) {
+            report_watermark(
+                wctx->watermark_cbk, wctx->watermark_user_data, &wctx->above_high_watermark, false);
+        } else if ((ret == -EAGAIN) || (ret > 0)) {
+            report_watermark(
+                wctx->watermark_cbk, wctx->watermark_user_data, &wctx->above_high_watermark, true);
+        }
+
         // Timeout check
         if ((k_uptime_get() - start_time) >= PIPE_TIMEOUT_MS) {
             EDGEHOG_LOG_ERR("Timeout writing to pipe - user application is too slow to read");
@@ -200,7 +251,7 @@ static edgehog_result_t write_complete(void *ctx)
     k_event_wait(
         &wctx->eof_event, EDGEHOG_FT_STREAM_ACK_EVENT_FLAG, false, K_MSEC(EVENT_TIMEOUT_MS));
 
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
     return EDGEHOG_RESULT_OK;
 }
 
@@ -213,29 +264,31 @@ static void write_abort(void *ctx)
     k_event_wait(
         &wctx->eof_event, EDGEHOG_FT_STREAM_ACK_EVENT_FLAG, false, K_MSEC(EVENT_TIMEOUT_MS));
 
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
 }
 
 static edgehog_result_t read_init(
     void **ctx, edgehog_ft_cbks_t *cbks, char *source, size_t *out_file_size, bool /*is_tar*/)
 {
-    read_ctx_t *rctx = k_malloc(sizeof(read_ctx_t));
+    read_ctx_t *rctx = edgehog_ft_ctx_alloc(sizeof(read_ctx_t));
     if (!rctx) {
         return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
 
-    k_pipe_init(&rctx->pipe, rctx->pipe_buffer, STREAM_PIPE_BUFFER_SIZE);
+    k_pipe_init(&rctx->pipe, rctx->pipe_buffer, STREAM_PIPE_MAX_SIZE);
     k_event_init(&rctx->eof_event);
 
     if (!cbks || !cbks->on_stream_transfer_start) {
         EDGEHOG_LOG_ERR("Invalid callbacks provided for stream read");
-        k_free(rctx);
+        edgehog_ft_ctx_free(rctx);
         return EDGEHOG_RESULT_INVALID_PARAM;
     }
 
     // TODO: evaluate if source might need some parsing or validation.
 
-    edgehog_ft_stream_t stream = { .pipe = &rctx->pipe, .event = &rctx->eof_event };
+    edgehog_ft_stream_t stream = { .pipe = &rctx->pipe,
+        .event = &rctx->eof_event,
+        .pipe_buffer_size = STREAM_PIPE_MAX_SIZE };
 
     size_t upload_size = 0;
     bool accepted = cbks->on_stream_transfer_start(
@@ -243,10 +296,28 @@ static edgehog_result_t read_init(
 
     if (!accepted) {
         EDGEHOG_LOG_ERR("Transfer rejected for: %s", source);
-        k_free(rctx);
+        edgehog_ft_ctx_free(rctx);
         return EDGEHOG_RESULT_INVALID_PARAM;
     }
 
+    // Apply the pipe size chosen by the application, nothing has been queued in the pipe yet
+    rctx->pipe_size = CLAMP(stream.pipe_buffer_size, STREAM_PIPE_MIN_SIZE, STREAM_PIPE_MAX_SIZE);
+    if (rctx->pipe_size != STREAM_PIPE_MAX_SIZE) {
+        k_pipe_init(&rctx->pipe, rctx->pipe_buffer, rctx->pipe_size);
+    }
+    rctx->watermark_cbk = stream.watermark_cbk;
+    rctx->watermark_user_data = stream.watermark_user_data;
+    rctx->above_high_watermark = false;
+
+    // Zero-copy mode: the application handed a memory-mapped region, the upload is served
+    // with direct spans into it and the pipe goes unused
+    if (stream.direct_region && (stream.direct_region_size > 0)) {
+        rctx->direct_region = stream.direct_region;
+        rctx->direct_size = stream.direct_region_size;
+        rctx->direct_offset = 0;
+        upload_size = stream.direct_region_size;
+    }
+
     if (out_file_size) {
         *out_file_size = upload_size;
     }
@@ -262,18 +333,33 @@ static edgehog_result_t read_get_next_entry(void * /*ctx*/, char * /*file_name*/
 }
 
 static edgehog_result_t read_chunk(
-    void *ctx, size_t max_length, uint8_t **chunk_data, size_t *chunk_size, bool *last_chunk)
+    void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk)
 {
     read_ctx_t *rctx = (read_ctx_t *) ctx;
     int64_t start_time = k_uptime_get();
 
+    // The TAR and compression producers pull through this copying path with their own buffers,
+    // a direct region still spares them the pipe round trip
+    if (rctx->direct_region) {
+        size_t read_size = MIN(max_length, rctx->direct_size - rctx->direct_offset);
+        memcpy(buffer, &rctx->direct_region[rctx->direct_offset], read_size);
+        rctx->direct_offset += read_size;
+        *chunk_size = read_size;
+        *last_chunk = (rctx->direct_offset == rctx->direct_size);
+        return EDGEHOG_RESULT_OK;
+    }
+
     // Loop until we read data, encounter a hard error, or detect EOF
     while (true) {
-        // Try to read data from the pipe without blocking
-        size_t bytes_to_read = MIN(READ_BUFFER_SIZE, max_length);
-        int ret = k_pipe_read(&rctx->pipe, rctx->read_buffer, bytes_to_read, K_NO_WAIT);
+        // Try to read data from the pipe directly into the caller provided buffer
+        int ret = k_pipe_read(&rctx->pipe, buffer, max_length, K_NO_WAIT);
         if (ret > 0) {
-            *chunk_data = rctx->read_buffer;
+            // A read draining as much as the pipe can hold means it is running full and the
+            // network is the bottleneck
+            if ((size_t) ret == MIN(max_length, rctx->pipe_size)) {
+                report_watermark(rctx->watermark_cbk, rctx->watermark_user_data,
+                    &rctx->above_high_watermark, true);
+            }
             *chunk_size = (size_t) ret;
             *last_chunk = false;
             return EDGEHOG_RESULT_OK;
@@ -284,6 +370,10 @@ static edgehog_result_t read_chunk(
             return EDGEHOG_RESULT_INTERNAL_ERROR;
         }
 
+        // The pipe drained completely, the application is the bottleneck
+        report_watermark(
+            rctx->watermark_cbk, rctx->watermark_user_data, &rctx->above_high_watermark, false);
+
         // The pipe is empty (-EAGAIN). Check if the writer signaled something.
         uint32_t events = k_event_test(&rctx->eof_event,
             EDGEHOG_FT_STREAM_EOF_EVENT_FLAG | EDGEHOG_FT_STREAM_ERROR_EVENT_FLAG);
@@ -292,7 +382,6 @@ static edgehog_result_t read_chunk(
             return EDGEHOG_RESULT_INTERNAL_ERROR;
         }
         if (events & EDGEHOG_FT_STREAM_EOF_EVENT_FLAG) {
-            *chunk_data = NULL;
             *chunk_size = 0;
             *last_chunk = true;
             return EDGEHOG_RESULT_OK;
@@ -311,15 +400,47 @@ static edgehog_result_t read_chunk(
     return EDGEHOG_RESULT_OK;
 }
 
+static edgehog_result_t read_span(
+    void *ctx, const uint8_t **span, size_t max_length, size_t *chunk_size, bool *last_chunk)
+{
+    read_ctx_t *rctx = (read_ctx_t *) ctx;
+
+    // Signal the caller to fall back to the copying read for pipe-backed transfers
+    if (!rctx->direct_region) {
+        *span = NULL;
+        return EDGEHOG_RESULT_OK;
+    }
+
+    // Yield a length-clamped span pointing directly into the mapped region
+    size_t read_size = MIN(max_length, rctx->direct_size - rctx->direct_offset);
+    *span = &rctx->direct_region[rctx->direct_offset];
+    rctx->direct_offset += read_size;
+    *chunk_size = read_size;
+    *last_chunk = (rctx->direct_offset == rctx->direct_size);
+
+    return EDGEHOG_RESULT_OK;
+}
+
 static edgehog_result_t read_complete(void *ctx)
 {
     EDGEHOG_LOG_DBG("File read has been completed, freeing context.");
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
     return EDGEHOG_RESULT_OK;
 }
 
 static void read_abort(void *ctx)
 {
     EDGEHOG_LOG_DBG("File read has been aborted.");
-    k_free(ctx);
+    edgehog_ft_ctx_free(ctx);
+}
+
+static void report_watermark(edgehog_ft_stream_watermark_cbk_t cbk, void *user_data,
+    bool *above_high_watermark, bool high)
+{
+    // Only actual crossings are reported, repeated states are filtered out
+    if (!cbk || (*above_high_watermark == high)) {
+        return;
+    }
+    *above_high_watermark = high;
+    cbk(high ? EDGEHOG_FT_STREAM_WATERMARK_HIGH : EDGEHOG_FT_STREAM_WATERMARK_LOW, user_data);
 }
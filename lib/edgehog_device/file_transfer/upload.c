@@ -10,10 +10,15 @@
 #include "file_transfer/compression.h"
 #include "file_transfer/core.h"
 #include "file_transfer/filesystem.h"
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION
+#include "file_transfer/partition.h"
+#endif
 #include "file_transfer/stream.h"
 #include "file_transfer/utils.h"
 #include "http.h"
 #include "log.h"
+#include "sdk_event.h"
+#include "thread_placement.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,23 +31,107 @@ EDGEHOG_LOG_MODULE_REGISTER(file_transfer_upload, CONFIG_EDGEHOG_DEVICE_FILE_TRA
 #define EDGEHOG_COMPRESSION_SAFE_MARGIN 64
 #endif
 
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR)
+// Size of the upload pipeline swap buffers, large enough for both the LZ4 and the TAR producers
+#define UPLOAD_PIPELINE_BUF_SIZE MAX(EDGEHOG_FT_COMPRESSED_OUT_BUFFER_SIZE, 2 * ZTAR_BLOCK_SIZE)
+// Number of swap buffers in the upload pipeline, one being produced while one transmits
+#define UPLOAD_PIPELINE_BUF_COUNT 2
+// Stack size for the upload pipeline worker thread
+#define UPLOAD_PIPELINE_STACK_SIZE 4096
+// Priority for the upload pipeline worker thread, same as the file transfer thread
+#ifdef CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT
+#define UPLOAD_PIPELINE_THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_PRIORITY
+#else
+#define UPLOAD_PIPELINE_THREAD_PRIORITY 5
+#endif
+// CPU mask for the upload pipeline worker thread, same as the file transfer thread
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_CPU_MASK
+#define UPLOAD_PIPELINE_CPU_MASK CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_THREAD_CPU_MASK
+#else
+#define UPLOAD_PIPELINE_CPU_MASK 0
+#endif
+// Marker for "no buffer currently held by the HTTP layer"
+#define UPLOAD_PIPELINE_NO_BUF (-1)
+
+/** @brief Swap buffer for the two-stage upload pipeline. */
+struct upload_pipe_buf
+{
+    /** @brief Produced output, handed to the HTTP layer for transmission. */
+    uint8_t buf[UPLOAD_PIPELINE_BUF_SIZE];
+    /** @brief Number of valid bytes in the buffer. */
+    size_t len;
+    /** @brief Set when this is the final buffer, ending the upload. */
+    bool last;
+    /** @brief Set when the worker failed while producing this buffer. */
+    bool failed;
+    /** @brief Given by the worker when the buffer is ready to transmit. */
+    struct k_sem ready;
+    /** @brief Given by the consumer when the buffer may be refilled. */
+    struct k_sem free;
+};
+
+/** @brief Producer stage of the upload pipeline, fills a swap buffer with the next chunk. */
+typedef edgehog_result_t (*upload_pipeline_produce_t)(
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *len, bool *last);
+#endif
+
+// Size of the transmit buffer the read backends fill directly
+#define UPLOAD_READ_BUFFER_SIZE 4096
+// Clamp for zero-copy spans, bounds each HTTP send and keeps progress reporting responsive
+#define UPLOAD_DIRECT_SPAN_SIZE 32768
+
+/** @brief Transmit buffer for uploads, filled in place by the file read callbacks. A single
+ * static buffer is sufficient since uploads are serialized on the file transfer thread. */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint8_t upload_read_buf[UPLOAD_READ_BUFFER_SIZE];
+
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR)
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/** @brief Swap buffers for the upload pipeline, single set since uploads are serialized. */
+static struct upload_pipe_buf upload_pipe_bufs[UPLOAD_PIPELINE_BUF_COUNT];
+/** @brief Worker thread producing the next chunk while the previous one transmits. */
+static struct k_thread upload_pipeline_thread;
+K_THREAD_STACK_DEFINE(upload_pipeline_stack, UPLOAD_PIPELINE_STACK_SIZE);
+/** @brief Producer stage run by the pipeline worker for the current upload. */
+static upload_pipeline_produce_t upload_pipeline_produce;
+/** @brief Set to make the worker exit at the next free-buffer hand-off. */
+static atomic_t upload_pipeline_abort;
+/** @brief Tracks if the pipeline worker is currently running. */
+static bool upload_pipeline_started;
+/** @brief Index of the next buffer to hand to the HTTP layer. */
+static int upload_pipeline_consume_idx;
+/** @brief Index of the buffer currently held by the HTTP layer. */
+static int upload_pipeline_transmit_idx;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
 
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR)
+static edgehog_result_t process_pipelined_upload_chunk(edgehog_ft_http_cbk_data_t *data,
+    edgehog_http_payload_chunk_t *payload_chunk, upload_pipeline_produce_t produce);
+static void upload_pipeline_start(edgehog_ft_http_cbk_data_t *data);
+static void upload_pipeline_stop(edgehog_ft_http_cbk_data_t *data);
+static void upload_pipeline_worker(void *data_ptr, void *unused1, void *unused2);
+#endif
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
-static edgehog_result_t process_compressed_upload_chunk(
-    edgehog_ft_http_cbk_data_t *data, edgehog_http_payload_chunk_t *payload_chunk);
+static edgehog_result_t produce_next_compressed_chunk(edgehog_ft_http_cbk_data_t *data,
+    uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written, bool *last);
 static edgehog_result_t init_upload_compression(
-    edgehog_ft_http_cbk_data_t *data, size_t *lz4_bytes_written);
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written);
 static edgehog_result_t compress_next_upload_chunk(
-    edgehog_ft_http_cbk_data_t *data, size_t *lz4_bytes_written);
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written);
 static edgehog_result_t write_upload_compression_footer(
-    edgehog_ft_http_cbk_data_t *data, size_t *lz4_bytes_written);
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written);
 #endif
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
-static edgehog_result_t process_tar_upload_chunk(
-    edgehog_ft_http_cbk_data_t *data, edgehog_http_payload_chunk_t *payload_chunk);
+static edgehog_result_t produce_next_tar_chunk(edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf,
+    size_t out_size, size_t *tar_bytes_written, bool *last);
 #endif
 static edgehog_result_t process_uncompressed_upload_chunk(
     edgehog_ft_http_cbk_data_t *data, edgehog_http_payload_chunk_t *payload_chunk);
@@ -75,19 +164,17 @@ static int tar_read_file_data(uint8_t *buffer, size_t max_size, void *user_data,
     edgehog_ft_http_cbk_data_t *data = (edgehog_ft_http_cbk_data_t *) user_data;
     const edgehog_ft_file_read_cbks_t *file_cbks = data->file_cbks;
 
-    uint8_t *chunk_data = NULL;
     bool last_chunk = false;
 
+    // The read backend fills the ZTAR buffer directly, no intermediate copy is required
     edgehog_result_t eres = file_cbks->file_read_chunk(
-        data->file_cbks_ctx, max_size, &chunk_data, bytes_read, &last_chunk);
+        data->file_cbks_ctx, buffer, max_size, bytes_read, &last_chunk);
     if (eres != EDGEHOG_RESULT_OK) {
         data->posix_errno = EIO;
         data->message = "Failed to read a chunk from the next file for TAR pack";
         return -1;
     }
 
-    // ZTAR expects the buffer to be filled
-    memcpy(buffer, chunk_data, *bytes_read);
     return 0;
 }
 #endif
@@ -107,22 +194,21 @@ static edgehog_result_t http_put_device_to_server_payload_cbk(
     if (!payload_chunk) {
         data->posix_errno = EPIPE;
         data->message = "Unable to access payload chunk";
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
-        if (data->encoding == EDGEHOG_FT_ENCODING_LZ4) {
-            file_transfer_compression_free(&data->comp_ctx);
-        }
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR)
+        upload_pipeline_stop(data);
 #endif
         return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
     }
 
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
     if (data->encoding == EDGEHOG_FT_ENCODING_LZ4) {
-        return process_compressed_upload_chunk(data, payload_chunk);
+        return process_pipelined_upload_chunk(data, payload_chunk, produce_next_compressed_chunk);
     }
 #endif
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
     if (data->encoding == EDGEHOG_FT_ENCODING_TAR) {
-        return process_tar_upload_chunk(data, payload_chunk);
+        return process_pipelined_upload_chunk(data, payload_chunk, produce_next_tar_chunk);
     }
 #endif
 
@@ -181,14 +267,22 @@ void edgehog_ft_handle_device_to_server(
     http_cbk_user_data->posix_errno = posix_errno;
     http_cbk_user_data->message = message;
 
+    sdk_event_publish(EDGEHOG_SDK_TRANSFER_STARTED_EVENT, EDGEHOG_RESULT_OK, upload_size);
+
     edgehog_http_put_data_t http_put_data = { .url = msg->url,
         .header_fields = (const char **) msg->http_headers,
         .timeout_ms = EDGEHOG_FT_HTTP_REQ_TIMEOUT_MS,
+        .profile = EDGEHOG_HTTP_PROFILE_BULK,
         .payload_size = upload_size,
         .payload_cbk = http_put_device_to_server_payload_cbk,
         .user_data = http_cbk_user_data };
     // Perform the HTTP put request to upload the file
     eres = edgehog_http_put(&http_put_data);
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR)
+    // Safety net in case the HTTP layer terminated without signaling the payload callback
+    upload_pipeline_stop(http_cbk_user_data);
+#endif
     if (eres != EDGEHOG_RESULT_OK) {
         EDGEHOG_LOG_ERR("File transfer HTTP put failure: %d.", eres);
         posix_errno = http_cbk_user_data->posix_errno;
@@ -212,6 +306,11 @@ void edgehog_ft_handle_device_to_server(
     }
 
 exit:
+    sdk_event_publish(((posix_errno == 0) && (eres == EDGEHOG_RESULT_OK))
+            ? EDGEHOG_SDK_TRANSFER_COMPLETED_EVENT
+            : EDGEHOG_SDK_TRANSFER_FAILED_EVENT,
+        eres, http_cbk_user_data ? http_cbk_user_data->transferred_bytes : 0);
+
     edgehog_ft_http_cbk_data_destroy(http_cbk_user_data);
     edgehog_ft_send_response(
         edgehog_device, &msg->id, EDGEHOG_FT_TYPE_DEVICE_TO_SERVER, posix_errno, message, eres);
@@ -222,55 +321,161 @@ exit:
  *         Static functions definitions         *
  ***********************************************/
 
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR)
+static edgehog_result_t process_pipelined_upload_chunk(edgehog_ft_http_cbk_data_t *data,
+    edgehog_http_payload_chunk_t *payload_chunk, upload_pipeline_produce_t produce)
+{
+    // Spawn the pipeline worker on the first chunk
+    if (!upload_pipeline_started) {
+        upload_pipeline_produce = produce;
+        upload_pipeline_start(data);
+    }
+
+    // The HTTP layer is done with the previously handed buffer, release it to the worker
+    if (upload_pipeline_transmit_idx != UPLOAD_PIPELINE_NO_BUF) {
+        k_sem_give(&upload_pipe_bufs[upload_pipeline_transmit_idx].free);
+        upload_pipeline_transmit_idx = UPLOAD_PIPELINE_NO_BUF;
+    }
+
+    // Wait for the worker to finish producing the next buffer. While the HTTP layer
+    // transmits it, the worker moves on to produce the following one.
+    struct upload_pipe_buf *pbuf = &upload_pipe_bufs[upload_pipeline_consume_idx];
+    k_sem_take(&pbuf->ready, K_FOREVER);
+
+    if (pbuf->failed) {
+        upload_pipeline_stop(data);
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+
+    // Set the pointers for the HTTP payload chunk
+    payload_chunk->chunk_start_addr = pbuf->buf;
+    payload_chunk->chunk_size = pbuf->len;
+    payload_chunk->last_chunk = pbuf->last;
+
+    upload_pipeline_transmit_idx = upload_pipeline_consume_idx;
+    upload_pipeline_consume_idx = (upload_pipeline_consume_idx + 1) % UPLOAD_PIPELINE_BUF_COUNT;
+
+    // Cleanup after handing over the final buffer, the worker has already exited
+    if (pbuf->last) {
+        upload_pipeline_stop(data);
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static void upload_pipeline_start(edgehog_ft_http_cbk_data_t *data)
+{
+    atomic_clear(&upload_pipeline_abort);
+    upload_pipeline_consume_idx = 0;
+    upload_pipeline_transmit_idx = UPLOAD_PIPELINE_NO_BUF;
+
+    for (int i = 0; i < UPLOAD_PIPELINE_BUF_COUNT; i++) {
+        k_sem_init(&upload_pipe_bufs[i].ready, 0, 1);
+        k_sem_init(&upload_pipe_bufs[i].free, 1, 1);
+    }
+
+    k_thread_create(&upload_pipeline_thread, upload_pipeline_stack, UPLOAD_PIPELINE_STACK_SIZE,
+        upload_pipeline_worker, data, NULL, NULL, UPLOAD_PIPELINE_THREAD_PRIORITY, 0,
+        EDGEHOG_THREAD_START_DELAY);
+    k_thread_name_set(&upload_pipeline_thread, "edgehog_ft_pipe");
+    edgehog_thread_placement_start(&upload_pipeline_thread, UPLOAD_PIPELINE_CPU_MASK);
+
+    upload_pipeline_started = true;
+}
+
+static void upload_pipeline_stop(edgehog_ft_http_cbk_data_t *data)
+{
+    if (!upload_pipeline_started) {
+        return;
+    }
+
+    // Unblock the worker if it is waiting for a free buffer and wait for it to exit
+    atomic_set(&upload_pipeline_abort, 1);
+    for (int i = 0; i < UPLOAD_PIPELINE_BUF_COUNT; i++) {
+        k_sem_give(&upload_pipe_bufs[i].free);
+    }
+    k_thread_join(&upload_pipeline_thread, K_FOREVER);
+
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
-static edgehog_result_t process_compressed_upload_chunk(
-    edgehog_ft_http_cbk_data_t *data, edgehog_http_payload_chunk_t *payload_chunk)
+    if (data->encoding == EDGEHOG_FT_ENCODING_LZ4) {
+        file_transfer_compression_free(&data->comp_ctx);
+    }
+#else
+    ARG_UNUSED(data);
+#endif
+    upload_pipeline_started = false;
+}
+
+static void upload_pipeline_worker(void *data_ptr, void *unused1, void *unused2)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    edgehog_ft_http_cbk_data_t *data = (edgehog_ft_http_cbk_data_t *) data_ptr;
+
+    for (int idx = 0;; idx = (idx + 1) % UPLOAD_PIPELINE_BUF_COUNT) {
+        struct upload_pipe_buf *pbuf = &upload_pipe_bufs[idx];
+
+        k_sem_take(&pbuf->free, K_FOREVER);
+        if (atomic_get(&upload_pipeline_abort)) {
+            return;
+        }
+
+        size_t len = 0;
+        bool last = false;
+        edgehog_result_t eres
+            = upload_pipeline_produce(data, pbuf->buf, sizeof(pbuf->buf), &len, &last);
+
+        pbuf->len = len;
+        pbuf->last = last;
+        pbuf->failed = (eres != EDGEHOG_RESULT_OK);
+        k_sem_give(&pbuf->ready);
+
+        // Stop after an error or once the final buffer has been produced
+        if (pbuf->failed || pbuf->last) {
+            return;
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+static edgehog_result_t produce_next_compressed_chunk(edgehog_ft_http_cbk_data_t *data,
+    uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written, bool *last)
 {
-    size_t lz4_bytes_written = 0;
     edgehog_result_t eres = EDGEHOG_RESULT_OK;
+    *last = false;
 
     // Initialize and write the LZ4 Header if not already done
     if (!file_transfer_compression_is_initialized(&data->comp_ctx)) {
-        eres = init_upload_compression(data, &lz4_bytes_written);
-        if (eres != EDGEHOG_RESULT_OK) {
-            return eres;
-        }
-    } else {
-        // Keep looping until we have something to send via HTTP or we write the footer
-        while (lz4_bytes_written == 0 && !data->comp_footer_written) {
-
-            if (!data->file_exhausted) {
-                eres = compress_next_upload_chunk(data, &lz4_bytes_written);
-                if (eres != EDGEHOG_RESULT_OK) {
-                    return eres;
-                }
-            }
+        return init_upload_compression(data, out_buf, out_size, lz4_bytes_written);
+    }
+
+    // Keep looping until we have something to send via HTTP or we write the footer
+    while (*lz4_bytes_written == 0 && !data->comp_footer_written) {
 
-            // If file is fully read, write the LZ4 Footer
-            if (data->file_exhausted && !data->comp_footer_written) {
-                eres = write_upload_compression_footer(data, &lz4_bytes_written);
-                if (eres != EDGEHOG_RESULT_OK) {
-                    return eres;
-                }
+        if (!data->file_exhausted) {
+            eres = compress_next_upload_chunk(data, out_buf, out_size, lz4_bytes_written);
+            if (eres != EDGEHOG_RESULT_OK) {
+                return eres;
             }
         }
-    }
-
-    // Set the pointers for the HTTP payload chunk
-    payload_chunk->chunk_start_addr = data->comp_out_buf;
-    payload_chunk->chunk_size = lz4_bytes_written;
-    payload_chunk->last_chunk = data->comp_footer_written;
 
-    // Cleanup after final HTTP transmission
-    if (data->comp_footer_written) {
-        file_transfer_compression_free(&data->comp_ctx);
+        // If file is fully read, write the LZ4 Footer
+        if (data->file_exhausted && !data->comp_footer_written) {
+            eres = write_upload_compression_footer(data, out_buf, out_size, lz4_bytes_written);
+            if (eres != EDGEHOG_RESULT_OK) {
+                return eres;
+            }
+        }
     }
 
+    *last = data->comp_footer_written;
     return EDGEHOG_RESULT_OK;
 }
 
 static edgehog_result_t init_upload_compression(
-    edgehog_ft_http_cbk_data_t *data, size_t *lz4_bytes_written)
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written)
 {
     int ret = file_transfer_compression_init(&data->comp_ctx);
     if (ret != 0) {
@@ -281,8 +486,7 @@ static edgehog_result_t init_upload_compression(
         return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
     }
 
-    ret = file_transfer_compression_begin(
-        &data->comp_ctx, data->comp_out_buf, sizeof(data->comp_out_buf), lz4_bytes_written);
+    ret = file_transfer_compression_begin(&data->comp_ctx, out_buf, out_size, lz4_bytes_written);
     if (ret != 0) {
         data->posix_errno = EIO;
         data->message = "Compression failure";
@@ -295,22 +499,22 @@ static edgehog_result_t init_upload_compression(
 }
 
 static edgehog_result_t compress_next_upload_chunk(
-    edgehog_ft_http_cbk_data_t *data, size_t *lz4_bytes_written)
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written)
 {
     const edgehog_ft_file_read_cbks_t *file_cbks
         = (const edgehog_ft_file_read_cbks_t *) data->file_cbks;
-    uint8_t *chunk_data = NULL;
     size_t chunk_size = 0;
     int ret = 0;
 
     // Calculate safe read size based on remaining output buffer space
-    size_t available_space = sizeof(data->comp_out_buf) - *lz4_bytes_written;
+    size_t available_space = out_size - *lz4_bytes_written;
     size_t safe_max_read = (available_space > EDGEHOG_COMPRESSION_SAFE_MARGIN)
         ? (available_space - EDGEHOG_COMPRESSION_SAFE_MARGIN)
         : 0;
+    safe_max_read = MIN(safe_max_read, sizeof(upload_read_buf));
 
     edgehog_result_t eres = file_cbks->file_read_chunk(
-        data->file_cbks_ctx, safe_max_read, &chunk_data, &chunk_size, &data->file_exhausted);
+        data->file_cbks_ctx, upload_read_buf, safe_max_read, &chunk_size, &data->file_exhausted);
 
     if (eres != EDGEHOG_RESULT_OK) {
         data->posix_errno = EIO;
@@ -323,9 +527,8 @@ static edgehog_result_t compress_next_upload_chunk(
     // Feed it to the compressor
     if (chunk_size > 0) {
         size_t chunk_written = 0;
-        ret = file_transfer_compression_update(&data->comp_ctx, chunk_data, chunk_size,
-            data->comp_out_buf + *lz4_bytes_written,
-            sizeof(data->comp_out_buf) - *lz4_bytes_written, &chunk_written);
+        ret = file_transfer_compression_update(&data->comp_ctx, upload_read_buf, chunk_size,
+            out_buf + *lz4_bytes_written, out_size - *lz4_bytes_written, &chunk_written);
         if (ret != 0) {
             data->posix_errno = EIO;
             data->message = "Compression failure";
@@ -342,12 +545,11 @@ static edgehog_result_t compress_next_upload_chunk(
 }
 
 static edgehog_result_t write_upload_compression_footer(
-    edgehog_ft_http_cbk_data_t *data, size_t *lz4_bytes_written)
+    edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf, size_t out_size, size_t *lz4_bytes_written)
 {
     size_t chunk_written = 0;
-    int ret
-        = file_transfer_compression_end(&data->comp_ctx, data->comp_out_buf + *lz4_bytes_written,
-            sizeof(data->comp_out_buf) - *lz4_bytes_written, &chunk_written);
+    int ret = file_transfer_compression_end(&data->comp_ctx, out_buf + *lz4_bytes_written,
+        out_size - *lz4_bytes_written, &chunk_written);
 
     if (ret != 0) {
         data->posix_errno = EIO;
@@ -366,10 +568,10 @@ static edgehog_result_t write_upload_compression_footer(
 #endif
 
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
-static edgehog_result_t process_tar_upload_chunk(
-    edgehog_ft_http_cbk_data_t *data, edgehog_http_payload_chunk_t *payload_chunk)
+static edgehog_result_t produce_next_tar_chunk(edgehog_ft_http_cbk_data_t *data, uint8_t *out_buf,
+    size_t out_size, size_t *tar_bytes_written, bool *last)
 {
-    size_t tar_bytes_written = 0;
+    *tar_bytes_written = 0;
 
     if (!ztar_pack_is_initialized(&data->ztar_pack_ctx)) {
         ztar_pack_callbacks_t cbks
@@ -378,8 +580,8 @@ static edgehog_result_t process_tar_upload_chunk(
     }
 
     if (!data->tar_exhausted) {
-        ztar_result_t zres = ztar_pack_read_stream(
-            &data->ztar_pack_ctx, data->tar_buffer, sizeof(data->tar_buffer), &tar_bytes_written);
+        ztar_result_t zres
+            = ztar_pack_read_stream(&data->ztar_pack_ctx, out_buf, out_size, tar_bytes_written);
 
         if (zres == ZTAR_RESULT_ARCHIVE_EXAHUSTED) {
             data->tar_exhausted = true;
@@ -390,11 +592,8 @@ static edgehog_result_t process_tar_upload_chunk(
         }
     }
 
-    payload_chunk->chunk_start_addr = data->tar_buffer;
-    payload_chunk->chunk_size = tar_bytes_written;
-    payload_chunk->last_chunk = data->tar_exhausted;
-
-    edgehog_ft_update_progress(data, tar_bytes_written, data->tar_exhausted);
+    *last = data->tar_exhausted;
+    edgehog_ft_update_progress(data, *tar_bytes_written, data->tar_exhausted);
 
     return EDGEHOG_RESULT_OK;
 }
@@ -406,14 +605,34 @@ static edgehog_result_t process_uncompressed_upload_chunk(
     const edgehog_ft_file_read_cbks_t *file_cbks
         = (const edgehog_ft_file_read_cbks_t *) data->file_cbks;
     edgehog_result_t eres = EDGEHOG_RESULT_OK;
-    uint8_t *chunk_data = NULL;
     size_t chunk_size = 0;
     bool last_chunk = true;
 
-    // No maximum read in this case, leave it to the file read backend to limit the chunk size
-    size_t max_read = SIZE_MAX;
+    // Zero-copy path: backends serving memory-mapped content yield a span pointing directly
+    // into the mapped region, skipping both the transmit buffer and the copy
+    if (file_cbks->file_read_span) {
+        const uint8_t *span = NULL;
+        eres = file_cbks->file_read_span(
+            data->file_cbks_ctx, &span, UPLOAD_DIRECT_SPAN_SIZE, &chunk_size, &last_chunk);
+        if (eres != EDGEHOG_RESULT_OK) {
+            data->posix_errno = EIO;
+            data->message = "Failed to read span from storage";
+            return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+        }
+        if (span) {
+            edgehog_ft_update_progress(data, chunk_size, last_chunk);
+
+            payload_chunk->chunk_start_addr = (uint8_t *) span;
+            payload_chunk->chunk_size = chunk_size;
+            payload_chunk->last_chunk = last_chunk;
+
+            return EDGEHOG_RESULT_OK;
+        }
+    }
+
+    // The read backend fills the transmit buffer directly, no intermediate copy is required
     eres = file_cbks->file_read_chunk(
-        data->file_cbks_ctx, max_read, &chunk_data, &chunk_size, &last_chunk);
+        data->file_cbks_ctx, upload_read_buf, sizeof(upload_read_buf), &chunk_size, &last_chunk);
     if (eres != EDGEHOG_RESULT_OK) {
         data->posix_errno = EIO;
         data->message = "Failed to read chunk from storage";
@@ -422,7 +641,7 @@ static edgehog_result_t process_uncompressed_upload_chunk(
 
     edgehog_ft_update_progress(data, chunk_size, last_chunk);
 
-    payload_chunk->chunk_start_addr = chunk_data;
+    payload_chunk->chunk_start_addr = upload_read_buf;
     payload_chunk->chunk_size = chunk_size;
     payload_chunk->last_chunk = last_chunk;
 
@@ -437,5 +656,10 @@ const edgehog_ft_file_read_cbks_t *get_callbacks(enum edgehog_ft_location_type s
     } else if (source_type == EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM) {
         file_cbks = &edgehog_ft_filesystem_read_cbks;
     }
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION
+    else if (source_type == EDGEHOG_FT_LOCATION_TYPE_PARTITION) {
+        file_cbks = &edgehog_ft_partition_read_cbks;
+    }
+#endif
     return file_cbks;
 }
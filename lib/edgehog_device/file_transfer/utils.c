@@ -44,9 +44,30 @@ EDGEHOG_LOG_MODULE_REGISTER(file_transfer_utils, CONFIG_EDGEHOG_DEVICE_FILE_TRAN
 #define CONTENT_TYPE_DEVICE_TO_SERVER "device_to_server"
 
 #define PROGRESS_REPORT_INTERVAL_PERCENT 5
-#define PROGRESS_REPORT_INTERVAL_BYTES (256 * 1024)
+#define PROGRESS_REPORT_INTERVAL_BYTES CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PROGRESS_MIN_BYTES
+#define PROGRESS_REPORT_INTERVAL_MS CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PROGRESS_MIN_INTERVAL_MS
 #define PROGRESS_ONE_HUNDRED_PERCENT 100
 
+#define FT_CTX_BLOCK_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE
+#define FT_CTX_BLOCK_COUNT CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_COUNT
+#define FT_CTX_BLOCK_ALIGN 8
+
+BUILD_ASSERT(sizeof(edgehog_ft_http_cbk_data_t) <= FT_CTX_BLOCK_SIZE,
+    "The HTTP callback data doesn't fit a per-transfer context slab block");
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+K_MEM_SLAB_DEFINE_STATIC(ft_ctx_slab, FT_CTX_BLOCK_SIZE, FT_CTX_BLOCK_COUNT, FT_CTX_BLOCK_ALIGN);
+
+#define FT_MSG_BLOCK_SIZE CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_MSG_BLOCK_SIZE
+/** @brief One block per queue slot on each lane plus the request being served on each lane. */
+#define FT_MSG_BLOCK_COUNT                                                                         \
+    ((CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_QUEUE_SIZE + 1) * EDGEHOG_FT_LANE_COUNT)
+
+// Statically allocated pool of request message envelopes, each block holds every string of one
+// transfer request so accepting it is a single pool grab in Astarte callback context
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+K_MEM_SLAB_DEFINE_STATIC(ft_msg_slab, FT_MSG_BLOCK_SIZE, FT_MSG_BLOCK_COUNT, sizeof(char *));
+
 /**
  * @brief Temporary structure to hold parsed HTTP headers.
  * @details Used during the parsing of Astarte endpoints to keep track of the HTTP header keys,
@@ -70,13 +91,12 @@ typedef struct
 
 static void parse_endpoint_value(const char *path, const astarte_data_t *rx_value,
     edgehog_ft_msg_t *tmp, parsed_http_headers_t *headers);
-static char **serialize_http_headers(
-    const char *keys[], size_t keys_size, const char *values[], size_t values_size);
+static edgehog_result_t msg_arena_copy_in(
+    edgehog_ft_msg_t *tmp, const parsed_http_headers_t *headers);
+static char *arena_copy_string(char **cursor, const char *src);
 static enum edgehog_ft_encoding parse_encoding_string(const char *string);
 static enum edgehog_ft_location_type parse_location_type_string(const char *string);
-static void free_http_headers(char *header_fields[]);
 static void progress_work_handler(struct k_work *work);
-static char *duplicate_string(const char *src);
 
 /************************************************
  *         Global functions definitions         *
@@ -120,17 +140,6 @@ edgehog_result_t edgehog_ft_msg_init(astarte_object_entry_t *rx_values, size_t r
         goto failure;
     }
 
-    if (parsed_http_headers.keys && parsed_http_headers.values) {
-        tmp.http_headers
-            = serialize_http_headers(parsed_http_headers.keys, parsed_http_headers.keys_len,
-                parsed_http_headers.values, parsed_http_headers.values_len);
-        if (!tmp.http_headers) {
-            EDGEHOG_LOG_ERR("Serialization of the HTTP headers failed");
-            eres = EDGEHOG_RESULT_FILE_TRANSFER_INVALID_REQUEST;
-            goto failure;
-        }
-    }
-
     if ((tmp.encoding != EDGEHOG_FT_ENCODING_NONE)
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
         && (tmp.encoding != EDGEHOG_FT_ENCODING_LZ4)
@@ -161,6 +170,13 @@ edgehog_result_t edgehog_ft_msg_init(astarte_object_entry_t *rx_values, size_t r
     }
 #endif
 
+    // Up to here every string in tmp is borrowed from the event data. Copy them all into a
+    // single pool block with one grab, the message owns the block from this point on.
+    eres = msg_arena_copy_in(&tmp, &parsed_http_headers);
+    if (eres != EDGEHOG_RESULT_OK) {
+        goto failure;
+    }
+
     char id_str[UUID_STR_LEN] = { 0 };
     uuid_to_string(&tmp.id, id_str);
     EDGEHOG_LOG_DBG("FT msg - ID: %s, URL: %s, LocType: %d, Loc: %s, Enc: %d, Size: %lld, "
@@ -179,22 +195,46 @@ failure:
 
 void edgehog_ft_msg_destroy(edgehog_ft_msg_t *msg)
 {
-    k_free(msg->url);
+    // Every string of the message lives in a single pool block, released in one go. A message
+    // that failed before the copy-in only holds borrowed pointers and no block.
+    if (msg->arena) {
+        k_mem_slab_free(&ft_msg_slab, msg->arena);
+        msg->arena = NULL;
+    }
     msg->url = NULL;
-    k_free(msg->digest);
     msg->digest = NULL;
-    if (msg->http_headers) {
-        free_http_headers(msg->http_headers);
-        msg->http_headers = NULL;
-    }
-    k_free(msg->location);
+    msg->http_headers = NULL;
     msg->location = NULL;
 }
 
+void *edgehog_ft_ctx_alloc(size_t size)
+{
+    if (size > FT_CTX_BLOCK_SIZE) {
+        EDGEHOG_LOG_ERR("Context object of %zu bytes exceeds the slab block size", size);
+        return NULL;
+    }
+
+    void *block = NULL;
+    if (k_mem_slab_alloc(&ft_ctx_slab, &block, K_NO_WAIT) != 0) {
+        EDGEHOG_LOG_ERR("Per-transfer context slab exhausted");
+        return NULL;
+    }
+
+    memset(block, 0, size);
+    return block;
+}
+
+void edgehog_ft_ctx_free(void *obj)
+{
+    if (obj) {
+        k_mem_slab_free(&ft_ctx_slab, obj);
+    }
+}
+
 edgehog_ft_http_cbk_data_t *edgehog_ft_http_cbk_data_new(edgehog_device_handle_t edgehog_device,
     edgehog_ft_msg_t *msg, const void *file_cbks, void *file_cbks_ctx)
 {
-    edgehog_ft_http_cbk_data_t *data = k_calloc(1, sizeof(edgehog_ft_http_cbk_data_t));
+    edgehog_ft_http_cbk_data_t *data = edgehog_ft_ctx_alloc(sizeof(edgehog_ft_http_cbk_data_t));
     if (!data) {
         return NULL;
     }
@@ -209,6 +249,7 @@ edgehog_ft_http_cbk_data_t *edgehog_ft_http_cbk_data_new(edgehog_device_handle_t
     data->transferred_bytes = 0;
     data->total_bytes = msg->file_size_bytes;
     data->last_reported_bytes = ATOMIC_INIT(0);
+    data->last_reported_ms = ATOMIC_INIT((atomic_val_t) k_uptime_get_32());
 
     k_work_init(&data->progress_work, progress_work_handler);
     return data;
@@ -220,7 +261,7 @@ void edgehog_ft_http_cbk_data_destroy(edgehog_ft_http_cbk_data_t *data)
         struct k_work_sync sync;
         k_work_flush(&data->progress_work, &sync);
     }
-    k_free(data);
+    edgehog_ft_ctx_free(data);
 }
 
 void edgehog_ft_update_progress(
@@ -230,28 +271,37 @@ void edgehog_ft_update_progress(
         return;
     }
 
-    size_t last_reported_bytes = atomic_get(&data->last_reported_bytes);
+    atomic_val_t last_reported_bytes = atomic_get(&data->last_reported_bytes);
     data->transferred_bytes += chunk_size;
-    bool should_report = false;
-
-    if (data->total_bytes > 0) {
-        size_t current_percent
-            = (data->transferred_bytes * PROGRESS_ONE_HUNDRED_PERCENT) / data->total_bytes;
-        size_t last_percent
-            = (last_reported_bytes * PROGRESS_ONE_HUNDRED_PERCENT) / data->total_bytes;
-
-        if (current_percent >= last_percent + PROGRESS_REPORT_INTERVAL_PERCENT || last_chunk) {
-            should_report = true;
+    bool should_report = last_chunk;
+
+    if (!should_report) {
+        if (data->total_bytes > 0) {
+            size_t current_percent
+                = (data->transferred_bytes * PROGRESS_ONE_HUNDRED_PERCENT) / data->total_bytes;
+            size_t last_percent
+                = ((size_t) last_reported_bytes * PROGRESS_ONE_HUNDRED_PERCENT) / data->total_bytes;
+
+            should_report = current_percent >= last_percent + PROGRESS_REPORT_INTERVAL_PERCENT;
+        } else {
+            should_report = data->transferred_bytes
+                >= (size_t) last_reported_bytes + PROGRESS_REPORT_INTERVAL_BYTES;
         }
-    } else {
-        if (data->transferred_bytes >= last_reported_bytes + PROGRESS_REPORT_INTERVAL_BYTES
-            || last_chunk) {
-            should_report = true;
+
+        // Coalesce bursts of threshold crossings, the final report always goes through.
+        uint32_t now_ms = k_uptime_get_32();
+        uint32_t elapsed_ms = now_ms - (uint32_t) atomic_get(&data->last_reported_ms);
+        if (should_report && elapsed_ms < PROGRESS_REPORT_INTERVAL_MS) {
+            should_report = false;
         }
     }
 
-    if (should_report) {
-        atomic_set(&data->last_reported_bytes, (atomic_val_t) data->transferred_bytes);
+    // The compare-and-swap makes the submission check lock-free: of any concurrent callers
+    // crossing the same threshold, only the one that wins the swap submits the work item.
+    if (should_report
+        && atomic_cas(&data->last_reported_bytes, last_reported_bytes,
+            (atomic_val_t) data->transferred_bytes)) {
+        atomic_set(&data->last_reported_ms, (atomic_val_t) k_uptime_get_32());
         k_work_submit(&data->progress_work);
     }
 }
@@ -363,7 +413,7 @@ static void parse_endpoint_value(const char *path, const astarte_data_t *rx_valu
     }
     if (strcmp(path, ENDPOINT_URL) == 0
         && astarte_data_to_string(*rx_value, &tmp_string) == ASTARTE_RESULT_OK) {
-        tmp->url = duplicate_string(tmp_string);
+        tmp->url = (char *) tmp_string;
         return;
     }
     if (strcmp(path, ENDPOINT_HTTP_HEADER_KEYS) == 0) {
@@ -386,7 +436,7 @@ static void parse_endpoint_value(const char *path, const astarte_data_t *rx_valu
     }
     if (strcmp(path, ENDPOINT_DIGEST) == 0
         && astarte_data_to_string(*rx_value, &tmp_string) == ASTARTE_RESULT_OK) {
-        tmp->digest = duplicate_string(tmp_string);
+        tmp->digest = (char *) tmp_string;
         return;
     }
     if (is_ser_to_dev && strcmp(path, ENDPOINT_FILE_SIZE_BYTES) == 0
@@ -401,59 +451,89 @@ static void parse_endpoint_value(const char *path, const astarte_data_t *rx_valu
     }
     if (strcmp(path, loc_key) == 0
         && astarte_data_to_string(*rx_value, &tmp_string) == ASTARTE_RESULT_OK) {
-        tmp->location = duplicate_string(tmp_string);
+        tmp->location = (char *) tmp_string;
         return;
     }
 }
 
-static char **serialize_http_headers(
-    const char *keys[], size_t keys_size, const char *values[], size_t values_size)
+static edgehog_result_t msg_arena_copy_in(
+    edgehog_ft_msg_t *tmp, const parsed_http_headers_t *headers)
 {
-    if (!keys || !values) {
-        EDGEHOG_LOG_WRN("Serializing HTTP headers without providing the appropriate buffers");
-        return NULL;
+    // Compute the full envelope size upfront: the array of header string pointers (+1 for the
+    // NULL terminator), every formatted header string and the request strings
+    size_t num_headers = 0;
+    size_t header_ptrs_size = 0;
+    size_t arena_size = 0;
+    if (headers->keys || headers->values) {
+        if (!headers->keys || !headers->values || (headers->keys_len != headers->values_len)) {
+            EDGEHOG_LOG_WRN("Serializing HTTP headers with mismatched keys and values");
+            return EDGEHOG_RESULT_FILE_TRANSFER_INVALID_REQUEST;
+        }
+        num_headers = headers->keys_len;
+        header_ptrs_size = (num_headers + 1) * sizeof(char *);
+        arena_size += header_ptrs_size;
+        for (size_t i = 0; i < num_headers; i++) {
+            if (!headers->keys[i] || !headers->values[i]) {
+                EDGEHOG_LOG_WRN("Null pointer encountered in header keys or values");
+                return EDGEHOG_RESULT_FILE_TRANSFER_INVALID_REQUEST;
+            }
+            // Each header string holds key + value + ": " + "\r\n" + NULL
+            arena_size += strlen(headers->keys[i]) + strlen(headers->values[i]) + sizeof(": \r\n");
+        }
     }
-    if (keys_size != values_size) {
-        EDGEHOG_LOG_WRN("Serializing HTTP headers with different sizes");
-        return NULL;
+    arena_size += strlen(tmp->url) + 1;
+    arena_size += strlen(tmp->location) + 1;
+    if (tmp->digest) {
+        arena_size += strlen(tmp->digest) + 1;
     }
-    size_t num_headers = values_size;
 
-    // Dynamically allocate the array of string pointers (+1 for the NULL terminator)
-    char **out = (char **) k_calloc(num_headers + 1, sizeof(char *));
-    if (!out) {
-        EDGEHOG_LOG_WRN("Failed to allocate memory for HTTP headers array");
-        return NULL;
+    if (arena_size > FT_MSG_BLOCK_SIZE) {
+        EDGEHOG_LOG_ERR(
+            "Transfer request strings of %zu bytes exceed the message block size", arena_size);
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
 
-    // If empty array
-    if (num_headers == 0) {
-        out[0] = NULL;
-        return out;
+    void *block = NULL;
+    if (k_mem_slab_alloc(&ft_msg_slab, &block, K_NO_WAIT) != 0) {
+        EDGEHOG_LOG_ERR("Transfer request message pool exhausted");
+        return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
 
-    for (size_t i = 0; i < num_headers; i++) {
-        if (!keys[i] || !values[i]) {
-            EDGEHOG_LOG_WRN("Null pointer encountered in header keys or values");
-            free_http_headers(out);
-            return NULL;
-        }
-
-        // Calculate required output string size (key + value + ": " + "\r\n" + NULL)
-        size_t needed = strlen(keys[i]) + strlen(values[i]) + sizeof(": \r\n");
-        out[i] = k_calloc(needed, sizeof(char));
-        if (!out[i]) {
-            EDGEHOG_LOG_WRN("Failed to allocate memory for file transfer http headers");
-            free_http_headers(out);
-            return NULL;
+    // The header pointer array sits at the block start where its alignment is guaranteed, the
+    // strings are bump-pointer copied right after it
+    char *cursor = (char *) block + header_ptrs_size;
+    if (num_headers > 0) {
+        char **header_ptrs = (char **) block;
+        for (size_t i = 0; i < num_headers; i++) {
+            size_t needed
+                = strlen(headers->keys[i]) + strlen(headers->values[i]) + sizeof(": \r\n");
+            // NOLINTNEXTLINE(cert-err33-c)
+            snprintf(cursor, needed, "%s: %s\r\n", headers->keys[i], headers->values[i]);
+            header_ptrs[i] = cursor;
+            cursor += needed;
         }
+        header_ptrs[num_headers] = NULL;
+        tmp->http_headers = header_ptrs;
+    }
 
-        // NOLINTNEXTLINE(cert-err33-c)
-        snprintf(out[i], needed, "%s: %s\r\n", keys[i], values[i]);
+    tmp->url = arena_copy_string(&cursor, tmp->url);
+    tmp->location = arena_copy_string(&cursor, tmp->location);
+    if (tmp->digest) {
+        tmp->digest = arena_copy_string(&cursor, tmp->digest);
     }
 
-    out[num_headers] = NULL;
-    return out;
+    tmp->arena = block;
+    return EDGEHOG_RESULT_OK;
+}
+
+static char *arena_copy_string(char **cursor, const char *src)
+{
+    // Length including the null terminator
+    size_t size = strlen(src) + 1;
+    char *dest = *cursor;
+    memcpy(dest, src, size);
+    *cursor += size;
+    return dest;
 }
 
 static enum edgehog_ft_encoding parse_encoding_string(const char *string)
@@ -481,17 +561,12 @@ static enum edgehog_ft_location_type parse_location_type_string(const char *stri
     if (strcmp(string, "streaming") == 0) {
         return EDGEHOG_FT_LOCATION_TYPE_STREAMING;
     }
-    return EDGEHOG_FT_LOCATION_TYPE_UNSUPPORTED;
-}
-
-static void free_http_headers(char *header_fields[])
-{
-    if (header_fields) {
-        for (size_t i = 0; header_fields[i] != NULL; i++) {
-            k_free(header_fields[i]);
-        }
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_PARTITION
+    if (strcmp(string, "partition") == 0) {
+        return EDGEHOG_FT_LOCATION_TYPE_PARTITION;
     }
-    k_free((void *) header_fields);
+#endif
+    return EDGEHOG_FT_LOCATION_TYPE_UNSUPPORTED;
 }
 
 static void progress_work_handler(struct k_work *work)
@@ -527,22 +602,9 @@ static void progress_work_handler(struct k_work *work)
         return;
     }
 
-    EDGEHOG_LOG_INF("File transfer ID %s progress: %lld / %lld bytes", id_str, bytes, total_bytes);
+    // One progress publish per threshold crossing can still be frequent on fast links, keep the
+    // informational line throttled as well
+    EDGEHOG_LOG_INF_THROTTLED(
+        "File transfer ID %s progress: %lld / %lld bytes", id_str, bytes, total_bytes);
 }
 
-static char *duplicate_string(const char *src)
-{
-    if (!src) {
-        return NULL;
-    }
-
-    // length including the null terminator
-    size_t len = strlen(src) + 1;
-    char *dest = k_malloc(len);
-
-    if (dest) {
-        memcpy(dest, src, len);
-    }
-
-    return dest;
-}
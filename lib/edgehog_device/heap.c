@@ -0,0 +1,94 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "heap.h"
+
+#include "edgehog_device/heap.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/mem_stats.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(edgehog_heap, CONFIG_EDGEHOG_DEVICE_HEAP_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_HEAP_DEFINE(edgehog_heap, CONFIG_EDGEHOG_DEVICE_HEAP_SIZE);
+static atomic_t failed_allocations;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+#endif
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void *edgehog_malloc(size_t size)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP
+    void *ptr = k_heap_alloc(&edgehog_heap, size, K_NO_WAIT);
+    if (!ptr) {
+        atomic_inc(&failed_allocations);
+        EDGEHOG_LOG_WRN("Edgehog heap exhausted allocating %zu bytes", size);
+    }
+    return ptr;
+#else
+    return malloc(size);
+#endif
+}
+
+void *edgehog_calloc(size_t num, size_t size)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP
+    void *ptr = k_heap_calloc(&edgehog_heap, num, size, K_NO_WAIT);
+    if (!ptr) {
+        atomic_inc(&failed_allocations);
+        EDGEHOG_LOG_WRN("Edgehog heap exhausted allocating %zu bytes", num * size);
+    }
+    return ptr;
+#else
+    return calloc(num, size);
+#endif
+}
+
+void edgehog_free(void *ptr)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP
+    k_heap_free(&edgehog_heap, ptr);
+#else
+    free(ptr);
+#endif
+}
+
+edgehog_result_t edgehog_heap_stats_get(edgehog_heap_stats_t *stats)
+{
+    if (!stats) {
+        EDGEHOG_LOG_ERR("Unable to get heap statistics, stats undefined");
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP
+    struct sys_memory_stats runtime_stats = { 0 };
+    int ret = sys_heap_runtime_stats_get(&edgehog_heap.heap, &runtime_stats);
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR("Unable to get heap statistics, error %d", ret);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    stats->allocated_bytes = runtime_stats.allocated_bytes;
+    stats->free_bytes = runtime_stats.free_bytes;
+    stats->max_allocated_bytes = runtime_stats.max_allocated_bytes;
+    stats->failed_allocations = (uint32_t) atomic_get(&failed_allocations);
+    return EDGEHOG_RESULT_OK;
+#else
+    return EDGEHOG_RESULT_NOT_SUPPORTED;
+#endif
+}
@@ -6,6 +6,9 @@
 
 #include "http.h"
 
+#include "heap.h"
+#include "trace.h"
+
 #include <zephyr/kernel.h>
 #include <zephyr/net/http/client.h>
 #include <zephyr/net/http/parser.h>
@@ -37,6 +40,14 @@ struct request_cbk_ctx
     edgehog_http_payload_cbk_t payload_cbk;
     /** @brief Callback for a the response event of an HTTP request. */
     edgehog_http_response_cbk_t response_cbk;
+    /** @brief Wrap each uploaded chunk with HTTP chunked transfer encoding. */
+    bool chunked;
+    /** @brief True once a 2xx status code has been captured, later fragments skip the check. */
+    bool status_validated;
+    /** @brief True once the first response byte of the request has been traced. */
+    bool first_byte_traced;
+    /** @brief Total body bytes received for the request. */
+    size_t rx_bytes;
     /** @brief User data passed to callback functions. */
     void *user_data;
 };
@@ -52,8 +63,12 @@ struct request_data
     const char **header_fields;
     /** @brief Length of the payload. */
     size_t payload_len;
+    /** @brief Use HTTP chunked transfer encoding for the payload. */
+    bool chunked;
     /** @brief Timeout to use for the HTTP operations in ms. */
     int32_t timeout_ms;
+    /** @brief Socket tuning profile for the request. */
+    edgehog_http_profile_t profile;
     /** @brief Internal Zephyr callback for processing payload uploads. */
     http_payload_cb_t payload_cbk;
     /** @brief Internal Zephyr callback for processing HTTP responses. */
@@ -65,10 +80,121 @@ struct request_data
 #define PORT_STR_LEN 6
 #define HTTPS_STR "https"
 #define HTTPS_STR_LEN sizeof(HTTPS_STR)
+/** @brief Buffer size for the hostname extracted from a request URL, covers a full DNS name. */
+#define HTTP_HOST_BUF_SIZE 256
+
+#ifndef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
+// While the file transfer is optional the OTA is mandatory, so the OTA HTTPs
+// certificate will always be set.
+static const sec_tag_t http_sec_tags[] = {
+    CONFIG_EDGEHOG_DEVICE_OTA_HTTPS_CA_CERT_TAG,
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG
+    CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG,
+#endif
+};
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+/** @brief Buffer size for the hostname of the cached connection. */
+#define HTTP_CACHED_HOST_BUF_SIZE 128
+
+/** @brief Cached connection kept open across requests to the same host and port. */
+struct connection_cache
+{
+    /** @brief Cached connected socket, -1 when the cache is empty. */
+    int sock;
+    /** @brief Hostname the cached socket is connected to. */
+    char host[HTTP_CACHED_HOST_BUF_SIZE];
+    /** @brief Port the cached socket is connected to. */
+    char port[PORT_STR_LEN];
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static K_MUTEX_DEFINE(connection_cache_mutex);
+static struct connection_cache connection_cache = { .sock = -1 };
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+/** @brief Buffer size for the hostname of the cached DNS record. */
+#define HTTP_DNS_CACHE_HOST_BUF_SIZE 128
+
+/** @brief Cached DNS record reused across requests to the same host and port. */
+struct dns_cache_entry
+{
+    /** @brief Set when the entry holds a valid record. */
+    bool valid;
+    /** @brief Hostname the record has been resolved from. */
+    char host[HTTP_DNS_CACHE_HOST_BUF_SIZE];
+    /** @brief Port used when resolving the record. */
+    char port[PORT_STR_LEN];
+    /** @brief Resolved address. */
+    struct sockaddr addr;
+    /** @brief Length of the resolved address. */
+    socklen_t addrlen;
+    /** @brief Address family of the resolved address. */
+    int family;
+    /** @brief Socket type of the resolved address. */
+    int socktype;
+    /** @brief Expiration time of the record. */
+    k_timepoint_t expiry;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static K_MUTEX_DEFINE(dns_cache_mutex);
+static struct dns_cache_entry dns_cache;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_URL_CACHE
+/** @brief Cached URL parse results reused across requests to the same URL.
+ * @details Zephyr's http_client re-initializes its own parser internally on every request, so
+ * the reusable context covers the per-request setup the SDK layer owns: URL parsing, host and
+ * port extraction and path assembly. */
+struct url_parse_cache
+{
+    /** @brief Heap copy of the last parsed URL, NULL when the cache is empty. */
+    char *url;
+    /** @brief Heap copy of the assembled path with query for the cached URL. */
+    char *full_path;
+    /** @brief Hostname extracted from the cached URL. */
+    char host[HTTP_HOST_BUF_SIZE];
+    /** @brief Port extracted from the cached URL. */
+    char port[PORT_STR_LEN];
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static K_MUTEX_DEFINE(url_parse_cache_mutex);
+static struct url_parse_cache url_parse_cache;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+/** @brief Lower clamp for the derived stall window. */
+#define HTTP_ADAPTIVE_STALL_MIN_MS 2000
+/** @brief Upper clamp for the derived stall window, also used before any measurement. */
+#define HTTP_ADAPTIVE_STALL_MAX_MS 30000
+/** @brief Stall margin, receiving one buffer may take this many times the rolling average. */
+#define HTTP_ADAPTIVE_STALL_MARGIN 8
+/** @brief EMA weight denominator, a new sample contributes one part in this many. */
+#define HTTP_ADAPTIVE_EMA_WEIGHT 4
+/** @brief Requests moving fewer bytes than this do not update the rolling throughput. */
+#define HTTP_ADAPTIVE_MIN_SAMPLE_BYTES 4096
+
+// Rolling link throughput in bytes per second, zero until the first measurement
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static atomic_t http_rolling_throughput;
+#endif
 
 /** @brief Buffer size for formatting chunk length in HTTP chunked transfer encoding. */
 #define HTTP_CHUNKED_PAYLOAD_CHUNK_LENGTH_BUFFER_SIZE 32
 
+// Statically allocated pool of receive buffers, one per concurrent HTTP request. Keeps the
+// hot request path free of heap allocations.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+K_MEM_SLAB_DEFINE_STATIC(http_recv_buf_slab, CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE,
+    CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_POOL_COUNT, sizeof(void *));
+
 /************************************************
  *         Static functions declaration         *
  ***********************************************/
@@ -79,9 +205,60 @@ struct request_data
  *
  * @param[in] host domain name, a string representation of an IPv4.
  * @param[in] port service port, a string representation of HTTP service port.
+ * @param[in] profile Socket tuning profile for the request.
  * @return -1 upon failure, a file descriptor for the new socket otherwise.
  */
-static int create_and_connect_socket(const char *host, const char *port);
+static int create_and_connect_socket(
+    const char *host, const char *port, edgehog_http_profile_t profile);
+
+/**
+ * @brief Create a socket, apply the transport options and connect it to a resolved address.
+ *
+ * @param[in] hostname domain name, used for the TLS hostname verification.
+ * @param[in] family Address family of the resolved address.
+ * @param[in] socktype Socket type of the resolved address.
+ * @param[in] addr The resolved address to connect to.
+ * @param[in] addrlen Length of the resolved address.
+ * @param[in] profile Socket tuning profile for the request.
+ * @return -1 upon failure, a file descriptor for the new socket otherwise.
+ */
+static int socket_connect_addr(const char *hostname, int family, int socktype,
+    const struct sockaddr *addr, socklen_t addrlen, edgehog_http_profile_t profile);
+
+/**
+ * @brief Get a socket connected to a server, reusing a cached keep-alive connection when possible.
+ *
+ * @param[in] host domain name, a string representation of an IPv4.
+ * @param[in] port service port, a string representation of HTTP service port.
+ * @param[in] profile Socket tuning profile for the request.
+ * @param[out] reused Set to true when a cached connection has been reused.
+ * @return -1 upon failure, a file descriptor for the socket otherwise.
+ */
+static int acquire_connected_socket(
+    const char *host, const char *port, edgehog_http_profile_t profile, bool *reused);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING
+/**
+ * @brief Apply the tuning profile of a request to its socket.
+ *
+ * @note Must run before connecting, the receive buffer size caps the TCP window the stack
+ * advertises during the handshake.
+ *
+ * @param[in] sock The socket descriptor to configure.
+ * @param[in] profile Socket tuning profile for the request.
+ */
+static void http_socket_apply_tuning(int sock, edgehog_http_profile_t profile);
+#endif
+
+/**
+ * @brief Return a socket after a request, caching it for reuse or closing it.
+ *
+ * @param[in] sock The connected socket descriptor.
+ * @param[in] host domain name the socket is connected to.
+ * @param[in] port service port the socket is connected to.
+ * @param[in] keep True when the connection completed cleanly and can be reused.
+ */
+static void release_connected_socket(int sock, const char *host, const char *port, bool keep);
 
 /**
  * @brief Configures, initiates, and manages an HTTP request (GET or PUT).
@@ -91,6 +268,54 @@ static int create_and_connect_socket(const char *host, const char *port);
  */
 static edgehog_result_t perform_request(struct request_data *data);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_URL_CACHE
+/**
+ * @brief Fetch the parse results cached for a URL.
+ *
+ * @param[in] url The request URL to look up.
+ * @param[out] host Buffer of HTTP_HOST_BUF_SIZE bytes receiving the cached hostname on a hit.
+ * @param[out] port Buffer of PORT_STR_LEN bytes receiving the cached port on a hit.
+ * @param[out] full_path Set to a heap copy of the cached path on a hit, owned by the caller.
+ * Left untouched on a miss.
+ */
+static void url_parse_cache_lookup(const char *url, char *host, char *port, char **full_path);
+
+/**
+ * @brief Store the parse results of a URL, replacing the previously cached entry.
+ *
+ * @param[in] url The parsed request URL.
+ * @param[in] host The hostname extracted from the URL.
+ * @param[in] port The port extracted from the URL.
+ * @param[in] full_path The assembled path with query for the URL.
+ */
+static void url_parse_cache_store(
+    const char *url, const char *host, const char *port, const char *full_path);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+/**
+ * @brief Fold the outcome of a completed request into the rolling throughput.
+ *
+ * @param[in] bytes Body bytes moved by the request.
+ * @param[in] duration_ms Duration of the request in milliseconds.
+ */
+static void http_adaptive_record(size_t bytes, int64_t duration_ms);
+
+/**
+ * @brief Derive the stall window from the rolling throughput.
+ *
+ * @return The stall window in milliseconds, clamped between the configured bounds.
+ */
+static int32_t http_adaptive_stall_window_ms(void);
+
+/**
+ * @brief Apply the derived stall window as receive and send timeouts on a socket.
+ *
+ * @param[in] sock The socket descriptor to configure.
+ */
+static void http_adaptive_apply_stall_timeouts(int sock);
+#endif
+
 /**
  * @brief Helper function to reliably send all bytes of a buffer over a socket.
  *
@@ -100,6 +325,19 @@ static edgehog_result_t perform_request(struct request_data *data);
  * @return The total number of bytes sent, or -1 on error.
  */
 static int send_buffer_fully(int sock, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Helper function to reliably send a scatter-gather list of buffers over a socket.
+ *
+ * @note The entries of the list are adjusted in place to track partial sends.
+ *
+ * @param sock The connected socket descriptor.
+ * @param iov Scatter-gather list of buffers to send.
+ * @param iov_cnt Number of entries in the list.
+ * @return The total number of bytes sent, or -1 on error.
+ */
+static int send_iovec_fully(int sock, struct iovec *iov, size_t iov_cnt);
+
 /**
  * @brief Helper function to build the full path (including query) from a parsed URL.
  *
@@ -127,7 +365,8 @@ static edgehog_result_t build_full_path(
 static int get_response_cbk(
     struct http_response *rsp, enum http_final_call final_data, void *user_data)
 {
-    EDGEHOG_LOG_DBG("get_response_cbk called. Status: %s (%d), Fragment len: %zu",
+    // Called once per received fragment, keep the per-fragment logging throttled
+    EDGEHOG_LOG_DBG_THROTTLED("get_response_cbk called. Status: %s (%d), Fragment len: %zu",
         rsp->http_status ? rsp->http_status : "N/A", rsp->http_status_code, rsp->body_frag_len);
 
     if (!user_data) {
@@ -137,30 +376,42 @@ static int get_response_cbk(
 
     struct request_cbk_ctx *ctx = (struct request_cbk_ctx *) user_data;
 
-    // Evaluate the status code if it has been parsed
-    if ((rsp->http_status_code < HTTP_200_OK)
-        || (rsp->http_status_code >= HTTP_300_MULTIPLE_CHOICES)) {
-        EDGEHOG_LOG_ERR(
-            "HTTP request failed, response code: %s (%d)", rsp->http_status, rsp->http_status_code);
-        ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
-        return -1;
+    if (!ctx->first_byte_traced) {
+        ctx->first_byte_traced = true;
+        EDGEHOG_TRACE(EDGEHOG_TRACE_HTTP_FIRST_BYTE);
+    }
+
+    ctx->rx_bytes += rsp->body_frag_len;
+
+    // Evaluate the status code if it has been parsed. Once a success code has been captured the
+    // later fragments of the same response skip the re-evaluation.
+    if (!ctx->status_validated) {
+        if ((rsp->http_status_code < HTTP_200_OK)
+            || (rsp->http_status_code >= HTTP_300_MULTIPLE_CHOICES)) {
+            EDGEHOG_LOG_ERR("HTTP request failed, response code: %s (%d)", rsp->http_status,
+                rsp->http_status_code);
+            ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+            return -1;
+        }
+        ctx->status_validated = true;
     }
 
     edgehog_http_response_chunk_t http_response_chunk = { 0 };
     if (rsp->body_found) {
-        EDGEHOG_LOG_DBG("Processing body fragment of size %zu.", rsp->body_frag_len);
+        EDGEHOG_LOG_DBG_THROTTLED("Processing body fragment of size %zu.", rsp->body_frag_len);
         http_response_chunk.chunk_start_addr = rsp->body_frag_start;
         http_response_chunk.chunk_size = rsp->body_frag_len;
     } else {
         EDGEHOG_LOG_DBG("Empty body found in HTTP response chunk");
     }
     http_response_chunk.response_size = rsp->content_length;
+    http_response_chunk.status_code = rsp->http_status_code;
     http_response_chunk.last_chunk = (final_data == HTTP_DATA_FINAL);
 
     if (final_data == HTTP_DATA_FINAL) {
         EDGEHOG_LOG_DBG("All HTTP data received for this response.");
     } else {
-        EDGEHOG_LOG_DBG("Awaiting more HTTP data...");
+        EDGEHOG_LOG_DBG_THROTTLED("Awaiting more HTTP data...");
     }
 
     ctx->result = ctx->response_cbk(&http_response_chunk, ctx->user_data);
@@ -236,13 +487,37 @@ static int put_payload_cbk(int sock, struct http_request * /*req*/, void *user_d
             return -EIO;
         }
 
-        EDGEHOG_LOG_DBG("Retrieved payload chunk from user callback. Size: %zu, Last chunk: %d",
+        // Runs once per uploaded chunk, keep the per-chunk logging throttled
+        EDGEHOG_LOG_DBG_THROTTLED(
+            "Retrieved payload chunk from user callback. Size: %zu, Last chunk: %d",
             http_payload_chunk.chunk_size, http_payload_chunk.last_chunk);
 
-        // Send the raw chunk directly to the socket without HTTP chunk wrappers
         if (http_payload_chunk.chunk_size > 0) {
-            int sent_bytes = send_buffer_fully(
-                sock, http_payload_chunk.chunk_start_addr, http_payload_chunk.chunk_size);
+            int sent_bytes = 0;
+            if (ctx->chunked) {
+                // Gather the chunk-length line, the body and the trailing CRLF in a single
+                // send operation to avoid Nagle interactions between small writes
+                char length_line[HTTP_CHUNKED_PAYLOAD_CHUNK_LENGTH_BUFFER_SIZE] = { 0 };
+                int length_line_len = snprintf(length_line, sizeof(length_line), "%zx\r\n",
+                    http_payload_chunk.chunk_size);
+                if ((length_line_len < 0) || (length_line_len >= sizeof(length_line))) {
+                    EDGEHOG_LOG_ERR("Failed formatting the chunk length line");
+                    ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+                    return -EIO;
+                }
+                char chunk_end[] = "\r\n";
+                struct iovec chunk_iov[] = {
+                    { .iov_base = length_line, .iov_len = length_line_len },
+                    { .iov_base = http_payload_chunk.chunk_start_addr,
+                        .iov_len = http_payload_chunk.chunk_size },
+                    { .iov_base = chunk_end, .iov_len = sizeof(chunk_end) - 1 },
+                };
+                sent_bytes = send_iovec_fully(sock, chunk_iov, ARRAY_SIZE(chunk_iov));
+            } else {
+                // Send the raw chunk directly to the socket without HTTP chunk wrappers
+                sent_bytes = send_buffer_fully(
+                    sock, http_payload_chunk.chunk_start_addr, http_payload_chunk.chunk_size);
+            }
             if (sent_bytes < 0) {
                 EDGEHOG_LOG_ERR("Failed to send chunk payload: %d", sent_bytes);
                 ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
@@ -250,11 +525,23 @@ static int put_payload_cbk(int sock, struct http_request * /*req*/, void *user_d
             }
             total_sent_bytes += sent_bytes;
 
-            EDGEHOG_LOG_DBG("Sent raw chunk of size %zu bytes. Total sent so far: %d",
+            EDGEHOG_LOG_DBG_THROTTLED("Sent chunk of size %zu bytes. Total sent so far: %d",
                 http_payload_chunk.chunk_size, total_sent_bytes);
         }
     }
 
+    if (ctx->chunked) {
+        char terminator[] = "0\r\n\r\n";
+        int sent_bytes
+            = send_buffer_fully(sock, (const uint8_t *) terminator, sizeof(terminator) - 1);
+        if (sent_bytes < 0) {
+            EDGEHOG_LOG_ERR("Failed to send the chunked encoding terminator: %d", sent_bytes);
+            ctx->result = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
+            return -EIO;
+        }
+        total_sent_bytes += sent_bytes;
+    }
+
     EDGEHOG_LOG_DBG("Finished sending all payload chunks. Total bytes sent: %d", total_sent_bytes);
 
     return total_sent_bytes;
@@ -274,6 +561,7 @@ edgehog_result_t edgehog_http_get(edgehog_http_get_data_t *data)
         .url = data->url,
         .header_fields = data->header_fields,
         .timeout_ms = data->timeout_ms,
+        .profile = data->profile,
         .payload_len = 0,
         .payload_cbk = NULL,
         .response_cbk = get_response_cbk,
@@ -315,13 +603,16 @@ edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
         .url = data->url,
         .header_fields = data->header_fields,
         .timeout_ms = data->timeout_ms,
-        .payload_len = data->payload_size,
+        .profile = data->profile,
+        .payload_len = data->chunked ? 0 : data->payload_size,
+        .chunked = data->chunked,
         .payload_cbk = put_payload_cbk,
         .response_cbk = put_response_cbk,
         .cbk_ctx = {
             .result = EDGEHOG_RESULT_OK,
             .payload_cbk = data->payload_cbk,
             .response_cbk = NULL,
+            .chunked = data->chunked,
             .user_data = data->user_data,
         },
     };
@@ -331,12 +622,149 @@ edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data)
     return result;
 }
 
+edgehog_result_t edgehog_http_tls_credentials_check(void)
+{
+#ifndef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
+    for (size_t i = 0; i < ARRAY_SIZE(http_sec_tags); i++) {
+        size_t credential_len = 0;
+        int ret = tls_credential_get(
+            http_sec_tags[i], TLS_CREDENTIAL_CA_CERTIFICATE, NULL, &credential_len);
+        // The zero length probe returns -EFBIG when the credential is registered
+        if (ret == -ENOENT) {
+            EDGEHOG_LOG_ERR(
+                "No CA certificate registered for security tag %d", http_sec_tags[i]);
+            return EDGEHOG_RESULT_INVALID_CONFIGURATION;
+        }
+    }
+#endif
+    return EDGEHOG_RESULT_OK;
+}
+
 /************************************************
  *         Static functions definitions         *
  ***********************************************/
 
-static int create_and_connect_socket(const char *hostname, const char *port)
+static int socket_connect_addr(const char *hostname, int family, int socktype,
+    const struct sockaddr *addr, socklen_t addrlen, edgehog_http_profile_t profile)
+{
+#ifndef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING
+    ARG_UNUSED(profile);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
+    int proto = IPPROTO_TCP;
+    EDGEHOG_LOG_DBG("Using cleartext TCP (IPPROTO_TCP)");
+#else
+    int proto = IPPROTO_TLS_1_2;
+    EDGEHOG_LOG_DBG("Using secure TLS (IPPROTO_TLS_1_2)");
+#endif
+
+    EDGEHOG_LOG_DBG(
+        "Attempting to create socket (family: %d, socktype: %d, proto: %d)", family, socktype, proto);
+
+    int sock = zsock_socket(family, socktype, proto);
+    if (sock == -1) {
+        EDGEHOG_LOG_DBG("Socket creation failed for this address...");
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Socket successfully created (fd: %d). Applying options.", sock);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_TCP_NODELAY
+    // Disable Nagle's algorithm so small upload writes are not delayed
+    EDGEHOG_LOG_DBG("Setting TCP_NODELAY option.");
+    int nodelay = 1;
+    int nodelay_rc = zsock_setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    if (nodelay_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (TCP_NODELAY): %d", nodelay_rc);
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING
+    // Applied before connecting, the receive buffer sizes the advertised TCP window
+    http_socket_apply_tuning(sock, profile);
+#endif
+
+#ifndef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
+    EDGEHOG_LOG_DBG("Setting TLS_SEC_TAG_LIST option.");
+    int sockopt_rc
+        = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, http_sec_tags, sizeof(http_sec_tags));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_ERR("Socket options error (TLS_SEC_TAG_LIST): %d", sockopt_rc);
+        zsock_close(sock);
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Setting TLS_HOSTNAME option to '%s'.", hostname);
+    sockopt_rc = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, hostname, strlen(hostname));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_ERR("Socket options error (TLS_HOSTNAME): %d", sockopt_rc);
+        zsock_close(sock);
+        return -1;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_TLS_SESSION_CACHE
+    // An abbreviated handshake on reconnection to the same server saves seconds on
+    // constrained links. A failure here is not fatal, it only costs a full handshake.
+    EDGEHOG_LOG_DBG("Setting TLS_SESSION_CACHE option.");
+    int session_cache = TLS_SESSION_CACHE_ENABLED;
+    sockopt_rc = zsock_setsockopt(
+        sock, SOL_TLS, TLS_SESSION_CACHE, &session_cache, sizeof(session_cache));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (TLS_SESSION_CACHE): %d", sockopt_rc);
+    }
+#endif
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+    // Applied before connecting so the stall window also bounds the TLS handshake
+    http_adaptive_apply_stall_timeouts(sock);
+#endif
+
+    EDGEHOG_LOG_DBG("Attempting to connect socket %d to remote address.", sock);
+    int connect_rc = zsock_connect(sock, addr, addrlen);
+    if (connect_rc == -1) {
+        EDGEHOG_LOG_DBG(
+            "Connection failed (%d -  %s), closing socket...", errno, strerror(errno));
+        zsock_close(sock);
+        return -1;
+    }
+
+    EDGEHOG_LOG_DBG("Successfully connected socket %d.", sock);
+    EDGEHOG_TRACE(EDGEHOG_TRACE_HTTP_SOCKET_CONNECTED);
+    return sock;
+}
+
+static int create_and_connect_socket(
+    const char *hostname, const char *port, edgehog_http_profile_t profile)
 {
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+    // Attempt to skip the DNS resolution using the cached address for this host and port
+    struct dns_cache_entry cached = { 0 };
+    bool cached_valid = false;
+    k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+    if (dns_cache.valid && !sys_timepoint_expired(dns_cache.expiry)
+        && (strcmp(dns_cache.host, hostname) == 0) && (strcmp(dns_cache.port, port) == 0)) {
+        cached = dns_cache;
+        cached_valid = true;
+    }
+    k_mutex_unlock(&dns_cache_mutex);
+
+    if (cached_valid) {
+        EDGEHOG_LOG_DBG("Using cached DNS record for %s:%s", hostname, port);
+        int sock = socket_connect_addr(
+            hostname, cached.family, cached.socktype, &cached.addr, cached.addrlen, profile);
+        if (sock >= 0) {
+            return sock;
+        }
+        // The cached address might be stale, invalidate it and resolve again
+        EDGEHOG_LOG_DBG("Connection to cached DNS record failed, resolving again");
+        k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+        dns_cache.valid = false;
+        k_mutex_unlock(&dns_cache_mutex);
+    }
+#endif
+
     EDGEHOG_LOG_DBG("Attempting DNS resolution for %s:%s", hostname, port);
 
     struct zsock_addrinfo hints = { 0 };
@@ -354,74 +782,39 @@ static int create_and_connect_socket(const char *hostname, const char *port)
     }
 
     EDGEHOG_LOG_DBG("DNS resolution successful. Iterating through available addresses.");
-
-#ifdef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
-    int proto = IPPROTO_TCP;
-    EDGEHOG_LOG_DBG("Using cleartext TCP (IPPROTO_TCP)");
-#else
-    int proto = IPPROTO_TLS_1_2;
-    EDGEHOG_LOG_DBG("Using secure TLS (IPPROTO_TLS_1_2)");
-#endif
+    EDGEHOG_TRACE(EDGEHOG_TRACE_HTTP_DNS_RESOLVED);
 
     int sock = -1;
     struct zsock_addrinfo *curr_addr = NULL;
 
     // Iterate through the linked list of resolved addresses
     for (curr_addr = host_addrinfo; curr_addr != NULL; curr_addr = curr_addr->ai_next) {
-        EDGEHOG_LOG_DBG("Attempting to create socket (family: %d, socktype: %d, proto: %d)",
-            curr_addr->ai_family, curr_addr->ai_socktype, proto);
-
-        sock = zsock_socket(curr_addr->ai_family, curr_addr->ai_socktype, proto);
-        if (sock == -1) {
-            EDGEHOG_LOG_DBG("Socket creation failed for this address, trying next address...");
-            continue;
-        }
-
-        EDGEHOG_LOG_DBG("Socket successfully created (fd: %d). Applying options.", sock);
-
-#ifndef CONFIG_EDGEHOG_DEVICE_DEVELOP_USE_NON_TLS_HTTP
-        // While the file transfer is optional the OTA is mandatory, so the OTA HTTPs
-        // certificate will always be set.
-        sec_tag_t sec_tag_opt[] = {
-            CONFIG_EDGEHOG_DEVICE_OTA_HTTPS_CA_CERT_TAG,
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG
-            CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HTTPS_CA_CERT_TAG,
-#endif
-        };
-
-        EDGEHOG_LOG_DBG("Setting TLS_SEC_TAG_LIST option.");
-        int sockopt_rc
-            = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt, sizeof(sec_tag_opt));
-        if (sockopt_rc == -1) {
-            EDGEHOG_LOG_ERR("Socket options error (TLS_SEC_TAG_LIST): %d", sockopt_rc);
-            zsock_close(sock);
-            sock = -1;
+        sock = socket_connect_addr(hostname, curr_addr->ai_family, curr_addr->ai_socktype,
+            curr_addr->ai_addr, curr_addr->ai_addrlen, profile);
+        if (sock < 0) {
+            EDGEHOG_LOG_DBG("Trying next address...");
             continue;
         }
 
-        EDGEHOG_LOG_DBG("Setting TLS_HOSTNAME option to '%s'.", hostname);
-        sockopt_rc = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, hostname, strlen(hostname));
-        if (sockopt_rc == -1) {
-            EDGEHOG_LOG_ERR("Socket options error (TLS_HOSTNAME): %d", sockopt_rc);
-            zsock_close(sock);
-            sock = -1;
-            continue;
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE
+        // Remember the address that worked for the next requests to this host and port
+        if ((strlen(hostname) < HTTP_DNS_CACHE_HOST_BUF_SIZE)
+            && (curr_addr->ai_addrlen <= sizeof(dns_cache.addr))) {
+            k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+            memcpy(&dns_cache.addr, curr_addr->ai_addr, curr_addr->ai_addrlen);
+            dns_cache.addrlen = curr_addr->ai_addrlen;
+            dns_cache.family = curr_addr->ai_family;
+            dns_cache.socktype = curr_addr->ai_socktype;
+            strncpy(dns_cache.host, hostname, sizeof(dns_cache.host) - 1);
+            dns_cache.host[sizeof(dns_cache.host) - 1] = '\0';
+            strncpy(dns_cache.port, port, sizeof(dns_cache.port) - 1);
+            dns_cache.port[sizeof(dns_cache.port) - 1] = '\0';
+            dns_cache.expiry = sys_timepoint_calc(
+                K_SECONDS(CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_DNS_CACHE_TTL_SECONDS));
+            dns_cache.valid = true;
+            k_mutex_unlock(&dns_cache_mutex);
         }
 #endif
-
-        EDGEHOG_LOG_DBG("Attempting to connect socket %d to remote address.", sock);
-        int connect_rc = zsock_connect(sock, curr_addr->ai_addr, curr_addr->ai_addrlen);
-        if (connect_rc == -1) {
-            EDGEHOG_LOG_DBG(
-                "Connection failed (%d -  %s), closing socket and trying next address...", errno,
-                strerror(errno));
-            zsock_close(sock);
-            sock = -1;
-            continue;
-        }
-
-        // If we reach here, we have successfully connected
-        EDGEHOG_LOG_DBG("Successfully connected socket %d.", sock);
         break;
     }
 
@@ -441,72 +834,119 @@ static edgehog_result_t perform_request(struct request_data *data)
     edgehog_result_t eres = EDGEHOG_RESULT_OK;
     EDGEHOG_LOG_DBG("Entering perform_request. Method: %d, URL: %s", data->method, data->url);
 
-    // Create and connect the socket to use
-    struct http_parser_url parser;
-    http_parser_url_init(&parser);
-    int ret = http_parser_parse_url(data->url, strlen(data->url), 0, &parser);
+    char host[HTTP_HOST_BUF_SIZE] = { 0 };
+    char port[PORT_STR_LEN] = { 0 };
+    char *full_path = NULL;
 
-    if (ret < 0) {
-        EDGEHOG_LOG_ERR("Invalid http request URL: %s %d", data->url, ret);
-        return EDGEHOG_RESULT_PARSE_URL_ERROR;
-    }
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_URL_CACHE
+    // Reuse the components parsed for the previous request when the URL is unchanged, as on
+    // retries, multi-attempt downloads and keep-alive sessions
+    url_parse_cache_lookup(data->url, host, port, &full_path);
+#endif
 
-    uint16_t host_off = parser.field_data[UF_HOST].off;
-    uint16_t host_len = parser.field_data[UF_HOST].len;
+    if (!full_path) {
+        struct http_parser_url parser;
+        http_parser_url_init(&parser);
+        int ret = http_parser_parse_url(data->url, strlen(data->url), 0, &parser);
 
-    char host[host_len + 1];
-    ret = snprintf(host, host_len + 1, "%s", data->url + host_off);
-    if (ret < 0) {
-        EDGEHOG_LOG_ERR("Error extracting hostname from URL");
-        return EDGEHOG_RESULT_PARSE_URL_ERROR;
-    }
+        if (ret < 0) {
+            EDGEHOG_LOG_ERR("Invalid http request URL: %s %d", data->url, ret);
+            return EDGEHOG_RESULT_PARSE_URL_ERROR;
+        }
 
-    char port[PORT_STR_LEN] = { 0 };
-    if (parser.port == 0) {
-        strncpy(port, strncmp("https", data->url, HTTPS_STR_LEN - 1) == 0 ? "443" : "80",
-            PORT_STR_LEN - 1);
-    } else {
-        ret = sprintf(port, "%u", parser.port);
+        uint16_t host_off = parser.field_data[UF_HOST].off;
+        uint16_t host_len = parser.field_data[UF_HOST].len;
+
+        if (host_len >= sizeof(host)) {
+            EDGEHOG_LOG_ERR("Hostname in URL is too long: %s", data->url);
+            return EDGEHOG_RESULT_PARSE_URL_ERROR;
+        }
+
+        ret = snprintf(host, host_len + 1, "%s", data->url + host_off);
         if (ret < 0) {
-            EDGEHOG_LOG_ERR("Error extracting port from URL");
+            EDGEHOG_LOG_ERR("Error extracting hostname from URL");
             return EDGEHOG_RESULT_PARSE_URL_ERROR;
         }
+
+        if (parser.port == 0) {
+            strncpy(port, strncmp("https", data->url, HTTPS_STR_LEN - 1) == 0 ? "443" : "80",
+                PORT_STR_LEN - 1);
+        } else {
+            ret = sprintf(port, "%u", parser.port);
+            if (ret < 0) {
+                EDGEHOG_LOG_ERR("Error extracting port from URL");
+                return EDGEHOG_RESULT_PARSE_URL_ERROR;
+            }
+        }
+
+        EDGEHOG_LOG_DBG("Parsed URL correctly. Host: %s, Port: %s", host, port);
+
+        edgehog_result_t path_res = build_full_path(data->url, &parser, &full_path);
+        if (path_res != EDGEHOG_RESULT_OK) {
+            return path_res;
+        }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_URL_CACHE
+        url_parse_cache_store(data->url, host, port, full_path);
+#endif
     }
 
-    EDGEHOG_LOG_DBG("Parsed URL correctly. Host: %s, Port: %s", host, port);
+    EDGEHOG_LOG_DBG("Extracted path with query: %s", full_path);
 
-    int sock = create_and_connect_socket(host, port);
+    bool sock_reused = false;
+    int sock = acquire_connected_socket(host, port, data->profile, &sock_reused);
     if (sock < 0) {
         EDGEHOG_LOG_ERR(
             "Aborting HTTP request due to socket creation/connection failure (err %d)", sock);
+        edgehog_free(full_path);
         return EDGEHOG_RESULT_NETWORK_ERROR;
     }
 
-    char *full_path = NULL;
-    edgehog_result_t path_res = build_full_path(data->url, &parser, &full_path);
-    if (path_res != EDGEHOG_RESULT_OK) {
-        zsock_close(sock);
-        return path_res;
-    }
-
-    EDGEHOG_LOG_DBG("Extracted path with query: %s", full_path);
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+    // Refresh the stall window on every request, cached keep-alive sockets keep the one
+    // derived when they were opened otherwise
+    http_adaptive_apply_stall_timeouts(sock);
+#endif
 
     // Perform the HTTP request and wait for the response
-    uint8_t *recv_buf = k_malloc(CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE);
-    if (recv_buf == NULL) {
-        EDGEHOG_LOG_ERR("Failed to allocate memory for recv_buf");
-        k_free(full_path);
+    uint8_t *recv_buf = NULL;
+    int slab_rc = k_mem_slab_alloc(&http_recv_buf_slab, (void **) &recv_buf, K_NO_WAIT);
+    if (slab_rc != 0) {
+        EDGEHOG_LOG_ERR("No free receive buffer in the HTTP buffer pool");
+        edgehog_free(full_path);
         zsock_close(sock);
         return EDGEHOG_RESULT_OUT_OF_MEMORY;
     }
     memset(recv_buf, 0, CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE);
 
+    // For a chunked upload the Transfer-Encoding header is appended to the user headers
+    const char **merged_headers = NULL;
+    if (data->chunked) {
+        size_t headers_count = 0;
+        while (data->header_fields && data->header_fields[headers_count]) {
+            headers_count++;
+        }
+        merged_headers = edgehog_malloc((headers_count + 2) * sizeof(char *));
+        if (!merged_headers) {
+            EDGEHOG_LOG_ERR("Failed to allocate memory for merged_headers");
+            k_mem_slab_free(&http_recv_buf_slab, recv_buf);
+            edgehog_free(full_path);
+            zsock_close(sock);
+            return EDGEHOG_RESULT_OUT_OF_MEMORY;
+        }
+        for (size_t i = 0; i < headers_count; i++) {
+            merged_headers[i] = data->header_fields[i];
+        }
+        merged_headers[headers_count] = "Transfer-Encoding: chunked\r\n";
+        merged_headers[headers_count + 1] = NULL;
+    }
+
     struct http_request req = { 0 };
     req.method = data->method;
     req.host = host;
     req.port = NULL;
     req.url = full_path;
-    req.header_fields = data->header_fields;
+    req.header_fields = merged_headers ? merged_headers : data->header_fields;
     req.protocol = "HTTP/1.1";
     req.payload_len = data->payload_len;
 
@@ -523,12 +963,42 @@ static edgehog_result_t perform_request(struct request_data *data)
     req.recv_buf_len = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE;
 
     EDGEHOG_LOG_DBG("Executing http_client_req on socket %d...", sock);
+    EDGEHOG_TRACE(EDGEHOG_TRACE_HTTP_REQUEST_START);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+    int64_t request_start_ms = k_uptime_get();
+#endif
 
     // Pass context struct as the user_data parameter
     int http_rc = http_client_req(sock, &req, data->timeout_ms, &data->cbk_ctx);
 
     EDGEHOG_LOG_DBG("http_client_req returned with code: %d", http_rc);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    // The server might have silently closed the cached connection, retry on a fresh one. The
+    // retry is only safe while no callback has consumed data yet: once body bytes reached the
+    // response callback, or a payload producer started streaming the upload, re-issuing the
+    // request would feed the stateful consumer the same bytes twice
+    if ((http_rc < 0) && sock_reused && (data->cbk_ctx.rx_bytes == 0) && !data->payload_cbk) {
+        EDGEHOG_LOG_DBG("Request on cached connection failed, retrying on a new connection.");
+        zsock_close(sock);
+        sock_reused = false;
+        sock = create_and_connect_socket(host, port, data->profile);
+        if (sock < 0) {
+            k_mem_slab_free(&http_recv_buf_slab, recv_buf);
+            edgehog_free(merged_headers);
+            edgehog_free(full_path);
+            return EDGEHOG_RESULT_NETWORK_ERROR;
+        }
+        data->cbk_ctx.result = EDGEHOG_RESULT_OK;
+        data->cbk_ctx.status_validated = false;
+        data->cbk_ctx.first_byte_traced = false;
+        data->cbk_ctx.rx_bytes = 0;
+        http_rc = http_client_req(sock, &req, data->timeout_ms, &data->cbk_ctx);
+        EDGEHOG_LOG_DBG("http_client_req retry returned with code: %d", http_rc);
+    }
+#endif
+
     if (http_rc < 0) {
         EDGEHOG_LOG_ERR("HTTP request failed, http error: %d", http_rc);
         eres = EDGEHOG_RESULT_HTTP_REQUEST_ERROR;
@@ -539,12 +1009,171 @@ static edgehog_result_t perform_request(struct request_data *data)
         EDGEHOG_LOG_DBG("HTTP request completed successfully.");
     }
 
-    zsock_close(sock);
-    k_free(recv_buf);
-    k_free(full_path);
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+    if (eres == EDGEHOG_RESULT_OK) {
+        http_adaptive_record(data->cbk_ctx.rx_bytes, k_uptime_get() - request_start_ms);
+    }
+#endif
+
+    release_connected_socket(sock, host, port, eres == EDGEHOG_RESULT_OK);
+    k_mem_slab_free(&http_recv_buf_slab, recv_buf);
+    edgehog_free(merged_headers);
+    edgehog_free(full_path);
     return eres;
 }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_URL_CACHE
+static void url_parse_cache_lookup(const char *url, char *host, char *port, char **full_path)
+{
+    k_mutex_lock(&url_parse_cache_mutex, K_FOREVER);
+    if (url_parse_cache.url && (strcmp(url_parse_cache.url, url) == 0)) {
+        size_t path_size = strlen(url_parse_cache.full_path) + 1;
+        char *path_copy = edgehog_malloc(path_size);
+        if (path_copy) {
+            memcpy(path_copy, url_parse_cache.full_path, path_size);
+            memcpy(host, url_parse_cache.host, HTTP_HOST_BUF_SIZE);
+            memcpy(port, url_parse_cache.port, PORT_STR_LEN);
+            *full_path = path_copy;
+            EDGEHOG_LOG_DBG("Reusing cached parse results for URL: %s", url);
+        }
+    }
+    k_mutex_unlock(&url_parse_cache_mutex);
+}
+
+static void url_parse_cache_store(
+    const char *url, const char *host, const char *port, const char *full_path)
+{
+    size_t url_size = strlen(url) + 1;
+    size_t path_size = strlen(full_path) + 1;
+    char *url_copy = edgehog_malloc(url_size);
+    char *path_copy = edgehog_malloc(path_size);
+
+    k_mutex_lock(&url_parse_cache_mutex, K_FOREVER);
+    edgehog_free(url_parse_cache.url);
+    edgehog_free(url_parse_cache.full_path);
+    url_parse_cache.url = NULL;
+    url_parse_cache.full_path = NULL;
+    if (url_copy && path_copy) {
+        memcpy(url_copy, url, url_size);
+        memcpy(path_copy, full_path, path_size);
+        url_parse_cache.url = url_copy;
+        url_parse_cache.full_path = path_copy;
+        memcpy(url_parse_cache.host, host, HTTP_HOST_BUF_SIZE);
+        memcpy(url_parse_cache.port, port, PORT_STR_LEN);
+    } else {
+        // Failing to cache only costs a reparse on the next request
+        edgehog_free(url_copy);
+        edgehog_free(path_copy);
+    }
+    k_mutex_unlock(&url_parse_cache_mutex);
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING
+static void http_socket_apply_tuning(int sock, edgehog_http_profile_t profile)
+{
+    int rcvbuf = (profile == EDGEHOG_HTTP_PROFILE_BULK)
+        ? CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_BULK_RCVBUF
+        : CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_SMALL_RCVBUF;
+    int sndbuf = (profile == EDGEHOG_HTTP_PROFILE_BULK)
+        ? CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_BULK_SNDBUF
+        : CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_SMALL_SNDBUF;
+
+    // A zero in the configuration keeps the kernel default for that buffer. A failure here
+    // is not fatal, it only costs throughput on the affected direction.
+    if (rcvbuf > 0) {
+        EDGEHOG_LOG_DBG("Setting SO_RCVBUF to %d on socket %d", rcvbuf, sock);
+        int sockopt_rc = zsock_setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        if (sockopt_rc == -1) {
+            EDGEHOG_LOG_WRN("Socket options error (SO_RCVBUF): %d", sockopt_rc);
+        }
+    }
+    if (sndbuf > 0) {
+        EDGEHOG_LOG_DBG("Setting SO_SNDBUF to %d on socket %d", sndbuf, sock);
+        int sockopt_rc = zsock_setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        if (sockopt_rc == -1) {
+            EDGEHOG_LOG_WRN("Socket options error (SO_SNDBUF): %d", sockopt_rc);
+        }
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_KEEPALIVE
+    // Keepalive probes detect a silently dropped connection, which matters most for the
+    // cached keep-alive sockets that sit idle between requests
+    int keepalive = 1;
+    int sockopt_rc
+        = zsock_setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (SO_KEEPALIVE): %d", sockopt_rc);
+    }
+    int keep_idle = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_KEEPALIVE_IDLE_SECONDS;
+    sockopt_rc = zsock_setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &keep_idle, sizeof(keep_idle));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (TCP_KEEPIDLE): %d", sockopt_rc);
+    }
+    int keep_intvl = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_KEEPALIVE_INTERVAL_SECONDS;
+    sockopt_rc
+        = zsock_setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &keep_intvl, sizeof(keep_intvl));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (TCP_KEEPINTVL): %d", sockopt_rc);
+    }
+    int keep_cnt = CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING_KEEPALIVE_COUNT;
+    sockopt_rc = zsock_setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &keep_cnt, sizeof(keep_cnt));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (TCP_KEEPCNT): %d", sockopt_rc);
+    }
+#endif
+}
+#endif
+
+static int acquire_connected_socket(
+    const char *host, const char *port, edgehog_http_profile_t profile, bool *reused)
+{
+    *reused = false;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    k_mutex_lock(&connection_cache_mutex, K_FOREVER);
+    if ((connection_cache.sock >= 0) && (strcmp(connection_cache.host, host) == 0)
+        && (strcmp(connection_cache.port, port) == 0)) {
+        int sock = connection_cache.sock;
+        connection_cache.sock = -1;
+        k_mutex_unlock(&connection_cache_mutex);
+        EDGEHOG_LOG_DBG("Reusing cached connection to %s:%s (fd: %d)", host, port, sock);
+        *reused = true;
+        return sock;
+    }
+    k_mutex_unlock(&connection_cache_mutex);
+#endif
+
+    return create_and_connect_socket(host, port, profile);
+}
+
+static void release_connected_socket(int sock, const char *host, const char *port, bool keep)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_KEEP_ALIVE
+    if (keep && (strlen(host) < HTTP_CACHED_HOST_BUF_SIZE)) {
+        k_mutex_lock(&connection_cache_mutex, K_FOREVER);
+        // Evict a previously cached connection to a different server
+        if (connection_cache.sock >= 0) {
+            zsock_close(connection_cache.sock);
+        }
+        connection_cache.sock = sock;
+        strncpy(connection_cache.host, host, sizeof(connection_cache.host) - 1);
+        connection_cache.host[sizeof(connection_cache.host) - 1] = '\0';
+        strncpy(connection_cache.port, port, sizeof(connection_cache.port) - 1);
+        connection_cache.port[sizeof(connection_cache.port) - 1] = '\0';
+        k_mutex_unlock(&connection_cache_mutex);
+        EDGEHOG_LOG_DBG("Caching connection to %s:%s for reuse (fd: %d)", host, port, sock);
+        return;
+    }
+#else
+    ARG_UNUSED(host);
+    ARG_UNUSED(port);
+    ARG_UNUSED(keep);
+#endif
+
+    zsock_close(sock);
+}
+
 static int send_buffer_fully(int sock, const uint8_t *buf, size_t len)
 {
     int sent_bytes = 0;
@@ -563,6 +1192,38 @@ static int send_buffer_fully(int sock, const uint8_t *buf, size_t len)
     return sent_bytes;
 }
 
+static int send_iovec_fully(int sock, struct iovec *iov, size_t iov_cnt)
+{
+    int total_sent = 0;
+    size_t curr = 0;
+
+    while (curr < iov_cnt) {
+        struct msghdr msg = { 0 };
+        msg.msg_iov = &iov[curr];
+        msg.msg_iovlen = iov_cnt - curr;
+
+        int sent = zsock_sendmsg(sock, &msg, 0);
+        if (sent <= 0) {
+            EDGEHOG_LOG_ERR("Failed to send socket data: %d", errno);
+            return -1;
+        }
+        total_sent += sent;
+
+        // Advance the scatter-gather list past the bytes that have been sent
+        size_t consumed = sent;
+        while ((curr < iov_cnt) && (consumed >= iov[curr].iov_len)) {
+            consumed -= iov[curr].iov_len;
+            curr++;
+        }
+        if (curr < iov_cnt) {
+            iov[curr].iov_base = (uint8_t *) iov[curr].iov_base + consumed;
+            iov[curr].iov_len -= consumed;
+        }
+    }
+
+    return total_sent;
+}
+
 static edgehog_result_t build_full_path(
     const char *url, const struct http_parser_url *parser, char **out_path)
 {
@@ -575,7 +1236,7 @@ static edgehog_result_t build_full_path(
 
     // Calculate total size needed: path + '?' + query + null terminator
     size_t full_path_len = (path_len == 0 ? 1 : path_len) + (has_query ? (1 + query_len) : 0) + 1;
-    char *full_path = k_malloc(full_path_len);
+    char *full_path = edgehog_malloc(full_path_len);
     if (!full_path) {
         EDGEHOG_LOG_ERR("Failed to allocate memory for full_path");
         return EDGEHOG_RESULT_OUT_OF_MEMORY;
@@ -586,14 +1247,14 @@ static edgehog_result_t build_full_path(
         int ret = snprintf(full_path, full_path_len, "/");
         if (ret < 0) {
             EDGEHOG_LOG_ERR("Error writing root path");
-            k_free(full_path);
+            edgehog_free(full_path);
             return EDGEHOG_RESULT_PARSE_URL_ERROR;
         }
     } else {
         int ret = snprintf(full_path, path_len + 1, "%s", url + path_off);
         if (ret < 0) {
             EDGEHOG_LOG_ERR("Error extracting path from URL");
-            k_free(full_path);
+            edgehog_free(full_path);
             return EDGEHOG_RESULT_PARSE_URL_ERROR;
         }
     }
@@ -605,7 +1266,7 @@ static edgehog_result_t build_full_path(
         int ret = snprintf(full_path + curr_len + 1, query_len + 1, "%s", url + query_off);
         if (ret < 0) {
             EDGEHOG_LOG_ERR("Error extracting query from URL");
-            k_free(full_path);
+            edgehog_free(full_path);
             return EDGEHOG_RESULT_PARSE_URL_ERROR;
         }
     }
@@ -613,3 +1274,55 @@ static edgehog_result_t build_full_path(
     *out_path = full_path;
     return EDGEHOG_RESULT_OK;
 }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
+static void http_adaptive_record(size_t bytes, int64_t duration_ms)
+{
+    if ((bytes < HTTP_ADAPTIVE_MIN_SAMPLE_BYTES) || (duration_ms <= 0)) {
+        return;
+    }
+
+    atomic_val_t sample = (atomic_val_t) ((bytes * MSEC_PER_SEC) / (size_t) duration_ms);
+    atomic_val_t prev = atomic_get(&http_rolling_throughput);
+    if (prev == 0) {
+        atomic_set(&http_rolling_throughput, sample);
+        return;
+    }
+    // A racing writer only costs one lost sample, the average converges regardless
+    atomic_set(&http_rolling_throughput,
+        ((prev * (HTTP_ADAPTIVE_EMA_WEIGHT - 1)) + sample) / HTTP_ADAPTIVE_EMA_WEIGHT);
+}
+
+static int32_t http_adaptive_stall_window_ms(void)
+{
+    atomic_val_t throughput = atomic_get(&http_rolling_throughput);
+    if (throughput == 0) {
+        return HTTP_ADAPTIVE_STALL_MAX_MS;
+    }
+
+    // Time to receive one buffer at the rolling throughput, widened by the stall margin
+    int64_t window_ms = ((int64_t) CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_RCV_BUFFER_SIZE
+                            * HTTP_ADAPTIVE_STALL_MARGIN * MSEC_PER_SEC)
+        / (int64_t) throughput;
+    return (int32_t) CLAMP(window_ms, HTTP_ADAPTIVE_STALL_MIN_MS, HTTP_ADAPTIVE_STALL_MAX_MS);
+}
+
+static void http_adaptive_apply_stall_timeouts(int sock)
+{
+    int32_t window_ms = http_adaptive_stall_window_ms();
+    struct timeval stall_tv = {
+        .tv_sec = window_ms / MSEC_PER_SEC,
+        .tv_usec = (window_ms % MSEC_PER_SEC) * USEC_PER_MSEC,
+    };
+
+    EDGEHOG_LOG_DBG("Applying a %d ms stall window to socket %d", window_ms, sock);
+    int sockopt_rc = zsock_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &stall_tv, sizeof(stall_tv));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (SO_RCVTIMEO): %d", sockopt_rc);
+    }
+    sockopt_rc = zsock_setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &stall_tv, sizeof(stall_tv));
+    if (sockopt_rc == -1) {
+        EDGEHOG_LOG_WRN("Socket options error (SO_SNDTIMEO): %d", sockopt_rc);
+    }
+}
+#endif // CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_ADAPTIVE_TIMEOUT
@@ -47,6 +47,8 @@ struct edgehog_device
     enum device_states state;
     /** @brief This flag marks if the initial publish has been performed. */
     bool initial_publish;
+    /** @brief True when the instance lives in the internal static storage. */
+    bool statically_allocated;
     /** @brief Handle of an Astarte device. */
     astarte_device_handle_t astarte_device;
     /** @brief The last returned error from Astarte. */
@@ -69,14 +71,17 @@ struct edgehog_device
     char boot_id[UUID_STR_LEN];
     /** @brief OTA thread data used during the OTA Update operation. */
     ota_thread_t ota_thread;
-    /** @brief LED thread data used during the LED blink. */
-    led_thread_t led_thread;
+    /** @brief LED blink data used during the LED blink. */
+    led_blink_t led_blink;
     /** @brief Telemetry data. */
     edgehog_telemetry_t *telemetry;
     /** @brief File transfer data. */
     edgehog_ft_t *file_transfer;
-    /** @brief Semaphore used to synchronize an OTA or File Transfer operation. */
+    /** @brief Counting semaphore synchronizing OTA and File Transfer operations. Each file
+     * transfer lane holds one permit while transferring, an OTA update drains all of them. */
     struct k_sem sync_ota_ft_sem;
+    /** @brief Work item running the initial publish burst off the poll path. */
+    struct k_work initial_publish_work;
     /** @brief User-provided storage partitions for telemetry. */
     edgehog_storage_partition_t *storage_partitions;
     /** @brief Length of user-provided storage partitions. */
@@ -85,6 +90,12 @@ struct edgehog_device
     /** @brief WiFi scan data struct. */
     struct wifi_scan wifi_scan_data;
 #endif
+#ifdef CONFIG_EDGEHOG_DEVICE_POLL_THREAD
+    /** @brief Thread pumping the Astarte connection in place of the application poll loop. */
+    struct k_thread poll_thread;
+    /** @brief State bits for the pump thread, see POLL_THREAD_RUNNING_BIT. */
+    atomic_t poll_thread_state;
+#endif
 };
 
 #endif // EDGEHOG_PRIVATE_H
@@ -0,0 +1,33 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+/**
+ * @file event_loop.h
+ * @brief Shared event-loop thread running the SDK services in single-thread mode.
+ *
+ * @details With CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD enabled the OTA, file transfer and
+ * telemetry services do not own dedicated threads, they submit their work to the single
+ * work queue returned by #edgehog_event_loop_get. Work items run one at a time, in
+ * submission order.
+ */
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Get the shared SDK event-loop work queue, starting it on the first call.
+ *
+ * @return The work queue backing the event-loop thread.
+ */
+struct k_work_q *edgehog_event_loop_get(void);
+
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,78 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILE_TRANSFER_CHECKPOINT_H
+#define FILE_TRANSFER_CHECKPOINT_H
+
+/**
+ * @file file_transfer/checkpoint.h
+ * @brief Persistent resume checkpoints for interrupted downloads.
+ */
+
+#include "file_transfer/core.h"
+#include "file_transfer/utils.h"
+
+/** @brief Digest update callback used while re-hashing the stored prefix of a resumed file. */
+typedef edgehog_result_t (*edgehog_ft_rehash_cbk_t)(
+    edgehog_ft_http_cbk_data_t *data, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Look up the resume offset for a transfer request.
+ *
+ * @details Matches the stored checkpoint slot against the request identity (transfer ID,
+ * download URL and destination) and clamps the persisted offset to the size of the stored
+ * partial file, so a checkpoint written ahead of the last filesystem sync can never resume
+ * past the durable data.
+ *
+ * @param[in] msg The transfer request to look up.
+ * @param[out] resume_offset The offset to resume from, zero when nothing can be resumed.
+ */
+void edgehog_ft_checkpoint_resume_offset(const edgehog_ft_msg_t *msg, size_t *resume_offset);
+
+/**
+ * @brief Start checkpointing a transfer, claiming the persistent checkpoint slot.
+ *
+ * @param[in,out] data The HTTP callback data of the transfer to checkpoint.
+ * @param[in] msg The transfer request being served.
+ * @param[in] resume_offset The offset the transfer starts from, zero for a fresh download.
+ */
+void edgehog_ft_checkpoint_begin(
+    edgehog_ft_http_cbk_data_t *data, const edgehog_ft_msg_t *msg, size_t resume_offset);
+
+/**
+ * @brief Account received bytes, persisting the checkpoint on the configured interval.
+ *
+ * @param[in,out] data The HTTP callback data of the transfer being checkpointed.
+ * @param[in] bytes Number of bytes just received and handed to the storage backend.
+ */
+void edgehog_ft_checkpoint_note(edgehog_ft_http_cbk_data_t *data, size_t bytes);
+
+/**
+ * @brief Drop the persistent checkpoint of a transfer that completed or cannot be resumed.
+ *
+ * @details A no-op for transfers that never claimed the checkpoint slot, so an unrelated
+ * completion does not wipe the checkpoint of a parked transfer.
+ *
+ * @param[in,out] data The HTTP callback data of the transfer, may be NULL.
+ */
+void edgehog_ft_checkpoint_clear(edgehog_ft_http_cbk_data_t *data);
+
+/**
+ * @brief Feed the stored prefix of a resumed file back into the streaming digest.
+ *
+ * @details The server only sends the bytes past the resume offset, the digest still has to
+ * cover the whole file for the final verification to succeed.
+ *
+ * @param[in] path Filesystem path of the stored partial file.
+ * @param[in] length Number of prefix bytes to hash, the resume offset.
+ * @param[in] update The digest update callback to feed.
+ * @param[in,out] data The HTTP callback data passed through to the update callback.
+ * @return EDGEHOG_RESULT_OK on success, otherwise an error code.
+ */
+edgehog_result_t edgehog_ft_checkpoint_rehash(const char *path, size_t length,
+    edgehog_ft_rehash_cbk_t update, edgehog_ft_http_cbk_data_t *data);
+
+#endif // FILE_TRANSFER_CHECKPOINT_H
@@ -35,6 +35,23 @@ enum edgehog_ft_encoding
     EDGEHOG_FT_ENCODING_UNSUPPORTED,
 };
 
+/**
+ * @brief Transfer lanes of the file transfer service, one per transfer direction.
+ * @details Each lane owns a message queue and a service thread, so a server-to-device transfer
+ * is never queued behind a device-to-server one. Within a lane transfers run one at a time.
+ * With CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD the lanes share the SDK event-loop thread instead
+ * and transfers of both directions serialize on it.
+ */
+enum edgehog_ft_lane
+{
+    /** @brief Lane serving server-to-device transfers. */
+    EDGEHOG_FT_LANE_DOWNLOAD = 0,
+    /** @brief Lane serving device-to-server transfers. */
+    EDGEHOG_FT_LANE_UPLOAD,
+    /** @brief Number of transfer lanes. */
+    EDGEHOG_FT_LANE_COUNT,
+};
+
 /**
  * @brief Locations for file transfers.
  */
@@ -44,6 +61,8 @@ enum edgehog_ft_location_type
     EDGEHOG_FT_LOCATION_TYPE_FILESYSTEM = 0,
     /** @brief Stream location. */
     EDGEHOG_FT_LOCATION_TYPE_STREAMING,
+    /** @brief Raw flash partition location. */
+    EDGEHOG_FT_LOCATION_TYPE_PARTITION,
     /** @brief Unsupported location. */
     EDGEHOG_FT_LOCATION_TYPE_UNSUPPORTED,
 };
@@ -71,16 +90,36 @@ typedef struct
     edgehog_ft_type_t type;
     /** @brief Total expected decompressed file size in bytes (server-to-device transfers). */
     int64_t file_size_bytes;
+    /** @brief Pool block holding every string of the message, released with the message. */
+    void *arena;
 } edgehog_ft_msg_t;
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+/** @brief Work item draining one transfer lane on the shared event loop. */
+typedef struct
+{
+    /** @brief The work item submitted to the event loop when the lane has requests queued. */
+    struct k_work work;
+    /** @brief The lane this work item drains. */
+    enum edgehog_ft_lane lane;
+    /** @brief The device owning the file transfer service. */
+    edgehog_device_handle_t device;
+} edgehog_ft_lane_work_t;
+#endif
+
 /** @brief Data structure for the file transfer service. */
 typedef struct
 {
-    /** @brief Message queue used to pass transfer requests to the service thread. */
-    struct k_msgq msgq;
-    /** @brief File transfer service thread, peeks the msgq and performs transfers if present. */
-    struct k_thread thread;
-    /** @brief Run state for the file transfer service thread. */
+    /** @brief Per-lane message queues used to pass transfer requests to the service threads. */
+    struct k_msgq msgq[EDGEHOG_FT_LANE_COUNT];
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+    /** @brief Per-lane work items draining the queues on the shared event loop. */
+    edgehog_ft_lane_work_t lane_work[EDGEHOG_FT_LANE_COUNT];
+#else
+    /** @brief Per-lane service threads, each peeks its msgq and performs transfers if present. */
+    struct k_thread thread[EDGEHOG_FT_LANE_COUNT];
+#endif
+    /** @brief Run state shared by all file transfer service threads. */
     atomic_t thread_state;
     /** @brief File transfer callbacks registered by the user. */
     edgehog_ft_cbks_t cbks;
@@ -88,6 +127,10 @@ typedef struct
     edgehog_ft_filesystem_partition_t *partitions;
     /** @brief The length of the partitions array. */
     size_t partitions_len;
+    /** @brief The raw flash partitions explicitly allowed for file transfers. */
+    edgehog_ft_flash_partition_t *flash_partitions;
+    /** @brief The length of the flash_partitions array. */
+    size_t flash_partitions_len;
 } edgehog_ft_t;
 
 /**
@@ -102,10 +145,14 @@ void edgeghog_ft_publish_capabilities(edgehog_device_handle_t edgehog_device);
  * @param cbks File transfer callbacks registered by the user.
  * @param partitions Pointer to the file system partitions explicitly allowed for file transfers.
  * @param partitions_len The number of partitions in the array.
+ * @param flash_partitions Pointer to the raw flash partitions explicitly allowed for file
+ * transfers.
+ * @param flash_partitions_len The number of flash partitions in the array.
  * @return A pointer to the newly allocated edgehog_ft_t instance, or NULL if allocation fails.
  */
-edgehog_ft_t *edgehog_ft_new(
-    edgehog_ft_cbks_t cbks, edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len);
+edgehog_ft_t *edgehog_ft_new(edgehog_ft_cbks_t cbks,
+    edgehog_ft_filesystem_partition_t *partitions, size_t partitions_len,
+    edgehog_ft_flash_partition_t *flash_partitions, size_t flash_partitions_len);
 
 /**
  * @brief Frees all resources associated with a file transfer context.
@@ -7,7 +7,8 @@
 #ifndef FILE_TRANSFER_DECOMPRESSION_H
 #define FILE_TRANSFER_DECOMPRESSION_H
 
-#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+#if defined(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION)                                       \
+    || defined(CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION)
 
 /**
  * @file file_transfer/decompression.h
@@ -88,6 +89,13 @@ int file_transfer_decompression_process_chunk(
  */
 void file_transfer_decompression_free(file_transfer_decompression_ctx_t *ctx);
 
+/**
+ * @brief Get the number of bytes currently allocated from the decompression buffer pool.
+ *
+ * @return The pool occupancy in bytes.
+ */
+size_t file_transfer_decompression_pool_usage(void);
+
 #ifdef __cplusplus
 }
 #endif
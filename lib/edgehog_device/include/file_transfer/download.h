@@ -28,6 +28,10 @@ typedef struct
     edgehog_result_t (*file_complete)(void *ctx);
     /** @brief Aborts the transfer and cleans up resources (e.g., deletes partial file). */
     void (*file_abort)(void *ctx);
+    /** @brief Optional: repositions an already stored destination to resume at the offset. */
+    edgehog_result_t (*file_resume)(void *ctx, size_t resume_offset);
+    /** @brief Optional: flushes and closes keeping the partial file for a later resume. */
+    void (*file_park)(void *ctx);
 } edgehog_ft_file_write_cbks_t;
 
 /**
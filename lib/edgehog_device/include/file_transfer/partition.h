@@ -0,0 +1,30 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILE_TRANSFER_PARTITION_H
+#define FILE_TRANSFER_PARTITION_H
+
+/**
+ * @file file_transfer/partition.h
+ * @brief Raw flash partition APIs for file transfer.
+ */
+
+#include "file_transfer/download.h"
+#include "file_transfer/upload.h"
+
+/**
+ * @brief Partition write callbacks for file transfer.
+ * This structure provides the necessary callbacks for writing data to a raw flash partition.
+ */
+extern const edgehog_ft_file_write_cbks_t edgehog_ft_partition_write_cbks;
+
+/**
+ * @brief Partition read callbacks for file transfer.
+ * This structure provides the necessary callbacks for reading data from a raw flash partition.
+ */
+extern const edgehog_ft_file_read_cbks_t edgehog_ft_partition_read_cbks;
+
+#endif // FILE_TRANSFER_PARTITION_H
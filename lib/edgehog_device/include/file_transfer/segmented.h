@@ -0,0 +1,62 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILE_TRANSFER_SEGMENTED_H
+#define FILE_TRANSFER_SEGMENTED_H
+
+/**
+ * @file file_transfer/segmented.h
+ * @brief Segmented multi-connection download for large file transfers
+ *
+ * @details The file is divided into fixed-size stripes assigned round-robin to a small pool of
+ * worker threads. Each worker fetches its stripes with HTTP range requests over its own
+ * connection, while the caller thread hands the buffered stripes to the chunk callback strictly
+ * in file order. The digest, decompression and file append paths therefore behave exactly as in
+ * the single-stream download.
+ */
+
+#include "edgehog_device/result.h"
+#include "http.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** @brief Parameters for a segmented download. */
+typedef struct
+{
+    /** @brief URL to download the file from. */
+    const char *url;
+    /** @brief NULL terminated list of extra headers for the range requests, or NULL. */
+    const char **header_fields;
+    /** @brief Total size of the file in bytes. */
+    size_t file_size;
+    /** @brief Callback receiving the reassembled chunks in file order. */
+    edgehog_http_response_cbk_t response_cbk;
+    /** @brief User data passed to the callback function. */
+    void *user_data;
+} edgehog_ft_segmented_params_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Download a file through concurrent HTTP range requests.
+ *
+ * @param[in] params Parameters for the segmented download.
+ * @param[out] range_unsupported Set when the server answered a range request with a full body
+ * before any chunk was delivered to the callback. The caller can then fall back to the
+ * single-stream download path.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_ft_segmented_download(
+    const edgehog_ft_segmented_params_t *params, bool *range_unsupported);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_TRANSFER_SEGMENTED_H
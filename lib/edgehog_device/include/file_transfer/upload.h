@@ -23,9 +23,15 @@ typedef struct
     /** @brief Retrieves the next file entry and opens it (used for TAR directories). */
     edgehog_result_t (*file_get_next_entry)(
         void *ctx, char *file_name, size_t name_len, size_t *file_size, bool *has_next);
-    /** @brief Reads a chunk of data from the currently opened file in the backend. */
+    /** @brief Reads a chunk of data from the currently opened file in the backend, filling the
+     * caller-provided buffer directly to avoid an intermediate copy. */
     edgehog_result_t (*file_read_chunk)(
-        void *ctx, size_t max_length, uint8_t **chunk_data, size_t *chunk_size, bool *last_chunk);
+        void *ctx, uint8_t *buffer, size_t max_length, size_t *chunk_size, bool *last_chunk);
+    /** @brief Optional zero-copy read, yields a length-clamped span pointing directly into
+     * backend-owned memory instead of filling a buffer. NULL when the backend cannot serve
+     * spans; a backend may also report NULL in the span output to request the copying read. */
+    edgehog_result_t (*file_read_span)(
+        void *ctx, const uint8_t **span, size_t max_length, size_t *chunk_size, bool *last_chunk);
     /** @brief Finalizes and closes the file transfer successfully. */
     edgehog_result_t (*file_complete)(void *ctx);
     /** @brief Aborts the transfer and cleans up resources. */
@@ -16,6 +16,10 @@
 
 #include <psa/crypto.h>
 
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+#include <zephyr/crypto/crypto.h>
+#endif
+
 #include "file_transfer/compression.h"
 #include "file_transfer/core.h"
 #include "file_transfer/decompression.h"
@@ -56,10 +60,18 @@ typedef struct
     size_t total_bytes;
     /** @brief The number of bytes at the last progress report */
     atomic_t last_reported_bytes;
+    /** @brief Uptime in milliseconds at the last progress report */
+    atomic_t last_reported_ms;
     /** @brief The expected digest string for verification (e.g., "sha256:...") */
     const char *expected_digest;
     /** @brief The hash operation context for streaming digest calculation */
     psa_hash_operation_t hash_operation;
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_HW_DIGEST
+    /** @brief Hash session context for the hardware hash engine */
+    struct hash_ctx hw_hash_ctx;
+    /** @brief Set when the streaming digest is computed by the hardware hash engine */
+    bool hw_digest;
+#endif
     /** @brief Optional encoding for the file transfer payload. */
     enum edgehog_ft_encoding encoding;
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
@@ -67,25 +79,57 @@ typedef struct
     file_transfer_decompression_ctx_t decomp_ctx;
     /** @brief Compression context for outgoing uploaded files */
     file_transfer_compression_ctx_t comp_ctx;
-    /** @brief Buffer used to hold the compressed output chunk during uploads */
-    uint8_t comp_out_buf[EDGEHOG_FT_COMPRESSED_OUT_BUFFER_SIZE];
     /** @brief Track if the underlying file is fully read */
     bool file_exhausted;
     /** @brief Track if the LZ4 footer has been successfully written */
     bool comp_footer_written;
 #endif
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_RESUME
+    /** @brief Hash of the download URL stored in the resume checkpoint. */
+    uint32_t ckpt_url_hash;
+    /** @brief Hash of the destination location stored in the resume checkpoint. */
+    uint32_t ckpt_location_hash;
+    /** @brief Bytes of the file received so far, including the resumed prefix. */
+    size_t ckpt_offset;
+    /** @brief Value of ckpt_offset at which the checkpoint is persisted next. */
+    size_t ckpt_next_save;
+    /** @brief True while the transfer keeps a resume checkpoint up to date. */
+    bool ckpt_active;
+    /** @brief True when the running request was issued with a Range header to resume. */
+    bool ckpt_resumed;
+    /** @brief Set when the server ignored the Range header of a resumed request. */
+    bool ckpt_range_ignored;
+#endif
 #ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR
     /** @brief ZTAR context for TAR unpacking */
     ztar_unpack_t ztar_unpack_ctx;
     /** @brief ZTAR context for TAR packing */
     ztar_pack_t ztar_pack_ctx;
-    /** @brief TAR buffer, used to temporarely store data while packing a TAR archive */
-    uint8_t tar_buffer[ZTAR_BLOCK_SIZE * 2];
     /** @brief Service flag to be used to verify if the TAR has been fully processed */
     bool tar_exhausted;
 #endif
 } edgehog_ft_http_cbk_data_t;
 
+/**
+ * @brief Allocate a per-transfer context object from the file transfer slab.
+ *
+ * @details All the fixed-size, short-lived per-transfer objects come from a single static
+ * memory slab, making transfer setup O(1), immune to heap fragmentation, and capping the
+ * number of concurrent transfers deterministically. The returned block is zeroed.
+ *
+ * @param size Size of the object, it must not exceed the configured slab block size. The use
+ * sites enforce this at build time with a BUILD_ASSERT.
+ * @return A pointer to the zeroed object, or NULL if the slab is exhausted.
+ */
+void *edgehog_ft_ctx_alloc(size_t size);
+
+/**
+ * @brief Return a per-transfer context object to the file transfer slab.
+ *
+ * @param obj Object allocated with #edgehog_ft_ctx_alloc, may be NULL.
+ */
+void edgehog_ft_ctx_free(void *obj);
+
 /**
  * @brief Parses an array of Astarte object entries and initializes a file transfer message.
  *
@@ -0,0 +1,46 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+/**
+ * @file heap.h
+ * @brief Internal allocation wrappers for the Edgehog device library.
+ *
+ * @details All dynamic allocations of the library go through these wrappers. When
+ * CONFIG_EDGEHOG_DEVICE_DEDICATED_HEAP is enabled they are served from a dedicated k_heap,
+ * isolating Edgehog from application heap fragmentation and providing usage accounting.
+ * Otherwise they fall back to the libc heap.
+ */
+
+#include <stdlib.h>
+
+/**
+ * @brief Allocate a memory region, #edgehog_free releases it.
+ *
+ * @param[in] size Size in bytes of the region to allocate.
+ * @return A pointer to the allocated region, NULL upon failure.
+ */
+void *edgehog_malloc(size_t size);
+
+/**
+ * @brief Allocate a zero initialized array, #edgehog_free releases it.
+ *
+ * @param[in] num Number of elements in the array.
+ * @param[in] size Size in bytes of each element.
+ * @return A pointer to the allocated array, NULL upon failure.
+ */
+void *edgehog_calloc(size_t num, size_t size);
+
+/**
+ * @brief Release a region obtained from #edgehog_malloc or #edgehog_calloc.
+ *
+ * @param[in] ptr The region to release, might be NULL.
+ */
+void edgehog_free(void *ptr);
+
+#endif // HEAP_H
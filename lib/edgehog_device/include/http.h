@@ -18,6 +18,18 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/** @brief Socket tuning profiles for HTTP requests.
+ * @details With CONFIG_EDGEHOG_DEVICE_ADVANCED_HTTP_SOCKET_TUNING enabled each profile carries
+ * its own receive and send buffer sizes, so bulk transfer sockets can get the large TCP window
+ * high-latency links need without paying that memory on every request. */
+typedef enum
+{
+    /** @brief Small control request, kept on the kernel default buffer sizes. */
+    EDGEHOG_HTTP_PROFILE_SMALL = 0,
+    /** @brief Bulk OTA or file transfer request, tuned for throughput. */
+    EDGEHOG_HTTP_PROFILE_BULK,
+} edgehog_http_profile_t;
+
 /** @brief Chunk of response from the server. */
 typedef struct
 {
@@ -27,6 +39,8 @@ typedef struct
     size_t chunk_size;
     /** @brief Size of the response. */
     size_t response_size;
+    /** @brief HTTP status code of the response. */
+    uint16_t status_code;
     /** @brief Identify the last chunk of the response. */
     bool last_chunk;
 } edgehog_http_response_chunk_t;
@@ -74,6 +88,8 @@ typedef struct
     const char **header_fields;
     /** @brief Timeout to use for the HTTP operations in ms. */
     int32_t timeout_ms;
+    /** @brief Socket tuning profile for the request. */
+    edgehog_http_profile_t profile;
     /** @brief Callback for a chunk response event. */
     edgehog_http_response_cbk_t response_cbk;
     /** @brief User data passed to the callback function. */
@@ -89,8 +105,15 @@ typedef struct
     const char **header_fields;
     /** @brief Timeout to use for the HTTP operations in ms. */
     int32_t timeout_ms;
-    /** @brief Size of the data transmitted by the HTTP PUT request. */
+    /** @brief Socket tuning profile for the request. */
+    edgehog_http_profile_t profile;
+    /** @brief Size of the data transmitted by the HTTP PUT request. Ignored when chunked. */
     size_t payload_size;
+    /** @brief Use HTTP chunked transfer encoding instead of a Content-Length upload.
+     *
+     * The Transfer-Encoding header is added automatically and each payload chunk is sent with
+     * its encoding wrappers in a single scatter-gather operation. */
+    bool chunked;
     /** @brief Callback for a chunk payload event. */
     edgehog_http_payload_cbk_t payload_cbk;
     /** @brief User data passed to the callback function. */
@@ -117,6 +140,18 @@ edgehog_result_t edgehog_http_get(edgehog_http_get_data_t *data);
  */
 edgehog_result_t edgehog_http_put(edgehog_http_put_data_t *data);
 
+/**
+ * @brief Check that the TLS credentials used by the transfer sockets are registered.
+ *
+ * @details Probes the configured credential tags once, so a missing CA certificate is reported at
+ * device initialization instead of at the first OTA or file transfer request. Always successful
+ * when TLS is disabled for development.
+ *
+ * @return EDGEHOG_RESULT_OK when every configured tag holds a CA certificate,
+ * EDGEHOG_RESULT_INVALID_CONFIGURATION otherwise.
+ */
+edgehog_result_t edgehog_http_tls_credentials_check(void);
+
 #ifdef __cplusplus
 }
 #endif
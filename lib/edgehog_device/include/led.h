@@ -20,16 +20,31 @@
 /** @brief The devicetree node identifier for the Edgehog LED alias. */
 #define EDGEHOG_LED_NODE DT_ALIAS(edgehog_led)
 
-/** @brief Data struct for a led thread instance. */
+/** @brief One step of a LED blink pattern, the LED is set to a level and held for a duration. */
 typedef struct
 {
-    /** @brief LED thread running state. */
+    /** @brief Level to set the LED to. */
+    int level;
+    /** @brief Time to hold the level, in milliseconds. */
+    uint32_t duration_ms;
+} led_pattern_step_t;
+
+/** @brief Data struct for a LED blink instance. */
+typedef struct
+{
+    /** @brief LED blink running state. */
     atomic_t led_run_state;
-    /** @brief LED k_thread_handle. */
-    struct k_thread led_thread_handle;
+    /** @brief Timer walking the steps of the active pattern. */
+    struct k_timer led_pattern_timer;
     /** @brief LED stop timer. */
     struct k_timer led_blink_timer;
-} led_thread_t;
+    /** @brief Steps of the active pattern, walked cyclically. */
+    const led_pattern_step_t *pattern;
+    /** @brief Number of steps in the active pattern. */
+    size_t pattern_len;
+    /** @brief Index of the next step of the active pattern. */
+    size_t pattern_idx;
+} led_blink_t;
 
 #ifdef __cplusplus
 extern "C" {
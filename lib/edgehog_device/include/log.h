@@ -7,6 +7,8 @@
 #ifndef LOG_H
 #define LOG_H
 
+#include <stdint.h>
+
 #include <zephyr/logging/log.h>
 
 #define EDGEHOG_LOG_MODULE_REGISTER(...) LOG_MODULE_REGISTER(__VA_ARGS__) // NOLINT
@@ -23,4 +25,38 @@
 
 #define EDGEHOG_LOG_HEXDUMP_DBG(...) LOG_HEXDUMP_DBG(__VA_ARGS__) // NOLINT
 
+/**
+ * @brief Per-callsite rate limited logging.
+ *
+ * @details Emits the first @p first occurrences of the callsite, then one every @p every. Use
+ * it for per-chunk logging on hot paths (HTTP payload callbacks, progress reporting), where
+ * emitting every occurrence throttles the data path it is observing. The counter is per
+ * callsite and is deliberately not synchronized: under concurrent callers an occasional
+ * off-pattern emission is acceptable and cheaper than an atomic on the hot path.
+ *
+ * String arguments are copied into the message at the callsite by the Zephyr log core, so the
+ * throttled macros remain safe in deferred mode like the plain ones. Do not log pointers into
+ * transient payload buffers.
+ */
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+#define EDGEHOG_LOG_RATE_LIMITED(log_macro, first, every, ...)                                     \
+    do {                                                                                           \
+        static uint32_t edgehog_log_rl_count;                                                      \
+        uint32_t edgehog_log_rl_n = edgehog_log_rl_count++;                                        \
+        if ((edgehog_log_rl_n < (first)) || (((edgehog_log_rl_n - (first)) % (every)) == 0)) {     \
+            log_macro(__VA_ARGS__);                                                                \
+        }                                                                                          \
+    } while (0)
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/** @brief Rate limited EDGEHOG_LOG_DBG, with the configured first/every pattern. */
+#define EDGEHOG_LOG_DBG_THROTTLED(...)                                                             \
+    EDGEHOG_LOG_RATE_LIMITED(EDGEHOG_LOG_DBG, CONFIG_EDGEHOG_DEVICE_LOG_THROTTLE_FIRST,            \
+        CONFIG_EDGEHOG_DEVICE_LOG_THROTTLE_EVERY, __VA_ARGS__)
+
+/** @brief Rate limited EDGEHOG_LOG_INF, with the configured first/every pattern. */
+#define EDGEHOG_LOG_INF_THROTTLED(...)                                                             \
+    EDGEHOG_LOG_RATE_LIMITED(EDGEHOG_LOG_INF, CONFIG_EDGEHOG_DEVICE_LOG_THROTTLE_FIRST,            \
+        CONFIG_EDGEHOG_DEVICE_LOG_THROTTLE_EVERY, __VA_ARGS__)
+
 #endif // LOG_H
@@ -18,6 +18,14 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Take a snapshot of the OS informations.
+ *
+ * @details Formats the OS version once into an internal cache, subsequent calls are no-ops.
+ * Publishing then reads from the cache without re-formatting.
+ */
+void os_info_snapshot(void);
+
 /**
  * @brief Publish a OS informations.
  *
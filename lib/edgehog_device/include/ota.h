@@ -15,9 +15,21 @@
 #include "edgehog_device/device.h"
 #include "edgehog_device/result.h"
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+#include "ota_delta.h"
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+#include "file_transfer/decompression.h"
+#endif
+
 #include <zephyr/dfu/flash_img.h>
 #include <zephyr/kernel.h>
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+#include <zephyr/storage/flash_map.h>
+#endif
+
 /**
  * @brief OTA Request data.
  *
@@ -46,8 +58,40 @@ typedef struct
     size_t download_size;
     /** @brief Size of the OTA image. */
     size_t image_size;
+    /** @brief Flash-committed offset the current download attempt resumed from. */
+    size_t download_start_offset;
+    /** @brief Set when the server ignored a Range request, forcing a restart from byte zero. */
+    bool resume_unsupported;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+    /** @brief Flash area handle for the secondary slot used by the erase-ahead logic. */
+    const struct flash_area *erase_fa;
+    /** @brief Offset up to which the secondary slot has been erased. */
+    size_t erase_offset;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    /** @brief Delta patch engine context, used when the payload is a delta patch stream. */
+    ota_delta_ctx_t delta_ctx;
+    /** @brief Set once the start of the stream has been probed for the delta patch magic. */
+    bool delta_probed;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    /** @brief Decompression context, used when the payload is an LZ4 frame compressed image. */
+    file_transfer_decompression_ctx_t decomp_ctx;
+    /** @brief Set once the start of the stream has been probed for the LZ4 frame magic. */
+    bool decomp_probed;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT
+    /** @brief Tokens available in the download rate-limit bucket, in bytes. */
+    size_t rate_tokens;
+    /** @brief Uptime in milliseconds of the last rate-limit token refill. */
+    int64_t rate_last_refill_ms;
+#endif
     /** @brief Last download percentage sent to the server. */
     uint8_t last_perc_sent;
+    /** @brief Uptime in milliseconds of the last progress publish. */
+    int64_t last_progress_ms;
+    /** @brief Value of the downloaded size at the last progress publish. */
+    size_t last_progress_bytes;
     /** @brief OTA thread running state. */
     atomic_t ota_run_state;
 } ota_thread_data_t;
@@ -57,8 +101,13 @@ typedef struct
 {
     /** @brief OTA thread data. */
     ota_thread_data_t ota_thread_data;
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+    /** @brief Work item running the OTA procedure on the shared event loop. */
+    struct k_work ota_work;
+#else
     /** @brief Thread handle. */
     struct k_thread ota_thread_handle;
+#endif
 } ota_thread_t;
 
 #ifdef __cplusplus
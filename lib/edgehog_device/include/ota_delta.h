@@ -0,0 +1,132 @@
+/*
+ * (C) Copyright 2025, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+/**
+ * @file ota_delta.h
+ * @brief Streaming delta-patch engine for OTA updates
+ *
+ * @details A delta OTA payload is a patch computed by the server against the image running in
+ * the primary slot. The device reconstructs the secondary slot image by interleaving reads from
+ * the primary partition with literal data carried in the patch, instead of downloading the
+ * complete image.
+ *
+ * The patch stream layout is:
+ * - u32 magic ("EDT1", little-endian)
+ * - u32 target image size
+ * - a sequence of records, each starting with:
+ *   - u8 opcode (0x00 copy from primary, 0x01 literal data)
+ *   - u32 length
+ *   - copy records are followed by a u32 source offset in the primary slot,
+ *     data records are followed by `length` raw image bytes.
+ */
+
+#include "edgehog_device/result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/dfu/flash_img.h>
+
+/** @brief Magic marking the start of a delta patch stream ("EDT1", little-endian). */
+#define OTA_DELTA_MAGIC 0x31544445U
+
+/** @brief Size of the fixed patch stream header (magic and target size). */
+#define OTA_DELTA_STREAM_HEADER_SIZE 8U
+
+/** @brief Maximum size of a single record header (opcode, length and source offset). */
+#define OTA_DELTA_RECORD_HEADER_SIZE 9U
+
+/** @brief Internal states of the delta patch engine. */
+typedef enum
+{
+    /** @brief Parsing the patch stream header. */
+    OTA_DELTA_STATE_STREAM_HEADER = 0,
+    /** @brief Parsing the next record header. */
+    OTA_DELTA_STATE_RECORD_HEADER,
+    /** @brief Consuming the literal bytes of a data record. */
+    OTA_DELTA_STATE_RECORD_DATA,
+    /** @brief The full target image has been reconstructed. */
+    OTA_DELTA_STATE_DONE,
+} ota_delta_state_t;
+
+/** @brief Context for a streaming delta patch application. */
+typedef struct
+{
+    /** @brief Set when a delta patch stream has been detected and the engine is in use. */
+    bool active;
+    /** @brief Engine parsing state. */
+    ota_delta_state_t state;
+    /** @brief Image flash context used to write the reconstructed image to the secondary slot. */
+    struct flash_img_context *flash_ctx;
+    /** @brief Flash area ID of the primary slot, source for the copy records. */
+    uint8_t primary_area_id;
+    /** @brief Accumulation buffer for headers split across received chunks. */
+    uint8_t header_buf[OTA_DELTA_RECORD_HEADER_SIZE];
+    /** @brief Number of bytes currently accumulated in the header buffer. */
+    size_t header_len;
+    /** @brief Bytes still to consume for the record being processed. */
+    uint32_t record_remaining;
+    /** @brief Size of the reconstructed target image, from the patch stream header. */
+    uint32_t target_size;
+    /** @brief Number of target image bytes reconstructed so far. */
+    size_t patched_size;
+} ota_delta_ctx_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check if a buffer starts with the delta patch stream magic.
+ *
+ * @param[in] buf Start of the received stream, requires at least 4 valid bytes.
+ * @param[in] len Number of valid bytes in the buffer.
+ * @return True when the stream is a delta patch, false otherwise.
+ */
+bool edgehog_ota_delta_detect(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Initialize a delta patch engine context.
+ *
+ * @param[out] ctx Context to initialize.
+ * @param[in] flash_ctx Image flash context for the secondary slot, already initialized.
+ * @param[in] primary_area_id Flash area ID of the primary slot.
+ */
+void edgehog_ota_delta_init(
+    ota_delta_ctx_t *ctx, struct flash_img_context *flash_ctx, uint8_t primary_area_id);
+
+/**
+ * @brief Feed a chunk of the patch stream to the engine.
+ *
+ * @details Copy records are applied immediately by streaming reads from the primary partition
+ * into the image flash context, literal data is written through as it is received.
+ *
+ * @param[inout] ctx Delta engine context.
+ * @param[in] chunk Received patch bytes.
+ * @param[in] chunk_size Number of valid bytes in the chunk.
+ * @param[in] last_chunk True when this is the final chunk of the patch stream.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_ota_delta_feed(
+    ota_delta_ctx_t *ctx, const uint8_t *chunk, size_t chunk_size, bool last_chunk);
+
+/**
+ * @brief Check if the engine reconstructed the complete target image.
+ *
+ * @param[in] ctx Delta engine context.
+ * @return True when the full target image has been committed, false otherwise.
+ */
+bool edgehog_ota_delta_complete(ota_delta_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_DELTA_H
@@ -0,0 +1,68 @@
+/*
+ * (C) Copyright 2025, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OTA_PIPELINE_H
+#define OTA_PIPELINE_H
+
+/**
+ * @file ota_pipeline.h
+ * @brief Double-buffered pipeline overlapping HTTP receive and flash writes during OTA
+ *
+ * @details The pipeline owns two statically allocated buffers and a dedicated writer thread.
+ * Received payload bytes are copied into one buffer while the writer thread flushes the other
+ * to the secondary slot, so the socket never sits idle waiting for flash programming.
+ *
+ * Only a single pipeline instance can be active at a time, matching the single OTA thread.
+ */
+
+#include "edgehog_device/result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/dfu/flash_img.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the pipeline and spawn its writer thread.
+ *
+ * @param[in] flash_ctx Image flash context for the secondary slot, already initialized.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_ota_pipeline_start(struct flash_img_context *flash_ctx);
+
+/**
+ * @brief Submit received payload bytes to the pipeline.
+ *
+ * @details Blocks only when both buffers are full, that is when the network is faster than
+ * flash programming.
+ *
+ * @param[in] data Received payload bytes.
+ * @param[in] size Number of valid bytes.
+ * @param[in] last True when this is the final chunk of the payload.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_ota_pipeline_write(const uint8_t *data, size_t size, bool last);
+
+/**
+ * @brief Drain the pipeline and join the writer thread.
+ *
+ * @details Always call this after the download terminated, successfully or not.
+ *
+ * @return EDGEHOG_RESULT_OK if all submitted bytes have been committed to flash, otherwise an
+ * error code.
+ */
+edgehog_result_t edgehog_ota_pipeline_finish(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_PIPELINE_H
@@ -0,0 +1,39 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PUBLISH_SCRATCH_H
+#define PUBLISH_SCRATCH_H
+
+/**
+ * @file publish_scratch.h
+ * @brief Shared scratch arena for Astarte payload assembly.
+ *
+ * @details Publish sites assemble their astarte_object_entry arrays and payload snapshots in one
+ * statically allocated arena instead of on their thread stacks, so the service thread stacks no
+ * longer need headroom for the largest payload. The arena is handed out whole to one publisher
+ * at a time and the acquire blocks until it is free; payload assembly and send complete before
+ * the release, so concurrent publishers serialize for that duration. Never acquire the arena
+ * twice from the same call chain, the second acquire would wait on the first forever.
+ */
+
+#include <stddef.h>
+
+/**
+ * @brief Acquire the publish scratch arena, blocking until it is free.
+ *
+ * @param[in] size Number of bytes the publisher needs.
+ *
+ * @return The arena start, 8 byte aligned, or NULL when the configured arena is too small for
+ * the requested size.
+ */
+void *publish_scratch_acquire(size_t size);
+
+/**
+ * @brief Release the publish scratch arena, the pointed memory must no longer be used.
+ */
+void publish_scratch_release(void);
+
+#endif // PUBLISH_SCRATCH_H
@@ -18,6 +18,14 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Take a snapshot of the runtime informations.
+ *
+ * @details Formats the runtime version and environment once into an internal cache, subsequent
+ * calls are no-ops. Publishing then reads from the cache without re-formatting.
+ */
+void runtime_info_snapshot(void);
+
 /**
  * @brief Publish a runtime informations.
  *
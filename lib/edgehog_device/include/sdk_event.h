@@ -0,0 +1,57 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SDK_EVENT_H
+#define SDK_EVENT_H
+
+/**
+ * @file sdk_event.h
+ * @brief Internal publisher for the zbus SDK event channel.
+ *
+ * @details Thin wrapper around the @p edgehog_sdk_chan zbus channel. Call sites use it
+ * unconditionally, when CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS is disabled the publication
+ * compiles out.
+ */
+
+#include <stddef.h>
+
+#include <zephyr/kernel.h>
+
+#include "edgehog_device/result.h"
+#include "edgehog_device/sdk_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+
+/**
+ * @brief Publish an event on the zbus SDK channel.
+ *
+ * @param[in] event The event code to publish.
+ * @param[in] result Result associated with the event, #EDGEHOG_RESULT_OK when not meaningful.
+ * @param[in] bytes Number of bytes moved, zero when not meaningful.
+ */
+void sdk_event_publish(edgehog_sdk_event_t event, edgehog_result_t result, size_t bytes);
+
+#else
+
+static inline void sdk_event_publish(
+    edgehog_sdk_event_t event, edgehog_result_t result, size_t bytes)
+{
+    ARG_UNUSED(event);
+    ARG_UNUSED(result);
+    ARG_UNUSED(bytes);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SDK_EVENT_H
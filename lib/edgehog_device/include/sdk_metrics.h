@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SDK_METRICS_H
+#define SDK_METRICS_H
+
+/**
+ * @file sdk_metrics.h
+ * @brief Self-profiling counters for the SDK internals.
+ *
+ * @details Lightweight counters recorded on the hot paths of the SDK, published on the telemetry
+ * cadence through the #EDGEHOG_TELEMETRY_SDK_METRICS type. No Astarte interface covers these
+ * figures, so the publish surfaces them through the log, where fleet log collection picks them
+ * up.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+#include "edgehog_device/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Point-in-time copy of the collected SDK metrics counters. */
+typedef struct
+{
+    /** @brief Latency of the last telemetry publish in milliseconds. */
+    int64_t publish_latency_last_ms;
+    /** @brief Highest telemetry publish latency seen in milliseconds. */
+    int64_t publish_latency_max_ms;
+    /** @brief Messages dropped from the internal queues. */
+    uint32_t queue_drops;
+    /** @brief Expiries of the telemetry scheduler timer. */
+    uint32_t timer_wakeups;
+} edgehog_sdk_metrics_snapshot_t;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SDK_METRICS
+
+/**
+ * @brief Record the outcome of a completed OTA image download.
+ *
+ * @param[in] bytes Number of bytes downloaded over the wire.
+ * @param[in] duration_ms Duration of the download in milliseconds.
+ */
+void sdk_metrics_record_ota_download(size_t bytes, int64_t duration_ms);
+
+/**
+ * @brief Record the latency of one telemetry publish.
+ *
+ * @param[in] latency_ms Time spent inside the publish in milliseconds.
+ */
+void sdk_metrics_record_publish_latency(int64_t latency_ms);
+
+/**
+ * @brief Record a message dropped from one of the internal queues.
+ */
+void sdk_metrics_record_queue_drop(void);
+
+/**
+ * @brief Record an expiry of the telemetry scheduler timer.
+ */
+void sdk_metrics_record_timer_wakeup(void);
+
+/**
+ * @brief Copy the current counter values into a snapshot.
+ *
+ * @param[out] snapshot The snapshot to fill.
+ */
+void sdk_metrics_snapshot(edgehog_sdk_metrics_snapshot_t *snapshot);
+
+/**
+ * @brief Publish the collected SDK metrics.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle.
+ */
+void publish_sdk_metrics(edgehog_device_handle_t edgehog_device);
+
+#else
+
+static inline void sdk_metrics_record_ota_download(size_t bytes, int64_t duration_ms)
+{
+    ARG_UNUSED(bytes);
+    ARG_UNUSED(duration_ms);
+}
+
+static inline void sdk_metrics_record_publish_latency(int64_t latency_ms)
+{
+    ARG_UNUSED(latency_ms);
+}
+
+static inline void sdk_metrics_record_queue_drop(void)
+{
+}
+
+static inline void sdk_metrics_record_timer_wakeup(void)
+{
+}
+
+static inline void sdk_metrics_snapshot(edgehog_sdk_metrics_snapshot_t *snapshot)
+{
+    *snapshot = (edgehog_sdk_metrics_snapshot_t) { 0 };
+}
+
+static inline void publish_sdk_metrics(edgehog_device_handle_t edgehog_device)
+{
+    ARG_UNUSED(edgehog_device);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_SDK_METRICS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SDK_METRICS_H
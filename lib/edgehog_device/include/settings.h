@@ -23,6 +23,34 @@
 
 #include <zephyr/settings/settings.h>
 
+/** @brief Maximum number of entries that a settings transaction can stage. */
+#define EDGEHOG_SETTINGS_TRANSACTION_MAX_ENTRIES 4
+
+/**
+ * @brief Settings transaction staging multiple keys for a single backend commit.
+ *
+ * @details The staged entries are packed into a single settings record, so the backend performs
+ * one commit however many keys the transaction contains. The packed record replaces any record
+ * committed by a previous transaction on the same subtree, keys not staged again are dropped.
+ */
+typedef struct
+{
+    /** @brief Subtree all the staged keys belong to. */
+    const char *subtree;
+    /** @brief The staged entries. */
+    struct
+    {
+        /** @brief Key of the settings item. */
+        const char *key;
+        /** @brief Value of the settings item, owned by the caller until the commit. */
+        const void *value;
+        /** @brief Size in bytes of the value. */
+        size_t value_len;
+    } entries[EDGEHOG_SETTINGS_TRANSACTION_MAX_ENTRIES];
+    /** @brief Number of staged entries. */
+    size_t entries_len;
+} edgehog_settings_transaction_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -76,6 +104,44 @@ edgehog_result_t edgehog_settings_save(
  */
 edgehog_result_t edgehog_settings_delete(const char *subtree, const char *key);
 
+/**
+ * @brief Start a settings transaction.
+ *
+ * @param[out] transaction The transaction to initialize.
+ * @param[in] subtree subtree name all the staged keys belong to.
+ */
+void edgehog_settings_transaction_begin(
+    edgehog_settings_transaction_t *transaction, const char *subtree);
+
+/**
+ * @brief Stage a value in a settings transaction.
+ *
+ * @details Nothing is persisted until #edgehog_settings_transaction_commit is called, the value
+ * pointer must remain valid until then.
+ *
+ * @param[inout] transaction The transaction to stage the value in.
+ * @param[in] key key of the settings item.
+ * @param[in] value Pointer to the value of the settings item.
+ * @param[in] value_len Size in bytes of the value.
+ *
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_settings_transaction_set(
+    edgehog_settings_transaction_t *transaction, const char *key, const void *value,
+    size_t value_len);
+
+/**
+ * @brief Commit all the staged values of a transaction with a single backend commit.
+ *
+ * @details The values are delivered back through #edgehog_settings_load as individual keys, the
+ * loader callbacks do not need to know whether a key was saved individually or in a transaction.
+ *
+ * @param[inout] transaction The transaction to commit.
+ *
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+edgehog_result_t edgehog_settings_transaction_commit(edgehog_settings_transaction_t *transaction);
+
 #ifdef __cplusplus
 }
 #endif
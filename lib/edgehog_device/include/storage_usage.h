@@ -25,6 +25,15 @@ extern "C" {
  */
 void publish_storage_usage(edgehog_device_handle_t edgehog_device);
 
+/**
+ * @brief Invalidate the cached settings storage usage figures.
+ *
+ * @details The NVS/ZMS free space accounting is cached since it requires a flash walk, and its
+ * result only changes when the settings backend is written. To be called after every write or
+ * delete on the Edgehog settings, the next usage collection then performs a full rescan.
+ */
+void storage_usage_settings_cache_invalidate(void);
+
 #ifdef __cplusplus
 }
 #endif
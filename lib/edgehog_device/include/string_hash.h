@@ -0,0 +1,41 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef STRING_HASH_H
+#define STRING_HASH_H
+
+/**
+ * @file string_hash.h
+ * @brief String hashing helper shared by the event routing fast paths.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Compute the FNV-1a 32 bit hash of a NULL terminated string.
+ *
+ * @param[in] str The string to hash.
+ * @return The hash of the string.
+ */
+static inline uint32_t edgehog_string_hash(const char *str)
+{
+    uint32_t hash = 2166136261U;
+    for (const char *chr = str; *chr != '\0'; chr++) {
+        hash ^= (uint8_t) *chr;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STRING_HASH_H
@@ -14,6 +14,15 @@
 
 #include "edgehog_device/device.h"
 
+/** @brief Point in time system status sample. */
+typedef struct
+{
+    /** @brief Estimate of the available memory in bytes. */
+    size_t avail_memory;
+    /** @brief Number of allocated/running threads. */
+    int task_count;
+} system_status_sample_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +34,13 @@ extern "C" {
  */
 void publish_system_status(edgehog_device_handle_t edgehog_device);
 
+/**
+ * @brief Take a system status sample.
+ *
+ * @param[out] sample Sample to fill with the current system status.
+ */
+void system_status_sample(system_status_sample_t *sample);
+
 #ifdef __cplusplus
 }
 #endif
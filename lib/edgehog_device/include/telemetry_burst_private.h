@@ -0,0 +1,38 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TELEMETRY_BURST_PRIVATE_H
+#define TELEMETRY_BURST_PRIVATE_H
+
+/**
+ * @file telemetry_burst_private.h
+ * @brief Private burst telemetry functions.
+ */
+
+#include "edgehog_device/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
+/**
+ * @brief Upload all buffered burst samples as one batch.
+ *
+ * @details Called by the telemetry service thread when it receives a
+ * #EDGEHOG_TELEMETRY_SYSTEM_STATUS_BURST message. Each sample is published with the timestamp
+ * recorded when it was taken.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle.
+ */
+void edgehog_telemetry_burst_flush(edgehog_device_handle_t edgehog_device);
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_BURST_PRIVATE_H
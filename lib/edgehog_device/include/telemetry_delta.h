@@ -0,0 +1,78 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TELEMETRY_DELTA_H
+#define TELEMETRY_DELTA_H
+
+/**
+ * @file telemetry_delta.h
+ * @brief Change detection cache for periodic telemetry payloads.
+ *
+ * @details Telemetry publishers hand their payload to this cache before sending. A payload that
+ * matches the last published one for the same key is skipped, unless the last publish is older
+ * than the configured maximum age, so steady-state telemetry traffic drops to the forced
+ * refresh rate while changes are still published immediately.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_DELTA
+
+/**
+ * @brief Check if a telemetry payload should be published.
+ *
+ * @details When this function returns true the cache is updated assuming the caller publishes
+ * the payload. If the publish fails afterwards call #telemetry_delta_invalidate so the next
+ * period retries.
+ *
+ * @param[in] key Stable identifier for the telemetry stream, e.g. the Astarte path.
+ * @param[in] payload The payload content to compare, timestamps and other always-changing
+ * fields should be left out by the caller.
+ * @param[in] payload_len Length in bytes of @p payload.
+ * @return True if the payload changed or the forced refresh age expired, false otherwise.
+ */
+bool telemetry_delta_should_publish(const char *key, const void *payload, size_t payload_len);
+
+/**
+ * @brief Drop the cache entry for a telemetry stream.
+ *
+ * @details To be called when a publish accounted by #telemetry_delta_should_publish failed, so
+ * the payload is sent again on the next period.
+ *
+ * @param[in] key Stable identifier for the telemetry stream.
+ */
+void telemetry_delta_invalidate(const char *key);
+
+#else
+
+static inline bool telemetry_delta_should_publish(
+    const char *key, const void *payload, size_t payload_len)
+{
+    ARG_UNUSED(key);
+    ARG_UNUSED(payload);
+    ARG_UNUSED(payload_len);
+    return true;
+}
+
+static inline void telemetry_delta_invalidate(const char *key)
+{
+    ARG_UNUSED(key);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_DELTA
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_DELTA_H
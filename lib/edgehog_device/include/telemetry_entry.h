@@ -26,8 +26,8 @@ typedef struct
     int64_t period_seconds;
     /** @brief Enables the telemetry. */
     bool enable;
-    /** @brief Struct of telemetry timer. */
-    struct k_timer timer;
+    /** @brief Next transmission deadline as system uptime in ms, 0 when not scheduled. */
+    int64_t next_deadline_ms;
 } edgehog_telemetry_entry_t;
 
 /** @brief Telemetry period used by default for new entries. */
@@ -49,6 +49,13 @@ extern "C" {
 edgehog_telemetry_entry_t *telemetry_entry_new(
     edgehog_telemetry_type_t type, int64_t period_seconds, bool enable);
 
+/**
+ * @brief Release a telemetry entry back to the entry pool.
+ *
+ * @param[in] entry The telemetry entry to release, might be NULL.
+ */
+void telemetry_entry_free(edgehog_telemetry_entry_t *entry);
+
 /**
  * @brief Load telemetry entries from settings.
  *
@@ -23,26 +23,39 @@
  * @brief Data struct for a telemetry instance.
  *
  * @details Defines the Telemetry data used by Edgehog telemetry.
- * The two arrays `configs` and `entries` are separated because following a set-unset cycle
- * each telemetry entry has to return to the initially configured state.
+ * The base configuration and the `entries` array are separated because following a set-unset
+ * cycle each telemetry entry has to return to the initially configured state.
  *
  */
 typedef struct
 {
-    /** @brief Base configurations provided by the user. */
-    edgehog_telemetry_config_t *configs;
-    /** @brief Length of base configurations. */
-    size_t configs_len;
+    /** @brief Base periods provided by the user, indexed by type, negative when unconfigured. */
+    long config_periods[EDGEHOG_TELEMETRY_LEN];
+    /** @brief True when the instance lives in the internal static storage. */
+    bool statically_allocated;
     /** @brief Telemetry entries list. */
     edgehog_telemetry_entry_t *entries[EDGEHOG_TELEMETRY_LEN];
     /** @brief Message queue. */
     struct k_msgq msgq;
+    /** @brief Bitmask of the types currently in the msgq, duplicate requests coalesce on it. */
+    atomic_t pending_types;
     /** @brief Ring buffer that holds queued messages. */
     char msgq_buffer[EDGEHOG_TELEMETRY_LEN * sizeof(edgehog_telemetry_type_t)];
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+    /** @brief Device handle, used by the publish work handler. */
+    edgehog_device_handle_t device;
+    /** @brief Work item draining the msgq on the system workqueue. */
+    struct k_work publish_work;
+#else
     /** @brief Telemetry service thread, peeks the msgq and transmits eventual messages. */
     struct k_thread thread;
-    /** @brief Run state for the telemetry service thread. */
+#endif
+    /** @brief Run state for the telemetry service. */
     atomic_t thread_state;
+    /** @brief Single scheduler timer, armed on the earliest entry deadline. */
+    struct k_timer timer;
+    /** @brief Lock protecting the entry deadlines and the scheduler timer. */
+    struct k_spinlock sched_lock;
 } edgehog_telemetry_t;
 
 #ifdef __cplusplus
@@ -57,6 +70,20 @@ extern "C" {
  */
 edgehog_telemetry_t *edgehog_telemetry_new(edgehog_telemetry_config_t *configs, size_t configs_len);
 
+/**
+ * @brief Create an Edgehog telemetry service in the internal static storage.
+ *
+ * @details Behaves like #edgehog_telemetry_new but places the service context in a statically
+ * allocated instance instead of the heap. A single static instance is available, the storage is
+ * released by #edgehog_telemetry_destroy.
+ *
+ * @param configs An array of user configuration entries.
+ * @param configs_len Number of configuration elements.
+ * @return A pointer to Edgehog telemetry or a NULL if the static instance is already in use.
+ */
+edgehog_telemetry_t *edgehog_telemetry_new_static(
+    edgehog_telemetry_config_t *configs, size_t configs_len);
+
 /**
  * @brief Start an Edgehog telemetry service.
  *
@@ -111,6 +138,45 @@ edgehog_result_t edgehog_telemetry_config_set_event(
 edgehog_result_t edgehog_telemetry_config_unset_event(
     edgehog_telemetry_t *telemetry, astarte_device_data_event_t *event);
 
+/**
+ * @brief Request the transmission of a telemetry type.
+ *
+ * @details Safe to call from any context, including timer expiry. A request for a type that is
+ * already queued coalesces with the pending one, so a stalled link never piles up duplicates
+ * and the queue cannot overflow.
+ *
+ * @param telemetry A valid Edgehog telemetry handle.
+ * @param type The telemetry type to transmit.
+ *
+ * @return EDGEHOG_RESULT_OK if the request is queued or coalesced, an edgehog_result_t
+ * otherwise.
+ */
+edgehog_result_t edgehog_telemetry_request(
+    edgehog_telemetry_t *telemetry, edgehog_telemetry_type_t type);
+
+/**
+ * @brief Notify the telemetry service that a message has been queued.
+ *
+ * @details In the workqueue execution mode this submits the publish work item, the service
+ * thread mode polls the message queue and needs no notification.
+ *
+ * @param telemetry A valid Edgehog telemetry handle.
+ */
+void edgehog_telemetry_signal(edgehog_telemetry_t *telemetry);
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+/**
+ * @brief Notify the telemetry scheduler that the transport is currently awake.
+ *
+ * @details Flushes every entry inside its radio alignment slack window, so held publishes
+ * piggyback on the active transport instead of forcing their own radio wakeup later. Safe to
+ * call from any context, a no-op when the service is not running or no entry is close to due.
+ *
+ * @param telemetry A valid Edgehog telemetry handle.
+ */
+void edgehog_telemetry_transport_active(edgehog_telemetry_t *telemetry);
+#endif
+
 /**
  * @brief Check if the Edgehog telemetry service is running.
  *
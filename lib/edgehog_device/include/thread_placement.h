@@ -0,0 +1,74 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+/**
+ * @file thread_placement.h
+ * @brief Kconfig driven priority and CPU placement for the SDK service threads.
+ *
+ * @details With CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT enabled the service threads are created
+ * held (#EDGEHOG_THREAD_START_DELAY), the configured CPU mask is applied while they are not yet
+ * runnable, as the scheduler requires, and they are then released. With the option disabled the
+ * threads start at creation and the release call compiles down to nothing.
+ */
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT
+
+/** @brief Start delay for the service threads, held until their placement is applied. */
+#define EDGEHOG_THREAD_START_DELAY K_FOREVER
+
+/**
+ * @brief Apply the configured CPU mask to a thread and start it.
+ *
+ * @param[in] thread Thread created with #EDGEHOG_THREAD_START_DELAY, not yet started.
+ * @param[in] cpu_mask Bitmask of the CPUs the thread may run on, zero keeps the default mask.
+ */
+static inline void edgehog_thread_placement_start(k_tid_t thread, uint32_t cpu_mask)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+    if (cpu_mask != 0) {
+        k_thread_cpu_mask_clear(thread);
+        for (int cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; cpu++) {
+            if ((cpu_mask & BIT(cpu)) != 0) {
+                k_thread_cpu_mask_enable(thread, cpu);
+            }
+        }
+    }
+#else
+    ARG_UNUSED(cpu_mask);
+#endif
+    k_thread_start(thread);
+}
+
+#else
+
+#define EDGEHOG_THREAD_START_DELAY K_NO_WAIT
+
+static inline void edgehog_thread_placement_start(k_tid_t thread, uint32_t cpu_mask)
+{
+    // The thread was started at creation, nothing left to do
+    ARG_UNUSED(thread);
+    ARG_UNUSED(cpu_mask);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREAD_PLACEMENT_H
@@ -0,0 +1,100 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * @file trace.h
+ * @brief Hot-path trace points for the SDK internals.
+ *
+ * @details Trace points mark the stage boundaries of the HTTP, OTA and file transfer paths with
+ * cycle-counter timestamps in a RAM ring buffer, readable through the `edgehog_trace` shell
+ * command. The whole machinery compiles out without @c CONFIG_EDGEHOG_DEVICE_TRACE, the
+ * #EDGEHOG_TRACE macro then expands to nothing.
+ */
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Traceable stage boundaries. */
+typedef enum
+{
+    /** @brief A DNS resolution for a server hostname completed. */
+    EDGEHOG_TRACE_HTTP_DNS_RESOLVED = 1,
+    /** @brief A TCP (and eventual TLS) connection to a server completed. */
+    EDGEHOG_TRACE_HTTP_SOCKET_CONNECTED,
+    /** @brief An HTTP request is about to be sent. */
+    EDGEHOG_TRACE_HTTP_REQUEST_START,
+    /** @brief The first response byte of an HTTP request arrived. */
+    EDGEHOG_TRACE_HTTP_FIRST_BYTE,
+    /** @brief A secondary slot flash page is about to be erased. */
+    EDGEHOG_TRACE_OTA_ERASE,
+    /** @brief An OTA image chunk is about to be written to flash. */
+    EDGEHOG_TRACE_OTA_FLASH_WRITE,
+    /** @brief An OTA image chunk is about to be decompressed. */
+    EDGEHOG_TRACE_OTA_DECOMPRESS,
+    /** @brief A file transfer chunk arrived from the server. */
+    EDGEHOG_TRACE_FT_CHUNK,
+    /** @brief A file transfer chunk is about to be hashed into the digest. */
+    EDGEHOG_TRACE_FT_DIGEST_UPDATE,
+} edgehog_trace_point_t;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TRACE
+
+/**
+ * @brief Callback handed one recorded trace entry by #edgehog_trace_read.
+ *
+ * @param[in] cycles Cycle counter value at the time of the record.
+ * @param[in] point The recorded trace point.
+ * @param[in] user_data User specified data passed to #edgehog_trace_read.
+ */
+typedef void (*edgehog_trace_read_cbk_t)(
+    uint32_t cycles, edgehog_trace_point_t point, void *user_data);
+
+/**
+ * @brief Record a trace point in the ring buffer.
+ *
+ * @param[in] point The stage boundary being crossed.
+ */
+void edgehog_trace_record(edgehog_trace_point_t point);
+
+/**
+ * @brief Read the recorded trace entries, oldest first.
+ *
+ * @details Recording keeps running while the buffer is read, entries written meanwhile may be
+ * missed or torn. Quiesce the traced paths first for an exact picture.
+ *
+ * @param[in] cbk Callback invoked once per recorded entry.
+ * @param[in] user_data User specified data passed to the callback.
+ */
+void edgehog_trace_read(edgehog_trace_read_cbk_t cbk, void *user_data);
+
+/**
+ * @brief Get a human readable name for a trace point.
+ *
+ * @param[in] point The trace point.
+ * @return A static string naming the point.
+ */
+const char *edgehog_trace_point_name(edgehog_trace_point_t point);
+
+/** @brief Record a trace point, compiled out when tracing is disabled. */
+#define EDGEHOG_TRACE(point) edgehog_trace_record(point)
+
+#else
+
+#define EDGEHOG_TRACE(point) ((void) 0)
+
+#endif // CONFIG_EDGEHOG_DEVICE_TRACE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
@@ -61,12 +61,12 @@ struct wifi_scan
     char msgq_buffer[WIFI_SCAN_MAX_SCAN_RESULT * sizeof(struct wifi_scan_result_data)];
     /** @brief WiFi scan event callback. */
     struct net_mgmt_event_callback wifi_scan_cb;
-    /** @brief Main thread deputated to the transmission of messages to Astarte. */
-    struct k_thread thread;
-    /** @brief State of the transmission thread. */
-    atomic_t thread_state;
-    /** @brief Scan timeout to avoid deadlocks. */
-    struct k_timer timeout_timer;
+    /** @brief Work item deputated to the transmission of messages to Astarte. */
+    struct k_work transmit_work;
+    /** @brief Delayable work item enforcing the scan timeout to avoid deadlocks. */
+    struct k_work_delayable timeout_work;
+    /** @brief State of the scan state machine. */
+    atomic_t scan_state;
 };
 
 /**
@@ -81,7 +81,7 @@ edgehog_result_t edgehog_wifi_scan_init(edgehog_device_handle_t edgehog_device);
  * @brief Destroy a wifi scan module, interrupting any scan being performed.
  *
  * @param edgehog_device The handle to the edgehog device that manages the scans.
- * @param timeout A timeout used to interrupt the internal wifi scan thread.
+ * @param timeout Unused, canceling the internal scan work items is synchronous.
  * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
  */
 edgehog_result_t edgehog_wifi_scan_destroy(
@@ -157,6 +157,18 @@ typedef struct
     char padding[ZTAR_HEADER_HEADER_PADDING];
 } ztar_header_t;
 
+/**
+ * @brief Sum every byte of a 512-byte header block.
+ *
+ * @details Word-wise accumulation kernel shared by the pack and unpack checksum paths. Header
+ * processing is pure CPU on the transfer critical path and archives with many small members pay
+ * this sum once per member.
+ *
+ * @param[in] header The header block to sum.
+ * @return The unsigned sum of the 512 header bytes.
+ */
+uint32_t ztar_header_block_sum(const ztar_header_t *header);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,112 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZTAR_INDEX_H
+#define ZTAR_INDEX_H
+
+/**
+ * @file ztar/index.h
+ * @brief TAR archive indexing and seek-based extraction APIs.
+ * @details These APIs complement the linear stream parser for archives already stored on a
+ * seekable medium. An index scan visits only the 512-byte header blocks, skipping over the file
+ * data, so locating one member of a large bundle costs a handful of reads instead of streaming
+ * the whole archive. Extracting a located member then costs only reads proportional to the
+ * member size.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ztar/core.h"
+#include "ztar/unpack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reader callback fetching archive bytes at an arbitrary offset.
+ *
+ * @param[in] offset Byte offset from the start of the archive.
+ * @param[out] buffer Output buffer to fill with archive data.
+ * @param[in] size Number of bytes to read.
+ * @param[in,out] user_data User specified data.
+ * @return The number of bytes read, a short read means the archive ends early. A negative value
+ * on error, aborting the operation in progress.
+ */
+typedef int (*ztar_seek_read_cbk_t)(size_t offset, uint8_t *buffer, size_t size, void *user_data);
+
+/** @brief Index entry locating one member inside an archive. */
+typedef struct
+{
+    /** @brief Byte offset of the member's header block from the start of the archive. */
+    size_t header_offset;
+    /** @brief Byte offset of the member's file data from the start of the archive. */
+    size_t data_offset;
+    /** @brief Size of the member's file data in bytes. */
+    size_t file_size;
+} ztar_index_entry_t;
+
+/**
+ * @brief Callback invoked for each member found during an index scan.
+ *
+ * @param[in] header Pointer to the parsed TAR header, only valid for the callback duration.
+ * @param[in] entry Index entry locating the member, only valid for the callback duration.
+ * @param[in,out] user_data User specified data.
+ * @return 0 to continue scanning, a positive value to stop the scan early, or a negative value
+ * on error. The scan will abort if an error is returned.
+ */
+typedef int (*ztar_index_entry_cbk_t)(
+    const ztar_header_t *header, const ztar_index_entry_t *entry, void *user_data);
+
+/**
+ * @brief Scan an archive building its index, one entry callback per member.
+ * @details Only the header blocks are read, the file data is skipped over by seeking. The caller
+ * decides how to store the produced entries, keeping this parser free of allocations.
+ *
+ * @param[in] read_cbk Reader used to fetch archive bytes.
+ * @param[in,out] read_user_data User specified data passed to the reader.
+ * @param[in] entry_cbk Callback invoked for each member found.
+ * @param[in,out] entry_user_data User specified data passed to the entry callback.
+ * @return ZTAR_RESULT_OK if successful, otherwise a ztar_result_t error code.
+ */
+ztar_result_t ztar_index_scan(ztar_seek_read_cbk_t read_cbk, void *read_user_data,
+    ztar_index_entry_cbk_t entry_cbk, void *entry_user_data);
+
+/**
+ * @brief Locate a single member of an archive by its full file name.
+ *
+ * @param[in] read_cbk Reader used to fetch archive bytes.
+ * @param[in,out] read_user_data User specified data passed to the reader.
+ * @param[in] file_name Full file name of the member, as stored in the archive.
+ * @param[out] entry Output index entry for the located member.
+ * @return ZTAR_RESULT_OK if the member has been found, ZTAR_RESULT_ARCHIVE_EXAHUSTED if the
+ * archive does not contain it, otherwise a ztar_result_t error code.
+ */
+ztar_result_t ztar_index_find(ztar_seek_read_cbk_t read_cbk, void *read_user_data,
+    const char *file_name, ztar_index_entry_t *entry);
+
+/**
+ * @brief Extract a single member located by an index entry.
+ * @details Reads only the member's header and file data, invoking the standard unpack callbacks
+ * as the linear parser would. The cost is proportional to the member size, not to the archive
+ * size.
+ *
+ * @param[in] read_cbk Reader used to fetch archive bytes.
+ * @param[in,out] read_user_data User specified data passed to the reader.
+ * @param[in] entry Index entry locating the member, from #ztar_index_scan or #ztar_index_find.
+ * @param[in] callbacks Struct containing parser event callbacks.
+ * @param[in,out] cbk_user_data User specified data passed to the parser callbacks.
+ * @return ZTAR_RESULT_OK if successful, otherwise a ztar_result_t error code.
+ */
+ztar_result_t ztar_index_extract(ztar_seek_read_cbk_t read_cbk, void *read_user_data,
+    const ztar_index_entry_t *entry, ztar_unpack_callbacks_t callbacks, void *cbk_user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZTAR_INDEX_H
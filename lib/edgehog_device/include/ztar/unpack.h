@@ -42,7 +42,8 @@ typedef struct
      * @brief Callback invoked when file data is read from the stream.
      *
      * @param[in] header Pointer to the parsed TAR header.
-     * @param[in] data Pointer to the file data chunk.
+     * @param[in] data Pointer to the file data chunk. This points directly into the input buffer
+     * passed to #ztar_unpack_process (zero-copy) and is only valid for the callback duration.
      * @param[in] size Size of the file data chunk.
      * @param[in,out] user_data User specified data.
      * @return 0 if successful, -1 on error. The stream parser will abort if an error is returned.
@@ -82,6 +83,8 @@ typedef struct
     ztar_unpack_state_t state;
     /** @brief The TAR header currently being processed. */
     ztar_header_t current_header;
+    /** @brief Size of the file described by the current header, cached at header parse time. */
+    size_t current_file_size;
     /** @brief Number of bytes processed in the current header. */
     size_t bytes_processed_in_header;
     /** @brief Number of bytes processed in the current file data. */
@@ -125,6 +128,15 @@ bool ztar_unpack_is_initialized(const ztar_unpack_t *stream);
  */
 ztar_result_t ztar_unpack_process(ztar_unpack_t *stream, const uint8_t *data, size_t size);
 
+/**
+ * @brief Validate a raw TAR header block.
+ * @details Checks the USTAR magic, the version string and the header checksum.
+ *
+ * @param[in] header Pointer to the TAR header to validate.
+ * @return ZTAR_RESULT_OK if the header is valid, otherwise a ztar_result_t error code.
+ */
+ztar_result_t ztar_unpack_validate_header(const ztar_header_t *header);
+
 /**
  * @brief Extract the full file name from a parsed TAR header.
  * @details In USTAR, if the prefix is populated, the full path is prefix + '/' + name.
@@ -22,12 +22,28 @@ EDGEHOG_LOG_MODULE_REGISTER(led, CONFIG_EDGEHOG_DEVICE_LED_LOG_LEVEL);
 #define DOUBLE_BLINK_DELAY_OFF 200
 #define SLOW_BLINK_DELAY 2000
 
-#define THREAD_STACK_SIZE 1024
 #define LED_STATE_RUN_BIT (1)
 
-// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
-K_THREAD_STACK_DEFINE(led_thread_stack, THREAD_STACK_SIZE);
-// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+static const struct gpio_dt_spec edgehog_led_dev = GPIO_DT_SPEC_GET(EDGEHOG_LED_NODE, gpios);
+
+// Each pattern is a cycle of levels and hold times. The pattern timer sets the level of the
+// current step and rearms itself with the step duration, no thread is involved.
+static const led_pattern_step_t single_blink_pattern[] = {
+    { .level = 1, .duration_ms = BLINK_DELAY },
+    { .level = 0, .duration_ms = BLINK_DELAY },
+};
+
+static const led_pattern_step_t slow_blink_pattern[] = {
+    { .level = 1, .duration_ms = SLOW_BLINK_DELAY },
+    { .level = 0, .duration_ms = SLOW_BLINK_DELAY },
+};
+
+static const led_pattern_step_t double_blink_pattern[] = {
+    { .level = 1, .duration_ms = DOUBLE_BLINK_DELAY_ON },
+    { .level = 0, .duration_ms = DOUBLE_BLINK_DELAY_OFF },
+    { .level = 1, .duration_ms = DOUBLE_BLINK_DELAY_ON },
+    { .level = 0, .duration_ms = BLINK_DELAY },
+};
 
 /************************************************
  *         Static functions declaration         *
@@ -37,110 +53,56 @@ K_THREAD_STACK_DEFINE(led_thread_stack, THREAD_STACK_SIZE);
  * @brief Start a one-shot timer that expires after 1 minute.
  *
  * @param[in] led_blink_timer Handle to valid led blink timer.
- * @param[in] led_run_state Handle to valid led run state.
  */
-static void set_blink_timer(struct k_timer *led_blink_timer, atomic_t *led_run_state);
+static void set_blink_timer(struct k_timer *led_blink_timer);
 
 /**
  * @brief Setup Edgehog LED.
  *
- * @param[in] edgehog_led_dev Handle to valid edgehog gpio_dt_spec.
+ * @param[in] led_dev Handle to valid edgehog gpio_dt_spec.
  * @return EDGEHOG_RESULT_OK if setup has been successful, an error code otherwise.
  */
-static edgehog_result_t edgehog_led_setup(const struct gpio_dt_spec *edgehog_led_dev);
+static edgehog_result_t edgehog_led_setup(const struct gpio_dt_spec *led_dev);
 
 /**
- * @brief Get a k_thread_entry_t function based on the astarte value.
+ * @brief Get a blink pattern based on the astarte value.
  *
  * @param[in] value An astarte individual value representing the LED behaviour to select.
- * @param[out] blink_entry k_thread_entry_t struct used to store the blink entry function.
- * @return EDGEHOG_RESULT_OK if publish has been successful, an error code otherwise.
+ * @param[out] pattern Used to store the selected pattern steps.
+ * @param[out] pattern_len Used to store the number of steps of the selected pattern.
+ * @return EDGEHOG_RESULT_OK if a pattern has been selected, an error code otherwise.
  */
-static edgehog_result_t get_blink_entry(astarte_data_t value, k_thread_entry_t *blink_entry);
+static edgehog_result_t get_blink_pattern(
+    astarte_data_t value, const led_pattern_step_t **pattern, size_t *pattern_len);
 
 /************************************************
  *       Callbacks declaration/definition       *
  ***********************************************/
 
-static void blink_entry_point(
-    const struct gpio_dt_spec *edgehog_led_dev, atomic_t *led_run_state, k_timeout_t period)
-{
-    if (!edgehog_led_dev) {
-        EDGEHOG_LOG_ERR("No devices with compatible edgehog_led found");
-        return;
-    }
-
-    while (atomic_test_bit(led_run_state, LED_STATE_RUN_BIT)) {
-        int ret = gpio_pin_toggle_dt(edgehog_led_dev);
-        if (ret < 0) {
-            EDGEHOG_LOG_ERR("Unable to toggle Edgehog LED");
-        }
-        k_sleep(period);
-    }
-
-    gpio_pin_set_dt(edgehog_led_dev, 0);
-}
-
-static void single_blink_entry_point(void *led_run_state, void *ptr2, void *ptr3)
+static void pattern_timer_expiry(struct k_timer *timer_id)
 {
-    ARG_UNUSED(ptr2);
-    ARG_UNUSED(ptr3);
+    led_blink_t *led_blink = CONTAINER_OF(timer_id, led_blink_t, led_pattern_timer);
 
-    if (!led_run_state) {
-        return;
-    }
-
-    const struct gpio_dt_spec edgehog_led_dev = GPIO_DT_SPEC_GET(EDGEHOG_LED_NODE, gpios);
-    blink_entry_point(&edgehog_led_dev, (atomic_t *) led_run_state, K_MSEC(BLINK_DELAY));
-}
-
-static void slow_blink_entry_point(void *led_run_state, void *ptr2, void *ptr3)
-{
-    ARG_UNUSED(ptr2);
-    ARG_UNUSED(ptr3);
-
-    if (!led_run_state) {
-        return;
-    }
-
-    const struct gpio_dt_spec edgehog_led_dev = GPIO_DT_SPEC_GET(EDGEHOG_LED_NODE, gpios);
-    blink_entry_point(&edgehog_led_dev, (atomic_t *) led_run_state, K_MSEC(SLOW_BLINK_DELAY));
-}
-
-static void double_blink_entry_point(void *led_run_state, void *ptr2, void *ptr3)
-{
-    ARG_UNUSED(ptr2);
-    ARG_UNUSED(ptr3);
-
-    if (!led_run_state) {
+    if (!atomic_test_bit(&led_blink->led_run_state, LED_STATE_RUN_BIT)) {
+        gpio_pin_set_dt(&edgehog_led_dev, 0);
         return;
     }
 
-    const struct gpio_dt_spec edgehog_led_dev = GPIO_DT_SPEC_GET(EDGEHOG_LED_NODE, gpios);
-
-    while (atomic_test_bit((atomic_t *) led_run_state, LED_STATE_RUN_BIT)) {
-        gpio_pin_set_dt(&edgehog_led_dev, 1);
-        k_sleep(K_MSEC(DOUBLE_BLINK_DELAY_ON));
-        gpio_pin_set_dt(&edgehog_led_dev, 0);
-        k_sleep(K_MSEC(DOUBLE_BLINK_DELAY_OFF));
-        gpio_pin_set_dt(&edgehog_led_dev, 1);
-        k_sleep(K_MSEC(DOUBLE_BLINK_DELAY_ON));
-        gpio_pin_set_dt(&edgehog_led_dev, 0);
-        k_sleep(K_MSEC(BLINK_DELAY));
+    const led_pattern_step_t *step = &led_blink->pattern[led_blink->pattern_idx];
+    int ret = gpio_pin_set_dt(&edgehog_led_dev, step->level);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Unable to set Edgehog LED");
     }
-    gpio_pin_set_dt(&edgehog_led_dev, 0);
+    led_blink->pattern_idx = (led_blink->pattern_idx + 1) % led_blink->pattern_len;
+    k_timer_start(timer_id, K_MSEC(step->duration_ms), K_NO_WAIT);
 }
 
-extern void expiry_blink_timer(struct k_timer *timer_id)
+static void expiry_blink_timer(struct k_timer *timer_id)
 {
-    atomic_t *led_run_state = (atomic_t *) k_timer_user_data_get(timer_id);
-
-    if (!led_run_state) {
-        EDGEHOG_LOG_ERR("No led thread is running");
-        return;
-    }
+    led_blink_t *led_blink = CONTAINER_OF(timer_id, led_blink_t, led_blink_timer);
 
-    atomic_clear_bit(led_run_state, LED_STATE_RUN_BIT);
+    // The pattern timer turns the LED off and stops rearming at its next expiry
+    atomic_clear_bit(&led_blink->led_run_state, LED_STATE_RUN_BIT);
 }
 #endif
 
@@ -161,60 +123,44 @@ edgehog_result_t edgehog_led_event(
     EDGEHOG_LOG_ERR("Unable to find the edgehog LED Node in the device-tree");
     return EDGEHOG_RESULT_LED_NODE_NOT_FOUND;
 #else
-    const struct gpio_dt_spec edgehog_led_dev = GPIO_DT_SPEC_GET(EDGEHOG_LED_NODE, gpios);
-
     edgehog_result_t edgehog_result = edgehog_led_setup(&edgehog_led_dev);
 
     if (edgehog_result != EDGEHOG_RESULT_OK) {
         return edgehog_result;
     }
 
-    if (atomic_test_bit(&edgehog_dev->led_thread.led_run_state, LED_STATE_RUN_BIT)) {
+    led_blink_t *led_blink = &edgehog_dev->led_blink;
+
+    if (atomic_test_bit(&led_blink->led_run_state, LED_STATE_RUN_BIT)) {
         EDGEHOG_LOG_ERR("Unable to perform LED blink while another is still active.");
         return EDGEHOG_RESULT_LED_ALREADY_IN_PROGRESS;
     }
 
-    if (atomic_test_and_set_bit(&edgehog_dev->led_thread.led_run_state, LED_STATE_RUN_BIT)) {
+    if (atomic_test_and_set_bit(&led_blink->led_run_state, LED_STATE_RUN_BIT)) {
         EDGEHOG_LOG_ERR("Unable to set LED RUN BIT");
         edgehog_result = EDGEHOG_RESULT_OUT_OF_MEMORY;
         goto fail;
     }
 
-    struct k_thread *thread_handle = &edgehog_dev->led_thread.led_thread_handle;
-    memset(thread_handle, 0, sizeof(struct k_thread));
-
-    k_thread_entry_t blink_entry;
-
-    edgehog_result = get_blink_entry(event->individual, &blink_entry);
+    edgehog_result = get_blink_pattern(event->individual, &led_blink->pattern,
+        &led_blink->pattern_len);
 
     if (edgehog_result != EDGEHOG_RESULT_OK) {
         goto fail;
     }
 
-    k_tid_t thread_id = k_thread_create(thread_handle, led_thread_stack, THREAD_STACK_SIZE,
-        blink_entry, &edgehog_dev->led_thread.led_run_state, NULL, NULL, K_HIGHEST_THREAD_PRIO, 0,
-        K_NO_WAIT);
-
-    if (!thread_id) {
-        EDGEHOG_LOG_ERR("Led blink thread creation failed.");
-        edgehog_result = EDGEHOG_RESULT_THREAD_CREATE_ERROR;
-        goto fail;
-    }
-
-#ifdef CONFIG_THREAD_NAME
-    int ret = k_thread_name_set(thread_id, "edgehog_led_thread");
-    if (ret != 0) {
-        EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
-    }
-#endif
+    // The pattern must be in place before the first expiry, the timer runs the first step
+    // immediately
+    led_blink->pattern_idx = 0;
+    k_timer_init(&led_blink->led_pattern_timer, pattern_timer_expiry, NULL);
+    k_timer_start(&led_blink->led_pattern_timer, K_NO_WAIT, K_NO_WAIT);
 
-    set_blink_timer(
-        &edgehog_dev->led_thread.led_blink_timer, &edgehog_dev->led_thread.led_run_state);
+    set_blink_timer(&led_blink->led_blink_timer);
 
     return EDGEHOG_RESULT_OK;
 
 fail:
-    atomic_clear_bit(&edgehog_dev->led_thread.led_run_state, LED_STATE_RUN_BIT);
+    atomic_clear_bit(&led_blink->led_run_state, LED_STATE_RUN_BIT);
     return edgehog_result;
 
 #endif
@@ -226,7 +172,8 @@ fail:
 
 #if DT_NODE_HAS_STATUS(EDGEHOG_LED_NODE, okay)
 
-static edgehog_result_t get_blink_entry(astarte_data_t value, k_thread_entry_t *blink_entry)
+static edgehog_result_t get_blink_pattern(
+    astarte_data_t value, const led_pattern_step_t **pattern, size_t *pattern_len)
 {
     edgehog_result_t edgehog_result = EDGEHOG_RESULT_OK;
 
@@ -234,11 +181,14 @@ static edgehog_result_t get_blink_entry(astarte_data_t value, k_thread_entry_t *
         EDGEHOG_LOG_ERR("Unable to handle event, event value is not a string");
         edgehog_result = EDGEHOG_RESULT_ASTARTE_ERROR;
     } else if (strcmp(value.data.string, "Blink60Seconds") == 0) {
-        *blink_entry = single_blink_entry_point;
+        *pattern = single_blink_pattern;
+        *pattern_len = ARRAY_SIZE(single_blink_pattern);
     } else if (strcmp(value.data.string, "DoubleBlink60Seconds") == 0) {
-        *blink_entry = double_blink_entry_point;
+        *pattern = double_blink_pattern;
+        *pattern_len = ARRAY_SIZE(double_blink_pattern);
     } else if (strcmp(value.data.string, "SlowBlink60Seconds") == 0) {
-        *blink_entry = slow_blink_entry_point;
+        *pattern = slow_blink_pattern;
+        *pattern_len = ARRAY_SIZE(slow_blink_pattern);
     } else {
         EDGEHOG_LOG_ERR("Unable to handle event, behaivour not supported %s", value.data.string);
         edgehog_result = EDGEHOG_RESULT_ASTARTE_ERROR;
@@ -247,14 +197,14 @@ static edgehog_result_t get_blink_entry(astarte_data_t value, k_thread_entry_t *
     return edgehog_result;
 }
 
-static edgehog_result_t edgehog_led_setup(const struct gpio_dt_spec *edgehog_led_dev)
+static edgehog_result_t edgehog_led_setup(const struct gpio_dt_spec *led_dev)
 {
-    if (!gpio_is_ready_dt(edgehog_led_dev)) {
+    if (!gpio_is_ready_dt(led_dev)) {
         EDGEHOG_LOG_ERR("GPIO of Edgehog LED is not ready");
         return EDGEHOG_RESULT_LED_DEVICE_IS_NOT_READY;
     }
 
-    int ret = gpio_pin_configure_dt(edgehog_led_dev, GPIO_OUTPUT_ACTIVE);
+    int ret = gpio_pin_configure_dt(led_dev, GPIO_OUTPUT_ACTIVE);
     if (ret < 0) {
         EDGEHOG_LOG_ERR("Edgehog LED configuration error %d", ret);
         return EDGEHOG_RESULT_LED_CONFIGURE_ERROR;
@@ -263,10 +213,9 @@ static edgehog_result_t edgehog_led_setup(const struct gpio_dt_spec *edgehog_led
     return EDGEHOG_RESULT_OK;
 }
 
-static void set_blink_timer(struct k_timer *led_blink_timer, atomic_t *led_run_state)
+static void set_blink_timer(struct k_timer *led_blink_timer)
 {
     k_timer_init(led_blink_timer, expiry_blink_timer, NULL);
-    k_timer_user_data_set(led_blink_timer, (void *) led_run_state);
     k_timer_start(led_blink_timer, K_MINUTES(1), K_NO_WAIT);
 }
 
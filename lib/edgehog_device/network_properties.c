@@ -7,6 +7,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/net/net_if.h>
 #include <zephyr/net/net_l2.h>
+#include <zephyr/net/net_mgmt.h>
 
 #include "network_properties.h"
 
@@ -27,6 +28,18 @@
 
 EDGEHOG_LOG_MODULE_REGISTER(network_properties, CONFIG_EDGEHOG_DEVICE_NETWORK_PROPERTIES_LOG_LEVEL);
 
+#ifdef CONFIG_NET_MGMT_EVENT
+// The event handler runs in the net_mgmt context, it only marks the interface as pending in a
+// bitmask and defers the publish to the system workqueue.
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static struct net_mgmt_event_callback net_props_mgmt_cb;
+static struct k_work net_props_update_work;
+static edgehog_device_handle_t net_props_device;
+static atomic_t net_props_pending_ifaces;
+static bool net_props_events_registered;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
 void get_mac_address(struct net_if *iface, char *mac)
 {
     const struct net_linkaddr *link_addr = net_if_get_link_addr(iface);
@@ -86,11 +99,10 @@ struct net_publish_ctx
     edgehog_device_handle_t edgehog_device;
 };
 
-// Callback executed for each registered network interface
-static void process_interface_cb(struct net_if *iface, void *user_data)
+// Publish the properties of a single network interface
+static void publish_interface_properties(edgehog_device_handle_t edgehog_device,
+    struct net_if *iface)
 {
-    struct net_publish_ctx *ctx = user_data;
-
     char if_name[IF_NAME_LEN] = { 0 };
     char if_mac[FORMATTED_MAC_LEN] = { 0 };
     char mac_addr_endpoint[MAC_ADDR_ENDPOINT_LEN] = { 0 };
@@ -106,7 +118,7 @@ static void process_interface_cb(struct net_if *iface, void *user_data)
     snprintf(tech_type_endpoint, TECH_TYPE_ENDPOINT_LEN, "/%s/technologyType", if_name);
     // NOLINTEND(cert-err33-c)
 
-    astarte_result_t ares = astarte_device_set_property(ctx->edgehog_device->astarte_device,
+    astarte_result_t ares = astarte_device_set_property(edgehog_device->astarte_device,
         io_edgehog_devicemanager_NetworkInterfaceProperties.name, mac_addr_endpoint,
         astarte_data_from_string(if_mac));
 
@@ -114,7 +126,7 @@ static void process_interface_cb(struct net_if *iface, void *user_data)
         EDGEHOG_LOG_ERR("Unable to send network interface MAC: %s", if_name);
     }
 
-    ares = astarte_device_set_property(ctx->edgehog_device->astarte_device,
+    ares = astarte_device_set_property(edgehog_device->astarte_device,
         io_edgehog_devicemanager_NetworkInterfaceProperties.name, tech_type_endpoint,
         astarte_data_from_string(tech_type));
 
@@ -123,6 +135,67 @@ static void process_interface_cb(struct net_if *iface, void *user_data)
     }
 }
 
+// Callback executed for each registered network interface
+static void process_interface_cb(struct net_if *iface, void *user_data)
+{
+    struct net_publish_ctx *ctx = user_data;
+
+    publish_interface_properties(ctx->edgehog_device, iface);
+}
+
+#ifdef CONFIG_NET_MGMT_EVENT
+
+static void net_props_update_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    atomic_val_t pending = atomic_clear(&net_props_pending_ifaces);
+    for (int idx = 1; pending != 0; idx++, pending >>= 1) {
+        if ((pending & 1) == 0) {
+            continue;
+        }
+        struct net_if *iface = net_if_get_by_index(idx);
+        if (iface) {
+            publish_interface_properties(net_props_device, iface);
+        }
+    }
+}
+
+static void net_props_event_handler(
+    struct net_mgmt_event_callback *cb, uint64_t mgmt_event, struct net_if *iface)
+{
+    ARG_UNUSED(cb);
+
+    if (mgmt_event != NET_EVENT_IF_UP) {
+        return;
+    }
+
+    // The pending mask is shifted by one as interface indexes start from 1
+    int idx = net_if_get_by_iface(iface);
+    if ((idx <= 0) || (idx > ATOMIC_BITS)) {
+        return;
+    }
+    atomic_set_bit(&net_props_pending_ifaces, idx - 1);
+    k_work_submit(&net_props_update_work);
+}
+
+// Register the event handlers republishing the properties of an interface when it comes up,
+// the full enumeration only runs at the initial publish
+static void net_props_events_register(edgehog_device_handle_t edgehog_device)
+{
+    if (net_props_events_registered) {
+        return;
+    }
+    net_props_events_registered = true;
+
+    net_props_device = edgehog_device;
+    k_work_init(&net_props_update_work, net_props_update_work_handler);
+    net_mgmt_init_event_callback(&net_props_mgmt_cb, net_props_event_handler, NET_EVENT_IF_UP);
+    net_mgmt_add_event_callback(&net_props_mgmt_cb);
+}
+
+#endif
+
 void publish_network_properties(edgehog_device_handle_t edgehog_device)
 {
     EDGEHOG_LOG_DBG("Publishing Edgehog device network properties");
@@ -132,4 +205,9 @@ void publish_network_properties(edgehog_device_handle_t edgehog_device)
 
     // Iterate through all network interfaces safely
     net_if_foreach(process_interface_cb, &ctx);
+
+#ifdef CONFIG_NET_MGMT_EVENT
+    // Later changes are published incrementally per interface
+    net_props_events_register(edgehog_device);
+#endif
 }
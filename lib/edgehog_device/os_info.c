@@ -26,25 +26,27 @@ EDGEHOG_LOG_MODULE_REGISTER(os_info, CONFIG_EDGEHOG_DEVICE_OS_INFO_LOG_LEVEL);
 // Version will be like: "255.255.255" resulting 11 chars.
 #define OS_VERSION_SIZE 11
 
+/************************************************
+ *             Static variables                 *
+ ***********************************************/
+
+// Formatted once at snapshot time and constant afterwards, publishes read from here.
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static char os_version[OS_VERSION_SIZE + 1];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /************************************************
  *         Global functions definition          *
  ***********************************************/
 
-void publish_os_info(edgehog_device_handle_t edgehog_device)
+void os_info_snapshot(void)
 {
-    EDGEHOG_LOG_DBG("Publishing Edgehog device os info");
-    astarte_result_t res = astarte_device_set_property(edgehog_device->astarte_device,
-        io_edgehog_devicemanager_OSInfo.name, "/osName", astarte_data_from_string("Zephyr"));
-
-    if (res != ASTARTE_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to publish osName");
+    if (os_version[0] != '\0') {
         return;
     }
 
     uint32_t kernel_version = sys_kernel_version_get();
 
-    char os_version[OS_VERSION_SIZE + 1] = { 0 };
-
     int snprintf_rc = snprintf(os_version, OS_VERSION_SIZE, "%d.%d.%d",
         SYS_KERNEL_VER_MAJOR(kernel_version), // NOLINT(hicpp-signed-bitwise)
         SYS_KERNEL_VER_MINOR(kernel_version), // NOLINT(hicpp-signed-bitwise)
@@ -52,6 +54,23 @@ void publish_os_info(edgehog_device_handle_t edgehog_device)
 
     if (snprintf_rc > OS_VERSION_SIZE) {
         EDGEHOG_LOG_ERR("Incorrect length/format for os version");
+        os_version[0] = '\0';
+    }
+}
+
+void publish_os_info(edgehog_device_handle_t edgehog_device)
+{
+    EDGEHOG_LOG_DBG("Publishing Edgehog device os info");
+    astarte_result_t res = astarte_device_set_property(edgehog_device->astarte_device,
+        io_edgehog_devicemanager_OSInfo.name, "/osName", astarte_data_from_string("Zephyr"));
+
+    if (res != ASTARTE_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Unable to publish osName");
+        return;
+    }
+
+    os_info_snapshot();
+    if (os_version[0] == '\0') {
         return;
     }
 
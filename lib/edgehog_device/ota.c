@@ -11,10 +11,30 @@
 #include "edgehog_device/device.h"
 #include "edgehog_device/ota_event.h"
 #include "edgehog_private.h"
+#include "event_loop.h"
 #include "generated_interfaces.h"
+#include "heap.h"
 #include "http.h"
+#include "sdk_metrics.h"
 #include "settings.h"
+#include "string_hash.h"
 #include "system_time.h"
+#include "thread_placement.h"
+#include "trace.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+#include "file_transfer/decompression.h"
+
+#include <zephyr/sys/byteorder.h>
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE
+#include "ota_pipeline.h"
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PRE_REBOOT_VERIFY
+#include <psa/crypto.h>
+#endif
 
 #include <stdlib.h>
 
@@ -22,6 +42,7 @@
 #include <zephyr/dfu/flash_img.h>
 #include <zephyr/dfu/mcuboot.h>
 #include <zephyr/drivers/flash.h>
+#include <zephyr/net/http/status.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/sys/reboot.h>
 #include <zephyr/version.h>
@@ -34,12 +55,72 @@ EDGEHOG_LOG_MODULE_REGISTER(ota, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
  ***********************************************/
 
 #define OTA_REQ_TIMEOUT_MS (60 * 1000)
-#define MAX_OTA_RETRY 5
+#define OTA_RANGE_HEADER_BUF_SIZE 48
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+/** @brief Magic marking the start of an LZ4 frame (little-endian). */
+#define OTA_LZ4_FRAME_MAGIC 0x184D2204U
+#endif
+#define MAX_OTA_RETRY CONFIG_EDGEHOG_DEVICE_OTA_RETRY_MAX_ATTEMPTS
 #define OTA_PROGRESS_PERC 100
-#define OTA_PROGRESS_PERC_ROUNDING_STEP 10
+#define OTA_THROUGHPUT_MSG_BUF_SIZE 32
 #define OTA_ATTEMPS_DELAY_MS 2000
 #define OTA_REBOOT_MAX_DELAY_S 60
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PRE_REBOOT_VERIFY
+/** @brief Magic marking a valid MCUboot image header. */
+#define OTA_IMAGE_MAGIC 0x96f3b83dU
+/** @brief Magic marking the unprotected TLV area of an MCUboot image. */
+#define OTA_IMAGE_TLV_INFO_MAGIC 0x6907U
+/** @brief TLV type of the SHA-256 digest covering header, image and protected TLVs. */
+#define OTA_IMAGE_TLV_SHA256 0x10U
+/** @brief Chunk size used when streaming the secondary slot through the hash. */
+#define OTA_VERIFY_CHUNK_SIZE 256
+/** @brief Length of a SHA-256 digest in bytes. */
+#define OTA_SHA256_LEN 32
+
+/** @brief Raw MCUboot image header, as laid out at the start of the slot. */
+struct ota_image_header
+{
+    /** @brief Image magic, #OTA_IMAGE_MAGIC for a valid header. */
+    uint32_t magic;
+    /** @brief Load address, unused for swap based upgrades. */
+    uint32_t load_addr;
+    /** @brief Size of the header, the image body starts at this offset. */
+    uint16_t hdr_size;
+    /** @brief Size of the protected TLV area, covered by the image hash. */
+    uint16_t protect_tlv_size;
+    /** @brief Size of the image body. */
+    uint32_t img_size;
+    /** @brief Image flags. */
+    uint32_t flags;
+    /** @brief Image version, unused by the verification. */
+    uint8_t version[8];
+    /** @brief Reserved. */
+    uint32_t pad;
+};
+
+/** @brief Header of a TLV area in an MCUboot image trailer. */
+struct ota_image_tlv_info
+{
+    /** @brief TLV area magic. */
+    uint16_t magic;
+    /** @brief Total size of the TLV area, this header included. */
+    uint16_t tlv_tot;
+};
+
+/** @brief Single TLV entry in an MCUboot image trailer. */
+struct ota_image_tlv
+{
+    /** @brief Type of the entry. */
+    uint8_t type;
+    /** @brief Reserved. */
+    uint8_t pad;
+    /** @brief Length of the entry payload. */
+    uint16_t len;
+};
+#endif
+
 #define SLOT0_LABEL slot0_partition
 #define SLOT1_LABEL slot1_partition
 
@@ -56,10 +137,28 @@ EDGEHOG_LOG_MODULE_REGISTER(ota, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
 #define OTA_REQUEST_ID_KEY "req_id"
 
 #define THREAD_STACK_SIZE 8192
+#ifdef CONFIG_EDGEHOG_DEVICE_THREAD_PLACEMENT
+#define OTA_THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_OTA_THREAD_PRIORITY
+#else
+// Keep the historical placement, the OTA thread runs at the highest cooperative priority
+#define OTA_THREAD_PRIORITY K_HIGHEST_THREAD_PRIO
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_THREAD_CPU_MASK
+#define OTA_THREAD_CPU_MASK CONFIG_EDGEHOG_DEVICE_OTA_THREAD_CPU_MASK
+#else
+#define OTA_THREAD_CPU_MASK 0
+#endif
 #define OTA_STATE_RUN_BIT (1)
+#define OTA_STATE_PAUSE_BIT (2)
+#define OTA_PAUSE_POLL_MS 100
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT
+#define OTA_RATE_LIMIT_POLL_MS 10
+#endif
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+#ifndef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
 K_THREAD_STACK_DEFINE(ota_thread_stack, THREAD_STACK_SIZE);
+#endif
 
 #ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT
 #define ZBUS_SUBSCRIBER_NOTIFICATION_QUEUE_SIZE 5
@@ -137,6 +236,13 @@ static const char *swap_type_str(int swap_type);
  */
 static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+/**
+ * @brief Work handler running the OTA procedure on the shared event loop.
+ */
+static void ota_work_handler(struct k_work *work);
+#endif
+
 /**
  * @brief Waits for a reboot signal from the applcation, with a maximum wait time.
  */
@@ -171,6 +277,74 @@ static edgehog_result_t edgehog_ota_event_update(
 
 static edgehog_result_t perform_ota(edgehog_device_handle_t edgehog_device);
 static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_device);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PRE_REBOOT_VERIFY
+/**
+ * @brief Verify the downloaded image in the secondary slot before rebooting.
+ *
+ * @details Streams the slot content through a SHA-256 digest and compares it against the hash
+ * stored in the image trailer, the same check MCUboot performs at boot. Running it while the old
+ * firmware is live turns a corrupted download into a failed OTA instead of a swap and revert.
+ *
+ * @return EDGEHOG_RESULT_OK when the image digest matches, an error code otherwise.
+ */
+static edgehog_result_t verify_secondary_slot_image(void);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RETRY_BACKOFF
+/**
+ * @brief Compute the backoff delay before the next OTA download retry.
+ *
+ * @details Exponential delay doubled on every attempt and capped by the configured maximum. The
+ * sleep is drawn uniformly from the upper half of the delay using a per-device generator seeded
+ * from the boot ID, spreading the retries of a fleet hitting the same failure.
+ *
+ * @param[in] edgehog_device Handle to the Edgehog device instance.
+ * @param[in] attempt Zero-based index of the attempt that just failed.
+ * @return The delay to sleep in milliseconds.
+ */
+static int64_t ota_backoff_delay_ms(edgehog_device_handle_t edgehog_device, uint8_t attempt);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT
+/**
+ * @brief Refill the download rate-limit token bucket based on the elapsed time.
+ *
+ * @param[inout] thread_data OTA thread data holding the token bucket state.
+ */
+static void ota_rate_limit_refill(ota_thread_data_t *thread_data);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+/**
+ * @brief Reset the erase-ahead state, skipping the pages already holding committed data.
+ *
+ * @param[inout] thread_data OTA thread data with an open secondary slot flash area.
+ * @param[in] committed Number of bytes already committed to the secondary slot.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+static edgehog_result_t ota_erase_ahead_reset(ota_thread_data_t *thread_data, size_t committed);
+
+/**
+ * @brief Erase secondary slot pages up to the target offset, ahead of the write pointer.
+ *
+ * @param[inout] thread_data OTA thread data with an open secondary slot flash area.
+ * @param[in] target Offset the slot has to be erased up to, capped to the slot size.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+static edgehog_result_t ota_erase_ahead(ota_thread_data_t *thread_data, size_t target);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+/**
+ * @brief Write callback passing decompressed image bytes to the image flash context.
+ *
+ * @param[in] data Pointer to the decompressed data chunk.
+ * @param[in] size Size of the decompressed data chunk.
+ * @param[inout] user_data Image flash context for the secondary slot.
+ * @return 0 on success, negative value on error.
+ */
+static int ota_decompression_write_cbk(const uint8_t *data, size_t size, void *user_data);
+#endif
 
 /**
  * @brief Handle an OTA cancel operation event.
@@ -262,10 +436,13 @@ void edgehog_ota_init(edgehog_device_handle_t edgehog_dev)
         EDGEHOG_RESULT_OK, "");
 
 end:
-    edgehog_settings_delete(OTA_KEY, OTA_REQUEST_ID_KEY);
+    // One committed record replaces both keys, dropping the request ID and storing the idle state
     ota_settings.ota_state = OTA_STATE_IDLE;
-    edgehog_settings_save(
-        OTA_KEY, OTA_STATE_KEY, &ota_settings.ota_state, sizeof(ota_settings.ota_state));
+    edgehog_settings_transaction_t transaction = { 0 };
+    edgehog_settings_transaction_begin(&transaction, OTA_KEY);
+    edgehog_settings_transaction_set(
+        &transaction, OTA_STATE_KEY, &ota_settings.ota_state, sizeof(ota_settings.ota_state));
+    edgehog_settings_transaction_commit(&transaction);
 }
 
 edgehog_result_t edgehog_ota_event(
@@ -330,6 +507,31 @@ edgehog_result_t edgehog_ota_event(
     return res;
 }
 
+edgehog_result_t edgehog_device_ota_transfer_pause(edgehog_device_handle_t edgehog_device)
+{
+    if (!edgehog_device) {
+        EDGEHOG_LOG_ERR("Unable to pause OTA transfers, edgehog_device undefined");
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    atomic_set_bit(&edgehog_device->ota_thread.ota_thread_data.ota_run_state, OTA_STATE_PAUSE_BIT);
+
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t edgehog_device_ota_transfer_resume(edgehog_device_handle_t edgehog_device)
+{
+    if (!edgehog_device) {
+        EDGEHOG_LOG_ERR("Unable to resume OTA transfers, edgehog_device undefined");
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    atomic_clear_bit(
+        &edgehog_device->ota_thread.ota_thread_data.ota_run_state, OTA_STATE_PAUSE_BIT);
+
+    return EDGEHOG_RESULT_OK;
+}
+
 /************************************************
  *         Static functions definitions         *
  ***********************************************/
@@ -352,7 +554,7 @@ static edgehog_result_t edgehog_ota_event_update(
     memset(ota_thread_data, 0, sizeof(ota_thread_data_t));
 
     size_t req_uuid_len = strlen(ota_request->uuid);
-    ota_thread_data->ota_request.uuid = (char *) calloc((req_uuid_len + 1), sizeof(char));
+    ota_thread_data->ota_request.uuid = (char *) edgehog_calloc((req_uuid_len + 1), sizeof(char));
     if (!ota_thread_data->ota_request.uuid) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         edgehog_result = EDGEHOG_RESULT_OUT_OF_MEMORY;
@@ -361,7 +563,7 @@ static edgehog_result_t edgehog_ota_event_update(
     strncpy(ota_thread_data->ota_request.uuid, ota_request->uuid, req_uuid_len + 1);
 
     size_t ota_url_len = strlen(ota_request->download_url);
-    ota_thread_data->ota_request.download_url = (char *) calloc((ota_url_len + 1), sizeof(char));
+    ota_thread_data->ota_request.download_url = (char *) edgehog_calloc((ota_url_len + 1), sizeof(char));
     if (!ota_thread_data->ota_request.download_url) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         edgehog_result = EDGEHOG_RESULT_OUT_OF_MEMORY;
@@ -375,11 +577,25 @@ static edgehog_result_t edgehog_ota_event_update(
         goto fail;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+    // Run the OTA procedure as a work item on the shared event loop, other services queued on
+    // the loop wait for it to complete
+    k_work_init(&edgehog_device->ota_thread.ota_work, ota_work_handler);
+    if (k_work_submit_to_queue(edgehog_event_loop_get(), &edgehog_device->ota_thread.ota_work)
+        < 0) {
+        EDGEHOG_LOG_ERR("OTA update work submission failed.");
+        pub_ota_event(edgehog_device->astarte_device, ota_request->uuid, OTA_EVENT_FAILURE, 0,
+            EDGEHOG_RESULT_OTA_INTERNAL_ERROR, "");
+        edgehog_result = EDGEHOG_RESULT_THREAD_CREATE_ERROR;
+        goto fail;
+    }
+#else
     struct k_thread *thread_handle = &edgehog_device->ota_thread.ota_thread_handle;
     memset(thread_handle, 0, sizeof(struct k_thread));
 
     k_tid_t thread_id = k_thread_create(thread_handle, ota_thread_stack, THREAD_STACK_SIZE,
-        ota_thread_entry_point, edgehog_device, NULL, NULL, K_HIGHEST_THREAD_PRIO, 0, K_NO_WAIT);
+        ota_thread_entry_point, edgehog_device, NULL, NULL, OTA_THREAD_PRIORITY, 0,
+        EDGEHOG_THREAD_START_DELAY);
 
     if (!thread_id) {
         EDGEHOG_LOG_ERR("OTA update thread creation failed.");
@@ -396,15 +612,27 @@ static edgehog_result_t edgehog_ota_event_update(
     }
 #endif
 
+    edgehog_thread_placement_start(thread_id, OTA_THREAD_CPU_MASK);
+#endif // CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+
     return edgehog_result;
 
 fail:
-    free(ota_thread_data->ota_request.download_url);
-    free(ota_thread_data->ota_request.uuid);
+    edgehog_free(ota_thread_data->ota_request.download_url);
+    edgehog_free(ota_thread_data->ota_request.uuid);
 
     return edgehog_result;
 }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+static void ota_work_handler(struct k_work *work)
+{
+    ota_thread_t *ota_thread = CONTAINER_OF(work, ota_thread_t, ota_work);
+    edgehog_device_handle_t device = CONTAINER_OF(ota_thread, struct edgehog_device, ota_thread);
+    ota_thread_entry_point(device, NULL, NULL);
+}
+#endif
+
 static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
 {
     if (!edgehog_device) {
@@ -419,8 +647,11 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
     ota_thread_data_t *ota_thread_data = &edgehog_dev->ota_thread.ota_thread_data;
     const char *req_uuid = ota_thread_data->ota_request.uuid;
 
-    // before performing the OTA update, check if there is a File Transfer ongoing operation
-    k_sem_take(&edgehog_dev->sync_ota_ft_sem, K_FOREVER);
+    // before performing the OTA update, drain all the transfer lane permits so no File Transfer
+    // operation can run concurrently with the update
+    for (int i = 0; i < EDGEHOG_FT_LANE_COUNT; i++) {
+        k_sem_take(&edgehog_dev->sync_ota_ft_sem, K_FOREVER);
+    }
 
     // Step 1 acknowledge the valid update request and notify the start of the download
     // operation.
@@ -445,7 +676,18 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
 
     EDGEHOG_LOG_INF("DOWNLOAD_AND_DEPLOY");
     uint8_t ota_state = OTA_STATE_IN_PROGRESS;
-    edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+    edgehog_settings_transaction_t transaction = { 0 };
+    edgehog_settings_transaction_begin(&transaction, OTA_KEY);
+    edgehog_settings_transaction_set(&transaction, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+    edgehog_settings_transaction_set(&transaction, OTA_REQUEST_ID_KEY, req_uuid, UUID_STR_LEN);
+    edgehog_result = edgehog_settings_transaction_commit(&transaction);
+    if (edgehog_result != EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_ERR("Unable to write the OTA request into Edgehog Settings, OTA canceled");
+        EDGEHOG_LOG_WRN("OTA FAILED");
+        pub_ota_event(
+            edgehog_dev->astarte_device, req_uuid, OTA_EVENT_FAILURE, 0, edgehog_result, "");
+        goto selfdestruct;
+    }
 
     edgehog_result = perform_ota(edgehog_dev);
     if (edgehog_result == EDGEHOG_RESULT_OK) {
@@ -453,7 +695,10 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
             edgehog_dev->astarte_device, req_uuid, OTA_EVENT_DEPLOYING, 0, EDGEHOG_RESULT_OK, "");
         EDGEHOG_LOG_INF("OTA PREPARE REBOOT");
         ota_state = OTA_STATE_REBOOT;
-        edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+        edgehog_settings_transaction_begin(&transaction, OTA_KEY);
+        edgehog_settings_transaction_set(&transaction, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+        edgehog_settings_transaction_set(&transaction, OTA_REQUEST_ID_KEY, req_uuid, UUID_STR_LEN);
+        edgehog_settings_transaction_commit(&transaction);
 
         struct mcuboot_img_header hdr;
         memset(&hdr, 0, sizeof(struct mcuboot_img_header));
@@ -467,6 +712,17 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
             goto selfdestruct;
         }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PRE_REBOOT_VERIFY
+        edgehog_result = verify_secondary_slot_image();
+        if (edgehog_result != EDGEHOG_RESULT_OK) {
+            EDGEHOG_LOG_ERR("Downloaded image failed pre-reboot verification, reboot canceled");
+            pub_ota_event(edgehog_dev->astarte_device, req_uuid, OTA_EVENT_FAILURE, 0,
+                EDGEHOG_RESULT_OTA_INVALID_IMAGE, "");
+            goto selfdestruct;
+        }
+        EDGEHOG_LOG_INF("Secondary slot image digest verified");
+#endif
+
         err = boot_request_upgrade(BOOT_UPGRADE_TEST);
         if (err) {
             EDGEHOG_LOG_ERR("Failed to mark the image in slot 1 as pending %d", err);
@@ -490,21 +746,24 @@ static void ota_thread_entry_point(void *edgehog_device, void *ptr2, void *ptr3)
         EDGEHOG_LOG_WRN("OTA FAILED");
         pub_ota_event(
             edgehog_dev->astarte_device, req_uuid, OTA_EVENT_FAILURE, 0, edgehog_result, "");
-        ota_state = OTA_STATE_IDLE;
-        edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+        // The idle state is persisted once below, together with the request ID removal
     }
 
 selfdestruct:
     atomic_clear_bit(&edgehog_dev->ota_thread.ota_thread_data.ota_run_state, OTA_STATE_RUN_BIT);
 
-    free(ota_thread_data->ota_request.uuid);
-    free(ota_thread_data->ota_request.download_url);
-    edgehog_settings_delete(OTA_KEY, OTA_REQUEST_ID_KEY);
+    edgehog_free(ota_thread_data->ota_request.uuid);
+    edgehog_free(ota_thread_data->ota_request.download_url);
+    // One committed record replaces both keys, dropping the request ID and storing the idle state
     ota_state = OTA_STATE_IDLE;
-    edgehog_settings_save(OTA_KEY, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+    edgehog_settings_transaction_begin(&transaction, OTA_KEY);
+    edgehog_settings_transaction_set(&transaction, OTA_STATE_KEY, &ota_state, sizeof(uint8_t));
+    edgehog_settings_transaction_commit(&transaction);
 
-    // release the lock to the semaphore so that pending FT requests can be handled
-    k_sem_give(&edgehog_dev->sync_ota_ft_sem);
+    // release the transfer lane permits so that pending FT requests can be handled
+    for (int i = 0; i < EDGEHOG_FT_LANE_COUNT; i++) {
+        k_sem_give(&edgehog_dev->sync_ota_ft_sem);
+    }
 }
 
 static void wait_for_reboot(void)
@@ -533,11 +792,23 @@ static edgehog_result_t perform_ota(edgehog_device_handle_t edgehog_device)
     astarte_device_handle_t astarte_device = edgehog_device->astarte_device;
     ota_thread_data_t *thread_data = &edgehog_device->ota_thread.ota_thread_data;
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+    // Pages are erased incrementally ahead of the write pointer, the download can start
+    // without waiting for a bulk erase of the whole slot
+    int err = flash_area_open(FLASH_AREA_IMAGE_SECONDARY, &thread_data->erase_fa);
+    if (err) {
+        EDGEHOG_LOG_ERR("Failed to open second slot: %d", err);
+        return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+    }
+    thread_data->erase_offset = 0;
+#else
+    EDGEHOG_TRACE(EDGEHOG_TRACE_OTA_ERASE);
     int err = boot_erase_img_bank(FLASH_AREA_IMAGE_SECONDARY);
     if (err) {
         EDGEHOG_LOG_ERR("Failed to erase second slot: %d", err);
         return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
     }
+#endif
 
     err = flash_img_init(&thread_data->flash_ctx);
     if (err) {
@@ -545,31 +816,45 @@ static edgehog_result_t perform_ota(edgehog_device_handle_t edgehog_device)
         return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
     }
 
-    // Step 1 set the request ID to the received uuid in Settings
-    edgehog_result = edgehog_settings_save(
-        OTA_KEY, OTA_REQUEST_ID_KEY, thread_data->ota_request.uuid, UUID_STR_LEN);
-    if (edgehog_result != EDGEHOG_RESULT_OK) {
-        EDGEHOG_LOG_ERR("Unable to write OTA req_uuid into Edgehog Settings, OTA canceled");
-        return edgehog_result;
-    }
-    // Step 2 attempt OTA operation for MAX_OTA_RETRY tries
+    // The request ID is already persisted, committed in one record with the in progress state
+
+    // Attempt OTA operation for MAX_OTA_RETRY tries
 
     for (uint8_t update_attempts = 0; update_attempts < MAX_OTA_RETRY; update_attempts++) {
         pub_ota_event(astarte_device, thread_data->ota_request.uuid, OTA_EVENT_DOWNLOADING, 0,
             EDGEHOG_RESULT_OK, "");
 
+        int64_t attempt_start_ms = k_uptime_get();
         edgehog_result = perform_ota_attempt(edgehog_device);
 
+        if (edgehog_result == EDGEHOG_RESULT_OK) {
+            sdk_metrics_record_ota_download(
+                thread_data->download_size, k_uptime_get() - attempt_start_ms);
+        }
         if (edgehog_result == EDGEHOG_RESULT_OK || edgehog_result == EDGEHOG_RESULT_OTA_CANCELED) {
             break;
         }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RETRY_BACKOFF
+        k_msleep((int32_t) ota_backoff_delay_ms(edgehog_device, update_attempts));
+#else
         k_msleep(update_attempts * OTA_ATTEMPS_DELAY_MS);
+#endif
         pub_ota_event(
             astarte_device, thread_data->ota_request.uuid, OTA_EVENT_ERROR, 0, edgehog_result, "");
         EDGEHOG_LOG_WRN("! OTA FAILED, ATTEMPT #%d !", update_attempts);
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    // Drop a decoder possibly left over by a failed last attempt
+    file_transfer_decompression_free(&thread_data->decomp_ctx);
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+    flash_area_close(thread_data->erase_fa);
+    thread_data->erase_fa = NULL;
+#endif
+
     return edgehog_result;
 }
 
@@ -577,15 +862,100 @@ static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_devi
 {
     ota_thread_data_t *thread_data = &edgehog_device->ota_thread.ota_thread_data;
 
-    const char *header_fields[] = { 0 };
+    size_t committed_offset = flash_img_bytes_written(&thread_data->flash_ctx);
+
+    // A server that ignored the Range header forces the attempt to restart from byte zero
+    if (thread_data->resume_unsupported && (committed_offset > 0)) {
+        // With erase-ahead the written pages get erased again as the erase pointer passes them
+#ifndef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+        int err = boot_erase_img_bank(FLASH_AREA_IMAGE_SECONDARY);
+        if (err) {
+            EDGEHOG_LOG_ERR("Failed to erase second slot: %d", err);
+            return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+        }
+#endif
+        int init_ret = flash_img_init(&thread_data->flash_ctx);
+        if (init_ret) {
+            EDGEHOG_LOG_ERR("Unable to init flash area: %d", init_ret);
+            return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+        }
+        committed_offset = 0;
+    }
+
+    // A failed attempt may leave unflushed bytes in the stream flash buffer; drop them so the
+    // write position agrees with the flash-committed offset the Range request resumes from
+    thread_data->flash_ctx.stream.buf_bytes = 0;
+
+    thread_data->download_start_offset = committed_offset;
+
+    // Restart the progress throttle window for this attempt
+    thread_data->last_progress_ms = k_uptime_get();
+    thread_data->last_progress_bytes = committed_offset;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT
+    // Start the attempt with a full token bucket
+    thread_data->rate_tokens = CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT_BYTES_PER_SEC;
+    thread_data->rate_last_refill_ms = k_uptime_get();
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+    edgehog_result_t erase_res = ota_erase_ahead_reset(thread_data, committed_offset);
+    if (erase_res != EDGEHOG_RESULT_OK) {
+        return erase_res;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    // Each attempt restarts the patch stream from scratch
+    memset(&thread_data->delta_ctx, 0, sizeof(thread_data->delta_ctx));
+    thread_data->delta_probed = false;
+    thread_data->download_size = 0;
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    // Drop a decoder possibly left over by a previous failed attempt
+    file_transfer_decompression_free(&thread_data->decomp_ctx);
+    thread_data->decomp_probed = false;
+    thread_data->download_size = 0;
+#endif
+
+    char range_header[OTA_RANGE_HEADER_BUF_SIZE] = { 0 };
+    const char *header_fields[2] = { 0 };
+    if (committed_offset > 0) {
+        int ret
+            = snprintf(range_header, sizeof(range_header), "Range: bytes=%zu-\r\n", committed_offset);
+        if ((ret < 0) || (ret >= sizeof(range_header))) {
+            EDGEHOG_LOG_ERR("Error formatting the Range header");
+            return EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+        header_fields[0] = range_header;
+        EDGEHOG_LOG_INF("Resuming OTA download from flash-committed offset %zu", committed_offset);
+    }
 
     edgehog_http_get_data_t http_get_data = { .url = thread_data->ota_request.download_url,
         .timeout_ms = OTA_REQ_TIMEOUT_MS,
+        .profile = EDGEHOG_HTTP_PROFILE_BULK,
         .header_fields = header_fields,
         .response_cbk = http_download_payload_cbk,
         .user_data = edgehog_device };
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE
+    edgehog_result_t pipeline_result = edgehog_ota_pipeline_start(&thread_data->flash_ctx);
+    if (pipeline_result != EDGEHOG_RESULT_OK) {
+        return pipeline_result;
+    }
+#endif
+
     edgehog_result_t edgehog_result = edgehog_http_get(&http_get_data);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE
+    // Drain the pipeline before inspecting the download outcome
+    pipeline_result = edgehog_ota_pipeline_finish();
+    if ((edgehog_result == EDGEHOG_RESULT_OK) && (pipeline_result != EDGEHOG_RESULT_OK)) {
+        edgehog_result = pipeline_result;
+    }
+#endif
+
     if (!atomic_test_bit(&thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
         EDGEHOG_LOG_DBG("OTA canceled");
         return EDGEHOG_RESULT_OTA_CANCELED;
@@ -595,6 +965,34 @@ static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_devi
         return edgehog_result;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    if (file_transfer_decompression_is_initialized(&thread_data->decomp_ctx)) {
+        // Flush the image bytes still buffered in the flash context to the secondary slot
+        int flush_ret = flash_img_buffered_write(&thread_data->flash_ctx, NULL, 0, true);
+        file_transfer_decompression_free(&thread_data->decomp_ctx);
+        if (flush_ret < 0) {
+            EDGEHOG_LOG_ERR("Flash flush error: %d", flush_ret);
+            return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+        }
+        // In compressed mode the downloaded size is the compressed payload size
+        if (thread_data->download_size != thread_data->image_size) {
+            return EDGEHOG_RESULT_NETWORK_ERROR;
+        }
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    if (thread_data->delta_ctx.active) {
+        // In delta mode the downloaded size is the patch size, completeness of the
+        // reconstructed image is tracked by the delta engine.
+        if (!edgehog_ota_delta_complete(&thread_data->delta_ctx)) {
+            return EDGEHOG_RESULT_NETWORK_ERROR;
+        }
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
     thread_data->download_size = flash_img_bytes_written(&thread_data->flash_ctx);
 
     if (thread_data->download_size <= 0 || thread_data->download_size != thread_data->image_size) {
@@ -604,6 +1002,112 @@ static edgehog_result_t perform_ota_attempt(edgehog_device_handle_t edgehog_devi
     return EDGEHOG_RESULT_OK;
 }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_PRE_REBOOT_VERIFY
+static edgehog_result_t verify_secondary_slot_image(void)
+{
+    const struct flash_area *flash_area = NULL;
+    int ret = flash_area_open(FLASH_AREA_IMAGE_SECONDARY, &flash_area);
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR("Failed to open the secondary slot for verification: %d", ret);
+        return EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+    }
+
+    edgehog_result_t eres = EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    psa_hash_operation_t hash_operation = PSA_HASH_OPERATION_INIT;
+    bool hash_active = false;
+
+    struct ota_image_header header = { 0 };
+    ret = flash_area_read(flash_area, 0, &header, sizeof(header));
+    if ((ret != 0) || (header.magic != OTA_IMAGE_MAGIC)) {
+        EDGEHOG_LOG_ERR("Invalid MCUboot header in the secondary slot");
+        goto exit;
+    }
+
+    // The stored digest covers header, image body and protected TLV area
+    size_t hashed_len
+        = (size_t) header.hdr_size + (size_t) header.img_size + (size_t) header.protect_tlv_size;
+    if ((hashed_len + sizeof(struct ota_image_tlv_info)) > flash_area->fa_size) {
+        EDGEHOG_LOG_ERR("Image in the secondary slot does not fit the slot");
+        goto exit;
+    }
+
+    psa_status_t status = psa_hash_setup(&hash_operation, PSA_ALG_SHA_256);
+    if (status != PSA_SUCCESS) {
+        EDGEHOG_LOG_ERR("PSA hash setup failed with error: %d", status);
+        eres = EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+        goto exit;
+    }
+    hash_active = true;
+
+    uint8_t chunk[OTA_VERIFY_CHUNK_SIZE] = { 0 };
+    for (size_t offset = 0; offset < hashed_len; offset += sizeof(chunk)) {
+        size_t read_len = MIN(sizeof(chunk), hashed_len - offset);
+        ret = flash_area_read(flash_area, (off_t) offset, chunk, read_len);
+        if (ret != 0) {
+            EDGEHOG_LOG_ERR("Flash read error during image verification: %d", ret);
+            eres = EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+            goto exit;
+        }
+        status = psa_hash_update(&hash_operation, chunk, read_len);
+        if (status != PSA_SUCCESS) {
+            EDGEHOG_LOG_ERR("PSA hash update failed with error: %d", status);
+            eres = EDGEHOG_RESULT_OTA_INTERNAL_ERROR;
+            goto exit;
+        }
+    }
+
+    // Locate the SHA-256 entry in the unprotected TLV area following the hashed content
+    struct ota_image_tlv_info tlv_info = { 0 };
+    ret = flash_area_read(flash_area, (off_t) hashed_len, &tlv_info, sizeof(tlv_info));
+    if ((ret != 0) || (tlv_info.magic != OTA_IMAGE_TLV_INFO_MAGIC)) {
+        EDGEHOG_LOG_ERR("Invalid TLV area in the secondary slot image");
+        goto exit;
+    }
+
+    size_t tlv_offset = hashed_len + sizeof(tlv_info);
+    size_t tlv_end = hashed_len + tlv_info.tlv_tot;
+    while (tlv_offset + sizeof(struct ota_image_tlv) <= tlv_end) {
+        struct ota_image_tlv tlv = { 0 };
+        ret = flash_area_read(flash_area, (off_t) tlv_offset, &tlv, sizeof(tlv));
+        if (ret != 0) {
+            EDGEHOG_LOG_ERR("Flash read error during TLV parsing: %d", ret);
+            eres = EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+            goto exit;
+        }
+        tlv_offset += sizeof(tlv);
+
+        if ((tlv.type == OTA_IMAGE_TLV_SHA256) && (tlv.len == OTA_SHA256_LEN)) {
+            uint8_t expected_digest[OTA_SHA256_LEN] = { 0 };
+            ret = flash_area_read(
+                flash_area, (off_t) tlv_offset, expected_digest, sizeof(expected_digest));
+            if (ret != 0) {
+                EDGEHOG_LOG_ERR("Flash read error reading the image digest: %d", ret);
+                eres = EDGEHOG_RESULT_OTA_INIT_FLASH_ERROR;
+                goto exit;
+            }
+            status = psa_hash_verify(&hash_operation, expected_digest, sizeof(expected_digest));
+            hash_active = false;
+            if (status != PSA_SUCCESS) {
+                EDGEHOG_LOG_ERR("Secondary slot image digest mismatch");
+                goto exit;
+            }
+            eres = EDGEHOG_RESULT_OK;
+            goto exit;
+        }
+        tlv_offset += tlv.len;
+    }
+
+    EDGEHOG_LOG_ERR("No SHA-256 entry found in the secondary slot image trailer");
+
+exit:
+    if (hash_active) {
+        psa_hash_abort(&hash_operation);
+    }
+    flash_area_close(flash_area);
+    return eres;
+}
+#endif // CONFIG_EDGEHOG_DEVICE_OTA_PRE_REBOOT_VERIFY
+
 static edgehog_result_t http_download_payload_cbk(
     edgehog_http_response_chunk_t *response_chunk, void *user_data)
 {
@@ -623,27 +1127,180 @@ static edgehog_result_t http_download_payload_cbk(
         return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
     }
 
-    int ret = flash_img_buffered_write(&ota_thread_data->flash_ctx,
-        response_chunk->chunk_start_addr, response_chunk->chunk_size, response_chunk->last_chunk);
-    if (ret < 0) {
-        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
-        EDGEHOG_LOG_ERR("Errno: %s\n", strerror(errno));
-        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+    // Hold the transfer while deferred, letting TCP flow control slow the sender down
+    while (atomic_test_bit(&ota_thread_data->ota_run_state, OTA_STATE_PAUSE_BIT)) {
+        if (!atomic_test_bit(&ota_thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
+            return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+        }
+        k_msleep(OTA_PAUSE_POLL_MS);
     }
 
-    ota_thread_data->image_size = response_chunk->response_size;
-    ota_thread_data->download_size = flash_img_bytes_written(&ota_thread_data->flash_ctx);
-    int read_perc = (int) (OTA_PROGRESS_PERC * ota_thread_data->download_size
-        / response_chunk->response_size);
-    int read_perc_rounded = read_perc - (read_perc % OTA_PROGRESS_PERC_ROUNDING_STEP);
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT
+    // Token-bucket pacing: block until the bucket holds enough tokens for this chunk, so the
+    // socket reads and thus the sender get paced to the configured rate
+    size_t chunk_cost = MIN(
+        response_chunk->chunk_size, (size_t) CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT_BYTES_PER_SEC);
+    ota_rate_limit_refill(ota_thread_data);
+    while (ota_thread_data->rate_tokens < chunk_cost) {
+        if (!atomic_test_bit(&ota_thread_data->ota_run_state, OTA_STATE_RUN_BIT)) {
+            return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+        }
+        k_msleep(OTA_RATE_LIMIT_POLL_MS);
+        ota_rate_limit_refill(ota_thread_data);
+    }
+    ota_thread_data->rate_tokens -= chunk_cost;
+#endif
+
+    if ((ota_thread_data->download_start_offset > 0)
+        && (response_chunk->status_code != HTTP_206_PARTIAL_CONTENT)) {
+        // The body is the full image and can't be appended to the already committed bytes
+        EDGEHOG_LOG_WRN("Server ignored the Range header, restarting the download from scratch");
+        ota_thread_data->resume_unsupported = true;
+        return EDGEHOG_RESULT_HTTP_REQUEST_ABORTED;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    if (!ota_thread_data->delta_probed && (ota_thread_data->download_start_offset == 0)
+        && (response_chunk->chunk_size > 0)) {
+        ota_thread_data->delta_probed = true;
+        if (edgehog_ota_delta_detect(response_chunk->chunk_start_addr, response_chunk->chunk_size)) {
+            EDGEHOG_LOG_INF("Delta patch payload detected");
+            // A partially applied patch can't be resumed, force retries to restart clean
+            ota_thread_data->resume_unsupported = true;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+            // The reconstructed image size isn't known yet, erase the remaining slot now
+            edgehog_result_t erase_res = ota_erase_ahead(ota_thread_data, SIZE_MAX);
+            if (erase_res != EDGEHOG_RESULT_OK) {
+                return erase_res;
+            }
+#endif
+            edgehog_ota_delta_init(&ota_thread_data->delta_ctx, &ota_thread_data->flash_ctx,
+                FLASH_AREA_IMAGE_PRIMARY);
+        }
+    }
+#endif
 
-    if (read_perc_rounded != ota_thread_data->last_perc_sent) {
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    if (!ota_thread_data->decomp_probed && (ota_thread_data->download_start_offset == 0)
+        && (response_chunk->chunk_size >= sizeof(uint32_t))) {
+        ota_thread_data->decomp_probed = true;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+        bool delta_active = ota_thread_data->delta_ctx.active;
+#else
+        bool delta_active = false;
+#endif
+        if (!delta_active
+            && (sys_get_le32(response_chunk->chunk_start_addr) == OTA_LZ4_FRAME_MAGIC)) {
+            EDGEHOG_LOG_INF("LZ4 compressed payload detected");
+            // A partially decompressed stream can't be resumed, force retries to restart clean
+            ota_thread_data->resume_unsupported = true;
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+            // The decompressed image size isn't known yet, erase the remaining slot now
+            edgehog_result_t erase_res = ota_erase_ahead(ota_thread_data, SIZE_MAX);
+            if (erase_res != EDGEHOG_RESULT_OK) {
+                return erase_res;
+            }
+#endif
+            int init_ret = file_transfer_decompression_init(&ota_thread_data->decomp_ctx,
+                ota_decompression_write_cbk, &ota_thread_data->flash_ctx);
+            if (init_ret < 0) {
+                EDGEHOG_LOG_ERR("Unable to init the OTA decompression context");
+                return EDGEHOG_RESULT_OUT_OF_MEMORY;
+            }
+        }
+    }
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+    if (ota_thread_data->delta_ctx.active) {
+        edgehog_result_t delta_res
+            = edgehog_ota_delta_feed(&ota_thread_data->delta_ctx, response_chunk->chunk_start_addr,
+                response_chunk->chunk_size, response_chunk->last_chunk);
+        if (delta_res != EDGEHOG_RESULT_OK) {
+            return delta_res;
+        }
+        ota_thread_data->download_size += response_chunk->chunk_size;
+    } else
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+    if (file_transfer_decompression_is_initialized(&ota_thread_data->decomp_ctx)) {
+        EDGEHOG_TRACE(EDGEHOG_TRACE_OTA_DECOMPRESS);
+        int decomp_ret = file_transfer_decompression_process_chunk(&ota_thread_data->decomp_ctx,
+            response_chunk->chunk_start_addr, response_chunk->chunk_size);
+        if (decomp_ret < 0) {
+            EDGEHOG_LOG_ERR("Unable to decompress the OTA payload chunk");
+            return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+        }
+        ota_thread_data->download_size += response_chunk->chunk_size;
+    } else
+#endif
+    {
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+        // Keep a window of erased pages ahead of the bytes about to be written
+        edgehog_result_t erase_res = ota_erase_ahead(ota_thread_data,
+            ota_thread_data->download_size + response_chunk->chunk_size
+                + CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD_BYTES);
+        if (erase_res != EDGEHOG_RESULT_OK) {
+            return erase_res;
+        }
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE
+        // Hand the chunk over to the pipeline so flash programming overlaps the next receive
+        edgehog_result_t pipeline_res = edgehog_ota_pipeline_write(
+            response_chunk->chunk_start_addr, response_chunk->chunk_size,
+            response_chunk->last_chunk);
+        if (pipeline_res != EDGEHOG_RESULT_OK) {
+            return pipeline_res;
+        }
+        ota_thread_data->download_size += response_chunk->chunk_size;
+#else
+        EDGEHOG_TRACE(EDGEHOG_TRACE_OTA_FLASH_WRITE);
+        int ret
+            = flash_img_buffered_write(&ota_thread_data->flash_ctx, response_chunk->chunk_start_addr,
+                response_chunk->chunk_size, response_chunk->last_chunk);
+        if (ret < 0) {
+            EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+            EDGEHOG_LOG_ERR("Errno: %s\n", strerror(errno));
+            return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+        }
+
+        ota_thread_data->download_size = flash_img_bytes_written(&ota_thread_data->flash_ctx);
+#endif
+    }
+
+    // On a resumed download the response only carries the bytes that were still missing
+    ota_thread_data->image_size
+        = ota_thread_data->download_start_offset + response_chunk->response_size;
+    int read_perc = (int) (OTA_PROGRESS_PERC * ota_thread_data->download_size
+        / ota_thread_data->image_size);
+
+    // Time-based throttle: publish at most once per configured interval, so fast links don't
+    // burst MQTT publishes and slow links still report at a steady cadence
+    int64_t now_ms = k_uptime_get();
+    int64_t elapsed_ms = now_ms - ota_thread_data->last_progress_ms;
+    bool final_perc = (read_perc == OTA_PROGRESS_PERC)
+        && (ota_thread_data->last_perc_sent != OTA_PROGRESS_PERC);
+    if ((elapsed_ms >= CONFIG_EDGEHOG_DEVICE_OTA_PROGRESS_INTERVAL_MS) || final_perc) {
+        char throughput_msg[OTA_THROUGHPUT_MSG_BUF_SIZE] = { 0 };
+        if (elapsed_ms > 0) {
+            size_t delta_bytes
+                = ota_thread_data->download_size - ota_thread_data->last_progress_bytes;
+            size_t throughput = (delta_bytes * MSEC_PER_SEC) / (size_t) elapsed_ms;
+            // NOLINTNEXTLINE(cert-err33-c)
+            snprintf(throughput_msg, sizeof(throughput_msg), "throughput: %zu B/s", throughput);
+        }
         pub_ota_event(edgehog_device->astarte_device, ota_thread_data->ota_request.uuid,
-            OTA_EVENT_DOWNLOADING, read_perc_rounded, EDGEHOG_RESULT_OK, "");
-        EDGEHOG_LOG_DBG("Downloading %d%% chunk %d written %d size %d \n", read_perc_rounded,
+            OTA_EVENT_DOWNLOADING, read_perc, EDGEHOG_RESULT_OK, throughput_msg);
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+        // An OTA in progress keeps the transport awake, let held telemetry ride on it
+        edgehog_telemetry_transport_active(edgehog_device->telemetry);
+#endif
+        EDGEHOG_LOG_DBG("Downloading %d%% chunk %d written %d size %d \n", read_perc,
             response_chunk->chunk_size, ota_thread_data->download_size,
             response_chunk->response_size);
-        ota_thread_data->last_perc_sent = read_perc_rounded;
+        ota_thread_data->last_perc_sent = read_perc;
+        ota_thread_data->last_progress_ms = now_ms;
+        ota_thread_data->last_progress_bytes = ota_thread_data->download_size;
     }
 
     return EDGEHOG_RESULT_OK;
@@ -695,6 +1352,116 @@ static edgehog_result_t edgehog_ota_event_cancel(
     return EDGEHOG_RESULT_OK;
 }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RETRY_BACKOFF
+static int64_t ota_backoff_delay_ms(edgehog_device_handle_t edgehog_device, uint8_t attempt)
+{
+    // Per-device xorshift generator, lazily seeded from the boot ID hash
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    static uint32_t backoff_rng_state;
+
+    if (backoff_rng_state == 0) {
+        backoff_rng_state = edgehog_string_hash(edgehog_device->boot_id) | 1U;
+    }
+    backoff_rng_state ^= backoff_rng_state << 13;
+    backoff_rng_state ^= backoff_rng_state >> 17;
+    backoff_rng_state ^= backoff_rng_state << 5;
+
+    int64_t delay_ms = (int64_t) CONFIG_EDGEHOG_DEVICE_OTA_RETRY_BACKOFF_BASE_MS << attempt;
+    delay_ms = MIN(delay_ms, (int64_t) CONFIG_EDGEHOG_DEVICE_OTA_RETRY_BACKOFF_MAX_MS);
+
+    // Uniform draw from the upper half of the delay window
+    int64_t half_delay_ms = delay_ms / 2;
+    return half_delay_ms + (int64_t) (backoff_rng_state % ((uint32_t) half_delay_ms + 1U));
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT
+static void ota_rate_limit_refill(ota_thread_data_t *thread_data)
+{
+    int64_t now_ms = k_uptime_get();
+    int64_t elapsed_ms = now_ms - thread_data->rate_last_refill_ms;
+    if (elapsed_ms <= 0) {
+        return;
+    }
+
+    // The bucket capacity is one second worth of tokens, bounding the burst size
+    size_t refill = ((size_t) elapsed_ms * CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT_BYTES_PER_SEC)
+        / MSEC_PER_SEC;
+    thread_data->rate_tokens = MIN(thread_data->rate_tokens + refill,
+        (size_t) CONFIG_EDGEHOG_DEVICE_OTA_RATE_LIMIT_BYTES_PER_SEC);
+    thread_data->rate_last_refill_ms = now_ms;
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_ERASE_AHEAD
+static edgehog_result_t ota_erase_ahead_reset(ota_thread_data_t *thread_data, size_t committed)
+{
+    const struct device *flash_dev = flash_area_get_device(thread_data->erase_fa);
+    size_t offset = 0;
+
+    // Pages holding committed bytes are already erased and partially written, skip them
+    while (offset < committed) {
+        struct flash_pages_info page_info = { 0 };
+        int ret = flash_get_page_info_by_offs(
+            flash_dev, thread_data->erase_fa->fa_off + offset, &page_info);
+        if (ret) {
+            EDGEHOG_LOG_ERR("Failed to get flash page info: %d", ret);
+            return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+        }
+        offset += page_info.size;
+    }
+
+    thread_data->erase_offset = offset;
+
+    return EDGEHOG_RESULT_OK;
+}
+
+static edgehog_result_t ota_erase_ahead(ota_thread_data_t *thread_data, size_t target)
+{
+    const struct flash_area *erase_fa = thread_data->erase_fa;
+    const struct device *flash_dev = flash_area_get_device(erase_fa);
+
+    if (target > erase_fa->fa_size) {
+        target = erase_fa->fa_size;
+    }
+
+    while (thread_data->erase_offset < target) {
+        struct flash_pages_info page_info = { 0 };
+        int ret = flash_get_page_info_by_offs(
+            flash_dev, erase_fa->fa_off + thread_data->erase_offset, &page_info);
+        if (ret) {
+            EDGEHOG_LOG_ERR("Failed to get flash page info: %d", ret);
+            return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+        }
+        EDGEHOG_TRACE(EDGEHOG_TRACE_OTA_ERASE);
+        ret = flash_area_erase(erase_fa, thread_data->erase_offset, page_info.size);
+        if (ret) {
+            EDGEHOG_LOG_ERR("Failed to erase second slot page: %d", ret);
+            return EDGEHOG_RESULT_OTA_ERASE_SECOND_SLOT_ERROR;
+        }
+        thread_data->erase_offset += page_info.size;
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+#endif
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION
+static int ota_decompression_write_cbk(const uint8_t *data, size_t size, void *user_data)
+{
+    struct flash_img_context *flash_ctx = (struct flash_img_context *) user_data;
+
+    EDGEHOG_TRACE(EDGEHOG_TRACE_OTA_FLASH_WRITE);
+    int ret = flash_img_buffered_write(flash_ctx, data, size, false);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        return ret;
+    }
+
+    return 0;
+}
+#endif
+
 static const char *swap_type_str(int swap_type)
 {
     switch (swap_type) {
@@ -0,0 +1,258 @@
+/*
+ * (C) Copyright 2025, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DELTA
+
+#include "ota_delta.h"
+
+#include <string.h>
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_delta, CONFIG_EDGEHOG_DEVICE_OTA_DELTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Opcode for a record copying bytes from the primary slot. */
+#define OTA_DELTA_OPCODE_COPY 0x00U
+/** @brief Opcode for a record carrying literal image bytes. */
+#define OTA_DELTA_OPCODE_DATA 0x01U
+
+/** @brief Size of a copy record header (opcode, length and source offset). */
+#define OTA_DELTA_COPY_HEADER_SIZE 9U
+/** @brief Size of a data record header (opcode and length). */
+#define OTA_DELTA_DATA_HEADER_SIZE 5U
+
+/** @brief Stack buffer size used to stream copy records from the primary partition. */
+#define OTA_DELTA_COPY_BUF_SIZE 256U
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Accumulate stream bytes into the context header buffer.
+ *
+ * @param[inout] ctx Delta engine context.
+ * @param[in] chunk Received patch bytes.
+ * @param[in] chunk_size Number of valid bytes in the chunk.
+ * @param[in] required Header size to accumulate.
+ * @return The number of consumed bytes from the chunk.
+ */
+static size_t accumulate_header(
+    ota_delta_ctx_t *ctx, const uint8_t *chunk, size_t chunk_size, size_t required);
+
+/**
+ * @brief Apply a copy record by streaming reads from the primary partition into the flash sink.
+ *
+ * @param[inout] ctx Delta engine context.
+ * @param[in] src_offset Source offset in the primary slot.
+ * @param[in] length Number of bytes to copy.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+static edgehog_result_t apply_copy_record(
+    ota_delta_ctx_t *ctx, uint32_t src_offset, uint32_t length);
+
+/**
+ * @brief Write a run of literal or copied bytes to the image flash context.
+ *
+ * @param[inout] ctx Delta engine context.
+ * @param[in] data Bytes to write.
+ * @param[in] length Number of bytes to write.
+ * @return EDGEHOG_RESULT_OK if successful, otherwise an error code.
+ */
+static edgehog_result_t write_target_bytes(ota_delta_ctx_t *ctx, const uint8_t *data, size_t length);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+bool edgehog_ota_delta_detect(const uint8_t *buf, size_t len)
+{
+    if (!buf || (len < sizeof(uint32_t))) {
+        return false;
+    }
+    return sys_get_le32(buf) == OTA_DELTA_MAGIC;
+}
+
+void edgehog_ota_delta_init(
+    ota_delta_ctx_t *ctx, struct flash_img_context *flash_ctx, uint8_t primary_area_id)
+{
+    memset(ctx, 0, sizeof(ota_delta_ctx_t));
+    ctx->active = true;
+    ctx->state = OTA_DELTA_STATE_STREAM_HEADER;
+    ctx->flash_ctx = flash_ctx;
+    ctx->primary_area_id = primary_area_id;
+}
+
+edgehog_result_t edgehog_ota_delta_feed(
+    ota_delta_ctx_t *ctx, const uint8_t *chunk, size_t chunk_size, bool last_chunk)
+{
+    if (!ctx || !ctx->active) {
+        EDGEHOG_LOG_ERR("Delta engine has not been initialized");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    while (chunk_size > 0) {
+        size_t consumed = 0;
+        switch (ctx->state) {
+            case OTA_DELTA_STATE_STREAM_HEADER:
+                consumed = accumulate_header(ctx, chunk, chunk_size, OTA_DELTA_STREAM_HEADER_SIZE);
+                if (ctx->header_len == OTA_DELTA_STREAM_HEADER_SIZE) {
+                    if (sys_get_le32(ctx->header_buf) != OTA_DELTA_MAGIC) {
+                        EDGEHOG_LOG_ERR("Invalid delta patch magic");
+                        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+                    }
+                    ctx->target_size = sys_get_le32(&ctx->header_buf[sizeof(uint32_t)]);
+                    if (ctx->target_size == 0) {
+                        EDGEHOG_LOG_ERR("Delta patch declares an empty target image");
+                        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+                    }
+                    EDGEHOG_LOG_INF("Delta patch target image size: %u", ctx->target_size);
+                    ctx->header_len = 0;
+                    ctx->state = OTA_DELTA_STATE_RECORD_HEADER;
+                }
+                break;
+            case OTA_DELTA_STATE_RECORD_HEADER: {
+                // The opcode is the first header byte and determines the record header size,
+                // a copy record header might only be recognized once the opcode has arrived.
+                size_t required = OTA_DELTA_DATA_HEADER_SIZE;
+                if ((ctx->header_len > 0) && (ctx->header_buf[0] == OTA_DELTA_OPCODE_COPY)) {
+                    required = OTA_DELTA_COPY_HEADER_SIZE;
+                }
+                consumed = accumulate_header(ctx, chunk, chunk_size, required);
+                if (ctx->header_buf[0] == OTA_DELTA_OPCODE_COPY) {
+                    required = OTA_DELTA_COPY_HEADER_SIZE;
+                } else if (ctx->header_buf[0] != OTA_DELTA_OPCODE_DATA) {
+                    EDGEHOG_LOG_ERR("Invalid delta record opcode: %u", ctx->header_buf[0]);
+                    return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+                }
+                if (ctx->header_len == required) {
+                    uint32_t length = sys_get_le32(&ctx->header_buf[1]);
+                    if (ctx->header_buf[0] == OTA_DELTA_OPCODE_COPY) {
+                        uint32_t src_offset = sys_get_le32(&ctx->header_buf[1 + sizeof(uint32_t)]);
+                        edgehog_result_t res = apply_copy_record(ctx, src_offset, length);
+                        if (res != EDGEHOG_RESULT_OK) {
+                            return res;
+                        }
+                    } else {
+                        ctx->record_remaining = length;
+                        ctx->state = OTA_DELTA_STATE_RECORD_DATA;
+                    }
+                    ctx->header_len = 0;
+                }
+                break;
+            }
+            case OTA_DELTA_STATE_RECORD_DATA: {
+                consumed = MIN(chunk_size, (size_t) ctx->record_remaining);
+                edgehog_result_t res = write_target_bytes(ctx, chunk, consumed);
+                if (res != EDGEHOG_RESULT_OK) {
+                    return res;
+                }
+                ctx->record_remaining -= consumed;
+                if (ctx->record_remaining == 0) {
+                    ctx->state = OTA_DELTA_STATE_RECORD_HEADER;
+                }
+                break;
+            }
+            case OTA_DELTA_STATE_DONE:
+                EDGEHOG_LOG_ERR("Trailing bytes after the delta patch end");
+                return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+            default:
+                return EDGEHOG_RESULT_INTERNAL_ERROR;
+        }
+
+        chunk += consumed;
+        chunk_size -= consumed;
+
+        if ((ctx->state == OTA_DELTA_STATE_RECORD_HEADER) && (ctx->header_len == 0)
+            && (ctx->target_size > 0) && (ctx->patched_size == ctx->target_size)) {
+            ctx->state = OTA_DELTA_STATE_DONE;
+        }
+    }
+
+    if (last_chunk && (ctx->state != OTA_DELTA_STATE_DONE)) {
+        EDGEHOG_LOG_ERR("Truncated delta patch stream, reconstructed %zu of %u bytes",
+            ctx->patched_size, ctx->target_size);
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    return EDGEHOG_RESULT_OK;
+}
+
+bool edgehog_ota_delta_complete(ota_delta_ctx_t *ctx)
+{
+    return ctx && ctx->active && (ctx->state == OTA_DELTA_STATE_DONE);
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static size_t accumulate_header(
+    ota_delta_ctx_t *ctx, const uint8_t *chunk, size_t chunk_size, size_t required)
+{
+    size_t missing = required - ctx->header_len;
+    size_t consumed = MIN(chunk_size, missing);
+    memcpy(&ctx->header_buf[ctx->header_len], chunk, consumed);
+    ctx->header_len += consumed;
+    return consumed;
+}
+
+static edgehog_result_t apply_copy_record(ota_delta_ctx_t *ctx, uint32_t src_offset, uint32_t length)
+{
+    const struct flash_area *primary_fa = NULL;
+    int ret = flash_area_open(ctx->primary_area_id, &primary_fa);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Unable to open the primary flash area: %d", ret);
+        return EDGEHOG_RESULT_FLASH_ERROR;
+    }
+
+    edgehog_result_t res = EDGEHOG_RESULT_OK;
+    uint8_t copy_buf[OTA_DELTA_COPY_BUF_SIZE];
+    uint32_t copied = 0;
+    while (copied < length) {
+        size_t read_size = MIN((size_t) (length - copied), sizeof(copy_buf));
+        ret = flash_area_read(primary_fa, src_offset + copied, copy_buf, read_size);
+        if (ret < 0) {
+            EDGEHOG_LOG_ERR("Unable to read from the primary flash area: %d", ret);
+            res = EDGEHOG_RESULT_FLASH_ERROR;
+            break;
+        }
+        res = write_target_bytes(ctx, copy_buf, read_size);
+        if (res != EDGEHOG_RESULT_OK) {
+            break;
+        }
+        copied += read_size;
+    }
+
+    flash_area_close(primary_fa);
+    return res;
+}
+
+static edgehog_result_t write_target_bytes(ota_delta_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    if (ctx->patched_size + length > ctx->target_size) {
+        EDGEHOG_LOG_ERR("Delta patch overflows the declared target image size");
+        return EDGEHOG_RESULT_OTA_INVALID_IMAGE;
+    }
+
+    bool flush = (ctx->patched_size + length == ctx->target_size);
+    int ret = flash_img_buffered_write(ctx->flash_ctx, data, length, flush);
+    if (ret < 0) {
+        EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+        return EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+    }
+
+    ctx->patched_size += length;
+    return EDGEHOG_RESULT_OK;
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_OTA_DELTA
@@ -0,0 +1,241 @@
+/*
+ * (C) Copyright 2025, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifdef CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE
+
+#include "ota_pipeline.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(ota_pipeline, CONFIG_EDGEHOG_DEVICE_OTA_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define PIPELINE_BUF_SIZE CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE_BUFFER_SIZE
+#define PIPELINE_BUF_COUNT 2
+#define PIPELINE_THREAD_STACK_SIZE 2048
+
+/** @brief A single pipeline buffer slot, filled by the producer and drained by the writer. */
+struct pipeline_slot
+{
+    /** @brief Payload bytes staged for the flash write. */
+    uint8_t buf[PIPELINE_BUF_SIZE];
+    /** @brief Number of valid bytes in the buffer. */
+    size_t len;
+    /** @brief Perform the final flush of the image flash context after this slot. */
+    bool flush;
+    /** @brief The writer thread terminates after consuming this slot. */
+    bool last;
+};
+
+/** @brief State for the single pipeline instance. */
+struct pipeline_state
+{
+    /** @brief Image flash context the writer thread commits to. */
+    struct flash_img_context *flash_ctx;
+    /** @brief Ping-pong buffer slots. */
+    struct pipeline_slot slots[PIPELINE_BUF_COUNT];
+    /** @brief Counts the free slots, taken by the producer. */
+    struct k_sem free_sem;
+    /** @brief Counts the filled slots, taken by the writer thread. */
+    struct k_sem data_sem;
+    /** @brief Slot currently filled by the producer. */
+    uint8_t prod_idx;
+    /** @brief Slot next drained by the writer thread. */
+    uint8_t cons_idx;
+    /** @brief Bytes already staged in the producer slot. */
+    size_t fill;
+    /** @brief Set when the producer currently owns its slot. */
+    bool slot_owned;
+    /** @brief Set once any payload byte has been submitted. */
+    bool any_data;
+    /** @brief Set once the terminating slot has been submitted. */
+    bool terminated;
+    /** @brief First error reported by the writer thread. */
+    edgehog_result_t write_result;
+    /** @brief Writer thread handle. */
+    struct k_thread thread;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_THREAD_STACK_DEFINE(pipeline_thread_stack, PIPELINE_THREAD_STACK_SIZE);
+static struct pipeline_state pipeline;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Writer thread entry function, drains filled slots into the image flash context.
+ */
+static void pipeline_writer_entry_point(void *ptr1, void *ptr2, void *ptr3);
+
+/**
+ * @brief Publish the producer slot to the writer thread.
+ *
+ * @param[in] flush Perform the final flush of the image flash context after this slot.
+ * @param[in] last Ask the writer thread to terminate after consuming this slot.
+ */
+static void publish_producer_slot(bool flush, bool last);
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+edgehog_result_t edgehog_ota_pipeline_start(struct flash_img_context *flash_ctx)
+{
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.flash_ctx = flash_ctx;
+    pipeline.write_result = EDGEHOG_RESULT_OK;
+    k_sem_init(&pipeline.free_sem, PIPELINE_BUF_COUNT, PIPELINE_BUF_COUNT);
+    k_sem_init(&pipeline.data_sem, 0, PIPELINE_BUF_COUNT);
+
+    k_tid_t thread_id = k_thread_create(&pipeline.thread, pipeline_thread_stack,
+        PIPELINE_THREAD_STACK_SIZE, pipeline_writer_entry_point, NULL, NULL, NULL,
+        K_HIGHEST_THREAD_PRIO, 0, K_NO_WAIT);
+    if (!thread_id) {
+        EDGEHOG_LOG_ERR("OTA pipeline writer thread creation failed.");
+        return EDGEHOG_RESULT_THREAD_CREATE_ERROR;
+    }
+
+#ifdef CONFIG_THREAD_NAME
+    int ret = k_thread_name_set(thread_id, "edgehog_ota_pipeline");
+    if (ret != 0) {
+        EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
+    }
+#endif
+
+    return EDGEHOG_RESULT_OK;
+}
+
+edgehog_result_t edgehog_ota_pipeline_write(const uint8_t *data, size_t size, bool last)
+{
+    if (pipeline.write_result != EDGEHOG_RESULT_OK) {
+        return pipeline.write_result;
+    }
+    if (pipeline.terminated) {
+        EDGEHOG_LOG_ERR("Write submitted to a terminated pipeline");
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    if (size > 0) {
+        pipeline.any_data = true;
+    }
+
+    while (size > 0) {
+        if (!pipeline.slot_owned) {
+            k_sem_take(&pipeline.free_sem, K_FOREVER);
+            pipeline.slot_owned = true;
+            pipeline.fill = 0;
+        }
+
+        struct pipeline_slot *slot = &pipeline.slots[pipeline.prod_idx];
+        size_t copy_size = MIN(size, (size_t) PIPELINE_BUF_SIZE - pipeline.fill);
+        memcpy(&slot->buf[pipeline.fill], data, copy_size);
+        pipeline.fill += copy_size;
+        data += copy_size;
+        size -= copy_size;
+
+        bool slot_full = (pipeline.fill == PIPELINE_BUF_SIZE);
+        bool payload_complete = last && (size == 0);
+        if (slot_full || payload_complete) {
+            publish_producer_slot(payload_complete, payload_complete);
+        }
+
+        if (pipeline.write_result != EDGEHOG_RESULT_OK) {
+            return pipeline.write_result;
+        }
+    }
+
+    // An empty final chunk still has to flush the bytes staged so far
+    if (last && !pipeline.terminated) {
+        if (!pipeline.slot_owned) {
+            k_sem_take(&pipeline.free_sem, K_FOREVER);
+            pipeline.slot_owned = true;
+            pipeline.fill = 0;
+        }
+        publish_producer_slot(pipeline.any_data, true);
+    }
+
+    return pipeline.write_result;
+}
+
+edgehog_result_t edgehog_ota_pipeline_finish(void)
+{
+    // Unblock the writer thread if the download terminated before the final chunk
+    if (!pipeline.terminated) {
+        if (!pipeline.slot_owned) {
+            k_sem_take(&pipeline.free_sem, K_FOREVER);
+            pipeline.slot_owned = true;
+            pipeline.fill = 0;
+        }
+        publish_producer_slot(false, true);
+    }
+
+    int join_ret = k_thread_join(&pipeline.thread, K_FOREVER);
+    if (join_ret != 0) {
+        EDGEHOG_LOG_ERR("Failed to join the OTA pipeline writer thread: %d", join_ret);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    return pipeline.write_result;
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void publish_producer_slot(bool flush, bool last)
+{
+    struct pipeline_slot *slot = &pipeline.slots[pipeline.prod_idx];
+    slot->len = pipeline.fill;
+    slot->flush = flush;
+    slot->last = last;
+
+    pipeline.prod_idx = (pipeline.prod_idx + 1) % PIPELINE_BUF_COUNT;
+    pipeline.slot_owned = false;
+    pipeline.fill = 0;
+    if (last) {
+        pipeline.terminated = true;
+    }
+    k_sem_give(&pipeline.data_sem);
+}
+
+static void pipeline_writer_entry_point(void *ptr1, void *ptr2, void *ptr3)
+{
+    ARG_UNUSED(ptr1);
+    ARG_UNUSED(ptr2);
+    ARG_UNUSED(ptr3);
+
+    while (true) {
+        k_sem_take(&pipeline.data_sem, K_FOREVER);
+        struct pipeline_slot *slot = &pipeline.slots[pipeline.cons_idx];
+        pipeline.cons_idx = (pipeline.cons_idx + 1) % PIPELINE_BUF_COUNT;
+
+        if ((pipeline.write_result == EDGEHOG_RESULT_OK) && ((slot->len > 0) || slot->flush)) {
+            int ret
+                = flash_img_buffered_write(pipeline.flash_ctx, slot->buf, slot->len, slot->flush);
+            if (ret < 0) {
+                EDGEHOG_LOG_ERR("Flash write error: %d", ret);
+                pipeline.write_result = EDGEHOG_RESULT_OTA_WRITE_FLASH_ERROR;
+            }
+        }
+
+        bool last = slot->last;
+        k_sem_give(&pipeline.free_sem);
+        if (last) {
+            break;
+        }
+    }
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_OTA_DOWNLOAD_PIPELINE
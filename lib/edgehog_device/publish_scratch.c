@@ -0,0 +1,46 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "publish_scratch.h"
+
+#include <zephyr/kernel.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(publish_scratch, CONFIG_EDGEHOG_DEVICE_PUBLISH_SCRATCH_LOG_LEVEL);
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Arena shared by every publish site, sized for the largest payload assembly
+static uint8_t publish_scratch[CONFIG_EDGEHOG_DEVICE_PUBLISH_SCRATCH_SIZE] __aligned(8);
+// Binary semaphore guarding the arena, a mutex would allow a nested same-thread acquire to
+// silently hand the arena out twice
+static K_SEM_DEFINE(publish_scratch_sem, 1, 1);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void *publish_scratch_acquire(size_t size)
+{
+    if (size > sizeof(publish_scratch)) {
+        EDGEHOG_LOG_ERR("Publish payload of %zu bytes exceeds the %u bytes scratch arena, "
+                        "raise EDGEHOG_DEVICE_PUBLISH_SCRATCH_SIZE",
+            size, CONFIG_EDGEHOG_DEVICE_PUBLISH_SCRATCH_SIZE);
+        return NULL;
+    }
+
+    k_sem_take(&publish_scratch_sem, K_FOREVER);
+    return publish_scratch;
+}
+
+void publish_scratch_release(void)
+{
+    k_sem_give(&publish_scratch_sem);
+}
@@ -33,9 +33,51 @@ EDGEHOG_LOG_MODULE_REGISTER(runtime_info, CONFIG_EDGEHOG_DEVICE_RUNTIME_INFO_LOG
 #define ENVIRONMENT_SIZE 18
 
 /************************************************
- *         Static functions definitions         *
+ *             Static variables                 *
  ***********************************************/
 
+// Formatted once at snapshot time and constant afterwards, publishes read from here.
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static char runtime_version[RUNTIME_VERSION_SIZE + 1];
+static char environment[ENVIRONMENT_SIZE + 1];
+static bool snapshot_taken;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void runtime_info_snapshot(void)
+{
+    if (snapshot_taken) {
+        return;
+    }
+
+    int snprintf_rc = snprintf(runtime_version, RUNTIME_VERSION_SIZE, "%d.%d.%d",
+        EDGEHOG_DEVICE_MAJOR, // NOLINT(hicpp-signed-bitwise)
+        EDGEHOG_DEVICE_MINOR, // NOLINT(hicpp-signed-bitwise)
+        EDGEHOG_DEVICE_PATCH // NOLINT(hicpp-signed-bitwise)
+    );
+    if (snprintf_rc > RUNTIME_VERSION_SIZE) {
+        EDGEHOG_LOG_ERR("Incorrect length/format for runtime version");
+        runtime_version[0] = '\0';
+    }
+
+    uint32_t kernel_version = sys_kernel_version_get();
+
+    snprintf_rc = snprintf(environment, ENVIRONMENT_SIZE, "Zephyr %d.%d.%d",
+        SYS_KERNEL_VER_MAJOR(kernel_version), // NOLINT(hicpp-signed-bitwise)
+        SYS_KERNEL_VER_MINOR(kernel_version), // NOLINT(hicpp-signed-bitwise)
+        SYS_KERNEL_VER_PATCHLEVEL(kernel_version)); // NOLINT(hicpp-signed-bitwise)
+
+    if (snprintf_rc > ENVIRONMENT_SIZE) {
+        EDGEHOG_LOG_ERR("Incorrect length/format for environment");
+        environment[0] = '\0';
+    }
+
+    snapshot_taken = true;
+}
+
 void publish_runtime_info(edgehog_device_handle_t edgehog_device)
 {
     EDGEHOG_LOG_DBG("Publishing Edgehog device runtime info");
@@ -55,14 +97,8 @@ void publish_runtime_info(edgehog_device_handle_t edgehog_device)
         return;
     }
 
-    char runtime_version[RUNTIME_VERSION_SIZE + 1] = { 0 };
-    int snprintf_rc = snprintf(runtime_version, RUNTIME_VERSION_SIZE, "%d.%d.%d",
-        EDGEHOG_DEVICE_MAJOR, // NOLINT(hicpp-signed-bitwise)
-        EDGEHOG_DEVICE_MINOR, // NOLINT(hicpp-signed-bitwise)
-        EDGEHOG_DEVICE_PATCH // NOLINT(hicpp-signed-bitwise)
-    );
-    if (snprintf_rc > RUNTIME_VERSION_SIZE) {
-        EDGEHOG_LOG_ERR("Incorrect length/format for runtime version");
+    runtime_info_snapshot();
+    if (runtime_version[0] == '\0' || environment[0] == '\0') {
         return;
     }
 
@@ -75,19 +111,6 @@ void publish_runtime_info(edgehog_device_handle_t edgehog_device)
         return;
     }
 
-    uint32_t kernel_version = sys_kernel_version_get();
-
-    char environment[ENVIRONMENT_SIZE + 1] = { 0 };
-    snprintf_rc = snprintf(environment, ENVIRONMENT_SIZE, "Zephyr %d.%d.%d",
-        SYS_KERNEL_VER_MAJOR(kernel_version), // NOLINT(hicpp-signed-bitwise)
-        SYS_KERNEL_VER_MINOR(kernel_version), // NOLINT(hicpp-signed-bitwise)
-        SYS_KERNEL_VER_PATCHLEVEL(kernel_version)); // NOLINT(hicpp-signed-bitwise)
-
-    if (snprintf_rc > ENVIRONMENT_SIZE) {
-        EDGEHOG_LOG_ERR("Incorrect length/format for environment");
-        return;
-    }
-
     res = astarte_device_set_property(edgehog_device->astarte_device,
         io_edgehog_devicemanager_RuntimeInfo.name, RUNTIME_ENV_PROP,
         astarte_data_from_string(environment));
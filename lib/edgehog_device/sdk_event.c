@@ -0,0 +1,40 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdk_event.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+
+#include <zephyr/zbus/zbus.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(sdk_event, CONFIG_EDGEHOG_DEVICE_SDK_EVENT_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+// Bound on the wait for the channel lock, no observer runs in the publisher context
+#define SDK_EVENT_PUB_TIMEOUT K_SECONDS(1)
+
+ZBUS_CHAN_DEFINE(edgehog_sdk_chan, edgehog_sdk_chan_event_t, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+    ZBUS_MSG_INIT(.event = EDGEHOG_SDK_INVALID_EVENT, .result = EDGEHOG_RESULT_OK, .bytes = 0));
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void sdk_event_publish(edgehog_sdk_event_t event, edgehog_result_t result, size_t bytes)
+{
+    edgehog_sdk_chan_event_t chan_event = { .event = event, .result = result, .bytes = bytes };
+
+    int ret = zbus_chan_pub(&edgehog_sdk_chan, &chan_event, SDK_EVENT_PUB_TIMEOUT);
+    if (ret != 0) {
+        EDGEHOG_LOG_WRN("Failed publishing SDK event %d on the zbus channel: %d", event, ret);
+    }
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
@@ -0,0 +1,95 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdk_metrics.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SDK_METRICS
+
+#include <zephyr/sys/atomic.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_REGISTER(sdk_metrics, CONFIG_EDGEHOG_DEVICE_SDK_METRICS_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define MSEC_PER_SEC_I64 ((int64_t) MSEC_PER_SEC)
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// Recorders run on the hot paths, every figure is a single atomic store or add
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static atomic_t ota_last_download_bytes;
+static atomic_t ota_last_download_ms;
+static atomic_t publish_latency_last_ms;
+static atomic_t publish_latency_max_ms;
+static atomic_t queue_drop_count;
+static atomic_t timer_wakeup_count;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void sdk_metrics_record_ota_download(size_t bytes, int64_t duration_ms)
+{
+    atomic_set(&ota_last_download_bytes, (atomic_val_t) bytes);
+    atomic_set(&ota_last_download_ms, (atomic_val_t) duration_ms);
+}
+
+void sdk_metrics_record_publish_latency(int64_t latency_ms)
+{
+    atomic_set(&publish_latency_last_ms, (atomic_val_t) latency_ms);
+    atomic_val_t max = atomic_get(&publish_latency_max_ms);
+    while ((latency_ms > max)
+        && !atomic_cas(&publish_latency_max_ms, max, (atomic_val_t) latency_ms)) {
+        max = atomic_get(&publish_latency_max_ms);
+    }
+}
+
+void sdk_metrics_record_queue_drop(void)
+{
+    atomic_inc(&queue_drop_count);
+}
+
+void sdk_metrics_record_timer_wakeup(void)
+{
+    atomic_inc(&timer_wakeup_count);
+}
+
+void sdk_metrics_snapshot(edgehog_sdk_metrics_snapshot_t *snapshot)
+{
+    snapshot->publish_latency_last_ms = (int64_t) atomic_get(&publish_latency_last_ms);
+    snapshot->publish_latency_max_ms = (int64_t) atomic_get(&publish_latency_max_ms);
+    snapshot->queue_drops = (uint32_t) atomic_get(&queue_drop_count);
+    snapshot->timer_wakeups = (uint32_t) atomic_get(&timer_wakeup_count);
+}
+
+void publish_sdk_metrics(edgehog_device_handle_t edgehog_device)
+{
+    ARG_UNUSED(edgehog_device);
+
+    int64_t download_bytes = (int64_t) atomic_get(&ota_last_download_bytes);
+    int64_t download_ms = (int64_t) atomic_get(&ota_last_download_ms);
+    int64_t throughput_bps = 0;
+    if (download_ms > 0) {
+        throughput_bps = (download_bytes * MSEC_PER_SEC_I64) / download_ms;
+    }
+
+    // No Astarte interface carries these figures, they go out through the log
+    EDGEHOG_LOG_INF("SDK metrics: OTA last download %lld bytes in %lld ms (%lld B/s), publish "
+                    "latency last %lld ms max %lld ms, queue drops %lu, timer wakeups %lu",
+        (long long) download_bytes, (long long) download_ms, (long long) throughput_bps,
+        (long long) atomic_get(&publish_latency_last_ms),
+        (long long) atomic_get(&publish_latency_max_ms),
+        (unsigned long) atomic_get(&queue_drop_count),
+        (unsigned long) atomic_get(&timer_wakeup_count));
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_SDK_METRICS
@@ -7,6 +7,13 @@
 #include "settings.h"
 
 #include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "storage_usage.h"
 
 #include "log.h"
 EDGEHOG_LOG_MODULE_REGISTER(edgehog_settings, CONFIG_EDGEHOG_DEVICE_SETTINGS_LOG_LEVEL);
@@ -17,6 +24,151 @@ EDGEHOG_LOG_MODULE_REGISTER(edgehog_settings, CONFIG_EDGEHOG_DEVICE_SETTINGS_LOG
 
 #define EGDEHOG_ID "edgehog_device"
 
+// Reserved key the packed record of a transaction is stored under, within its subtree
+#define SETTINGS_BATCH_KEY "batch"
+// Upper bound for a logical key name packed in a transaction record
+#define SETTINGS_BATCH_MAX_KEY_LEN 32
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+// Upper bounds for the cached copy of the Edgehog subtree. The library stores the OTA batch
+// record plus two small values per telemetry type, values larger than these mark the cache
+// unusable and loads fall back to the storage backend.
+#define SETTINGS_CACHE_MAX_ENTRIES 12
+#define SETTINGS_CACHE_MAX_PATH_LEN 32
+#define SETTINGS_CACHE_MAX_VALUE_LEN 64
+
+/** @brief One cached setting, the path is relative to the Edgehog subtree root. */
+typedef struct
+{
+    /** @brief Path of the setting inside the Edgehog subtree, e.g. "ota/batch". */
+    char path[SETTINGS_CACHE_MAX_PATH_LEN + 1];
+    /** @brief Cached copy of the value. */
+    uint8_t value[SETTINGS_CACHE_MAX_VALUE_LEN];
+    /** @brief Size in bytes of the cached value. */
+    size_t value_len;
+    /** @brief True when this slot holds a setting. */
+    bool in_use;
+} settings_cache_entry_t;
+#endif
+
+/** @brief Context forwarding a loader callback through the batch record unpacking shim. */
+typedef struct
+{
+    /** @brief The loader callback provided by the caller. */
+    settings_load_direct_cb load_cb;
+    /** @brief The parameter provided by the caller for its callback. */
+    void *param;
+} settings_load_shim_t;
+
+/** @brief In memory value of a packed batch entry or cached setting, read back through #settings_value_read_cb. */
+typedef struct
+{
+    /** @brief Start of the value bytes. */
+    const uint8_t *data;
+    /** @brief Size in bytes of the value. */
+    size_t len;
+} settings_value_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static settings_cache_entry_t settings_cache[SETTINGS_CACHE_MAX_ENTRIES];
+// True once the cache has been populated from the backend, population happens only once
+static bool settings_cache_populated;
+// False when the subtree does not fit the cache bounds, loads then traverse the backend
+static bool settings_cache_usable;
+static K_MUTEX_DEFINE(settings_cache_mutex);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+/**
+ * @brief Populate the settings cache from the storage backend, once.
+ *
+ * @details Traverses the whole Edgehog subtree. When an entry exceeds the cache bounds the cache
+ * is marked unusable and loads keep hitting the backend.
+ */
+static void settings_cache_populate(void);
+
+/**
+ * @brief Loader callback storing one backend entry into the cache.
+ *
+ * @param[in] key the name with skipped part that was used as name in handler registration.
+ * @param[in] len the size of the data found in the backend.
+ * @param[in] read_cb function provided to read the data from the backend.
+ * @param[inout] cb_arg arguments for the read function provided by the backend.
+ * @param[inout] param unused.
+ *
+ * @return Always 0, the whole subtree is traversed.
+ */
+static int settings_cache_populate_cb(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param);
+
+/**
+ * @brief Insert or update one cached setting, called with the cache mutex held.
+ *
+ * @param[in] path Path of the setting relative to the Edgehog subtree root.
+ * @param[in] value Value of the setting.
+ * @param[in] value_len Size in bytes of the value.
+ */
+static void settings_cache_upsert(const char *path, const void *value, size_t value_len);
+
+/**
+ * @brief Serve a settings load for a subtree from the cache.
+ *
+ * @param[in] subtree subtree name of the subtree to be loaded.
+ * @param[in] shim The loader shim context to deliver the cached entries through.
+ * @return true when the load was served from the cache, false when the caller must fall back to
+ * the storage backend.
+ */
+static bool settings_cache_load(const char *subtree, settings_load_shim_t *shim);
+
+/**
+ * @brief Check whether a save would store the value already held by the backend.
+ *
+ * @param[in] path Path of the setting relative to the Edgehog subtree root.
+ * @param[in] value Value about to be saved.
+ * @param[in] value_len Size in bytes of the value.
+ * @return true when the cache holds an identical copy and the backend commit can be skipped.
+ */
+static bool settings_cache_matches(const char *path, const void *value, size_t value_len);
+#endif
+
+/**
+ * @brief Loader shim unpacking transaction batch records into their individual keys.
+ *
+ * @details Keys saved individually are forwarded to the caller callback unchanged, a batch record
+ * is unpacked and its entries are delivered one by one as if each had been saved on its own.
+ *
+ * @param[in] key the name with skipped part that was used as name in handler registration.
+ * @param[in] len the size of the data found in the backend.
+ * @param[in] read_cb function provided to read the data from the backend.
+ * @param[inout] cb_arg arguments for the read function provided by the backend.
+ * @param[inout] param pointer to the #settings_load_shim_t context.
+ *
+ * @return When nonzero value is returned, further subtree searching is stopped.
+ */
+static int settings_load_shim(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param);
+
+/**
+ * @brief Read callback serving a value from an unpacked batch record.
+ *
+ * @param[in] cb_arg Pointer to the #settings_value_t to read from.
+ * @param[out] data Destination buffer.
+ * @param[in] len Size in bytes of the destination buffer.
+ *
+ * @return The number of bytes copied.
+ */
+static ssize_t settings_value_read_cb(void *cb_arg, void *data, size_t len);
+
 /************************************************
  *         Global functions definition          *
  ***********************************************/
@@ -30,6 +182,10 @@ edgehog_result_t edgehog_settings_init()
         return EDGEHOG_RESULT_SETTINGS_INIT_FAIL;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+    settings_cache_populate();
+#endif
+
     EDGEHOG_LOG_DBG("Edgehog settings subsystem initialized successfully.");
     return EDGEHOG_RESULT_OK;
 }
@@ -47,8 +203,17 @@ edgehog_result_t edgehog_settings_load(
         return EDGEHOG_RESULT_SETTINGS_LOAD_FAIL;
     }
 
+    settings_load_shim_t shim = { .load_cb = load_cb, .param = param };
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+    if (settings_cache_load(subtree, &shim)) {
+        EDGEHOG_LOG_DBG("Served settings load for subtree [%s] from the cache", edgehog_subtree);
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
     EDGEHOG_LOG_DBG("Loading settings from subtree: [%s]", edgehog_subtree);
-    int res = settings_load_subtree_direct(edgehog_subtree, load_cb, param);
+    int res = settings_load_subtree_direct(edgehog_subtree, settings_load_shim, &shim);
     if (res != 0) {
         EDGEHOG_LOG_ERR("Unable to load items from the Edgehog setting [%s], error code: %d",
             edgehog_subtree, res);
@@ -74,6 +239,16 @@ edgehog_result_t edgehog_settings_save(
         return EDGEHOG_RESULT_SETTINGS_SAVE_FAIL;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+    // State machines re-persist unchanged values on idle re-entries and repeated in-progress
+    // transitions, skip the backend commit (NVS latency and flash wear) when nothing changed
+    if (settings_cache_matches(
+            edgehog_subtree_path + strlen(EGDEHOG_ID) + 1, value, value_len)) {
+        EDGEHOG_LOG_DBG("Setting [%s] unchanged, backend commit skipped", edgehog_subtree_path);
+        return EDGEHOG_RESULT_OK;
+    }
+#endif
+
     EDGEHOG_LOG_DBG(
         "Saving setting to path: [%s] (size: %zu bytes)", edgehog_subtree_path, value_len);
     int res = settings_save_one(edgehog_subtree_path, value, value_len);
@@ -83,7 +258,15 @@ edgehog_result_t edgehog_settings_save(
         return EDGEHOG_RESULT_SETTINGS_SAVE_FAIL;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+    // Write-through, the cached path is relative to the Edgehog subtree root
+    k_mutex_lock(&settings_cache_mutex, K_FOREVER);
+    settings_cache_upsert(edgehog_subtree_path + strlen(EGDEHOG_ID) + 1, value, value_len);
+    k_mutex_unlock(&settings_cache_mutex);
+#endif
+
     EDGEHOG_LOG_DBG("Successfully saved setting to path: [%s]", edgehog_subtree_path);
+    storage_usage_settings_cache_invalidate();
     return EDGEHOG_RESULT_OK;
 }
 
@@ -110,6 +293,256 @@ edgehog_result_t edgehog_settings_delete(const char *subtree, const char *key)
         return EDGEHOG_RESULT_SETTINGS_SAVE_FAIL;
     }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+    // Write-through removal of the cached entry
+    const char *relative_path = edgehog_subtree_path + strlen(EGDEHOG_ID) + 1;
+    k_mutex_lock(&settings_cache_mutex, K_FOREVER);
+    for (size_t i = 0; i < SETTINGS_CACHE_MAX_ENTRIES; i++) {
+        if (settings_cache[i].in_use && (strcmp(settings_cache[i].path, relative_path) == 0)) {
+            settings_cache[i].in_use = false;
+            break;
+        }
+    }
+    k_mutex_unlock(&settings_cache_mutex);
+#endif
+
     EDGEHOG_LOG_DBG("Successfully deleted setting at path: [%s]", edgehog_subtree_path);
+    storage_usage_settings_cache_invalidate();
+    return EDGEHOG_RESULT_OK;
+}
+
+void edgehog_settings_transaction_begin(
+    edgehog_settings_transaction_t *transaction, const char *subtree)
+{
+    transaction->subtree = subtree;
+    transaction->entries_len = 0;
+}
+
+edgehog_result_t edgehog_settings_transaction_set(
+    edgehog_settings_transaction_t *transaction, const char *key, const void *value,
+    size_t value_len)
+{
+    if (transaction->entries_len >= EDGEHOG_SETTINGS_TRANSACTION_MAX_ENTRIES) {
+        EDGEHOG_LOG_ERR("Settings transaction for [%s] is full, unable to stage { %s }",
+            transaction->subtree, key);
+        return EDGEHOG_RESULT_SETTINGS_SAVE_FAIL;
+    }
+    if ((strlen(key) > SETTINGS_BATCH_MAX_KEY_LEN) || (value_len > UINT16_MAX)) {
+        EDGEHOG_LOG_ERR("Unable to stage { %s }, key or value too large", key);
+        return EDGEHOG_RESULT_SETTINGS_SAVE_FAIL;
+    }
+
+    transaction->entries[transaction->entries_len].key = key;
+    transaction->entries[transaction->entries_len].value = value;
+    transaction->entries[transaction->entries_len].value_len = value_len;
+    transaction->entries_len++;
     return EDGEHOG_RESULT_OK;
 }
+
+edgehog_result_t edgehog_settings_transaction_commit(edgehog_settings_transaction_t *transaction)
+{
+    // Each packed entry holds: key length (u8), key bytes, value length (u16 LE), value bytes
+    size_t record_len = 0;
+    for (size_t i = 0; i < transaction->entries_len; i++) {
+        record_len += sizeof(uint8_t) + strlen(transaction->entries[i].key) + sizeof(uint16_t)
+            + transaction->entries[i].value_len;
+    }
+
+    uint8_t record[record_len];
+    size_t pos = 0;
+    for (size_t i = 0; i < transaction->entries_len; i++) {
+        size_t key_len = strlen(transaction->entries[i].key);
+        record[pos++] = (uint8_t) key_len;
+        memcpy(&record[pos], transaction->entries[i].key, key_len);
+        pos += key_len;
+        sys_put_le16((uint16_t) transaction->entries[i].value_len, &record[pos]);
+        pos += sizeof(uint16_t);
+        memcpy(&record[pos], transaction->entries[i].value, transaction->entries[i].value_len);
+        pos += transaction->entries[i].value_len;
+    }
+
+    EDGEHOG_LOG_DBG("Committing %zu staged settings for [%s] in one record",
+        transaction->entries_len, transaction->subtree);
+    return edgehog_settings_save(transaction->subtree, SETTINGS_BATCH_KEY, record, record_len);
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_SETTINGS_CACHE
+static void settings_cache_populate(void)
+{
+    k_mutex_lock(&settings_cache_mutex, K_FOREVER);
+    if (settings_cache_populated) {
+        k_mutex_unlock(&settings_cache_mutex);
+        return;
+    }
+
+    settings_cache_usable = true;
+    int res = settings_load_subtree_direct(EGDEHOG_ID, settings_cache_populate_cb, NULL);
+    if (res != 0) {
+        EDGEHOG_LOG_WRN("Unable to populate the settings cache, error code: %d", res);
+        settings_cache_usable = false;
+    }
+    settings_cache_populated = true;
+
+    k_mutex_unlock(&settings_cache_mutex);
+}
+
+static int settings_cache_populate_cb(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param)
+{
+    ARG_UNUSED(param);
+
+    if ((strlen(key) > SETTINGS_CACHE_MAX_PATH_LEN) || (len > SETTINGS_CACHE_MAX_VALUE_LEN)) {
+        EDGEHOG_LOG_WRN("Setting [%s] exceeds the cache bounds, settings cache disabled", key);
+        settings_cache_usable = false;
+        return 0;
+    }
+
+    uint8_t value[SETTINGS_CACHE_MAX_VALUE_LEN];
+    ssize_t read_len = read_cb(cb_arg, value, len);
+    if ((read_len < 0) || ((size_t) read_len != len)) {
+        EDGEHOG_LOG_WRN("Unable to read setting [%s], settings cache disabled", key);
+        settings_cache_usable = false;
+        return 0;
+    }
+
+    settings_cache_upsert(key, value, len);
+    return 0;
+}
+
+static void settings_cache_upsert(const char *path, const void *value, size_t value_len)
+{
+    if (!settings_cache_usable || (strlen(path) > SETTINGS_CACHE_MAX_PATH_LEN)
+        || (value_len > SETTINGS_CACHE_MAX_VALUE_LEN)) {
+        settings_cache_usable = false;
+        return;
+    }
+
+    settings_cache_entry_t *free_slot = NULL;
+    for (size_t i = 0; i < SETTINGS_CACHE_MAX_ENTRIES; i++) {
+        if (settings_cache[i].in_use && (strcmp(settings_cache[i].path, path) == 0)) {
+            free_slot = &settings_cache[i];
+            break;
+        }
+        if (!settings_cache[i].in_use && !free_slot) {
+            free_slot = &settings_cache[i];
+        }
+    }
+    if (!free_slot) {
+        EDGEHOG_LOG_WRN("Settings cache full, settings cache disabled");
+        settings_cache_usable = false;
+        return;
+    }
+
+    // NOLINTNEXTLINE(cert-err33-c)
+    strncpy(free_slot->path, path, SETTINGS_CACHE_MAX_PATH_LEN + 1);
+    memcpy(free_slot->value, value, value_len);
+    free_slot->value_len = value_len;
+    free_slot->in_use = true;
+}
+
+static bool settings_cache_load(const char *subtree, settings_load_shim_t *shim)
+{
+    size_t subtree_len = strlen(subtree);
+
+    k_mutex_lock(&settings_cache_mutex, K_FOREVER);
+    if (!settings_cache_populated || !settings_cache_usable) {
+        k_mutex_unlock(&settings_cache_mutex);
+        return false;
+    }
+
+    for (size_t i = 0; i < SETTINGS_CACHE_MAX_ENTRIES; i++) {
+        if (!settings_cache[i].in_use
+            || (strncmp(settings_cache[i].path, subtree, subtree_len) != 0)
+            || (settings_cache[i].path[subtree_len] != SETTINGS_NAME_SEPARATOR)) {
+            continue;
+        }
+
+        settings_value_t value
+            = { .data = settings_cache[i].value, .len = settings_cache[i].value_len };
+        int res = settings_load_shim(&settings_cache[i].path[subtree_len + 1],
+            settings_cache[i].value_len, settings_value_read_cb, &value, shim);
+        if (res != 0) {
+            break;
+        }
+    }
+    k_mutex_unlock(&settings_cache_mutex);
+
+    return true;
+}
+
+static bool settings_cache_matches(const char *path, const void *value, size_t value_len)
+{
+    bool matches = false;
+
+    k_mutex_lock(&settings_cache_mutex, K_FOREVER);
+    // Without a trustworthy cached copy every save must reach the backend
+    if (settings_cache_populated && settings_cache_usable) {
+        for (size_t i = 0; i < SETTINGS_CACHE_MAX_ENTRIES; i++) {
+            if (settings_cache[i].in_use && (strcmp(settings_cache[i].path, path) == 0)) {
+                matches = (settings_cache[i].value_len == value_len)
+                    && (memcmp(settings_cache[i].value, value, value_len) == 0);
+                break;
+            }
+        }
+    }
+    k_mutex_unlock(&settings_cache_mutex);
+
+    return matches;
+}
+#endif
+
+static int settings_load_shim(
+    const char *key, size_t len, settings_read_cb read_cb, void *cb_arg, void *param)
+{
+    settings_load_shim_t *shim = (settings_load_shim_t *) param;
+
+    if (strcmp(key, SETTINGS_BATCH_KEY) != 0) {
+        return shim->load_cb(key, len, read_cb, cb_arg, shim->param);
+    }
+
+    uint8_t record[len];
+    ssize_t read_len = read_cb(cb_arg, record, len);
+    if ((read_len < 0) || ((size_t) read_len != len)) {
+        EDGEHOG_LOG_ERR("Unable to read settings batch record: %zd", read_len);
+        return 0;
+    }
+
+    size_t pos = 0;
+    while (pos < len) {
+        size_t key_len = record[pos++];
+        char entry_key[SETTINGS_BATCH_MAX_KEY_LEN + 1] = { 0 };
+        if ((key_len > SETTINGS_BATCH_MAX_KEY_LEN) || (pos + key_len + sizeof(uint16_t) > len)) {
+            EDGEHOG_LOG_ERR("Malformed settings batch record, unpacking stopped");
+            return 0;
+        }
+        memcpy(entry_key, &record[pos], key_len);
+        pos += key_len;
+        settings_value_t value = { .len = sys_get_le16(&record[pos]) };
+        pos += sizeof(uint16_t);
+        if (pos + value.len > len) {
+            EDGEHOG_LOG_ERR("Malformed settings batch record, unpacking stopped");
+            return 0;
+        }
+        value.data = &record[pos];
+        pos += value.len;
+
+        int res = shim->load_cb(entry_key, value.len, settings_value_read_cb, &value, shim->param);
+        if (res != 0) {
+            return res;
+        }
+    }
+
+    return 0;
+}
+
+static ssize_t settings_value_read_cb(void *cb_arg, void *data, size_t len)
+{
+    settings_value_t *value = (settings_value_t *) cb_arg;
+    size_t copy_len = MIN(len, value->len);
+    memcpy(data, value->data, copy_len);
+    return (ssize_t) copy_len;
+}
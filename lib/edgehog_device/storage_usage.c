@@ -6,7 +6,10 @@
 
 #include "storage_usage.h"
 
+#include <string.h>
+
 #include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
 #include <zephyr/drivers/flash.h>
 #include <zephyr/fs/fs.h>
 #include <zephyr/settings/settings.h>
@@ -32,7 +35,9 @@
 
 #include "edgehog_private.h"
 #include "generated_interfaces.h"
+#include "publish_scratch.h"
 #include "system_time.h"
+#include "telemetry_delta.h"
 
 #include "log.h"
 EDGEHOG_LOG_MODULE_REGISTER(storage_usage, CONFIG_EDGEHOG_DEVICE_STORAGE_USAGE_LOG_LEVEL);
@@ -61,12 +66,48 @@ EDGEHOG_LOG_MODULE_REGISTER(storage_usage, CONFIG_EDGEHOG_DEVICE_STORAGE_USAGE_L
 #endif
 #endif
 
+/** @brief Maximum number of partitions held in the usage snapshot. */
+#define STORAGE_USAGE_SNAPSHOT_MAX 8
+
+/** @brief Cached usage figures for a single partition. */
+typedef struct
+{
+    /** @brief Partition path, points to stable configuration strings. */
+    const char *path;
+    /** @brief Total partition size in bytes. */
+    size_t total_space;
+    /** @brief Free partition space in bytes. */
+    size_t free_space;
+} storage_snapshot_entry_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Snapshot refreshed by the background work item and transmitted by the telemetry service
+static storage_snapshot_entry_t storage_snapshot[STORAGE_USAGE_SNAPSHOT_MAX];
+static size_t storage_snapshot_len;
+static bool storage_snapshot_valid;
+static struct k_spinlock storage_snapshot_lock;
+// Device for which the snapshot is collected
+static edgehog_device_handle_t storage_snapshot_device;
+static struct k_work storage_refresh_work;
+// Cached NVS/ZMS usage figures, valid until the next write to the Edgehog settings
+#if defined(CONFIG_SETTINGS_NVS) || defined(CONFIG_SETTINGS_ZMS)
+static size_t settings_cache_total;
+static size_t settings_cache_free;
+#endif
+static atomic_t settings_cache_valid;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /************************************************
  *         Static functions declarations        *
  ***********************************************/
 
-static void publish_user_storage_usage(edgehog_device_handle_t edgehog_device);
-static void publish_edgehog_storage_usage(edgehog_device_handle_t edgehog_device);
+static size_t collect_user_storage_usage(
+    edgehog_device_handle_t edgehog_device, storage_snapshot_entry_t *out, size_t out_max);
+static bool collect_edgehog_storage_usage(storage_snapshot_entry_t *out);
 #ifdef CONFIG_SETTINGS_NVS
 edgehog_result_t get_nvs_space(size_t *total_space, size_t *free_space);
 #endif // defined(CONFIG_SETTINGS_NVS)
@@ -76,6 +117,46 @@ edgehog_result_t get_zms_space(size_t *total_space, size_t *free_space);
 static void send_storage_telemetry(
     edgehog_device_handle_t device, const char *path, size_t total_space, size_t free_space);
 
+/************************************************
+ *       Callbacks declaration/definition       *
+ ***********************************************/
+
+/**
+ * @brief Work handler refreshing the storage usage snapshot.
+ *
+ * @details The NVS/ZMS free space accounting iterates flash sectors and can take hundreds of
+ * milliseconds, running it here keeps the flash scan off the telemetry publish path.
+ *
+ * @param[in] work Pointer to the work item triggering the call.
+ */
+static void storage_refresh_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    edgehog_device_handle_t edgehog_device = storage_snapshot_device;
+    if (!edgehog_device) {
+        return;
+    }
+
+    storage_snapshot_entry_t collected[STORAGE_USAGE_SNAPSHOT_MAX];
+    size_t collected_len = 0;
+
+    if ((edgehog_device->storage_partitions_len > 0) && edgehog_device->storage_partitions) {
+        collected_len = collect_user_storage_usage(
+            edgehog_device, collected, STORAGE_USAGE_SNAPSHOT_MAX);
+    }
+    if ((collected_len < STORAGE_USAGE_SNAPSHOT_MAX)
+        && collect_edgehog_storage_usage(&collected[collected_len])) {
+        collected_len++;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&storage_snapshot_lock);
+    memcpy(storage_snapshot, collected, collected_len * sizeof(storage_snapshot_entry_t));
+    storage_snapshot_len = collected_len;
+    storage_snapshot_valid = true;
+    k_spin_unlock(&storage_snapshot_lock, key);
+}
+
 /************************************************
  *         Global functions definition          *
  ***********************************************/
@@ -87,19 +168,56 @@ void publish_storage_usage(edgehog_device_handle_t edgehog_device)
         return;
     }
 
-    EDGEHOG_LOG_DBG("Publishing storage usage");
-    if ((edgehog_device->storage_partitions_len > 0) && edgehog_device->storage_partitions) {
-        publish_user_storage_usage(edgehog_device);
+    static bool work_initialized;
+    if (!work_initialized) {
+        k_work_init(&storage_refresh_work, storage_refresh_work_handler);
+        work_initialized = true;
+    }
+    storage_snapshot_device = edgehog_device;
+
+    storage_snapshot_entry_t *local
+        = publish_scratch_acquire(STORAGE_USAGE_SNAPSHOT_MAX * sizeof(storage_snapshot_entry_t));
+    if (!local) {
+        return;
+    }
+    size_t local_len = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&storage_snapshot_lock);
+    if (storage_snapshot_valid) {
+        local_len = storage_snapshot_len;
+        memcpy(local, storage_snapshot, local_len * sizeof(storage_snapshot_entry_t));
+    }
+    k_spin_unlock(&storage_snapshot_lock, key);
+
+    if (storage_snapshot_valid) {
+        EDGEHOG_LOG_DBG("Publishing storage usage");
+        for (size_t i = 0; i < local_len; i++) {
+            send_storage_telemetry(
+                edgehog_device, local[i].path, local[i].total_space, local[i].free_space);
+        }
+    } else {
+        EDGEHOG_LOG_DBG("Storage usage snapshot not collected yet, skipping publish");
     }
-    publish_edgehog_storage_usage(edgehog_device);
+    publish_scratch_release();
+
+    // Refresh the snapshot for the next period, off the publish path. The published figures
+    // are at most one telemetry period old.
+    k_work_submit(&storage_refresh_work);
+}
+
+void storage_usage_settings_cache_invalidate(void)
+{
+    atomic_clear(&settings_cache_valid);
 }
 
 /************************************************
  *         Static functions definition          *
  ***********************************************/
 
-static void publish_user_storage_usage(edgehog_device_handle_t edgehog_device)
+static size_t collect_user_storage_usage(
+    edgehog_device_handle_t edgehog_device, storage_snapshot_entry_t *out, size_t out_max)
 {
+    size_t out_len = 0;
     for (size_t i = 0; i < edgehog_device->storage_partitions_len; i++) {
         const char *path = edgehog_device->storage_partitions[i].path;
         size_t total_space = 0;
@@ -162,54 +280,72 @@ static void publish_user_storage_usage(edgehog_device_handle_t edgehog_device)
 
         EDGEHOG_LOG_DBG("Usage of partition %s, total space %zu, free space %zu", path, total_space,
             free_space);
-        send_storage_telemetry(edgehog_device, path, total_space, free_space);
+        if (out_len >= out_max) {
+            EDGEHOG_LOG_WRN("Storage usage snapshot full, partition %s not tracked", path);
+            break;
+        }
+        out[out_len].path = path;
+        out[out_len].total_space = total_space;
+        out[out_len].free_space = free_space;
+        out_len++;
     }
+    return out_len;
 }
 
-static void publish_edgehog_storage_usage(edgehog_device_handle_t edgehog_device)
+static bool collect_edgehog_storage_usage(storage_snapshot_entry_t *out)
 {
 #ifdef CONFIG_SETTINGS_NVS
     const char *path = "/" SETTINGS_PARTITION_LABEL;
     size_t total_space = 0;
     size_t free_space = 0;
     if (get_nvs_space(&total_space, &free_space) != EDGEHOG_RESULT_OK) {
-        return;
+        return false;
     }
 #elif defined(CONFIG_SETTINGS_ZMS)
     const char *path = "/" SETTINGS_PARTITION_LABEL;
     size_t total_space = 0;
     size_t free_space = 0;
     if (get_zms_space(&total_space, &free_space) != EDGEHOG_RESULT_OK) {
-        return;
+        return false;
     }
 #elif defined(CONFIG_SETTINGS_FILE)
     struct fs_file_t file;
     fs_file_t_init(&file);
     if (fs_open(&file, CONFIG_SETTINGS_FILE_PATH, 0) != 0) {
-        return;
+        return false;
     }
     const char *path = file.mp->mnt_point;
     fs_close(&file);
 
     struct fs_statvfs stats;
     if (fs_statvfs(path, &stats) != 0) {
-        return;
+        return false;
     }
     size_t total_space = (size_t) stats.f_frsize * stats.f_blocks;
     size_t free_space = (size_t) stats.f_frsize * stats.f_bfree;
 #else
-    return; // Unsupported storage backend, skip telemetry
+    ARG_UNUSED(out);
+    return false; // Unsupported storage backend, skip telemetry
 #endif
 
     EDGEHOG_LOG_DBG("Usage of Edgehog partition %s, total space %zu, free space %zu", path,
         total_space, free_space);
-    send_storage_telemetry(edgehog_device, path, total_space, free_space);
+    out->path = path;
+    out->total_space = total_space;
+    out->free_space = free_space;
+    return true;
 }
 
 #ifdef CONFIG_SETTINGS_NVS
 
 edgehog_result_t get_nvs_space(size_t *total_space, size_t *free_space)
 {
+    if (atomic_get(&settings_cache_valid)) {
+        *total_space = settings_cache_total;
+        *free_space = settings_cache_free;
+        return EDGEHOG_RESULT_OK;
+    }
+
     void *storage_ptr = NULL;
 
     int ret = settings_storage_get(&storage_ptr);
@@ -230,6 +366,12 @@ edgehog_result_t get_nvs_space(size_t *total_space, size_t *free_space)
     }
 
     *free_space = (size_t) free_space_res;
+
+    // A settings write racing with the scan may leave the figures one write behind until the
+    // following write invalidates the cache again
+    settings_cache_total = *total_space;
+    settings_cache_free = *free_space;
+    atomic_set(&settings_cache_valid, 1);
     return EDGEHOG_RESULT_OK;
 }
 #endif // defined (CONFIG_SETTINGS_NVS)
@@ -237,6 +379,12 @@ edgehog_result_t get_nvs_space(size_t *total_space, size_t *free_space)
 #ifdef CONFIG_SETTINGS_ZMS
 edgehog_result_t get_zms_space(size_t *total_space, size_t *free_space)
 {
+    if (atomic_get(&settings_cache_valid)) {
+        *total_space = settings_cache_total;
+        *free_space = settings_cache_free;
+        return EDGEHOG_RESULT_OK;
+    }
+
     void *storage_ptr = NULL;
 
     int ret = settings_storage_get(&storage_ptr);
@@ -257,6 +405,12 @@ edgehog_result_t get_zms_space(size_t *total_space, size_t *free_space)
     }
 
     *free_space = (size_t) free_space_res;
+
+    // A settings write racing with the scan may leave the figures one write behind until the
+    // following write invalidates the cache again
+    settings_cache_total = *total_space;
+    settings_cache_free = *free_space;
+    atomic_set(&settings_cache_valid, 1);
     return EDGEHOG_RESULT_OK;
 }
 #endif // defined (CONFIG_SETTINGS_ZMS)
@@ -264,6 +418,17 @@ edgehog_result_t get_zms_space(size_t *total_space, size_t *free_space)
 static void send_storage_telemetry(
     edgehog_device_handle_t device, const char *path, size_t total_space, size_t free_space)
 {
+    struct
+    {
+        size_t total_space;
+        size_t free_space;
+    } delta_payload = { .total_space = total_space, .free_space = free_space };
+    if (!telemetry_delta_should_publish(path, &delta_payload, sizeof(delta_payload))) {
+        return;
+    }
+
+    // Two entries stay on the stack, the caller holds the scratch arena for the snapshot copy
+    // and a nested acquire would wait on it forever
     astarte_object_entry_t object_entries[]
         = { { .path = "totalBytes", .data = astarte_data_from_longinteger(total_space) },
               { .path = "freeBytes", .data = astarte_data_from_longinteger(free_space) } };
@@ -277,5 +442,6 @@ static void send_storage_telemetry(
 
     if (res != ASTARTE_RESULT_OK) {
         EDGEHOG_LOG_ERR("Unable to send storage usage for %s", path);
+        telemetry_delta_invalidate(path);
     }
 }
@@ -6,9 +6,12 @@
 
 #include "system_status.h"
 
+#include "edgehog_device/heap.h"
 #include "edgehog_private.h"
 #include "hardware_info.h"
+#include "publish_scratch.h"
 #include "system_time.h"
+#include "telemetry_delta.h"
 
 #include <zephyr/kernel.h>
 
@@ -23,6 +26,27 @@ EDGEHOG_LOG_MODULE_REGISTER(system_status, CONFIG_EDGEHOG_DEVICE_SYSTEM_STATUS_L
  *        Defines, constants and typedef        *
  ***********************************************/
 
+/** @brief Number of per-thread stack watermark cache slots. */
+#define THREAD_WATERMARK_CACHE_SIZE 32
+
+/** @brief Number of entries in a system status object payload. */
+#define SYSTEM_STATUS_OBJECT_ENTRIES 4
+
+/** @brief Cached stack watermark for a single thread. */
+typedef struct
+{
+    /** @brief The thread owning the figures, NULL marks a free slot. */
+    const struct k_thread *thread;
+    /** @brief Start of the thread's stack, used to detect thread object reuse. */
+    uintptr_t stack_start;
+    /** @brief Size of the thread's stack. */
+    size_t stack_size;
+    /** @brief Unused stack space as of the last scan of this thread. */
+    size_t stack_unused;
+    /** @brief True when the thread was observed in the current collection pass. */
+    bool seen;
+} thread_watermark_t;
+
 /** @brief Data struct for a thread info instance. */
 typedef struct
 {
@@ -32,28 +56,117 @@ typedef struct
     size_t stack_size_free;
     /** @brief Number of allocated/running threads. */
     int count;
+    /** @brief Iteration index of the current thread within the pass. */
+    size_t thread_idx;
+    /** @brief Iteration index of the one cached thread to rescan in this pass. */
+    size_t rescan_idx;
 } thread_info_t;
 
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+static thread_watermark_t watermark_cache[THREAD_WATERMARK_CACHE_SIZE];
+// Rotating index of the next thread whose watermark gets rescanned
+static size_t watermark_rescan_cursor;
+#endif
+// Serializes collection passes between the telemetry thread and the burst sampling work item
+static K_MUTEX_DEFINE(watermark_mutex);
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+/**
+ * @brief Find the watermark cache slot for a thread.
+ *
+ * @param[in] thread The thread to look up.
+ * @return The matching slot, or NULL when the thread is not cached.
+ */
+static thread_watermark_t *watermark_cache_find(const struct k_thread *thread)
+{
+    for (size_t i = 0; i < THREAD_WATERMARK_CACHE_SIZE; i++) {
+        thread_watermark_t *slot = &watermark_cache[i];
+        // The stack bounds discriminate a recycled thread object from the cached one
+        if ((slot->thread == thread) && (slot->stack_start == thread->stack_info.start)
+            && (slot->stack_size == thread->stack_info.size)) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+#endif
+
 /* This callback counts the number of thread and sums stack size and free stack for each threads. */
 static void k_thread_stack_sum_cb(const struct k_thread *thread, void *user_data)
 {
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
-    size_t unused = thread->stack_info.size;
-
     thread_info_t *thread_info = (thread_info_t *) user_data;
+    size_t thread_idx = thread_info->thread_idx++;
+
+    // Stack usage only ever grows, so a cached watermark is at worst optimistic by the amount
+    // a thread consumed since its slot was last refreshed. One cached thread per pass gets
+    // rescanned in rotation, bounding the staleness without walking every stack every period.
+    thread_watermark_t *slot = watermark_cache_find(thread);
+    if (slot && (thread_idx != thread_info->rescan_idx)) {
+        slot->seen = true;
+        thread_info->count = thread_info->count + 1;
+        thread_info->stack_size_free = thread_info->stack_size_free + slot->stack_unused;
+        thread_info->stack_size = thread_info->stack_size + slot->stack_size;
+        return;
+    }
+
+    size_t unused = thread->stack_info.size;
     if (k_thread_stack_space_get(thread, &unused) == 0) {
         thread_info->count = thread_info->count + 1;
         thread_info->stack_size_free = thread_info->stack_size_free + unused;
         thread_info->stack_size = thread_info->stack_size + thread->stack_info.size;
+
+        if (!slot) {
+            // New thread, take over a free slot when one is available
+            for (size_t i = 0; (i < THREAD_WATERMARK_CACHE_SIZE) && !slot; i++) {
+                if (!watermark_cache[i].thread) {
+                    slot = &watermark_cache[i];
+                }
+            }
+        }
+        if (slot) {
+            slot->thread = thread;
+            slot->stack_start = thread->stack_info.start;
+            slot->stack_size = thread->stack_info.size;
+            slot->stack_unused = unused;
+            slot->seen = true;
+        }
     }
 #endif
 }
 
-void publish_system_status(edgehog_device_handle_t edgehog_device)
+void system_status_sample(system_status_sample_t *sample)
 {
-    EDGEHOG_LOG_DBG("Publishing Edgehog device system status");
     thread_info_t thread_info = { 0 };
+
+    k_mutex_lock(&watermark_mutex, K_FOREVER);
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+    thread_info.rescan_idx = watermark_rescan_cursor;
+    for (size_t i = 0; i < THREAD_WATERMARK_CACHE_SIZE; i++) {
+        watermark_cache[i].seen = false;
+    }
+#endif
     k_thread_foreach_unlocked(k_thread_stack_sum_cb, &thread_info);
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+    // Free the slots of threads that terminated since the last pass
+    for (size_t i = 0; i < THREAD_WATERMARK_CACHE_SIZE; i++) {
+        if (!watermark_cache[i].seen) {
+            watermark_cache[i].thread = NULL;
+        }
+    }
+    watermark_rescan_cursor = (watermark_rescan_cursor + 1) % MAX(thread_info.thread_idx, 1U);
+#endif
+    k_mutex_unlock(&watermark_mutex);
 
     size_t memory_size = 0;
     size_t avail_memory = 0;
@@ -64,20 +177,68 @@ void publish_system_status(edgehog_device_handle_t edgehog_device)
         avail_memory = thread_info.stack_size_free;
     }
 
-    astarte_object_entry_t object_entries[] = {
-        { .path = "availMemoryBytes", .data = astarte_data_from_longinteger(avail_memory) },
-        { .path = "bootId", .data = astarte_data_from_string(edgehog_device->boot_id) },
-        { .path = "taskCount", .data = astarte_data_from_integer(thread_info.count) },
-        { .path = "uptimeMillis", .data = astarte_data_from_longinteger(k_uptime_get()) },
-    };
+    // RAM allocated from the dedicated Edgehog heap is in use as well
+    edgehog_heap_stats_t heap_stats = { 0 };
+    if ((edgehog_heap_stats_get(&heap_stats) == EDGEHOG_RESULT_OK)
+        && (avail_memory > heap_stats.allocated_bytes)) {
+        avail_memory -= heap_stats.allocated_bytes;
+    }
+
+    sample->avail_memory = avail_memory;
+    sample->task_count = thread_info.count;
+}
+
+void publish_system_status(edgehog_device_handle_t edgehog_device)
+{
+    EDGEHOG_LOG_DBG("Publishing Edgehog device system status");
+    system_status_sample_t sample = { 0 };
+    system_status_sample(&sample);
+
+    // Watermark figures ride the slow system status cadence, the Astarte interfaces have no
+    // mapping for them so they are surfaced through the log
+    edgehog_heap_stats_t heap_stats = { 0 };
+    if (edgehog_heap_stats_get(&heap_stats) == EDGEHOG_RESULT_OK) {
+        EDGEHOG_LOG_INF("Edgehog heap watermark: %zu bytes peak, %zu bytes free, %lu failed "
+                        "allocations",
+            heap_stats.max_allocated_bytes, heap_stats.free_bytes,
+            (unsigned long) heap_stats.failed_allocations);
+    }
+
+    // The uptime and the per-boot constant boot id are left out of the change detection, a
+    // publish is only worth its traffic when the memory or task figures moved.
+    struct
+    {
+        size_t avail_memory;
+        size_t task_count;
+    } delta_payload
+        = { .avail_memory = sample.avail_memory, .task_count = (size_t) sample.task_count };
+    if (!telemetry_delta_should_publish("/systemStatus", &delta_payload, sizeof(delta_payload))) {
+        return;
+    }
+
+    astarte_object_entry_t *object_entries
+        = publish_scratch_acquire(SYSTEM_STATUS_OBJECT_ENTRIES * sizeof(astarte_object_entry_t));
+    if (!object_entries) {
+        return;
+    }
+    object_entries[0] = (astarte_object_entry_t) { .path = "availMemoryBytes",
+        .data = astarte_data_from_longinteger(sample.avail_memory) };
+    object_entries[1] = (astarte_object_entry_t) { .path = "bootId",
+        .data = astarte_data_from_string(edgehog_device->boot_id) };
+    object_entries[2] = (astarte_object_entry_t) { .path = "taskCount",
+        .data = astarte_data_from_integer(sample.task_count) };
+    object_entries[3] = (astarte_object_entry_t) { .path = "uptimeMillis",
+        .data = astarte_data_from_longinteger(k_uptime_get()) };
 
     int64_t timestamp_ms = 0;
     system_time_current_ms(&timestamp_ms);
 
     astarte_result_t res = astarte_device_send_object(edgehog_device->astarte_device,
         io_edgehog_devicemanager_SystemStatus.name, "/systemStatus", object_entries,
-        ARRAY_SIZE(object_entries), &timestamp_ms);
+        SYSTEM_STATUS_OBJECT_ENTRIES, &timestamp_ms);
+    publish_scratch_release();
     if (res != ASTARTE_RESULT_OK) {
         EDGEHOG_LOG_ERR("Unable to send system_status"); // NOLINT
+        telemetry_delta_invalidate("/systemStatus");
     }
 }
@@ -9,23 +9,36 @@
  * The telemetry for Edgehog devices is comprised of the following elements:
  * - A message queue used to communicate to the telemetry service the transmission requests
  * - A telemetry service task that waits for messages on the queue and when a new message is
- *   present it takes care of transmitting it.
+ *   present it takes care of transmitting it. It runs either as a dedicated thread polling the
+ *   queue, or as a work item on the system workqueue submitted when a message is queued
+ *   (CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE), trading the dedicated stack and the idle
+ *   polling wakeups for publishes running in the shared workqueue context.
  * - A set of telemetry entries, up to one for each type. Each telemetry entry can be scheduled
- *   at its defined frequency. When an entry is scheduled a zephyr kernel timer is created that
- *   automatically triggers transmission of the telemetry entry with the defined frequency. It
- *   triggers transmission by placing a new message in the telemetry message queue.
+ *   at its defined frequency. Scheduled entries carry an absolute transmission deadline and are
+ *   all driven by a single kernel timer armed on the earliest deadline. When the timer expires
+ *   every entry due within a small coalescing window is triggered in the same wakeup, by placing
+ *   a message in the telemetry message queue, and the timer is re-armed on the next deadline.
  */
 
 #include "telemetry_private.h"
 
 #include "edgehog_private.h"
+#include "event_loop.h"
 #include "generated_interfaces.h"
 #include "hardware_info.h"
+#include "heap.h"
+#include "sdk_event.h"
+#include "sdk_metrics.h"
 #include "settings.h"
 #include "storage_usage.h"
+#include "string_hash.h"
 #include "system_status.h"
+#include "telemetry_burst_private.h"
+#include "thread_placement.h"
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <astarte_device_sdk/device.h>
 
@@ -37,18 +50,93 @@ EDGEHOG_LOG_MODULE_REGISTER(telemetry, CONFIG_EDGEHOG_DEVICE_TELEMETRY_LOG_LEVEL
  ***********************************************/
 
 #define TELEMETRY_SERVICE_THREAD_STACK_SIZE 4096
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_THREAD_PRIORITY
+#define TELEMETRY_SERVICE_THREAD_PRIORITY CONFIG_EDGEHOG_DEVICE_TELEMETRY_THREAD_PRIORITY
+#else
 #define TELEMETRY_SERVICE_THREAD_PRIORITY 5
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_THREAD_CPU_MASK
+#define TELEMETRY_SERVICE_THREAD_CPU_MASK CONFIG_EDGEHOG_DEVICE_TELEMETRY_THREAD_CPU_MASK
+#else
+#define TELEMETRY_SERVICE_THREAD_CPU_MASK 0
+#endif
 #define TELEMETRY_SERVICE_THREAD_RUNNING_BIT (1)
 #define TELEMETRY_SERVICE_MSGQ_GET_TIMEOUT 100
+#define TELEMETRY_SERVICE_BATCH_WINDOW_MS CONFIG_EDGEHOG_DEVICE_TELEMETRY_BATCH_WINDOW_MS
+/** @brief Entries due within this window of a scheduler wakeup are fired in the same wakeup. */
+#define TELEMETRY_SCHEDULER_COALESCE_WINDOW_MS 500
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+/** @brief Maximum time a due entry is held waiting to piggyback on an awake transport. */
+#define TELEMETRY_RADIO_SLACK_MS                                                                   \
+    (CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_SLACK_SECONDS * MSEC_PER_SEC)
+#endif
 
+#ifndef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
 // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
 K_THREAD_STACK_DEFINE(telemetry_service_stack_area, TELEMETRY_SERVICE_THREAD_STACK_SIZE);
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Storage backing the service context created by edgehog_telemetry_new_static
+static edgehog_telemetry_t static_telemetry;
+static atomic_t static_telemetry_in_use;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * @brief Telemetry types in publish order, most valuable first.
+ *
+ * @details When a batch holds several types the OTA-adjacent health samples go out before the
+ * routine reports, so a link that stalls mid-batch loses the least valuable data first.
+ */
+static const edgehog_telemetry_type_t telemetry_publish_priority[] = {
+    EDGEHOG_TELEMETRY_SYSTEM_STATUS_BURST,
+    EDGEHOG_TELEMETRY_SYSTEM_STATUS,
+    EDGEHOG_TELEMETRY_WIFI_SCAN,
+    EDGEHOG_TELEMETRY_STORAGE_USAGE,
+    EDGEHOG_TELEMETRY_HW_INFO,
+    EDGEHOG_TELEMETRY_SDK_METRICS,
+};
+
+/**
+ * @brief Lookup table mapping the configurable Astarte interfaces to their telemetry type.
+ *
+ * @details The name hashes are filled in on the first lookup, a configuration event then hashes
+ * the incoming name once and runs a single confirming strcmp on the entry whose hash matches,
+ * instead of one full strcmp per supported interface.
+ */
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static struct
+{
+    /** @brief The Astarte interface for this telemetry type. */
+    const astarte_interface_t *interface;
+    /** @brief The telemetry type the interface maps to. */
+    edgehog_telemetry_type_t type;
+    /** @brief Hash of the interface name, 0 until computed. */
+    uint32_t name_hash;
+} interface_types[] = {
+    { .interface = &io_edgehog_devicemanager_HardwareInfo, .type = EDGEHOG_TELEMETRY_HW_INFO },
+    { .interface = &io_edgehog_devicemanager_WiFiScanResults, .type = EDGEHOG_TELEMETRY_WIFI_SCAN },
+    { .interface = &io_edgehog_devicemanager_SystemStatus,
+        .type = EDGEHOG_TELEMETRY_SYSTEM_STATUS },
+    { .interface = &io_edgehog_devicemanager_StorageUsage,
+        .type = EDGEHOG_TELEMETRY_STORAGE_USAGE },
+};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
 /************************************************
  *         Static functions declaration         *
  ***********************************************/
 
+/**
+ * @brief Initialize a telemetry service context.
+ *
+ * @param[in] telemetry The zeroed context to initialize.
+ * @param[in] configs An array of user configuration entries.
+ * @param[in] configs_len Number of configuration elements.
+ */
+static void telemetry_init(
+    edgehog_telemetry_t *telemetry, edgehog_telemetry_config_t *configs, size_t configs_len);
 /**
  * @brief Schedule a new telemetry entry.
  *
@@ -78,10 +166,32 @@ static edgehog_telemetry_type_t type_from_interface(const char *interface_name);
 /**
  * @brief Remove a telemetry entry from scheduling.
  *
+ * @param[in] telemetry A valid telemetry instance.
  * @param[in] entry The telemetry entry to remove from the scheduling.
  * @return EDGEHOG_RESULT_OK if successful, an edgehog_result_t otherwise.
  */
-static edgehog_result_t unschedule_entry(edgehog_telemetry_entry_t *entry);
+static edgehog_result_t unschedule_entry(
+    edgehog_telemetry_t *telemetry, edgehog_telemetry_entry_t *entry);
+/**
+ * @brief Re-arm the scheduler timer on the earliest entry deadline.
+ *
+ * @details Stops the timer when no entry is scheduled. Must be called with the scheduler lock
+ * held.
+ *
+ * @param[in] telemetry A valid telemetry instance.
+ */
+static void scheduler_rearm_locked(edgehog_telemetry_t *telemetry);
+/**
+ * @brief Queue every entry due within the window and advance its deadline by one period.
+ *
+ * @details Must be called with the scheduler lock held, the caller re-arms the timer.
+ *
+ * @param[in] telemetry A valid telemetry instance.
+ * @param[in] now The current uptime in milliseconds.
+ * @param[in] window_ms Entries with a deadline within this many milliseconds from now are queued.
+ */
+static void scheduler_flush_due_locked(
+    edgehog_telemetry_t *telemetry, int64_t now, int64_t window_ms);
 /**
  * @brief Check the existence of a telemetry type in the user provided configuration.
  *
@@ -111,11 +221,72 @@ static void publish_telemetry(edgehog_device_handle_t device, edgehog_telemetry_
  *       Callbacks declaration/definition       *
  ***********************************************/
 
+/**
+ * @brief Function invoked by the scheduler timer upon expiration.
+ *
+ * @details Places a message in the telemetry message queue for every entry due within the
+ * coalescing window, advances their deadlines by one period and re-arms the timer on the next
+ * deadline.
+ *
+ * @param[in] timer Pointer to the timer triggering the call.
+ */
+static void scheduler_timer_expiry_fn(struct k_timer *timer)
+{
+    edgehog_telemetry_t *telemetry = CONTAINER_OF(timer, edgehog_telemetry_t, timer);
+    int64_t now = k_uptime_get();
+
+    sdk_metrics_record_timer_wakeup();
+
+    k_spinlock_key_t key = k_spin_lock(&telemetry->sched_lock);
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+    // The radio pays for this wakeup regardless: everything due within the slack rides along
+    scheduler_flush_due_locked(telemetry, now, TELEMETRY_RADIO_SLACK_MS);
+#else
+    scheduler_flush_due_locked(telemetry, now, TELEMETRY_SCHEDULER_COALESCE_WINDOW_MS);
+#endif
+    scheduler_rearm_locked(telemetry);
+    k_spin_unlock(&telemetry->sched_lock, key);
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+/**
+ * @brief Work handler publishing the queued telemetry requests.
+ *
+ * @details Submitted each time a message is queued. It drains the whole message queue and
+ * publishes each collected telemetry type once, messages queued in the same tick are already
+ * all present when the handler runs so they batch naturally.
+ *
+ * @param[in] work Pointer to the work item triggering the call.
+ */
+static void telemetry_publish_work_handler(struct k_work *work)
+{
+    edgehog_telemetry_t *telemetry = CONTAINER_OF(work, edgehog_telemetry_t, publish_work);
+    edgehog_telemetry_type_t type = EDGEHOG_TELEMETRY_INVALID;
+
+    if (!atomic_test_bit(&telemetry->thread_state, TELEMETRY_SERVICE_THREAD_RUNNING_BIT)) {
+        return;
+    }
+
+    uint32_t batch = 0;
+    while (k_msgq_get(&telemetry->msgq, &type, K_NO_WAIT) == 0) {
+        atomic_clear_bit(&telemetry->pending_types, type);
+        batch |= BIT(type);
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(telemetry_publish_priority); i++) {
+        if (batch & BIT(telemetry_publish_priority[i])) {
+            publish_telemetry(telemetry->device, telemetry_publish_priority[i]);
+        }
+    }
+}
+#else
 /**
  * @brief Entry point for the telemetry service thread.
  *
  * @details This thread will wait for a new message from the telemetry message queue. Each time it
- * receives  one it will trigger the pubblish of a telemetry entry of the received type.
+ * receives one it keeps draining the queue for a short batching window, then publishes each
+ * collected telemetry type once. Entries sharing the same period fire in the same tick, batching
+ * them avoids a separate publish storm for every tick.
  *
  * @param[in] device_ptr Pointer to a valid instance of an edgehog device.
  * @param[in] queue_ptr Pointer to the message queue instance.
@@ -130,11 +301,30 @@ static void telemetry_service_thread_entry_point(void *device_ptr, void *queue_p
 
     while (
         atomic_test_bit(&device->telemetry->thread_state, TELEMETRY_SERVICE_THREAD_RUNNING_BIT)) {
-        if (k_msgq_get(msgq, &type, K_MSEC(TELEMETRY_SERVICE_MSGQ_GET_TIMEOUT)) == 0) {
-            publish_telemetry(device, type);
+        if (k_msgq_get(msgq, &type, K_MSEC(TELEMETRY_SERVICE_MSGQ_GET_TIMEOUT)) != 0) {
+            continue;
+        }
+        atomic_clear_bit(&device->telemetry->pending_types, type);
+
+        // Collect every request queued within the batching window, duplicates collapse in the
+        // bitmask. A window of zero leaves the single received type in the batch.
+        uint32_t batch = BIT(type);
+        int64_t window_end = k_uptime_get() + TELEMETRY_SERVICE_BATCH_WINDOW_MS;
+        int64_t remaining_ms = 0;
+        while (((remaining_ms = window_end - k_uptime_get()) > 0)
+            && (k_msgq_get(msgq, &type, K_MSEC(remaining_ms)) == 0)) {
+            atomic_clear_bit(&device->telemetry->pending_types, type);
+            batch |= BIT(type);
+        }
+
+        for (size_t i = 0; i < ARRAY_SIZE(telemetry_publish_priority); i++) {
+            if (batch & BIT(telemetry_publish_priority[i])) {
+                publish_telemetry(device, telemetry_publish_priority[i]);
+            }
         }
     }
 }
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
 
 /************************************************
  *         Global functions definitions         *
@@ -143,32 +333,28 @@ static void telemetry_service_thread_entry_point(void *device_ptr, void *queue_p
 edgehog_telemetry_t *edgehog_telemetry_new(edgehog_telemetry_config_t *configs, size_t configs_len)
 {
     // Allocate space for the telemetry internal struct
-    edgehog_telemetry_t *telemetry = calloc(1, sizeof(edgehog_telemetry_t));
+    edgehog_telemetry_t *telemetry = edgehog_calloc(1, sizeof(edgehog_telemetry_t));
     if (!telemetry) {
         EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
         return NULL;
     }
 
-    // Copy the provided settings to the telemetry internal struct
-    telemetry->configs_len = configs_len;
-    if (configs_len > 0) {
-        telemetry->configs = calloc(telemetry->configs_len, sizeof(edgehog_telemetry_config_t));
-        if (!telemetry->configs) {
-            EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
-            goto error;
-        }
-        memcpy(telemetry->configs, configs, configs_len * sizeof(edgehog_telemetry_config_t));
-    }
-
-    // Load telemetries first from settings, then as a fallback from the provided configuration
-    telemetry_entries_load_from_settings(telemetry->entries);
-    telemetry_entries_load_from_config(configs, configs_len, telemetry->entries);
-
+    telemetry_init(telemetry, configs, configs_len);
     return telemetry;
+}
 
-error:
-    edgehog_telemetry_destroy(telemetry);
-    return NULL;
+edgehog_telemetry_t *edgehog_telemetry_new_static(
+    edgehog_telemetry_config_t *configs, size_t configs_len)
+{
+    if (!atomic_cas(&static_telemetry_in_use, 0, 1)) {
+        EDGEHOG_LOG_ERR("The static telemetry service instance is already in use");
+        return NULL;
+    }
+
+    memset(&static_telemetry, 0, sizeof(static_telemetry));
+    telemetry_init(&static_telemetry, configs, configs_len);
+    static_telemetry.statically_allocated = true;
+    return &static_telemetry;
 }
 
 edgehog_result_t edgehog_telemetry_start(edgehog_device_handle_t device)
@@ -188,9 +374,14 @@ edgehog_result_t edgehog_telemetry_start(edgehog_device_handle_t device)
     k_msgq_init(&telemetry->msgq, telemetry->msgq_buffer, sizeof(edgehog_telemetry_type_t),
         EDGEHOG_TELEMETRY_LEN);
 
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+    telemetry->device = device;
+    k_work_init(&telemetry->publish_work, telemetry_publish_work_handler);
+#else
     k_tid_t thread_id = k_thread_create(&telemetry->thread, telemetry_service_stack_area,
         TELEMETRY_SERVICE_THREAD_STACK_SIZE, telemetry_service_thread_entry_point, (void *) device,
-        (void *) &telemetry->msgq, NULL, TELEMETRY_SERVICE_THREAD_PRIORITY, 0, K_NO_WAIT);
+        (void *) &telemetry->msgq, NULL, TELEMETRY_SERVICE_THREAD_PRIORITY, 0,
+        EDGEHOG_THREAD_START_DELAY);
 
     if (!thread_id) {
         EDGEHOG_LOG_ERR("Unable to start telemetry message thread");
@@ -205,6 +396,9 @@ edgehog_result_t edgehog_telemetry_start(edgehog_device_handle_t device)
     }
 #endif
 
+    edgehog_thread_placement_start(thread_id, TELEMETRY_SERVICE_THREAD_CPU_MASK);
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+
     for (int i = 0; i < EDGEHOG_TELEMETRY_LEN; i++) {
         edgehog_telemetry_entry_t *entry = telemetry->entries[i];
         if (entry && entry->enable) {
@@ -257,7 +451,7 @@ edgehog_result_t edgehog_telemetry_config_set_event(
     if (entry->enable) {
         return schedule_entry(telemetry, entry);
     }
-    return unschedule_entry(entry);
+    return unschedule_entry(telemetry, entry);
 }
 
 edgehog_result_t edgehog_telemetry_config_unset_event(
@@ -291,13 +485,20 @@ edgehog_result_t edgehog_telemetry_config_unset_event(
     if (entry->enable) {
         return schedule_entry(telemetry, entry);
     }
-    return unschedule_entry(entry);
+    return unschedule_entry(telemetry, entry);
 }
 
 edgehog_result_t edgehog_telemetry_stop(edgehog_telemetry_t *telemetry, k_timeout_t timeout)
 {
-    // Request the thread to self exit
+    // Request the service to stop processing messages
     atomic_clear_bit(&telemetry->thread_state, TELEMETRY_SERVICE_THREAD_RUNNING_BIT);
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+    ARG_UNUSED(timeout);
+    // Wait for an eventual in flight publish work item to complete
+    struct k_work_sync sync;
+    k_work_cancel_sync(&telemetry->publish_work, &sync);
+    return EDGEHOG_RESULT_OK;
+#else
     // Wait for the thread to self exit
     int res = k_thread_join(&telemetry->thread, timeout);
     switch (res) {
@@ -308,19 +509,57 @@ edgehog_result_t edgehog_telemetry_stop(edgehog_telemetry_t *telemetry, k_timeou
         default:
             return EDGEHOG_RESULT_INTERNAL_ERROR;
     }
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
 }
 
 void edgehog_telemetry_destroy(edgehog_telemetry_t *telemetry)
 {
+    k_timer_stop(&telemetry->timer);
     for (int i = 0; i < EDGEHOG_TELEMETRY_LEN; i++) {
-        if ((telemetry->entries[i])
-            && (k_timer_remaining_get(&telemetry->entries[i]->timer) != 0)) {
-            k_timer_stop(&telemetry->entries[i]->timer);
-        }
-        free(telemetry->entries[i]);
+        telemetry_entry_free(telemetry->entries[i]);
     }
-    free(telemetry->configs);
-    free(telemetry);
+    if (telemetry->statically_allocated) {
+        atomic_clear(&static_telemetry_in_use);
+    } else {
+        edgehog_free(telemetry);
+    }
+}
+
+edgehog_result_t edgehog_telemetry_request(
+    edgehog_telemetry_t *telemetry, edgehog_telemetry_type_t type)
+{
+    if ((type <= EDGEHOG_TELEMETRY_INVALID) || (type >= EDGEHOG_TELEMETRY_LEN)) {
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    // Coalesce with an eventual pending request for the same type. Since each type occupies at
+    // most one queue slot and the queue holds one slot per type, the put below cannot fail.
+    if (atomic_test_and_set_bit(&telemetry->pending_types, type)) {
+        return EDGEHOG_RESULT_OK;
+    }
+
+    if (k_msgq_put(&telemetry->msgq, &type, K_NO_WAIT) != 0) {
+        atomic_clear_bit(&telemetry->pending_types, type);
+        sdk_metrics_record_queue_drop();
+        EDGEHOG_LOG_WRN("Telemetry queue full, dropped request for type %d", type);
+        return EDGEHOG_RESULT_INTERNAL_ERROR;
+    }
+
+    edgehog_telemetry_signal(telemetry);
+    return EDGEHOG_RESULT_OK;
+}
+
+void edgehog_telemetry_signal(edgehog_telemetry_t *telemetry)
+{
+#if defined(CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD)
+    // Publishes run on the shared SDK event loop instead of the system workqueue
+    k_work_submit_to_queue(edgehog_event_loop_get(), &telemetry->publish_work);
+#elif defined(CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE)
+    k_work_submit(&telemetry->publish_work);
+#else
+    // The service thread polls the message queue, no notification needed
+    ARG_UNUSED(telemetry);
+#endif
 }
 
 bool edgehog_telemetry_is_running(edgehog_telemetry_t *telemetry)
@@ -331,6 +570,34 @@ bool edgehog_telemetry_is_running(edgehog_telemetry_t *telemetry)
     return atomic_test_bit(&telemetry->thread_state, TELEMETRY_SERVICE_THREAD_RUNNING_BIT);
 }
 
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+void edgehog_telemetry_transport_active(edgehog_telemetry_t *telemetry)
+{
+    if (!edgehog_telemetry_is_running(telemetry)) {
+        return;
+    }
+
+    // The transport is awake for other traffic: flush every entry inside its slack window with
+    // it instead of waking the radio again when the slack expires. Deadlines keep advancing by
+    // whole periods, so alignment only jitters single publishes, never the average cadence.
+    k_spinlock_key_t key = k_spin_lock(&telemetry->sched_lock);
+    scheduler_flush_due_locked(telemetry, k_uptime_get(), TELEMETRY_RADIO_SLACK_MS);
+    scheduler_rearm_locked(telemetry);
+    k_spin_unlock(&telemetry->sched_lock, key);
+}
+#endif
+
+void edgehog_device_telemetry_transport_hint(edgehog_device_handle_t edgehog_device)
+{
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+    if (edgehog_device) {
+        edgehog_telemetry_transport_active(edgehog_device->telemetry);
+    }
+#else
+    ARG_UNUSED(edgehog_device);
+#endif
+}
+
 /************************************************
  *         Static functions definitions         *
  ***********************************************/
@@ -359,24 +626,10 @@ static edgehog_result_t schedule_entry(
         return EDGEHOG_RESULT_OK;
     }
 
-    struct k_timer *timer = &entry->timer;
-    if (k_timer_remaining_get(timer) == 0) {
-
-        // Note: the timer callback is set when the entry is created
-        k_timer_user_data_set(timer, &telemetry->msgq);
-        k_timer_start(timer, K_SECONDS(entry->period_seconds), K_SECONDS(entry->period_seconds));
-
-        if (k_timer_remaining_get(timer) == 0) {
-            EDGEHOG_LOG_WRN("The timer %d could not be set into the Active state", entry->type);
-            k_timer_stop(timer);
-            telemetry_entry_remove(entry->type, telemetry->entries);
-            goto error;
-        };
-
-    } else {
-        k_timer_stop(timer);
-        k_timer_start(timer, K_SECONDS(entry->period_seconds), K_SECONDS(entry->period_seconds));
-    }
+    k_spinlock_key_t key = k_spin_lock(&telemetry->sched_lock);
+    entry->next_deadline_ms = k_uptime_get() + (entry->period_seconds * MSEC_PER_SEC);
+    scheduler_rearm_locked(telemetry);
+    k_spin_unlock(&telemetry->sched_lock, key);
 
     return EDGEHOG_RESULT_OK;
 
@@ -385,6 +638,27 @@ error:
     return EDGEHOG_RESULT_TELEMETRY_START_FAIL;
 }
 
+static void telemetry_init(
+    edgehog_telemetry_t *telemetry, edgehog_telemetry_config_t *configs, size_t configs_len)
+{
+    k_timer_init(&telemetry->timer, scheduler_timer_expiry_fn, NULL);
+
+    // Index the provided base periods by type, so config event handling reads them in O(1)
+    for (int i = 0; i < EDGEHOG_TELEMETRY_LEN; i++) {
+        telemetry->config_periods[i] = -1;
+    }
+    for (size_t i = 0; i < configs_len; i++) {
+        edgehog_telemetry_type_t type = configs[i].type;
+        if ((type > EDGEHOG_TELEMETRY_INVALID) && (type < EDGEHOG_TELEMETRY_LEN)) {
+            telemetry->config_periods[type] = configs[i].period_seconds;
+        }
+    }
+
+    // Load telemetries first from settings, then as a fallback from the provided configuration
+    telemetry_entries_load_from_settings(telemetry->entries);
+    telemetry_entries_load_from_config(configs, configs_len, telemetry->entries);
+}
+
 static edgehog_result_t parse_configuration_event(
     astarte_device_data_event_t *event, edgehog_telemetry_type_t *type, char **endpoint)
 {
@@ -417,22 +691,26 @@ static edgehog_result_t parse_configuration_event(
 
 static edgehog_telemetry_type_t type_from_interface(const char *interface_name)
 {
-    if (strcmp(interface_name, io_edgehog_devicemanager_HardwareInfo.name) == 0) {
-        return EDGEHOG_TELEMETRY_HW_INFO;
-    }
-    if (strcmp(interface_name, io_edgehog_devicemanager_WiFiScanResults.name) == 0) {
-        return EDGEHOG_TELEMETRY_WIFI_SCAN;
-    }
-    if (strcmp(interface_name, io_edgehog_devicemanager_SystemStatus.name) == 0) {
-        return EDGEHOG_TELEMETRY_SYSTEM_STATUS;
+    // Lazy one-time hashing of the table, the interface names are not compile time constants
+    // here. A race on the first events is benign since every writer stores the same values.
+    if (interface_types[0].name_hash == 0) {
+        for (size_t i = 0; i < ARRAY_SIZE(interface_types); i++) {
+            interface_types[i].name_hash = edgehog_string_hash(interface_types[i].interface->name);
+        }
     }
-    if (strcmp(interface_name, io_edgehog_devicemanager_StorageUsage.name) == 0) {
-        return EDGEHOG_TELEMETRY_STORAGE_USAGE;
+
+    uint32_t hash = edgehog_string_hash(interface_name);
+    for (size_t i = 0; i < ARRAY_SIZE(interface_types); i++) {
+        if ((interface_types[i].name_hash == hash)
+            && (strcmp(interface_name, interface_types[i].interface->name) == 0)) {
+            return interface_types[i].type;
+        }
     }
     return EDGEHOG_TELEMETRY_INVALID;
 }
 
-static edgehog_result_t unschedule_entry(edgehog_telemetry_entry_t *entry)
+static edgehog_result_t unschedule_entry(
+    edgehog_telemetry_t *telemetry, edgehog_telemetry_entry_t *entry)
 {
     if (!entry) {
         EDGEHOG_LOG_ERR("Telemetry undefined");
@@ -446,35 +724,73 @@ static edgehog_result_t unschedule_entry(edgehog_telemetry_entry_t *entry)
 
     telemetry_entry_store(entry);
 
-    if (k_timer_remaining_get(&entry->timer) != 0) {
-        k_timer_stop(&entry->timer);
-    }
+    k_spinlock_key_t key = k_spin_lock(&telemetry->sched_lock);
+    entry->next_deadline_ms = 0;
+    scheduler_rearm_locked(telemetry);
+    k_spin_unlock(&telemetry->sched_lock, key);
 
     return EDGEHOG_RESULT_OK;
 }
 
-static bool type_is_in_config(edgehog_telemetry_type_t type, edgehog_telemetry_t *telemetry)
+static void scheduler_flush_due_locked(
+    edgehog_telemetry_t *telemetry, int64_t now, int64_t window_ms)
 {
-    for (int i = 0; i < telemetry->configs_len; i++) {
-        if (type == telemetry->configs[i].type) {
-            return true;
+    for (int i = 0; i < EDGEHOG_TELEMETRY_LEN; i++) {
+        edgehog_telemetry_entry_t *entry = telemetry->entries[i];
+        if (!entry || (entry->next_deadline_ms <= 0)) {
+            continue;
+        }
+        if (entry->next_deadline_ms <= now + window_ms) {
+            edgehog_telemetry_request(telemetry, entry->type);
+            int64_t period_ms = entry->period_seconds * MSEC_PER_SEC;
+            entry->next_deadline_ms += period_ms;
+            // Skip over missed periods instead of firing in a burst to catch up
+            if (entry->next_deadline_ms <= now) {
+                entry->next_deadline_ms = now + period_ms;
+            }
         }
     }
-    return false;
 }
 
-static int64_t get_period_from_config(edgehog_telemetry_type_t type, edgehog_telemetry_t *telemetry)
+static void scheduler_rearm_locked(edgehog_telemetry_t *telemetry)
 {
-    for (int i = 0; i < telemetry->configs_len; i++) {
-        if (type == telemetry->configs[i].type) {
-            return telemetry->configs[i].period_seconds;
+    int64_t earliest = INT64_MAX;
+    for (int i = 0; i < EDGEHOG_TELEMETRY_LEN; i++) {
+        edgehog_telemetry_entry_t *entry = telemetry->entries[i];
+        if (entry && (entry->next_deadline_ms > 0) && (entry->next_deadline_ms < earliest)) {
+            earliest = entry->next_deadline_ms;
         }
     }
-    return -1;
+
+    if (earliest == INT64_MAX) {
+        k_timer_stop(&telemetry->timer);
+        return;
+    }
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_RADIO_ALIGNED
+    // Hold due entries for the slack window: transport activity flushes them earlier while the
+    // radio is already awake, the timer firing means the slack expired with nothing to ride
+    earliest += TELEMETRY_RADIO_SLACK_MS;
+#endif
+
+    int64_t delay_ms = earliest - k_uptime_get();
+    k_timer_start(&telemetry->timer, K_MSEC(MAX(delay_ms, 0)), K_NO_WAIT);
+}
+
+static bool type_is_in_config(edgehog_telemetry_type_t type, edgehog_telemetry_t *telemetry)
+{
+    return telemetry->config_periods[type] >= 0;
+}
+
+static int64_t get_period_from_config(edgehog_telemetry_type_t type, edgehog_telemetry_t *telemetry)
+{
+    return telemetry->config_periods[type];
 }
 
 static void publish_telemetry(edgehog_device_handle_t device, edgehog_telemetry_type_t type)
 {
+    int64_t publish_start_ms = k_uptime_get();
+
     switch (type) {
         case EDGEHOG_TELEMETRY_HW_INFO:
             publish_hardware_info(device);
@@ -490,7 +806,21 @@ static void publish_telemetry(edgehog_device_handle_t device, edgehog_telemetry_
         case EDGEHOG_TELEMETRY_STORAGE_USAGE:
             publish_storage_usage(device);
             break;
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
+        case EDGEHOG_TELEMETRY_SYSTEM_STATUS_BURST:
+            edgehog_telemetry_burst_flush(device);
+            break;
+#endif
+#ifdef CONFIG_EDGEHOG_DEVICE_SDK_METRICS
+        case EDGEHOG_TELEMETRY_SDK_METRICS:
+            publish_sdk_metrics(device);
+            break;
+#endif
         default:
             return;
     }
+
+    sdk_metrics_record_publish_latency(k_uptime_get() - publish_start_ms);
+    // The internal publishers log failures but do not propagate per-type results
+    sdk_event_publish(EDGEHOG_SDK_TELEMETRY_PUBLISHED_EVENT, EDGEHOG_RESULT_OK, 0);
 }
@@ -0,0 +1,223 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "telemetry_burst_private.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
+
+#include "edgehog_device/telemetry_burst.h"
+
+#include <zephyr/kernel.h>
+
+#include <astarte_device_sdk/device.h>
+#include <astarte_device_sdk/result.h>
+
+#include "edgehog_private.h"
+#include "generated_interfaces.h"
+#include "publish_scratch.h"
+#include "system_status.h"
+#include "system_time.h"
+#include "telemetry_private.h"
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_DECLARE(telemetry, CONFIG_EDGEHOG_DEVICE_TELEMETRY_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define BURST_SAMPLE_PERIOD_MS CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST_SAMPLE_PERIOD_MS
+#define BURST_BUFFER_DEPTH CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST_BUFFER_DEPTH
+
+/** @brief Number of entries in a burst system status object payload. */
+#define BURST_OBJECT_ENTRIES 4
+
+/** @brief One buffered burst sample. */
+typedef struct
+{
+    /** @brief Timestamp of the sample in ms since the epoch. */
+    int64_t timestamp_ms;
+    /** @brief System uptime in ms when the sample was taken. */
+    int64_t uptime_ms;
+    /** @brief The sampled system status. */
+    system_status_sample_t status;
+} burst_sample_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static burst_sample_t burst_ring[BURST_BUFFER_DEPTH];
+// Index of the next sample to write, the oldest sample sits count positions behind it
+static size_t burst_head;
+static size_t burst_count;
+// Lock protecting the ring, samples are taken in the workqueue and drained by the service thread
+static struct k_spinlock burst_lock;
+// Device for the active burst window, sampling and flushing are idle while NULL
+static edgehog_device_handle_t burst_device;
+// End of the burst window as system uptime in ms
+static int64_t burst_window_end_ms;
+static struct k_work_delayable burst_sample_work;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+/**
+ * @brief Ask the telemetry service thread to flush the ring buffer.
+ *
+ * @param[in] edgehog_device A valid Edgehog device handle.
+ */
+static void request_flush(edgehog_device_handle_t edgehog_device);
+
+/************************************************
+ *       Callbacks declaration/definition       *
+ ***********************************************/
+
+/**
+ * @brief Work handler taking one burst sample.
+ *
+ * @details Appends a sample to the ring buffer and re-schedules itself until the burst window
+ * ends. A flush is requested when the buffer fills up and when the window ends.
+ *
+ * @param[in] work Pointer to the work item triggering the call.
+ */
+static void burst_sample_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    edgehog_device_handle_t device = burst_device;
+    if (!device) {
+        return;
+    }
+
+    burst_sample_t sample = { 0 };
+    system_time_current_ms(&sample.timestamp_ms);
+    sample.uptime_ms = k_uptime_get();
+    system_status_sample(&sample.status);
+
+    k_spinlock_key_t key = k_spin_lock(&burst_lock);
+    burst_ring[burst_head] = sample;
+    burst_head = (burst_head + 1) % BURST_BUFFER_DEPTH;
+    // When the ring is full the oldest sample is overwritten
+    if (burst_count < BURST_BUFFER_DEPTH) {
+        burst_count++;
+    }
+    bool full = (burst_count == BURST_BUFFER_DEPTH);
+    k_spin_unlock(&burst_lock, key);
+
+    bool window_open = sample.uptime_ms < burst_window_end_ms;
+    if (full || !window_open) {
+        request_flush(device);
+    }
+    if (window_open) {
+        k_work_reschedule(&burst_sample_work, K_MSEC(BURST_SAMPLE_PERIOD_MS));
+    } else {
+        burst_device = NULL;
+    }
+}
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+edgehog_result_t edgehog_telemetry_burst_start(
+    edgehog_device_handle_t edgehog_device, int32_t duration_seconds)
+{
+    if (!edgehog_device || (duration_seconds <= 0)) {
+        EDGEHOG_LOG_ERR("Invalid burst telemetry window parameters");
+        return EDGEHOG_RESULT_INVALID_PARAM;
+    }
+
+    if (!edgehog_telemetry_is_running(edgehog_device->telemetry)) {
+        EDGEHOG_LOG_ERR("Unable to start a burst window, the telemetry service is not running");
+        return EDGEHOG_RESULT_TELEMETRY_START_FAIL;
+    }
+
+    static bool work_initialized;
+    if (!work_initialized) {
+        k_work_init_delayable(&burst_sample_work, burst_sample_work_handler);
+        work_initialized = true;
+    }
+
+    burst_window_end_ms = k_uptime_get() + (duration_seconds * (int64_t) MSEC_PER_SEC);
+    burst_device = edgehog_device;
+    k_work_reschedule(&burst_sample_work, K_NO_WAIT);
+
+    EDGEHOG_LOG_DBG("Burst telemetry window of %d s started", duration_seconds);
+    return EDGEHOG_RESULT_OK;
+}
+
+void edgehog_telemetry_burst_stop(edgehog_device_handle_t edgehog_device)
+{
+    burst_window_end_ms = 0;
+    k_work_cancel_delayable(&burst_sample_work);
+    burst_device = NULL;
+    if (edgehog_device) {
+        request_flush(edgehog_device);
+    }
+}
+
+void edgehog_telemetry_burst_flush(edgehog_device_handle_t edgehog_device)
+{
+    size_t flushed = 0;
+
+    // One acquire covers the whole drain, the entries are rebuilt in place for every sample
+    astarte_object_entry_t *object_entries
+        = publish_scratch_acquire(BURST_OBJECT_ENTRIES * sizeof(astarte_object_entry_t));
+    if (!object_entries) {
+        return;
+    }
+
+    // Pop one sample at a time so the send happens outside the lock
+    while (true) {
+        k_spinlock_key_t key = k_spin_lock(&burst_lock);
+        if (burst_count == 0) {
+            k_spin_unlock(&burst_lock, key);
+            break;
+        }
+        size_t oldest = (burst_head + BURST_BUFFER_DEPTH - burst_count) % BURST_BUFFER_DEPTH;
+        burst_sample_t sample = burst_ring[oldest];
+        burst_count--;
+        k_spin_unlock(&burst_lock, key);
+
+        object_entries[0] = (astarte_object_entry_t) { .path = "availMemoryBytes",
+            .data = astarte_data_from_longinteger(sample.status.avail_memory) };
+        object_entries[1] = (astarte_object_entry_t) { .path = "bootId",
+            .data = astarte_data_from_string(edgehog_device->boot_id) };
+        object_entries[2] = (astarte_object_entry_t) { .path = "taskCount",
+            .data = astarte_data_from_integer(sample.status.task_count) };
+        object_entries[3] = (astarte_object_entry_t) { .path = "uptimeMillis",
+            .data = astarte_data_from_longinteger(sample.uptime_ms) };
+
+        astarte_result_t res = astarte_device_send_object(edgehog_device->astarte_device,
+            io_edgehog_devicemanager_SystemStatus.name, "/systemStatus", object_entries,
+            BURST_OBJECT_ENTRIES, &sample.timestamp_ms);
+        if (res != ASTARTE_RESULT_OK) {
+            EDGEHOG_LOG_ERR("Unable to send a burst system status sample");
+        }
+        flushed++;
+    }
+    publish_scratch_release();
+
+    if (flushed > 0) {
+        EDGEHOG_LOG_DBG("Flushed %zu burst telemetry samples", flushed);
+    }
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void request_flush(edgehog_device_handle_t edgehog_device)
+{
+    // A request coalesces with an eventual pending one, which will drain the buffer anyway
+    edgehog_telemetry_request(edgehog_device->telemetry, EDGEHOG_TELEMETRY_SYSTEM_STATUS_BURST);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST
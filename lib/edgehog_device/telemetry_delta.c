@@ -0,0 +1,133 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "telemetry_delta.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TELEMETRY_DELTA
+
+#include <stdint.h>
+#include <string.h>
+
+#include "log.h"
+EDGEHOG_LOG_MODULE_DECLARE(telemetry, CONFIG_EDGEHOG_DEVICE_TELEMETRY_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Number of telemetry streams tracked by the cache. */
+#define DELTA_CACHE_SLOTS 8
+
+#define DELTA_MAX_AGE_MS                                                                           \
+    (CONFIG_EDGEHOG_DEVICE_TELEMETRY_DELTA_MAX_AGE_SECONDS * (int64_t) MSEC_PER_SEC)
+
+// FNV-1a 32 bit constants
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+/** @brief Cache entry for a single telemetry stream. */
+typedef struct
+{
+    /** @brief Hash of the stream key, 0 marks a free slot. */
+    uint32_t key_hash;
+    /** @brief Hash of the last published payload. */
+    uint32_t payload_hash;
+    /** @brief Uptime in ms of the last publish. */
+    int64_t last_publish_ms;
+} delta_slot_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static delta_slot_t delta_slots[DELTA_CACHE_SLOTS];
+// Next slot overwritten when the cache is full, evictions only cause an extra publish
+static size_t delta_evict_idx;
+// Lock protecting the slots, publishers run in different threads
+static struct k_spinlock delta_lock;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static uint32_t fnv1a_hash(const void *data, size_t len)
+{
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static delta_slot_t *find_slot(uint32_t key_hash)
+{
+    for (size_t i = 0; i < DELTA_CACHE_SLOTS; i++) {
+        if (delta_slots[i].key_hash == key_hash) {
+            return &delta_slots[i];
+        }
+    }
+    return NULL;
+}
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+bool telemetry_delta_should_publish(const char *key, const void *payload, size_t payload_len)
+{
+    // Reserve hash value 0 as the free slot marker
+    uint32_t key_hash = fnv1a_hash(key, strlen(key));
+    key_hash = (key_hash == 0) ? 1 : key_hash;
+    uint32_t payload_hash = fnv1a_hash(payload, payload_len);
+    int64_t now = k_uptime_get();
+    bool publish = true;
+
+    k_spinlock_key_t lock_key = k_spin_lock(&delta_lock);
+
+    delta_slot_t *slot = find_slot(key_hash);
+    if (slot && (slot->payload_hash == payload_hash)
+        && ((DELTA_MAX_AGE_MS <= 0) || ((now - slot->last_publish_ms) < DELTA_MAX_AGE_MS))) {
+        publish = false;
+    }
+
+    if (publish) {
+        if (!slot) {
+            slot = find_slot(0);
+        }
+        if (!slot) {
+            slot = &delta_slots[delta_evict_idx];
+            delta_evict_idx = (delta_evict_idx + 1) % DELTA_CACHE_SLOTS;
+        }
+        slot->key_hash = key_hash;
+        slot->payload_hash = payload_hash;
+        slot->last_publish_ms = now;
+    }
+
+    k_spin_unlock(&delta_lock, lock_key);
+
+    if (!publish) {
+        EDGEHOG_LOG_DBG("Telemetry for %s unchanged, skipping publish", key);
+    }
+    return publish;
+}
+
+void telemetry_delta_invalidate(const char *key)
+{
+    uint32_t key_hash = fnv1a_hash(key, strlen(key));
+    key_hash = (key_hash == 0) ? 1 : key_hash;
+
+    k_spinlock_key_t lock_key = k_spin_lock(&delta_lock);
+    delta_slot_t *slot = find_slot(key_hash);
+    if (slot) {
+        memset(slot, 0, sizeof(delta_slot_t));
+    }
+    k_spin_unlock(&delta_lock, lock_key);
+}
+
+#endif // CONFIG_EDGEHOG_DEVICE_TELEMETRY_DELTA
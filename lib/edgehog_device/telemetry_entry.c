@@ -7,6 +7,7 @@
 #include "telemetry_entry.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "settings.h"
 
@@ -23,6 +24,17 @@ EDGEHOG_LOG_MODULE_DECLARE(telemetry, CONFIG_EDGEHOG_DEVICE_TELEMETRY_LOG_LEVEL)
 #define SETTINGS_TELEMETRY_ENABLE_KEY "enable"
 #define SETTINGS_TELEMETRY_TYPE_KEY_SIZE 1
 
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// At most one entry per telemetry type can exist, so the pool is statically sized and entry
+// creation never touches the heap
+K_MEM_SLAB_DEFINE_STATIC(telemetry_entry_slab, WB_UP(sizeof(edgehog_telemetry_entry_t)),
+    EDGEHOG_TELEMETRY_LEN - 1, sizeof(void *));
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 /************************************************
  *         Static functions declaration         *
  ***********************************************/
@@ -51,21 +63,6 @@ static bool telemetry_entry_exist(
  *       Callbacks declaration/definition       *
  ***********************************************/
 
-/**
- * @brief Function invoked by each telemetry entry timer upon expiration.
- *
- * @details It will place a message in the message queue with the entry type.
- *
- * @param[in] timer Pointer to the timer triggering the call.
- */
-static void entry_timer_expiry_fn(struct k_timer *timer)
-{
-    edgehog_telemetry_entry_t *entry = CONTAINER_OF(timer, edgehog_telemetry_entry_t, timer);
-    struct k_msgq *msgq = (struct k_msgq *) k_timer_user_data_get(timer);
-
-    k_msgq_put(msgq, &entry->type, K_NO_WAIT);
-}
-
 /**
  * @brief Handle telemetry entries loading from settings.
  *
@@ -143,21 +140,28 @@ static int settings_entry_loader(
 edgehog_telemetry_entry_t *telemetry_entry_new(
     edgehog_telemetry_type_t type, int64_t period_seconds, bool enable)
 {
-    edgehog_telemetry_entry_t *entry = calloc(1, sizeof(edgehog_telemetry_entry_t));
-
-    if (!entry) {
-        EDGEHOG_LOG_ERR("Out of memory %s: %d", __FILE__, __LINE__);
+    void *block = NULL;
+    if (k_mem_slab_alloc(&telemetry_entry_slab, &block, K_NO_WAIT) != 0) {
+        EDGEHOG_LOG_ERR("Telemetry entry pool exhausted");
         return NULL;
     }
 
+    edgehog_telemetry_entry_t *entry = block;
+    memset(entry, 0, sizeof(edgehog_telemetry_entry_t));
     entry->type = type;
     entry->period_seconds = period_seconds;
     entry->enable = enable;
-    k_timer_init(&entry->timer, entry_timer_expiry_fn, NULL);
 
     return entry;
 }
 
+void telemetry_entry_free(edgehog_telemetry_entry_t *entry)
+{
+    if (entry) {
+        k_mem_slab_free(&telemetry_entry_slab, entry);
+    }
+}
+
 edgehog_result_t telemetry_entries_load_from_settings(edgehog_telemetry_entry_t **entries)
 {
     return edgehog_settings_load(SETTINGS_TELEMETRY_KEY, settings_entry_loader, (void *) entries);
@@ -212,7 +216,7 @@ void telemetry_entry_remove(edgehog_telemetry_type_t type, edgehog_telemetry_ent
     }
 
     edgehog_telemetry_entry_t *entry = entries[index];
-    free(entry);
+    telemetry_entry_free(entry);
     entries[index] = NULL;
 }
 
@@ -239,7 +243,7 @@ void telemetry_entry_set(edgehog_telemetry_entry_t *new_entry, edgehog_telemetry
     }
 
     edgehog_telemetry_entry_t *current_entry = entries[entry_idx];
-    free(current_entry);
+    telemetry_entry_free(current_entry);
     entries[entry_idx] = new_entry;
 }
 
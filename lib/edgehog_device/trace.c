@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "trace.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_TRACE
+
+#include <zephyr/sys/atomic.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief One recorded trace point. */
+typedef struct
+{
+    /** @brief Cycle counter value at the time of the record. */
+    uint32_t cycles;
+    /** @brief The recorded trace point. */
+    uint32_t point;
+} trace_entry_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static trace_entry_t trace_buffer[CONFIG_EDGEHOG_DEVICE_TRACE_BUFFER_DEPTH];
+// Monotonic write index, the slot is the index modulo the buffer depth
+static atomic_t trace_write_idx;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void edgehog_trace_record(edgehog_trace_point_t point)
+{
+    // Claiming the slot with a single atomic increment keeps the recorder down to a couple of
+    // stores. Concurrent writers that lap the buffer can tear an entry, which a trace reader
+    // can tolerate.
+    uint32_t idx = (uint32_t) atomic_inc(&trace_write_idx);
+    trace_entry_t *entry = &trace_buffer[idx % ARRAY_SIZE(trace_buffer)];
+    entry->cycles = k_cycle_get_32();
+    entry->point = (uint32_t) point;
+}
+
+void edgehog_trace_read(edgehog_trace_read_cbk_t cbk, void *user_data)
+{
+    uint32_t total = (uint32_t) atomic_get(&trace_write_idx);
+    uint32_t depth = ARRAY_SIZE(trace_buffer);
+    uint32_t count = MIN(total, depth);
+    uint32_t first = total - count;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const trace_entry_t *entry = &trace_buffer[(first + i) % depth];
+        cbk(entry->cycles, (edgehog_trace_point_t) entry->point, user_data);
+    }
+}
+
+const char *edgehog_trace_point_name(edgehog_trace_point_t point)
+{
+    switch (point) {
+        case EDGEHOG_TRACE_HTTP_DNS_RESOLVED:
+            return "http-dns-resolved";
+        case EDGEHOG_TRACE_HTTP_SOCKET_CONNECTED:
+            return "http-socket-connected";
+        case EDGEHOG_TRACE_HTTP_REQUEST_START:
+            return "http-request-start";
+        case EDGEHOG_TRACE_HTTP_FIRST_BYTE:
+            return "http-first-byte";
+        case EDGEHOG_TRACE_OTA_ERASE:
+            return "ota-erase";
+        case EDGEHOG_TRACE_OTA_FLASH_WRITE:
+            return "ota-flash-write";
+        case EDGEHOG_TRACE_OTA_DECOMPRESS:
+            return "ota-decompress";
+        case EDGEHOG_TRACE_FT_CHUNK:
+            return "ft-chunk";
+        case EDGEHOG_TRACE_FT_DIGEST_UPDATE:
+            return "ft-digest-update";
+        default:
+            return "unknown";
+    }
+}
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+#ifdef CONFIG_SHELL
+
+static void shell_print_entry_cbk(uint32_t cycles, edgehog_trace_point_t point, void *user_data)
+{
+    const struct shell *shell = (const struct shell *) user_data;
+    shell_print(
+        shell, "%10u us  %s", k_cyc_to_us_near32(cycles), edgehog_trace_point_name(point));
+}
+
+static int cmd_trace_dump(const struct shell *shell, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    edgehog_trace_read(shell_print_entry_cbk, (void *) shell);
+    return 0;
+}
+
+SHELL_CMD_REGISTER(edgehog_trace, NULL, "Dump the Edgehog SDK trace buffer", cmd_trace_dump);
+
+#endif // CONFIG_SHELL
+
+#endif // CONFIG_EDGEHOG_DEVICE_TRACE
@@ -14,8 +14,12 @@
 #include <astarte_device_sdk/device.h>
 
 #include "edgehog_private.h"
+#include "event_loop.h"
 #include "generated_interfaces.h"
+#include "publish_scratch.h"
+#include "sdk_metrics.h"
 #include "system_time.h"
+#include "telemetry_delta.h"
 
 #include "log.h"
 EDGEHOG_LOG_MODULE_REGISTER(wifi_scan, CONFIG_EDGEHOG_DEVICE_WIFI_SCAN_LOG_LEVEL);
@@ -24,18 +28,23 @@ EDGEHOG_LOG_MODULE_REGISTER(wifi_scan, CONFIG_EDGEHOG_DEVICE_WIFI_SCAN_LOG_LEVEL
 
 #define WIFI_SCAN_ACTIVE_TIME_MS 120
 
-#define WIFI_SCAN_THREAD_STACK_SIZE 16384
-#define WIFI_SCAN_THREAD_PRIORITY 5
-#define WIFI_SCAN_THREAD_START_BIT (1)
-#define WIFI_SCAN_THREAD_STOP_BIT (2)
-#define WIFI_SCAN_THREAD_KILL_BIT (3)
-#define WIFI_SCAN_MSGQ_GET_TIMEOUT_MS 100
+#define WIFI_SCAN_RUNNING_BIT (1)
+
+// In single-thread mode the scan work items run on the shared SDK event loop instead of the
+// system workqueue, like the other SDK services
+#ifdef CONFIG_EDGEHOG_DEVICE_SINGLE_THREAD
+#define WIFI_SCAN_WORK_SUBMIT(work) k_work_submit_to_queue(edgehog_event_loop_get(), (work))
+#define WIFI_SCAN_WORK_SCHEDULE(dwork, delay)                                                      \
+    k_work_schedule_for_queue(edgehog_event_loop_get(), (dwork), (delay))
+#else
+#define WIFI_SCAN_WORK_SUBMIT(work) k_work_submit(work)
+#define WIFI_SCAN_WORK_SCHEDULE(dwork, delay) k_work_schedule((dwork), (delay))
+#endif
 
 #define WIFI_SCAN_TIMEOUT_S 10
 
-// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
-K_THREAD_STACK_DEFINE(wifi_scan_stack_area, WIFI_SCAN_THREAD_STACK_SIZE);
-// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+// Number of entries in a WiFi scan result object payload
+#define WIFI_SCAN_OBJECT_ENTRIES 5
 
 /************************************************
  *         Static functions declarations        *
@@ -108,36 +117,29 @@ static void wifi_mgmt_scan_event_handler(
     }
 }
 
-static void scan_timeout_handler(struct k_timer *timer)
+static void scan_timeout_work_handler(struct k_work *work)
 {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct wifi_scan *wifi_scan_data = CONTAINER_OF(dwork, struct wifi_scan, timeout_work);
+
     EDGEHOG_LOG_WRN("WiFi scan timed out. Forcing completion.");
-    struct wifi_scan *wifi_scan_data = (struct wifi_scan *) k_timer_user_data_get(timer);
     net_mgmt_del_event_callback(&wifi_scan_data->wifi_scan_cb);
-    atomic_set_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_STOP_BIT);
+    WIFI_SCAN_WORK_SUBMIT(&wifi_scan_data->transmit_work);
 }
 
-static void wifi_scan_thread_entry_point(void *device_ptr, void *queue_ptr, void *unused)
+static void transmit_work_handler(struct k_work *work)
 {
-    ARG_UNUSED(unused);
-    EDGEHOG_LOG_DBG("WiFi scan thread started");
-
-    edgehog_device_handle_t device = (edgehog_device_handle_t) device_ptr;
-    struct wifi_scan *wifi_scan_data = &device->wifi_scan_data;
-    struct k_msgq *msgq = (struct k_msgq *) queue_ptr;
+    struct wifi_scan *wifi_scan_data = CONTAINER_OF(work, struct wifi_scan, transmit_work);
+    edgehog_device_handle_t device
+        = CONTAINER_OF(wifi_scan_data, struct edgehog_device, wifi_scan_data);
     struct wifi_scan_result_data data = { 0 };
 
-    while ((!atomic_test_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_STOP_BIT)
-               || (k_msgq_num_used_get(msgq) > 0))
-        && (!atomic_test_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_KILL_BIT))) {
-        if (k_msgq_get(msgq, &data, K_MSEC(WIFI_SCAN_MSGQ_GET_TIMEOUT_MS)) == 0) {
-            transmit_wifi_scan_result(data, device->astarte_device);
-        }
+    // Scan window closed, transmit the buffered results as a single back-to-back burst
+    while (k_msgq_get(&wifi_scan_data->msgq, &data, K_NO_WAIT) == 0) {
+        transmit_wifi_scan_result(data, device->astarte_device);
     }
 
-    EDGEHOG_LOG_DBG("WiFi scan thread terminated");
-    atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_STOP_BIT);
-    atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_KILL_BIT);
-    atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_START_BIT);
+    atomic_clear_bit(&wifi_scan_data->scan_state, WIFI_SCAN_RUNNING_BIT);
 }
 
 /************************************************
@@ -155,12 +157,10 @@ edgehog_result_t edgehog_wifi_scan_init(edgehog_device_handle_t edgehog_device)
     k_msgq_init(&wifi_scan_data->msgq, wifi_scan_data->msgq_buffer,
         sizeof(struct wifi_scan_result_data), WIFI_SCAN_MAX_SCAN_RESULT);
 
-    k_timer_init(&wifi_scan_data->timeout_timer, scan_timeout_handler, NULL);
-    k_timer_user_data_set(&wifi_scan_data->timeout_timer, wifi_scan_data);
+    k_work_init(&wifi_scan_data->transmit_work, transmit_work_handler);
+    k_work_init_delayable(&wifi_scan_data->timeout_work, scan_timeout_work_handler);
 
-    atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_START_BIT);
-    atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_STOP_BIT);
-    atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_KILL_BIT);
+    atomic_clear_bit(&wifi_scan_data->scan_state, WIFI_SCAN_RUNNING_BIT);
 
     return EDGEHOG_RESULT_OK;
 }
@@ -168,19 +168,19 @@ edgehog_result_t edgehog_wifi_scan_init(edgehog_device_handle_t edgehog_device)
 edgehog_result_t edgehog_wifi_scan_destroy(
     edgehog_device_handle_t edgehog_device, k_timeout_t timeout)
 {
+    ARG_UNUSED(timeout);
+
     EDGEHOG_LOG_DBG("Destroying WiFi scan driver");
     struct wifi_scan *wifi_scan_data = &edgehog_device->wifi_scan_data;
-    atomic_set_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_KILL_BIT);
-
-    int res = k_thread_join(&wifi_scan_data->thread, timeout);
-    switch (res) {
-        case 0:
-            return EDGEHOG_RESULT_OK;
-        case -EAGAIN:
-            return EDGEHOG_RESULT_TELEMETRY_STOP_TIMEOUT;
-        default:
-            return EDGEHOG_RESULT_INTERNAL_ERROR;
-    }
+    struct k_work_sync work_sync = { 0 };
+
+    net_mgmt_del_event_callback(&wifi_scan_data->wifi_scan_cb);
+    k_work_cancel_delayable_sync(&wifi_scan_data->timeout_work, &work_sync);
+    k_work_cancel_sync(&wifi_scan_data->transmit_work, &work_sync);
+    k_msgq_purge(&wifi_scan_data->msgq);
+    atomic_clear_bit(&wifi_scan_data->scan_state, WIFI_SCAN_RUNNING_BIT);
+
+    return EDGEHOG_RESULT_OK;
 }
 
 edgehog_result_t edgehog_wifi_scan_start(edgehog_device_handle_t edgehog_device)
@@ -188,7 +188,7 @@ edgehog_result_t edgehog_wifi_scan_start(edgehog_device_handle_t edgehog_device)
     EDGEHOG_LOG_DBG("Starting a new WiFi scan");
     struct wifi_scan *wifi_scan_data = &edgehog_device->wifi_scan_data;
 
-    if (atomic_test_and_set_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_START_BIT)) {
+    if (atomic_test_and_set_bit(&wifi_scan_data->scan_state, WIFI_SCAN_RUNNING_BIT)) {
         EDGEHOG_LOG_ERR("Failed starting wifi scan as one is already been executed");
         return EDGEHOG_RESULT_WIFI_SCAN_REQUEST_FAIL;
     }
@@ -196,7 +196,7 @@ edgehog_result_t edgehog_wifi_scan_start(edgehog_device_handle_t edgehog_device)
     struct net_if *iface = net_if_get_wifi_sta();
     if (!iface) {
         EDGEHOG_LOG_ERR("Failed getting interface for the WiFi station");
-        atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_START_BIT);
+        atomic_clear_bit(&wifi_scan_data->scan_state, WIFI_SCAN_RUNNING_BIT);
         return EDGEHOG_RESULT_WIFI_SCAN_REQUEST_FAIL;
     }
 
@@ -210,27 +210,12 @@ edgehog_result_t edgehog_wifi_scan_start(edgehog_device_handle_t edgehog_device)
     };
     if (net_mgmt(NET_REQUEST_WIFI_SCAN, iface, &params, sizeof(params))) {
         EDGEHOG_LOG_ERR("WiFi Scan request failed");
-        atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_START_BIT);
+        net_mgmt_del_event_callback(&wifi_scan_data->wifi_scan_cb);
+        atomic_clear_bit(&wifi_scan_data->scan_state, WIFI_SCAN_RUNNING_BIT);
         return EDGEHOG_RESULT_WIFI_SCAN_REQUEST_FAIL;
     }
 
-    k_tid_t thread_id = k_thread_create(&wifi_scan_data->thread, wifi_scan_stack_area,
-        WIFI_SCAN_THREAD_STACK_SIZE, wifi_scan_thread_entry_point, (void *) edgehog_device,
-        (void *) &wifi_scan_data->msgq, NULL, WIFI_SCAN_THREAD_PRIORITY, 0, K_NO_WAIT);
-    if (!thread_id) {
-        EDGEHOG_LOG_ERR("Unable to start wifi scan thread");
-        atomic_clear_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_START_BIT);
-        return EDGEHOG_RESULT_WIFI_SCAN_REQUEST_FAIL;
-    }
-
-#ifdef CONFIG_THREAD_NAME
-    int ret = k_thread_name_set(thread_id, "edgehog_wifi_scan_thread");
-    if (ret != 0) {
-        EDGEHOG_LOG_ERR("Failed to set thread name, error %d", ret);
-    }
-#endif
-
-    k_timer_start(&wifi_scan_data->timeout_timer, K_SECONDS(WIFI_SCAN_TIMEOUT_S), K_NO_WAIT);
+    WIFI_SCAN_WORK_SCHEDULE(&wifi_scan_data->timeout_work, K_SECONDS(WIFI_SCAN_TIMEOUT_S));
 
     EDGEHOG_LOG_DBG("WiFi scan started");
     return EDGEHOG_RESULT_OK;
@@ -253,8 +238,8 @@ static void handle_wifi_scan_done(edgehog_device_handle_t edgehog_device)
     }
 
     net_mgmt_del_event_callback(cb);
-    k_timer_stop(&wifi_scan_data->timeout_timer);
-    atomic_set_bit(&wifi_scan_data->thread_state, WIFI_SCAN_THREAD_STOP_BIT);
+    k_work_cancel_delayable(&wifi_scan_data->timeout_work);
+    WIFI_SCAN_WORK_SUBMIT(&wifi_scan_data->transmit_work);
 }
 
 static const char *mac_to_string(
@@ -294,22 +279,46 @@ static void transmit_wifi_scan_result(
     struct wifi_scan_result_data data, astarte_device_handle_t astarte_device)
 {
     EDGEHOG_LOG_DBG("Streaming scan result");
+    // The scan result struct is zero initialized and its strings are zero padded, hashing it
+    // as a whole is deterministic. An access point whose fields did not move since the last
+    // published scan is skipped. The RSSI is quantized into threshold-wide buckets for the
+    // change detection only, so jitter below the threshold does not retrigger a publish while
+    // the transmitted value stays exact.
+    struct wifi_scan_result_data delta_copy = data;
+#if defined(CONFIG_EDGEHOG_DEVICE_WIFI_SCAN_RSSI_THRESHOLD_DB)                                     \
+    && (CONFIG_EDGEHOG_DEVICE_WIFI_SCAN_RSSI_THRESHOLD_DB > 0)
+    delta_copy.rssi = (int8_t) (data.rssi / CONFIG_EDGEHOG_DEVICE_WIFI_SCAN_RSSI_THRESHOLD_DB);
+#endif
+    if (!telemetry_delta_should_publish(data.mac_addr, &delta_copy, sizeof(delta_copy))) {
+        return;
+    }
+
     int64_t timestamp_ms = 0;
     system_time_current_ms(&timestamp_ms);
 
-    astarte_object_entry_t object_entries[] = {
-        { .path = "channel", .data = astarte_data_from_integer(data.channel) },
-        { .path = "essid", .data = astarte_data_from_string(data.essid) },
-        { .path = "macAddress", .data = astarte_data_from_string(data.mac_addr) },
-        { .path = "rssi", .data = astarte_data_from_integer(data.rssi) },
-        { .path = "connected", .data = astarte_data_from_boolean(data.connected) },
-    };
+    astarte_object_entry_t *object_entries
+        = publish_scratch_acquire(WIFI_SCAN_OBJECT_ENTRIES * sizeof(astarte_object_entry_t));
+    if (!object_entries) {
+        return;
+    }
+    object_entries[0] = (astarte_object_entry_t) { .path = "channel",
+        .data = astarte_data_from_integer(data.channel) };
+    object_entries[1] = (astarte_object_entry_t) { .path = "essid",
+        .data = astarte_data_from_string(data.essid) };
+    object_entries[2] = (astarte_object_entry_t) { .path = "macAddress",
+        .data = astarte_data_from_string(data.mac_addr) };
+    object_entries[3]
+        = (astarte_object_entry_t) { .path = "rssi", .data = astarte_data_from_integer(data.rssi) };
+    object_entries[4] = (astarte_object_entry_t) { .path = "connected",
+        .data = astarte_data_from_boolean(data.connected) };
 
     astarte_result_t res
         = astarte_device_send_object(astarte_device, io_edgehog_devicemanager_WiFiScanResults.name,
-            "/ap", object_entries, ARRAY_SIZE(object_entries), &timestamp_ms);
+            "/ap", object_entries, WIFI_SCAN_OBJECT_ENTRIES, &timestamp_ms);
+    publish_scratch_release();
     if (res != ASTARTE_RESULT_OK) {
         EDGEHOG_LOG_ERR("Unable to send WiFiScanResults");
+        telemetry_delta_invalidate(data.mac_addr);
     }
 }
 
@@ -342,7 +351,9 @@ static void handle_wifi_scan_result(struct net_if *iface, edgehog_device_handle_
     EDGEHOG_LOG_DBG("%-4u | %-4d | %-17s | %-9d | (%-2u) %s", scan_result.channel, scan_result.rssi,
         scan_result.mac_addr, scan_result.connected, strlen(scan_result.essid), scan_result.essid);
 
-    k_msgq_put(&edgehog_device->wifi_scan_data.msgq, &scan_result, K_NO_WAIT);
+    if (k_msgq_put(&edgehog_device->wifi_scan_data.msgq, &scan_result, K_NO_WAIT) != 0) {
+        sdk_metrics_record_queue_drop();
+    }
 }
 
 #endif
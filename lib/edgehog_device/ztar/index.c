@@ -0,0 +1,214 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ztar/index.h"
+
+#include <zephyr/sys/util.h>
+
+#include <string.h>
+
+#include "log.h"
+
+EDGEHOG_LOG_MODULE_REGISTER(ztar_index, CONFIG_EDGEHOG_DEVICE_ZTAR_LOG_LEVEL);
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Context for the internal find-by-name scan callback. */
+struct index_find_ctx
+{
+    /** @brief Full file name to locate. */
+    const char *file_name;
+    /** @brief Output entry for the located member. */
+    ztar_index_entry_t *entry;
+    /** @brief Set when the member has been found. */
+    bool found;
+};
+
+/************************************************
+ *         Static functions declaration         *
+ ***********************************************/
+
+// Read a single header block at the given offset, checking for truncation.
+static ztar_result_t read_header_block(
+    ztar_seek_read_cbk_t read_cbk, void *read_user_data, size_t offset, ztar_header_t *header);
+// Scan callback matching a member by its full file name.
+static int find_entry_cbk(
+    const ztar_header_t *header, const ztar_index_entry_t *entry, void *user_data);
+
+/************************************************
+ *         Global functions definition          *
+ ***********************************************/
+
+ztar_result_t ztar_index_scan(ztar_seek_read_cbk_t read_cbk, void *read_user_data,
+    ztar_index_entry_cbk_t entry_cbk, void *entry_user_data)
+{
+    if (!read_cbk || !entry_cbk) {
+        EDGEHOG_LOG_ERR("Called ztar_index_scan with null callback pointer");
+        return ZTAR_RESULT_INVALID_ARGS;
+    }
+    EDGEHOG_LOG_DBG("Scanning ztar archive index");
+
+    size_t offset = 0;
+    while (true) {
+        ztar_header_t header;
+        ztar_result_t zres = read_header_block(read_cbk, read_user_data, offset, &header);
+        if (zres != ZTAR_RESULT_OK) {
+            return zres;
+        }
+
+        // An all-zero block marks the start of the archive trailer
+        uint8_t *raw_header = (uint8_t *) &header;
+        if ((raw_header[0] == 0)
+            && (memcmp(raw_header, raw_header + 1, sizeof(ztar_header_t) - 1) == 0)) {
+            return ZTAR_RESULT_OK;
+        }
+
+        zres = ztar_unpack_validate_header(&header);
+        if (zres != ZTAR_RESULT_OK) {
+            return zres;
+        }
+
+        size_t file_size = 0;
+        zres = ztar_unpack_get_file_size(&header, &file_size);
+        if (zres != ZTAR_RESULT_OK) {
+            return zres;
+        }
+
+        ztar_index_entry_t entry = { .header_offset = offset,
+            .data_offset = offset + sizeof(ztar_header_t),
+            .file_size = file_size };
+
+        int cbk_res = entry_cbk(&header, &entry, entry_user_data);
+        if (cbk_res < 0) {
+            EDGEHOG_LOG_ERR("Index entry callback returned error code %d", cbk_res);
+            return ZTAR_RESULT_USER_CBK_ERROR;
+        }
+        if (cbk_res > 0) {
+            return ZTAR_RESULT_OK;
+        }
+
+        // Seek past the file data and its padding to the next header block
+        offset = entry.data_offset + file_size + ZTAR_REQUIRED_FILE_PADDING(file_size);
+    }
+}
+
+ztar_result_t ztar_index_find(ztar_seek_read_cbk_t read_cbk, void *read_user_data,
+    const char *file_name, ztar_index_entry_t *entry)
+{
+    if (!file_name || !entry) {
+        EDGEHOG_LOG_ERR("Called ztar_index_find with null file name or entry pointer");
+        return ZTAR_RESULT_INVALID_ARGS;
+    }
+
+    struct index_find_ctx find_ctx = { .file_name = file_name, .entry = entry, .found = false };
+    ztar_result_t zres = ztar_index_scan(read_cbk, read_user_data, find_entry_cbk, &find_ctx);
+    if (zres != ZTAR_RESULT_OK) {
+        return zres;
+    }
+
+    return find_ctx.found ? ZTAR_RESULT_OK : ZTAR_RESULT_ARCHIVE_EXAHUSTED;
+}
+
+ztar_result_t ztar_index_extract(ztar_seek_read_cbk_t read_cbk, void *read_user_data,
+    const ztar_index_entry_t *entry, ztar_unpack_callbacks_t callbacks, void *cbk_user_data)
+{
+    if (!read_cbk || !entry) {
+        EDGEHOG_LOG_ERR("Called ztar_index_extract with null reader or entry pointer");
+        return ZTAR_RESULT_INVALID_ARGS;
+    }
+    if (!callbacks.on_file_start || !callbacks.on_file_data || !callbacks.on_file_end) {
+        EDGEHOG_LOG_ERR("Missing callback for member extraction");
+        return ZTAR_RESULT_INVALID_ARGS;
+    }
+    EDGEHOG_LOG_DBG("Extracting archive member at offset %zu", entry->header_offset);
+
+    // Re-read and validate the member header, it must outlive the data callbacks
+    ztar_header_t header;
+    ztar_result_t zres
+        = read_header_block(read_cbk, read_user_data, entry->header_offset, &header);
+    if (zres != ZTAR_RESULT_OK) {
+        return zres;
+    }
+    zres = ztar_unpack_validate_header(&header);
+    if (zres != ZTAR_RESULT_OK) {
+        return zres;
+    }
+
+    int cbk_res = callbacks.on_file_start(&header, cbk_user_data);
+    if (cbk_res != 0) {
+        EDGEHOG_LOG_ERR("File start callback returned error code %d", cbk_res);
+        return ZTAR_RESULT_USER_CBK_ERROR;
+    }
+
+    // Stream the member data one block at a time
+    uint8_t block[ZTAR_BLOCK_SIZE];
+    size_t processed = 0;
+    while (processed < entry->file_size) {
+        size_t bytes_to_read = MIN(sizeof(block), entry->file_size - processed);
+        int read_res
+            = read_cbk(entry->data_offset + processed, block, bytes_to_read, read_user_data);
+        if (read_res < 0) {
+            EDGEHOG_LOG_ERR("Reader callback returned error code %d", read_res);
+            return ZTAR_RESULT_USER_CBK_ERROR;
+        }
+        if ((size_t) read_res < bytes_to_read) {
+            return ZTAR_RESULT_TRUNCATED_FILE;
+        }
+
+        cbk_res = callbacks.on_file_data(&header, block, bytes_to_read, cbk_user_data);
+        if (cbk_res != 0) {
+            EDGEHOG_LOG_ERR("File data callback returned error code %d", cbk_res);
+            return ZTAR_RESULT_USER_CBK_ERROR;
+        }
+        processed += bytes_to_read;
+    }
+
+    cbk_res = callbacks.on_file_end(&header, cbk_user_data);
+    if (cbk_res != 0) {
+        EDGEHOG_LOG_ERR("File end callback returned error code %d", cbk_res);
+        return ZTAR_RESULT_USER_CBK_ERROR;
+    }
+
+    return ZTAR_RESULT_OK;
+}
+
+/************************************************
+ *         Static functions definition          *
+ ***********************************************/
+
+static ztar_result_t read_header_block(
+    ztar_seek_read_cbk_t read_cbk, void *read_user_data, size_t offset, ztar_header_t *header)
+{
+    int read_res = read_cbk(offset, (uint8_t *) header, sizeof(ztar_header_t), read_user_data);
+    if (read_res < 0) {
+        EDGEHOG_LOG_ERR("Reader callback returned error code %d", read_res);
+        return ZTAR_RESULT_USER_CBK_ERROR;
+    }
+    if ((size_t) read_res < sizeof(ztar_header_t)) {
+        return ZTAR_RESULT_TRUNCATED_ARCHIVE;
+    }
+    return ZTAR_RESULT_OK;
+}
+
+static int find_entry_cbk(
+    const ztar_header_t *header, const ztar_index_entry_t *entry, void *user_data)
+{
+    struct index_find_ctx *find_ctx = (struct index_find_ctx *) user_data;
+
+    char file_name[ZTAR_FILE_NAME_BUFF_SIZE] = { 0 };
+    if (ztar_unpack_get_file_name(header, file_name) != ZTAR_RESULT_OK) {
+        return -1;
+    }
+
+    if (strcmp(file_name, find_ctx->file_name) == 0) {
+        *find_ctx->entry = *entry;
+        find_ctx->found = true;
+        return 1;
+    }
+    return 0;
+}
@@ -8,9 +8,7 @@
 
 #include <zephyr/sys/util.h>
 
-#include <inttypes.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -24,10 +22,11 @@ EDGEHOG_LOG_MODULE_REGISTER(ztar_pack, CONFIG_EDGEHOG_DEVICE_ZTAR_LOG_LEVEL);
 
 // Default mode we will set for all the produced tar
 #define FILE_MODE_DEFAULT 0644
-// Checksum first termination (NULL)
-#define CHKSUM_TERMINATOR_NULL_IDX 6
 // Checksum second termination (space)
 #define CHKSUM_TERMINATOR_SPACE_IDX 7
+// Bits and mask of one octal digit, used by the table-driven octal emit
+#define OCTAL_DIGIT_BITS 3
+#define OCTAL_DIGIT_MASK 0x7U
 
 /************************************************
  *         Static functions declaration         *
@@ -232,17 +231,12 @@ static ztar_result_t pack_handle_header(
     header.typeflag = '0'; // Regular file, no directory support
     memset(header.chksum, ' ', sizeof(header.chksum));
 
-    uint32_t chksum = 0;
-    uint8_t *raw_header = (uint8_t *) &header;
-    for (size_t i = 0; i < sizeof(ztar_header_t); i++) {
-        chksum += raw_header[i];
-    }
+    uint32_t chksum = ztar_header_block_sum(&header);
 
-    int ret = snprintf(header.chksum, sizeof(header.chksum), "%06o", chksum);
-    if (ret < 0) {
+    // Emit the 6 octal digits plus NULL, then overwrite the trailing space terminator
+    if (pack_format_octal(chksum, header.chksum, CHKSUM_TERMINATOR_SPACE_IDX) < 0) {
         return ZTAR_RESULT_INTERNAL_ERROR;
     }
-    header.chksum[CHKSUM_TERMINATOR_NULL_IDX] = '\0';
     header.chksum[CHKSUM_TERMINATOR_SPACE_IDX] = ' ';
 
     memcpy(out, &header, sizeof(ztar_header_t));
@@ -327,15 +321,22 @@ static ztar_result_t pack_handle_trailer(
 
 static int pack_format_octal(uint64_t value, char *out, size_t out_size)
 {
+    static const char octal_digits[] = "01234567";
+
     if (!out || out_size == 0) {
         return -1;
     }
 
-    // This will produce a zero-padded octal string.
-    // %0* : Pad with zeros '0', width provided by the first argument '*'
-    // PRIo64 : Cross-platform macro for formatting uint64_t as octal
-    int written = snprintf(out, out_size, "%0*" PRIo64, (int) (out_size - 1), value);
-    if (written < 0 || (size_t) written >= out_size) {
+    // Zero-padded octal string emitted right-to-left from a digit table. Every member header
+    // formats six of these fields, so the snprintf machinery is deliberately kept off this path.
+    memset(out, '0', out_size - 1);
+    out[out_size - 1] = '\0';
+    for (size_t i = out_size - 1; (i > 0) && (value > 0); i--) {
+        out[i - 1] = octal_digits[value & OCTAL_DIGIT_MASK];
+        value >>= OCTAL_DIGIT_BITS;
+    }
+    if (value > 0) {
+        // The value does not fit the field width
         return -1;
     }
     return 0;
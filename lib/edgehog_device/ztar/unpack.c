@@ -137,6 +137,11 @@ ztar_result_t ztar_unpack_process(ztar_unpack_t *stream, const uint8_t *data, si
     return ZTAR_RESULT_OK;
 }
 
+ztar_result_t ztar_unpack_validate_header(const ztar_header_t *header)
+{
+    return validate_header(header);
+}
+
 ztar_result_t ztar_unpack_get_file_name(
     const ztar_header_t *header, char buffer[static ZTAR_FILE_NAME_BUFF_SIZE])
 {
@@ -237,6 +242,12 @@ static ztar_result_t stream_process_header(
             if (zres != ZTAR_RESULT_OK) {
                 return zres;
             }
+
+            // Cache the file size so the per-chunk data path doesn't re-parse the octal field
+            zres = ztar_unpack_get_file_size(&stream->current_header, &stream->current_file_size);
+            if (zres != ZTAR_RESULT_OK) {
+                return zres;
+            }
             stream->bytes_processed_in_file = 0;
             stream->state = ZTAR_UNPACK_STATE_DATA;
 
@@ -260,13 +271,7 @@ static ztar_result_t stream_process_header(
 static ztar_result_t stream_process_data(
     ztar_unpack_t *stream, const uint8_t *data, size_t size, size_t *bytes_consumed)
 {
-    ztar_result_t zres = ZTAR_RESULT_OK;
-
-    size_t file_size = 0;
-    zres = ztar_unpack_get_file_size(&stream->current_header, &file_size);
-    if (zres != ZTAR_RESULT_OK) {
-        return zres;
-    }
+    size_t file_size = stream->current_file_size;
 
     // Calculate how many bytes we still need to complete the file and parse as much as we can
     size_t file_bytes_needed = file_size - stream->bytes_processed_in_file;
@@ -313,13 +318,7 @@ static ztar_result_t stream_process_data(
 static ztar_result_t stream_process_padding(
     ztar_unpack_t *stream, const uint8_t *data, size_t size, size_t *bytes_consumed)
 {
-    ztar_result_t zres = ZTAR_RESULT_OK;
-
-    size_t file_size = 0;
-    zres = ztar_unpack_get_file_size(&stream->current_header, &file_size);
-    if (zres != ZTAR_RESULT_OK) {
-        return zres;
-    }
+    size_t file_size = stream->current_file_size;
 
     // Calculate how many bytes we still need to complete the padding and parse as much as we can
     size_t required_padding = ZTAR_REQUIRED_FILE_PADDING(file_size);
@@ -397,12 +396,8 @@ static ztar_result_t validate_header(const ztar_header_t *header)
         return zres;
     }
 
-    // Calculate the sum of all bytes in the header block (512 bytes)
-    uint32_t expected_chksum = 0;
-    uint8_t *raw_header = (uint8_t *) header;
-    for (size_t i = 0; i < sizeof(ztar_header_t); i++) {
-        expected_chksum += raw_header[i];
-    }
+    // Calculate the sum of all bytes in the header block (512 bytes) with the word-wise kernel
+    uint32_t expected_chksum = ztar_header_block_sum(header);
 
     // Subtract the actual bytes in the chksum field and replace them with spaces (' ')
     for (size_t i = 0; i < sizeof(header->chksum); i++) {
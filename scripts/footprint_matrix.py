@@ -0,0 +1,174 @@
+# (C) Copyright 2026, SECO Mind Srl
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Report the per-feature ROM/RAM footprint matrix of the Edgehog device library.
+
+The library is sized by building an application once as configured (the baseline) and once per
+optional feature with that feature toggled. The difference between the two builds is the cost
+of the feature: what disabling it saves on a constrained SKU, or what enabling it adds. The
+matrix covers the features the ``Kconfig``/``CMakeLists.txt`` structure can actually toggle:
+
+    file_transfer, file_transfer_tar, file_transfer_compression, ota_delta, ota_compression,
+    battery_status, telemetry_burst, telemetry_delta, sdk_metrics, trace, zbus_ota_event,
+    zbus_sdk_events, wifi_scan (via ``CONFIG_WIFI``)
+
+The LED service is compiled unconditionally and cannot be attributed this way. Whether a
+feature is measured by disabling or enabling it is decided from the baseline build ``.config``,
+so the matrix adapts to whatever the application under measurement selects. Features whose
+dependencies are not met by the baseline (e.g. tar without file transfer) are skipped.
+
+ROM/RAM figures are the FLASH and RAM used sizes from the linker memory usage report, so they
+include pulled-in Zephyr and third party code (LZ4, zbus, ...), which is the number that has
+to fit the SKU.
+
+Usage:
+    python footprint_matrix.py --board <board> [--app samples/edgehog_app] [--csv]
+
+Each feature build lands in its own build directory under --build-root (default
+``build_footprint``) so a rerun only rebuilds what changed.
+"""
+
+import argparse
+import csv
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+# An entry is (feature name, option toggled, options the baseline must have for the toggle to
+# be meaningful, extra options to pass alongside when enabling).
+FEATURES = [
+    ("file_transfer", "CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER", [], []),
+    (
+        "file_transfer_tar",
+        "CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_TAR",
+        ["CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER"],
+        [],
+    ),
+    (
+        "file_transfer_compression",
+        "CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION",
+        ["CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER"],
+        ["CONFIG_LZ4=y"],
+    ),
+    ("ota_delta", "CONFIG_EDGEHOG_DEVICE_OTA_DELTA", [], []),
+    ("ota_compression", "CONFIG_EDGEHOG_DEVICE_OTA_COMPRESSION", [], ["CONFIG_LZ4=y"]),
+    ("battery_status", "CONFIG_EDGEHOG_DEVICE_BATTERY_STATUS", [], []),
+    ("telemetry_burst", "CONFIG_EDGEHOG_DEVICE_TELEMETRY_BURST", [], []),
+    ("telemetry_delta", "CONFIG_EDGEHOG_DEVICE_TELEMETRY_DELTA", [], []),
+    ("sdk_metrics", "CONFIG_EDGEHOG_DEVICE_SDK_METRICS", [], []),
+    ("trace", "CONFIG_EDGEHOG_DEVICE_TRACE", [], []),
+    ("zbus_ota_event", "CONFIG_EDGEHOG_DEVICE_ZBUS_OTA_EVENT", [], ["CONFIG_ZBUS=y"]),
+    ("zbus_sdk_events", "CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS", [], ["CONFIG_ZBUS=y"]),
+    ("wifi_scan", "CONFIG_WIFI", [], []),
+]
+
+# Linker memory usage report line, e.g. "FLASH:      215096 B         1 MB     20.51%"
+MEMORY_LINE = re.compile(r"^\s*(\w+):\s+(\d+)\s+(B|KB|MB)\b", re.MULTILINE)
+
+UNIT_BYTES = {"B": 1, "KB": 1024, "MB": 1024 * 1024}
+
+
+def west_build(app, board, build_dir, extra_configs):
+    """Build the application and return the captured build output."""
+    cmd = ["west", "build", "-p", "auto", "-b", board, "-d", str(build_dir), str(app)]
+    if extra_configs:
+        cmd.append("--")
+        cmd.extend(f"-D{config}" for config in extra_configs)
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        sys.stderr.write(result.stderr)
+        raise RuntimeError(f"build failed in {build_dir}")
+    return result.stdout + result.stderr
+
+
+def parse_memory_usage(build_output):
+    """Return {region: used bytes} from the linker memory usage report."""
+    regions = {}
+    for match in MEMORY_LINE.finditer(build_output):
+        region, used, unit = match.groups()
+        regions[region.upper()] = int(used) * UNIT_BYTES[unit]
+    if "FLASH" not in regions or "RAM" not in regions:
+        raise RuntimeError("no memory usage report found in build output")
+    return regions
+
+
+def read_config(build_dir):
+    """Return the set of options enabled in the build .config."""
+    config_path = Path(build_dir) / "zephyr" / ".config"
+    enabled = set()
+    for line in config_path.read_text().splitlines():
+        option, _, value = line.partition("=")
+        if value == "y":
+            enabled.add(option)
+    return enabled
+
+
+def measure_feature(app, board, build_root, baseline_config, feature):
+    """Build with the feature toggled, return (memory regions, sign) or None if skipped."""
+    name, option, requires, enable_extras = feature
+    if any(dep not in baseline_config for dep in requires):
+        return None
+
+    if option in baseline_config:
+        # Baseline carries the feature, its cost is what disabling saves
+        configs = [f"{option}=n"]
+        sign = 1
+    else:
+        configs = [f"{option}=y"]
+        configs += [c for c in enable_extras if c.split("=")[0] not in baseline_config]
+        sign = -1
+
+    build_dir = Path(build_root) / name
+    output = west_build(app, board, build_dir, configs)
+    return parse_memory_usage(output), sign
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--app", default="samples/edgehog_app", help="application to measure")
+    parser.add_argument("--board", required=True, help="board to build for")
+    parser.add_argument(
+        "--build-root", default="build_footprint", help="directory holding the per-feature builds"
+    )
+    parser.add_argument("--csv", action="store_true", help="emit the matrix as CSV")
+    args = parser.parse_args()
+
+    baseline_dir = Path(args.build_root) / "baseline"
+    baseline = parse_memory_usage(west_build(args.app, args.board, baseline_dir, []))
+    baseline_config = read_config(baseline_dir)
+
+    rows = []
+    for feature in FEATURES:
+        measured = measure_feature(args.app, args.board, args.build_root, baseline_config, feature)
+        if measured is None:
+            print(f"skipping {feature[0]}: baseline does not meet its dependencies",
+                file=sys.stderr)
+            continue
+        toggled, sign = measured
+        rom = sign * (baseline["FLASH"] - toggled["FLASH"])
+        ram = sign * (baseline["RAM"] - toggled["RAM"])
+        state = "on" if sign == 1 else "off"
+        rows.append((feature[0], state, rom, ram))
+
+    if args.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(["feature", "baseline", "rom_bytes", "ram_bytes"])
+        for row in rows:
+            writer.writerow(row)
+        writer.writerow(["total_baseline", "", baseline["FLASH"], baseline["RAM"]])
+        return 0
+
+    print(f"baseline: {baseline['FLASH']} B ROM, {baseline['RAM']} B RAM\n")
+    print(f"{'feature':<26}  {'baseline':>8}  {'ROM':>8}  {'RAM':>8}")
+    for name, state, rom, ram in rows:
+        print(f"{name:<26}  {state:>8}  {rom:>+8}  {ram:>+8}")
+    print("\nA feature's cost is what disabling it saves (baseline on) or what enabling it")
+    print("adds (baseline off), including everything it pulls in from Zephyr and third party.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+# (C) Copyright 2026, SECO Mind Srl
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Report the footprint and placement of the generated Astarte interface descriptors.
+
+All interface descriptors and their mapping arrays in ``generated_interfaces.c`` are fully
+``const`` and expected to be linker-placed in flash, with no RAM copies and no runtime
+initialization. This script inspects a built ``zephyr.elf``, lists every
+``io_edgehog_devicemanager*`` descriptor symbol with its size and section class, prints the
+total flash footprint, and fails when any descriptor regressed into a RAM backed section.
+
+The report covers the descriptor structs and mapping arrays. The interface name and endpoint
+string literals are pooled into ``.rodata`` by the compiler and cannot be attributed to a
+symbol, so they are not included in the total.
+
+Usage:
+    python interface_footprint.py [--nm NM] path/to/zephyr.elf
+
+Use ``--nm`` to point at the cross toolchain nm, e.g. ``arm-zephyr-eabi-nm``.
+"""
+
+import argparse
+import subprocess
+import sys
+
+# nm symbol type letters for read-only (flash resident) and RAM backed sections
+FLASH_CLASSES = frozenset("rRtT")
+RAM_CLASSES = frozenset("dDbB")
+
+SYMBOL_PREFIX = "io_edgehog_devicemanager"
+
+
+def collect_symbols(nm, elf):
+    """Return (name, size, type letter) for every interface descriptor symbol in the ELF."""
+    output = subprocess.check_output([nm, "--print-size", elf], text=True)
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        # Lines without a size field carry only address, type and name
+        if len(fields) != 4:
+            continue
+        _, size, sym_type, name = fields
+        if name.startswith(SYMBOL_PREFIX):
+            symbols.append((name, int(size, 16), sym_type))
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="path to the built zephyr.elf")
+    parser.add_argument("--nm", default="nm", help="nm binary of the target toolchain")
+    args = parser.parse_args()
+
+    symbols = collect_symbols(args.nm, args.elf)
+    if not symbols:
+        print(f"error: no {SYMBOL_PREFIX}* symbols found in {args.elf}", file=sys.stderr)
+        return 1
+
+    flash_total = 0
+    misplaced = []
+    name_width = max(len(name) for name, _, _ in symbols)
+    print(f"{'symbol':<{name_width}}  {'size':>6}  class")
+    for name, size, sym_type in sorted(symbols):
+        print(f"{name:<{name_width}}  {size:>6}  {sym_type}")
+        if sym_type in FLASH_CLASSES:
+            flash_total += size
+        elif sym_type in RAM_CLASSES:
+            misplaced.append((name, size, sym_type))
+
+    print(f"\ninterface descriptors in flash: {flash_total} bytes ({len(symbols)} symbols)")
+
+    if misplaced:
+        print("\nerror: descriptors placed in RAM backed sections:", file=sys.stderr)
+        for name, size, sym_type in misplaced:
+            print(f"  {name} ({size} bytes, class {sym_type})", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
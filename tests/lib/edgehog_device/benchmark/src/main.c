@@ -0,0 +1,416 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/benchmark/src/main.c
+ *
+ * @details Benchmark harness for the file transfer service. It spins up a local HTTP server on
+ * the loopback interface serving synthetic payloads, then drives the server-to-device and
+ * device-to-server handlers directly, bypassing Astarte. For each scenario it reports the
+ * throughput in bytes per second, the per-thread CPU cycles (the calling thread accounts for
+ * the HTTP, decompression and unpacking stages, the application thread for the consumer side,
+ * the net threads for the IP stack) and the system heap usage including its peak.
+ *
+ * @note Run on native_sim, no external connectivity is required. Responses and progress events
+ * are not published since no Astarte device is connected, the library logs and carries on.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/mem_stats.h>
+#include <zephyr/sys/uuid.h>
+
+#include <edgehog_device/file_transfer.h>
+
+#include "edgehog_private.h"
+#include "file_transfer/core.h"
+#include "file_transfer/download.h"
+#include "file_transfer/upload.h"
+#include "microbench.h"
+#include "regression.h"
+#include "telemetry_bench.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SERVER_PORT 8080
+#define SERVER_ADDR "127.0.0.1"
+
+/* Synthetic payload sizes for the two scenarios */
+#define DOWNLOAD_PAYLOAD_SIZE (1024 * 1024)
+#define UPLOAD_PAYLOAD_SIZE (1024 * 1024)
+
+/* Pattern block used to generate and feed synthetic payloads */
+#define PATTERN_BLOCK_SIZE 1024
+
+#define THREAD_STACK_SIZE 8192
+#define THREAD_PRIORITY 5
+
+/* The k_malloc heap, queried for the allocation statistics */
+extern struct k_heap _system_heap;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_THREAD_STACK_DEFINE(server_thread_stack, THREAD_STACK_SIZE);
+K_THREAD_STACK_DEFINE(app_thread_stack, THREAD_STACK_SIZE);
+static struct k_thread server_thread;
+static struct k_thread app_thread;
+
+// Stream resources handed over by the transfer start callback
+static struct k_pipe *stream_pipe;
+static struct k_event *stream_event;
+static K_SEM_DEFINE(stream_ready_sem, 0, 1);
+
+// Bytes moved by the application side of the stream, per scenario
+static size_t app_stream_bytes;
+
+// Synthetic data block shared by the server and the upload feeder
+static uint8_t pattern_block[PATTERN_BLOCK_SIZE];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static char *bench_strdup(const char *src)
+{
+    size_t size = strlen(src) + 1;
+    char *dup = k_malloc(size);
+    if (dup) {
+        memcpy(dup, src, size);
+    }
+    return dup;
+}
+
+static void fill_pattern_block(void)
+{
+    // Mildly repetitive content, compressible but not trivial
+    for (size_t i = 0; i < PATTERN_BLOCK_SIZE; i++) {
+        pattern_block[i] = (uint8_t) ((i * 31U) ^ (i >> 3U));
+    }
+}
+
+/************************************************
+ *              Local HTTP server               *
+ ***********************************************/
+
+static int recv_http_headers(int client, char *buf, size_t buf_size, size_t *headers_len)
+{
+    size_t received = 0;
+    while (received < buf_size - 1) {
+        ssize_t res = zsock_recv(client, buf + received, buf_size - 1 - received, 0);
+        if (res <= 0) {
+            return -1;
+        }
+        received += (size_t) res;
+        buf[received] = '\0';
+        char *headers_end = strstr(buf, "\r\n\r\n");
+        if (headers_end) {
+            *headers_len = (size_t) (headers_end + 4 - buf);
+            return (int) received;
+        }
+    }
+    return -1;
+}
+
+static int send_all(int client, const uint8_t *data, size_t size)
+{
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t res = zsock_send(client, data + sent, size - sent, 0);
+        if (res < 0) {
+            return -1;
+        }
+        sent += (size_t) res;
+    }
+    return 0;
+}
+
+static void serve_download(int client)
+{
+    char headers[128] = { 0 };
+    // NOLINTNEXTLINE(cert-err33-c)
+    snprintf(headers, sizeof(headers),
+        "HTTP/1.1 200 OK\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+        DOWNLOAD_PAYLOAD_SIZE);
+    if (send_all(client, (const uint8_t *) headers, strlen(headers)) < 0) {
+        return;
+    }
+
+    size_t remaining = DOWNLOAD_PAYLOAD_SIZE;
+    while (remaining > 0) {
+        size_t block = MIN(remaining, sizeof(pattern_block));
+        if (send_all(client, pattern_block, block) < 0) {
+            return;
+        }
+        remaining -= block;
+    }
+}
+
+static void serve_upload(int client, const char *request, size_t request_len, size_t headers_len)
+{
+    size_t content_length = 0;
+    const char *length_header = strstr(request, "Content-Length:");
+    if (length_header) {
+        content_length = (size_t) strtoul(length_header + strlen("Content-Length:"), NULL, 10);
+    }
+
+    // Drain the request body, part of it may already follow the headers
+    size_t received = request_len - headers_len;
+    uint8_t sink[PATTERN_BLOCK_SIZE];
+    while (received < content_length) {
+        ssize_t res = zsock_recv(client, sink, sizeof(sink), 0);
+        if (res <= 0) {
+            break;
+        }
+        received += (size_t) res;
+    }
+
+    const char *response = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    send_all(client, (const uint8_t *) response, strlen(response));
+}
+
+static void server_thread_entry(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    int serv = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (serv < 0) {
+        printk("Benchmark server: socket creation failed\n");
+        return;
+    }
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(SERVER_PORT) };
+    zsock_inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+    if ((zsock_bind(serv, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+        || (zsock_listen(serv, 2) < 0)) {
+        printk("Benchmark server: bind/listen failed\n");
+        zsock_close(serv);
+        return;
+    }
+
+    while (true) {
+        int client = zsock_accept(serv, NULL, NULL);
+        if (client < 0) {
+            continue;
+        }
+
+        char request[512] = { 0 };
+        size_t headers_len = 0;
+        int request_len = recv_http_headers(client, request, sizeof(request), &headers_len);
+        if (request_len > 0) {
+            if (strncmp(request, "GET", strlen("GET")) == 0) {
+                serve_download(client);
+            } else {
+                serve_upload(client, request, (size_t) request_len, headers_len);
+            }
+        }
+        zsock_close(client);
+    }
+}
+
+/************************************************
+ *        Application side of the stream        *
+ ***********************************************/
+
+static bool on_stream_transfer_start(
+    const char *name, edgehog_ft_type_t type, size_t *expected_size, edgehog_ft_stream_t *stream)
+{
+    ARG_UNUSED(name);
+
+    if (type == EDGEHOG_FT_TYPE_DEVICE_TO_SERVER) {
+        *expected_size = UPLOAD_PAYLOAD_SIZE;
+    }
+
+    stream_pipe = stream->pipe;
+    stream_event = stream->event;
+    k_sem_give(&stream_ready_sem);
+    return true;
+}
+
+// Consumer for server-to-device transfers: drains the stream pipe and counts the bytes
+static void stream_drain_entry(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    k_sem_take(&stream_ready_sem, K_FOREVER);
+
+    uint8_t buf[PATTERN_BLOCK_SIZE];
+    size_t total = 0;
+    while (true) {
+        int ret = k_pipe_read(stream_pipe, buf, sizeof(buf), K_MSEC(10));
+        if (ret > 0) {
+            total += (size_t) ret;
+            continue;
+        }
+        if (k_event_test(stream_event, EDGEHOG_FT_STREAM_EOF_EVENT_FLAG)) {
+            while ((ret = k_pipe_read(stream_pipe, buf, sizeof(buf), K_NO_WAIT)) > 0) {
+                total += (size_t) ret;
+            }
+            k_event_post(stream_event, EDGEHOG_FT_STREAM_ACK_EVENT_FLAG);
+            break;
+        }
+    }
+    app_stream_bytes = total;
+}
+
+// Producer for device-to-server transfers: feeds the synthetic payload into the stream pipe
+static void stream_feed_entry(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    k_sem_take(&stream_ready_sem, K_FOREVER);
+
+    size_t total = 0;
+    while (total < UPLOAD_PAYLOAD_SIZE) {
+        size_t block = MIN((size_t) UPLOAD_PAYLOAD_SIZE - total, sizeof(pattern_block));
+        int ret = k_pipe_write(stream_pipe, pattern_block, block, K_MSEC(100));
+        if (ret > 0) {
+            total += (size_t) ret;
+        }
+    }
+    k_event_post(stream_event, EDGEHOG_FT_STREAM_EOF_EVENT_FLAG);
+    app_stream_bytes = total;
+}
+
+/************************************************
+ *              Metrics reporting               *
+ ***********************************************/
+
+static void print_thread_cpu_cbk(const struct k_thread *thread, void *user_data)
+{
+    ARG_UNUSED(user_data);
+
+    k_thread_runtime_stats_t stats;
+    if (k_thread_runtime_stats_get((k_tid_t) thread, &stats) != 0) {
+        return;
+    }
+
+    const char *name = k_thread_name_get((k_tid_t) thread);
+    printk("  %-24s %llu cycles\n", name ? name : "<unnamed>",
+        (unsigned long long) stats.execution_cycles);
+}
+
+static void print_metrics(const char *label, size_t bytes, int64_t elapsed_ms)
+{
+    int64_t throughput = (elapsed_ms > 0) ? (((int64_t) bytes * 1000) / elapsed_ms) : 0;
+    printk("[%s] %zu bytes in %lld ms, %lld bytes/s\n", label, bytes, elapsed_ms, throughput);
+
+    printk(" Per-thread CPU time:\n");
+    k_thread_foreach(print_thread_cpu_cbk, NULL);
+
+    struct sys_memory_stats heap_stats;
+    if (sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats) == 0) {
+        printk(" Heap: allocated %zu, peak %zu, free %zu bytes\n", heap_stats.allocated_bytes,
+            heap_stats.max_allocated_bytes, heap_stats.free_bytes);
+    }
+}
+
+/************************************************
+ *               Scenario drivers               *
+ ***********************************************/
+
+static edgehog_ft_msg_t build_msg(edgehog_ft_type_t type, const char *url, int64_t file_size)
+{
+    edgehog_ft_msg_t msg = { 0 };
+    (void) uuid_generate_v4(&msg.id);
+    msg.url = bench_strdup(url);
+    msg.encoding = EDGEHOG_FT_ENCODING_NONE;
+    msg.progress = false;
+    msg.location_type = EDGEHOG_FT_LOCATION_TYPE_STREAMING;
+    msg.location = bench_strdup("benchmark-stream");
+    msg.type = type;
+    msg.file_size_bytes = file_size;
+    return msg;
+}
+
+static void run_download_scenario(edgehog_device_handle_t device)
+{
+    app_stream_bytes = 0;
+    k_thread_create(&app_thread, app_thread_stack, THREAD_STACK_SIZE, stream_drain_entry, NULL,
+        NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+
+    edgehog_ft_msg_t msg = build_msg(EDGEHOG_FT_TYPE_SERVER_TO_DEVICE,
+        "http://" SERVER_ADDR ":" STRINGIFY(SERVER_PORT) "/payload.bin", DOWNLOAD_PAYLOAD_SIZE);
+
+    int64_t start_ms = k_uptime_get();
+    edgehog_ft_handle_server_to_device(device, &msg);
+    int64_t elapsed_ms = k_uptime_get() - start_ms;
+
+    k_thread_join(&app_thread, K_FOREVER);
+    print_metrics("server-to-device", app_stream_bytes, elapsed_ms);
+}
+
+static void run_upload_scenario(edgehog_device_handle_t device)
+{
+    app_stream_bytes = 0;
+    k_thread_create(&app_thread, app_thread_stack, THREAD_STACK_SIZE, stream_feed_entry, NULL,
+        NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+
+    edgehog_ft_msg_t msg = build_msg(EDGEHOG_FT_TYPE_DEVICE_TO_SERVER,
+        "http://" SERVER_ADDR ":" STRINGIFY(SERVER_PORT) "/upload", UPLOAD_PAYLOAD_SIZE);
+
+    int64_t start_ms = k_uptime_get();
+    edgehog_ft_handle_device_to_server(device, &msg);
+    int64_t elapsed_ms = k_uptime_get() - start_ms;
+
+    k_thread_join(&app_thread, K_FOREVER);
+    print_metrics("device-to-server", app_stream_bytes, elapsed_ms);
+}
+
+/************************************************
+ *                     Main                     *
+ ***********************************************/
+
+int main(void)
+{
+    printk("Edgehog file transfer benchmark starting\n");
+    fill_pattern_block();
+
+    // Cycle-accurate kernels first, before the network scenarios perturb the heap and threads
+    run_microbenchmarks();
+
+    k_thread_create(&server_thread, server_thread_stack, THREAD_STACK_SIZE, server_thread_entry,
+        NULL, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    (void) k_thread_name_set(&server_thread, "bench_http_srv");
+    // Give the server time to bind before the first request
+    k_sleep(K_MSEC(100));
+
+    // Minimal device context: only the fields the transfer handlers touch are populated. No
+    // Astarte device is attached, response and progress publishes fail and are logged.
+    static struct edgehog_device bench_device = { 0 };
+    edgehog_ft_cbks_t cbks = { .on_stream_transfer_start = on_stream_transfer_start };
+    bench_device.file_transfer = edgehog_ft_new(cbks, NULL, 0, NULL, 0);
+    if (!bench_device.file_transfer) {
+        printk("Failed to create the file transfer context\n");
+        return -1;
+    }
+    k_sem_init(&bench_device.sync_ota_ft_sem, EDGEHOG_FT_LANE_COUNT, EDGEHOG_FT_LANE_COUNT);
+
+    run_download_scenario(&bench_device);
+    run_upload_scenario(&bench_device);
+
+    // Telemetry service under sustained load, after the transfer scenarios have quiesced
+    run_telemetry_bench(&bench_device);
+
+    printk("Edgehog file transfer benchmark done\n");
+    // Fail the run when a kernel regressed beyond the recorded baseline threshold
+    return regression_report();
+}
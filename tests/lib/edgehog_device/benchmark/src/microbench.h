@@ -0,0 +1,21 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BENCHMARK_MICROBENCH_H
+#define BENCHMARK_MICROBENCH_H
+
+/**
+ * @file microbench.h
+ * @brief Cycle-accurate microbenchmarks for the SDK hot kernels.
+ */
+
+/**
+ * @brief Run all the microbenchmarks and print one result line per kernel.
+ * @details Each result is a single machine-parsable CSV line, see microbench.c for the format.
+ */
+void run_microbenchmarks(void);
+
+#endif // BENCHMARK_MICROBENCH_H
@@ -0,0 +1,111 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/benchmark/src/regression.c
+ *
+ * @details Performance regression checks for the microbenchmark kernels. Each target with a
+ * recorded baseline carries a table in src/baselines/<board>.inc mapping kernel names to the
+ * expected cycles per iteration. A kernel whose measured cycles per iteration exceed the
+ * baseline by more than CONFIG_MICROBENCH_REGRESSION_THRESHOLD_PERCENT prints:
+ *
+ *     bench_regression,<name>,<measured cycles/iter>,<baseline cycles/iter>,<delta percent>
+ *
+ * and the summary line at the end of the run flips to "fail", failing the benchmark process.
+ * Baselines with value 0 are placeholders, they record which kernels exist for the target but
+ * are never checked. To (re)record a baseline, run the benchmark on the target and copy the
+ * cycles divided by the iterations from each bench CSV line into the table.
+ */
+
+#include "regression.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/** @brief Recorded baseline for one microbenchmark kernel. */
+typedef struct
+{
+    /** @brief Kernel name, as it appears in the bench CSV line. */
+    const char *name;
+    /** @brief Expected cycles per iteration, 0 when not recorded yet. */
+    uint32_t cycles_per_iter;
+} bench_baseline_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// One baseline table per target, selected from the board option. Targets without a recorded
+// table get an empty one and every check becomes a no-op.
+static const bench_baseline_t baselines[] = {
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define BASELINE(name, cycles) { (name), (cycles) },
+#if defined(CONFIG_BOARD_NATIVE_SIM)
+#include "baselines/native_sim.inc"
+#endif
+#undef BASELINE
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Kernels that exceeded their baseline by more than the threshold
+static uint32_t regression_count;
+// Kernels checked against a recorded baseline
+static uint32_t checked_count;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static const bench_baseline_t *baseline_lookup(const char *name)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(baselines); i++) {
+        if (strcmp(baselines[i].name, name) == 0) {
+            return &baselines[i];
+        }
+    }
+    return NULL;
+}
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void regression_check(const char *name, uint32_t iterations, uint32_t cycles)
+{
+    if (!IS_ENABLED(CONFIG_MICROBENCH_REGRESSION_CHECK) || (iterations == 0)) {
+        return;
+    }
+
+    const bench_baseline_t *baseline = baseline_lookup(name);
+    if (!baseline || (baseline->cycles_per_iter == 0)) {
+        return;
+    }
+
+    checked_count++;
+    uint32_t measured = cycles / iterations;
+    uint64_t limit = ((uint64_t) baseline->cycles_per_iter
+        * (100U + CONFIG_MICROBENCH_REGRESSION_THRESHOLD_PERCENT));
+    if (((uint64_t) measured * 100U) > limit) {
+        uint32_t delta_percent
+            = (uint32_t) ((((uint64_t) measured * 100U) / baseline->cycles_per_iter) - 100U);
+        printk("bench_regression,%s,%u,%u,%u\n", name, measured, baseline->cycles_per_iter,
+            delta_percent);
+        regression_count++;
+    }
+}
+
+int regression_report(void)
+{
+    printk("bench_regression,%s,%u,%u\n", (regression_count == 0) ? "pass" : "fail",
+        checked_count, regression_count);
+    return (regression_count == 0) ? 0 : -1;
+}
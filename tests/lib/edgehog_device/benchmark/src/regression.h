@@ -0,0 +1,37 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/benchmark/src/regression.h
+ *
+ * @details Performance regression checks against recorded baselines, see regression.c.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Check a measured kernel against its recorded baseline.
+ *
+ * @details Does nothing when the kernel has no recorded baseline for the current target or when
+ * the regression check is disabled. Call it with the same figures passed to the bench report.
+ *
+ * @param[in] name Kernel name, as it appears in the bench CSV line and the baseline table.
+ * @param[in] iterations Number of iterations the cycle count covers.
+ * @param[in] cycles Measured CPU cycles over all iterations.
+ */
+void regression_check(const char *name, uint32_t iterations, uint32_t cycles);
+
+/**
+ * @brief Print the regression summary line.
+ *
+ * @return 0 when every checked kernel is within threshold, -1 when at least one regressed.
+ */
+int regression_report(void);
+
+#endif // REGRESSION_H
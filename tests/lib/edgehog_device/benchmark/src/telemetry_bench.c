@@ -0,0 +1,168 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/benchmark/src/telemetry_bench.c
+ *
+ * @details Telemetry throughput and wakeup benchmark. It configures every telemetry type at an
+ * aggressively short period, runs the service for a fixed window and reports one machine
+ * parsable line:
+ *
+ *     bench_telemetry,<run s>,<publishes>,<publishes/min>,<queue drops>,<timer wakeups>,
+ *     <wakeups/min>,<service CPU cycles>
+ *
+ * Publishes are counted from the SDK zbus event channel, the drop and wakeup figures come from
+ * the SDK metrics counters and the CPU time from the telemetry service thread runtime stats.
+ * Together they bound the safe maximum sampling rates and quantify what the request batching,
+ * the single scheduler timer and the publish path actually cost per sample.
+ */
+
+#include "telemetry_bench.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "edgehog_private.h"
+#include "sdk_metrics.h"
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+#include <zephyr/zbus/zbus.h>
+
+#include <edgehog_device/sdk_event.h>
+#endif
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+/* Length of the measurement window */
+#define TELEMETRY_BENCH_RUN_SECONDS 15
+
+/* Shortest period the configuration accepts, every type samples this aggressively */
+#define TELEMETRY_BENCH_PERIOD_SECONDS 1
+
+#define TELEMETRY_BENCH_STOP_TIMEOUT K_SECONDS(5)
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+// Telemetry publishes seen on the SDK event channel
+static atomic_t publish_count;
+#endif
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *     Callbacks definition and declaration     *
+ ***********************************************/
+
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+
+static void sdk_event_listener_cbk(const struct zbus_channel *chan)
+{
+    const edgehog_sdk_chan_event_t *event = zbus_chan_const_msg(chan);
+    if (event->event == EDGEHOG_SDK_TELEMETRY_PUBLISHED_EVENT) {
+        atomic_inc(&publish_count);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bench_sdk_event_listener, sdk_event_listener_cbk);
+ZBUS_CHAN_ADD_OBS(edgehog_sdk_chan, bench_sdk_event_listener, 3);
+
+#endif // CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+#ifndef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+static void telemetry_thread_cycles_cbk(const struct k_thread *thread, void *user_data)
+{
+    uint64_t *cycles = (uint64_t *) user_data;
+
+    const char *name = k_thread_name_get((k_tid_t) thread);
+    if (!name || (strcmp(name, "edgehog_telemetry_thread") != 0)) {
+        return;
+    }
+
+    k_thread_runtime_stats_t stats;
+    if (k_thread_runtime_stats_get((k_tid_t) thread, &stats) == 0) {
+        *cycles = stats.execution_cycles;
+    }
+}
+#endif
+
+// CPU cycles consumed by the telemetry service. In the workqueue execution mode the publishes
+// run on the system workqueue and have no dedicated thread to account, zero is reported.
+static uint64_t telemetry_service_cycles(void)
+{
+    uint64_t cycles = 0;
+#ifndef CONFIG_EDGEHOG_DEVICE_TELEMETRY_WORKQUEUE
+    k_thread_foreach(telemetry_thread_cycles_cbk, &cycles);
+#endif
+    return cycles;
+}
+
+/************************************************
+ *         Global functions definitions         *
+ ***********************************************/
+
+void run_telemetry_bench(edgehog_device_handle_t device)
+{
+    edgehog_telemetry_config_t configs[EDGEHOG_TELEMETRY_LEN - 1];
+    size_t configs_len = 0;
+    for (edgehog_telemetry_type_t type = EDGEHOG_TELEMETRY_INVALID + 1;
+        type < EDGEHOG_TELEMETRY_LEN; type++) {
+        configs[configs_len].type = type;
+        configs[configs_len].period_seconds = TELEMETRY_BENCH_PERIOD_SECONDS;
+        configs_len++;
+    }
+
+    device->telemetry = edgehog_telemetry_new(configs, configs_len);
+    if (!device->telemetry) {
+        printk("bench_telemetry,failed\n");
+        return;
+    }
+
+    edgehog_sdk_metrics_snapshot_t before = { 0 };
+    sdk_metrics_snapshot(&before);
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+    atomic_val_t publishes_before = atomic_get(&publish_count);
+#endif
+
+    if (edgehog_telemetry_start(device) != EDGEHOG_RESULT_OK) {
+        printk("bench_telemetry,failed\n");
+        edgehog_telemetry_destroy(device->telemetry);
+        device->telemetry = NULL;
+        return;
+    }
+
+    k_sleep(K_SECONDS(TELEMETRY_BENCH_RUN_SECONDS));
+
+    // Sample the service CPU time before the stop tears the thread down
+    uint64_t service_cycles = telemetry_service_cycles();
+
+    edgehog_telemetry_stop(device->telemetry, TELEMETRY_BENCH_STOP_TIMEOUT);
+
+    edgehog_sdk_metrics_snapshot_t after = { 0 };
+    sdk_metrics_snapshot(&after);
+    uint32_t publishes = 0;
+#ifdef CONFIG_EDGEHOG_DEVICE_ZBUS_SDK_EVENTS
+    publishes = (uint32_t) (atomic_get(&publish_count) - publishes_before);
+#endif
+    uint32_t drops = after.queue_drops - before.queue_drops;
+    uint32_t wakeups = after.timer_wakeups - before.timer_wakeups;
+
+    printk("bench_telemetry,%d,%u,%u,%u,%u,%u,%llu\n", TELEMETRY_BENCH_RUN_SECONDS, publishes,
+        (publishes * 60U) / TELEMETRY_BENCH_RUN_SECONDS, drops, wakeups,
+        (wakeups * 60U) / TELEMETRY_BENCH_RUN_SECONDS, (unsigned long long) service_cycles);
+
+    edgehog_telemetry_destroy(device->telemetry);
+    device->telemetry = NULL;
+}
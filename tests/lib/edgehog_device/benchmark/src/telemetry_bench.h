@@ -0,0 +1,26 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TELEMETRY_BENCH_H
+#define TELEMETRY_BENCH_H
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/benchmark/src/telemetry_bench.h
+ *
+ * @details Telemetry throughput and wakeup benchmark, see telemetry_bench.c.
+ */
+
+#include <edgehog_device/device.h>
+
+/**
+ * @brief Run the telemetry service at aggressive periods and report its sustained figures.
+ *
+ * @param[in] device The benchmark device context, its telemetry field is set up and torn down
+ * by the benchmark.
+ */
+void run_telemetry_bench(edgehog_device_handle_t device);
+
+#endif // TELEMETRY_BENCH_H
@@ -0,0 +1,389 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/ota_benchmark/src/main.c
+ *
+ * @details Benchmark harness for the OTA update path. It spins up a local HTTP server on the
+ * loopback interface serving a synthetic MCUboot image, then drives a scripted OTA update
+ * through the same entry point a real Astarte request takes. The stage-by-stage timing
+ * breakdown is reconstructed from the SDK trace ring buffer, attributing the gap between two
+ * consecutive trace entries to the later one, so the slot erase, the DNS resolution, the
+ * TCP connect, the server latency and every flash write stall show up as separate lines:
+ *
+ *     ota_stage,<name>,<count>,<total us>,<max us>
+ *
+ * While the download runs the downloaded byte count is sampled periodically as a throughput
+ * timeline:
+ *
+ *     ota_timeline,<elapsed ms>,<bytes>
+ *
+ * @note Run on native_sim, no external connectivity is required. Status events are not
+ * published since no Astarte device is connected, the library logs and carries on. Once the
+ * update reaches the pending-reboot state the benchmark prints the breakdown, confirms the
+ * reboot over the OTA zbus channel and lets the device reboot, which terminates the run. The
+ * reboot-to-confirm leg runs at the next boot through edgehog_ota_init and is not timed here.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/zbus/zbus.h>
+
+#include <edgehog_device/ota_event.h>
+
+#include "edgehog_private.h"
+#include "settings.h"
+#include "trace.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SERVER_PORT 8080
+#define SERVER_ADDR "127.0.0.1"
+
+/* Size of the synthetic OTA image, MCUboot header included */
+#define OTA_IMAGE_SIZE (128 * 1024)
+
+/* Pattern block used to generate the synthetic image body */
+#define PATTERN_BLOCK_SIZE 1024
+
+#define THREAD_STACK_SIZE 8192
+#define THREAD_PRIORITY 5
+
+/* Sampling period of the download throughput timeline */
+#define TIMELINE_PERIOD_MS 500
+
+/* Magic marking a valid MCUboot image header, checked when reading back the slot */
+#define OTA_IMAGE_MAGIC 0x96f3b83dU
+
+/* Highest trace point value plus one, sizes the per-point aggregation table */
+#define TRACE_POINT_SLOTS 16
+
+/** @brief Raw MCUboot image header, served at the start of the synthetic image. */
+struct ota_image_header
+{
+    uint32_t magic;
+    uint32_t load_addr;
+    uint16_t hdr_size;
+    uint16_t protect_tlv_size;
+    uint32_t img_size;
+    uint32_t flags;
+    uint8_t version[8];
+    uint32_t pad;
+};
+
+/** @brief Per trace point aggregation of the gaps attributed to it. */
+typedef struct
+{
+    uint32_t count;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+} trace_point_stats_t;
+
+/** @brief Running state of the trace buffer analysis. */
+typedef struct
+{
+    bool have_prev;
+    uint32_t prev_cycles;
+    trace_point_stats_t points[TRACE_POINT_SLOTS];
+} trace_analysis_t;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+K_THREAD_STACK_DEFINE(server_thread_stack, THREAD_STACK_SIZE);
+static struct k_thread server_thread;
+
+// Minimal device context driven by the scripted OTA request
+static struct edgehog_device bench_device;
+
+static K_SEM_DEFINE(ota_done_sem, 0, 1);
+static bool ota_failed;
+static int64_t ack_uptime_ms;
+static int64_t pending_uptime_ms;
+
+// Synthetic data block shared by the image body generator
+static uint8_t pattern_block[PATTERN_BLOCK_SIZE];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *    Callbacks definition and declaration      *
+ ***********************************************/
+
+static void ota_event_listener_cbk(const struct zbus_channel *chan)
+{
+    const edgehog_ota_chan_event_t *event = zbus_chan_const_msg(chan);
+
+    switch (event->event) {
+        case EDGEHOG_OTA_INIT_EVENT:
+            ack_uptime_ms = k_uptime_get();
+            break;
+        case EDGEHOG_OTA_PENDING_REBOOT_EVENT:
+            pending_uptime_ms = k_uptime_get();
+            k_sem_give(&ota_done_sem);
+            break;
+        case EDGEHOG_OTA_FAILED_EVENT:
+            ota_failed = true;
+            k_sem_give(&ota_done_sem);
+            break;
+        default:
+            break;
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bench_ota_listener, ota_event_listener_cbk);
+ZBUS_CHAN_ADD_OBS(edgehog_ota_chan, bench_ota_listener, 3);
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static void fill_pattern_block(void)
+{
+    // Mildly repetitive content, compressible but not trivial
+    for (size_t i = 0; i < PATTERN_BLOCK_SIZE; i++) {
+        pattern_block[i] = (uint8_t) ((i * 31U) ^ (i >> 3U));
+    }
+}
+
+/************************************************
+ *              Local HTTP server               *
+ ***********************************************/
+
+static int recv_http_headers(int client, char *buf, size_t buf_size)
+{
+    size_t received = 0;
+    while (received < buf_size - 1) {
+        ssize_t res = zsock_recv(client, buf + received, buf_size - 1 - received, 0);
+        if (res <= 0) {
+            return -1;
+        }
+        received += (size_t) res;
+        buf[received] = '\0';
+        if (strstr(buf, "\r\n\r\n")) {
+            return (int) received;
+        }
+    }
+    return -1;
+}
+
+static int send_all(int client, const uint8_t *data, size_t size)
+{
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t res = zsock_send(client, data + sent, size - sent, 0);
+        if (res < 0) {
+            return -1;
+        }
+        sent += (size_t) res;
+    }
+    return 0;
+}
+
+// Serves the synthetic image: a valid MCUboot header followed by pattern data
+static void serve_image(int client)
+{
+    char headers[128] = { 0 };
+    // NOLINTNEXTLINE(cert-err33-c)
+    snprintf(headers, sizeof(headers),
+        "HTTP/1.1 200 OK\r\nContent-Length: %d\r\nConnection: close\r\n\r\n", OTA_IMAGE_SIZE);
+    if (send_all(client, (const uint8_t *) headers, strlen(headers)) < 0) {
+        return;
+    }
+
+    struct ota_image_header image_header = {
+        .magic = OTA_IMAGE_MAGIC,
+        .hdr_size = sizeof(struct ota_image_header),
+        .img_size = OTA_IMAGE_SIZE - sizeof(struct ota_image_header),
+        .version = { 1, 0, 0, 0, 0, 0, 0, 0 },
+    };
+    if (send_all(client, (const uint8_t *) &image_header, sizeof(image_header)) < 0) {
+        return;
+    }
+
+    size_t remaining = OTA_IMAGE_SIZE - sizeof(image_header);
+    while (remaining > 0) {
+        size_t block = MIN(remaining, sizeof(pattern_block));
+        if (send_all(client, pattern_block, block) < 0) {
+            return;
+        }
+        remaining -= block;
+    }
+}
+
+static void server_thread_entry(void *unused1, void *unused2, void *unused3)
+{
+    ARG_UNUSED(unused1);
+    ARG_UNUSED(unused2);
+    ARG_UNUSED(unused3);
+
+    int serv = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (serv < 0) {
+        printk("Benchmark server: socket creation failed\n");
+        return;
+    }
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(SERVER_PORT) };
+    zsock_inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+    if ((zsock_bind(serv, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+        || (zsock_listen(serv, 2) < 0)) {
+        printk("Benchmark server: bind/listen failed\n");
+        zsock_close(serv);
+        return;
+    }
+
+    while (true) {
+        int client = zsock_accept(serv, NULL, NULL);
+        if (client < 0) {
+            continue;
+        }
+
+        char request[512] = { 0 };
+        if (recv_http_headers(client, request, sizeof(request)) > 0) {
+            serve_image(client);
+        }
+        zsock_close(client);
+    }
+}
+
+/************************************************
+ *           Stage timing breakdown             *
+ ***********************************************/
+
+// Attributes the gap from the previous trace entry to the current one, so each trace point
+// accumulates the time spent reaching it
+static void trace_analyze_cbk(uint32_t cycles, edgehog_trace_point_t point, void *user_data)
+{
+    trace_analysis_t *analysis = (trace_analysis_t *) user_data;
+
+    if (analysis->have_prev && ((size_t) point < TRACE_POINT_SLOTS)) {
+        // Unsigned subtraction stays correct across a cycle counter wrap
+        uint32_t gap = cycles - analysis->prev_cycles;
+        trace_point_stats_t *stats = &analysis->points[point];
+        stats->count++;
+        stats->total_cycles += gap;
+        stats->max_cycles = MAX(stats->max_cycles, gap);
+    }
+    analysis->prev_cycles = cycles;
+    analysis->have_prev = true;
+}
+
+static void print_stage_breakdown(void)
+{
+    trace_analysis_t analysis = { 0 };
+    edgehog_trace_read(trace_analyze_cbk, &analysis);
+
+    for (size_t point = 0; point < TRACE_POINT_SLOTS; point++) {
+        const trace_point_stats_t *stats = &analysis.points[point];
+        if (stats->count == 0) {
+            continue;
+        }
+        printk("ota_stage,%s,%u,%llu,%llu\n",
+            edgehog_trace_point_name((edgehog_trace_point_t) point), stats->count,
+            k_cyc_to_us_floor64(stats->total_cycles),
+            k_cyc_to_us_floor64((uint64_t) stats->max_cycles));
+    }
+}
+
+// Times one settings transaction commit, the persistence cost the OTA state machine pays on
+// every state change
+static void measure_settings_commit(void)
+{
+    if (edgehog_settings_init() != EDGEHOG_RESULT_OK) {
+        printk("ota_stage,settings-commit,failed\n");
+        return;
+    }
+
+    uint8_t state = 0;
+    edgehog_settings_transaction_t transaction = { 0 };
+    edgehog_settings_transaction_begin(&transaction, "bench");
+    edgehog_settings_transaction_set(&transaction, "state", &state, sizeof(state));
+
+    uint32_t start_cycles = k_cycle_get_32();
+    edgehog_result_t res = edgehog_settings_transaction_commit(&transaction);
+    uint32_t elapsed_cycles = k_cycle_get_32() - start_cycles;
+
+    if (res != EDGEHOG_RESULT_OK) {
+        printk("ota_stage,settings-commit,failed\n");
+        return;
+    }
+    printk("ota_stage,settings-commit,1,%llu,%llu\n",
+        k_cyc_to_us_floor64((uint64_t) elapsed_cycles),
+        k_cyc_to_us_floor64((uint64_t) elapsed_cycles));
+}
+
+/************************************************
+ *                     Main                     *
+ ***********************************************/
+
+int main(void)
+{
+    printk("Edgehog OTA benchmark starting, formats: "
+           "ota_stage,name,count,total_us,max_us and ota_timeline,elapsed_ms,bytes\n");
+    fill_pattern_block();
+
+    k_thread_create(&server_thread, server_thread_stack, THREAD_STACK_SIZE, server_thread_entry,
+        NULL, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    (void) k_thread_name_set(&server_thread, "bench_http_srv");
+    // Give the server time to bind before the first request
+    k_sleep(K_MSEC(100));
+
+    measure_settings_commit();
+
+    // Minimal device context: only the fields the OTA path touches are populated. No Astarte
+    // device is attached, status publishes fail and are logged.
+    k_sem_init(&bench_device.sync_ota_ft_sem, EDGEHOG_FT_LANE_COUNT, EDGEHOG_FT_LANE_COUNT);
+
+    astarte_object_entry_t entries[] = {
+        { .path = "uuid",
+            .data = astarte_data_from_string("8f1c9a7e-3a44-4a37-b6a1-0c5e8d2f9b10") },
+        { .path = "url",
+            .data = astarte_data_from_string(
+                "http://" SERVER_ADDR ":" STRINGIFY(SERVER_PORT) "/image.bin") },
+        { .path = "operation", .data = astarte_data_from_string("Update") },
+    };
+    astarte_device_datastream_object_event_t object_event = {
+        .entries = entries,
+        .entries_len = ARRAY_SIZE(entries),
+    };
+
+    int64_t start_ms = k_uptime_get();
+    edgehog_result_t res = edgehog_ota_event(&bench_device, &object_event);
+    if (res != EDGEHOG_RESULT_OK) {
+        printk("Failed to start the scripted OTA update\n");
+        return -1;
+    }
+
+    // Sample the downloaded byte count until the update reaches its terminal state
+    while (k_sem_take(&ota_done_sem, K_MSEC(TIMELINE_PERIOD_MS)) != 0) {
+        printk("ota_timeline,%lld,%zu\n", k_uptime_get() - start_ms,
+            bench_device.ota_thread.ota_thread_data.download_size);
+    }
+
+    if (ota_failed) {
+        printk("Scripted OTA update failed\n");
+        return -1;
+    }
+
+    printk("ota_stage,total,1,%lld,%lld\n", (pending_uptime_ms - ack_uptime_ms) * USEC_PER_MSEC,
+        (pending_uptime_ms - ack_uptime_ms) * USEC_PER_MSEC);
+    print_stage_breakdown();
+
+    // Confirm the reboot so the OTA thread skips its grace period, the device then reboots and
+    // the run terminates
+    printk("Edgehog OTA benchmark done, confirming reboot\n");
+    edgehog_ota_chan_event_t confirm = { .event = EDGEHOG_OTA_CONFIRM_REBOOT_EVENT };
+    zbus_chan_pub(&edgehog_ota_chan, &confirm, K_SECONDS(1));
+
+    return 0;
+}
@@ -0,0 +1,346 @@
+/*
+ * (C) Copyright 2026, SECO Mind Srl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file edgehog-zephyr-device/tests/lib/edgehog_device/soak/src/main.c
+ *
+ * @details Heap fragmentation soak benchmark. It loops the allocation patterns of the realistic
+ * workloads for a configurable duration: file transfer request parsing with its HTTP header
+ * arena, per-transfer context slab blocks, LZ4 decompression contexts, telemetry entry churn,
+ * OTA-sized download buffers and a population of mixed-size, mixed-lifetime string allocations.
+ * Between cycles it samples the system heap and probes the largest allocatable block, the metric
+ * that actually fails first on fragmented heaps while the total free count still looks healthy.
+ *
+ * Each snapshot prints one machine-parsable CSV line:
+ *
+ *     soak,<elapsed s>,<cycles>,<allocated>,<free>,<peak allocated>,<largest block>
+ *
+ * so allocation-strategy changes (slabs, arenas, dedicated heap) can be validated by comparing
+ * the largest-block trend over identical runs.
+ *
+ * @note Run on native_sim for hours-long runs, or on hardware for the real allocator behavior.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/mem_stats.h>
+
+#include <edgehog_device/file_transfer.h>
+
+#include "file_transfer/utils.h"
+#include "telemetry_entry.h"
+
+/************************************************
+ *        Defines, constants and typedef        *
+ ***********************************************/
+
+#define SOAK_DURATION_MS (CONFIG_SOAK_DURATION_MINUTES * 60 * MSEC_PER_SEC)
+#define SOAK_REPORT_PERIOD_MS (CONFIG_SOAK_REPORT_PERIOD_SECONDS * MSEC_PER_SEC)
+
+/* Number of transfer request parse/destroy pairs per cycle */
+#define SOAK_MSG_CHURN_PER_CYCLE 8
+
+/* Mixed-lifetime allocation population, freed and reallocated in pseudo random order */
+#define SOAK_HELD_BLOCKS 32
+#define SOAK_HELD_BLOCK_MIN_SIZE 16
+#define SOAK_HELD_BLOCK_MAX_SIZE 512
+
+/* OTA-sized buffers, allocated in a burst and released out of order */
+#define SOAK_OTA_BUFFERS 4
+#define SOAK_OTA_BUFFER_SIZE (8 * 1024)
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+/* Input compressed once at startup, decompressed on every cycle */
+#define SOAK_LZ4_INPUT_SIZE (16 * 1024)
+#define SOAK_LZ4_CHUNK_SIZE 1024
+#define SOAK_LZ4_COMP_BUF_SIZE (SOAK_LZ4_INPUT_SIZE + (SOAK_LZ4_INPUT_SIZE / 8) + 1024)
+#endif
+
+/* Binary search floor for the largest allocatable block probe */
+#define SOAK_PROBE_MIN_SIZE 16
+
+/* The k_malloc heap, queried for the allocation statistics */
+extern struct k_heap _system_heap;
+
+/************************************************
+ *         Static variables declarations        *
+ ***********************************************/
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Mixed-lifetime allocation population
+static void *held_blocks[SOAK_HELD_BLOCKS];
+// OTA-sized buffers released out of order
+static void *ota_buffers[SOAK_OTA_BUFFERS];
+// xorshift32 state driving the pseudo random sizes and orders, fixed seed for reproducible runs
+static uint32_t prng_state = 0x9e3779b9;
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+static uint8_t lz4_input[SOAK_LZ4_INPUT_SIZE];
+static uint8_t lz4_comp_buf[SOAK_LZ4_COMP_BUF_SIZE];
+static size_t lz4_comp_len;
+#endif
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/************************************************
+ *         Static functions definitions         *
+ ***********************************************/
+
+static uint32_t prng_next(void)
+{
+    uint32_t x = prng_state;
+    x ^= x << 13U;
+    x ^= x >> 17U;
+    x ^= x << 5U;
+    prng_state = x;
+    return x;
+}
+
+/************************************************
+ *               Workload cycles                *
+ ***********************************************/
+
+// Parse and destroy transfer requests, churning the HTTP header arena and the message strings
+static void churn_transfer_requests(void)
+{
+    const char *header_keys[] = { "Authorization", "Content-Type", "X-Request-Id", "X-Tenant" };
+    const char *header_values[] = { "Bearer 0123456789abcdef0123456789abcdef",
+        "application/octet-stream", "8f1c9a7e-3a44-4a37-b6a1-0c5e8d2f9b10", "soak" };
+
+    astarte_object_entry_t entries[] = {
+        { .path = "id", .data = astarte_data_from_string("8f1c9a7e-3a44-4a37-b6a1-0c5e8d2f9b10") },
+        { .path = "url", .data = astarte_data_from_string("http://soak.local/payload.bin") },
+        { .path = "httpHeaderKeys",
+            .data = astarte_data_from_string_array(header_keys, ARRAY_SIZE(header_keys)) },
+        { .path = "httpHeaderValues",
+            .data = astarte_data_from_string_array(header_values, ARRAY_SIZE(header_values)) },
+        { .path = "destinationType", .data = astarte_data_from_string("streaming") },
+        { .path = "destination", .data = astarte_data_from_string("soak-stream") },
+        { .path = "digest",
+            .data = astarte_data_from_string(
+                "sha256:9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08") },
+        { .path = "fileSizeBytes", .data = astarte_data_from_longinteger(1024 * 1024) },
+    };
+
+    for (int i = 0; i < SOAK_MSG_CHURN_PER_CYCLE; i++) {
+        edgehog_ft_msg_t msg = { 0 };
+        if (edgehog_ft_msg_init(entries, ARRAY_SIZE(entries), EDGEHOG_FT_TYPE_SERVER_TO_DEVICE,
+                &msg)
+            == EDGEHOG_RESULT_OK) {
+            // Interleave a per-transfer slab block with the live message, as a transfer does
+            void *ctx = edgehog_ft_ctx_alloc(CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_CTX_BLOCK_SIZE);
+            edgehog_ft_msg_destroy(&msg);
+            edgehog_ft_ctx_free(ctx);
+        }
+    }
+}
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+
+static int discard_decomp_data_cbk(const uint8_t *data, size_t size, void *user_data)
+{
+    ARG_UNUSED(data);
+    ARG_UNUSED(size);
+    ARG_UNUSED(user_data);
+    return 0;
+}
+
+static void prepare_lz4_stream(void)
+{
+    for (size_t i = 0; i < SOAK_LZ4_INPUT_SIZE; i++) {
+        lz4_input[i] = (uint8_t) ((i * 31U) ^ (i >> 3U));
+    }
+
+    file_transfer_compression_ctx_t ctx = { 0 };
+    uint8_t scratch[SOAK_LZ4_CHUNK_SIZE + 512];
+    size_t written = 0;
+
+    if ((file_transfer_compression_init(&ctx) < 0)
+        || (file_transfer_compression_begin(&ctx, lz4_comp_buf, sizeof(lz4_comp_buf), &written)
+            < 0)) {
+        printk("Soak: LZ4 stream preparation failed\n");
+        return;
+    }
+    lz4_comp_len = written;
+
+    for (size_t offset = 0; offset < SOAK_LZ4_INPUT_SIZE; offset += SOAK_LZ4_CHUNK_SIZE) {
+        if ((file_transfer_compression_update(&ctx, &lz4_input[offset], SOAK_LZ4_CHUNK_SIZE,
+                 scratch, sizeof(scratch), &written)
+                < 0)
+            || (lz4_comp_len + written > sizeof(lz4_comp_buf))) {
+            printk("Soak: LZ4 stream preparation failed\n");
+            file_transfer_compression_free(&ctx);
+            return;
+        }
+        memcpy(&lz4_comp_buf[lz4_comp_len], scratch, written);
+        lz4_comp_len += written;
+    }
+
+    if ((file_transfer_compression_end(&ctx, scratch, sizeof(scratch), &written) == 0)
+        && (lz4_comp_len + written <= sizeof(lz4_comp_buf))) {
+        memcpy(&lz4_comp_buf[lz4_comp_len], scratch, written);
+        lz4_comp_len += written;
+    }
+    file_transfer_compression_free(&ctx);
+}
+
+// A full decompression context lifecycle, exercising the decompression buffer allocations
+static void churn_decompression(void)
+{
+    if (lz4_comp_len == 0) {
+        return;
+    }
+
+    file_transfer_decompression_ctx_t ctx = { 0 };
+    if (file_transfer_decompression_init(&ctx, discard_decomp_data_cbk, NULL) < 0) {
+        return;
+    }
+    for (size_t offset = 0; offset < lz4_comp_len; offset += SOAK_LZ4_CHUNK_SIZE) {
+        size_t chunk = MIN((size_t) SOAK_LZ4_CHUNK_SIZE, lz4_comp_len - offset);
+        if (file_transfer_decompression_process_chunk(&ctx, &lz4_comp_buf[offset], chunk) < 0) {
+            break;
+        }
+    }
+    file_transfer_decompression_free(&ctx);
+}
+
+#endif /* CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION */
+
+// Telemetry entry pool churn, entries come and go with config set/unset events
+static void churn_telemetry_entries(void)
+{
+    edgehog_telemetry_entry_t *entries[EDGEHOG_TELEMETRY_LEN] = { 0 };
+
+    for (edgehog_telemetry_type_t type = EDGEHOG_TELEMETRY_INVALID + 1;
+        type < EDGEHOG_TELEMETRY_LEN; type++) {
+        edgehog_telemetry_entry_t *entry = telemetry_entry_new(type, 60, true);
+        if (entry) {
+            telemetry_entry_set(entry, entries);
+        }
+    }
+    for (edgehog_telemetry_type_t type = EDGEHOG_TELEMETRY_INVALID + 1;
+        type < EDGEHOG_TELEMETRY_LEN; type++) {
+        telemetry_entry_remove(type, entries);
+    }
+}
+
+// Replace a pseudo random held block with a new one of pseudo random size, building the
+// mixed-lifetime population that actually fragments a heap
+static void churn_held_blocks(void)
+{
+    size_t slot = prng_next() % SOAK_HELD_BLOCKS;
+    k_free(held_blocks[slot]);
+
+    size_t size = SOAK_HELD_BLOCK_MIN_SIZE
+        + (prng_next() % (SOAK_HELD_BLOCK_MAX_SIZE - SOAK_HELD_BLOCK_MIN_SIZE));
+    held_blocks[slot] = k_malloc(size);
+}
+
+// OTA-sized buffer burst, released in pseudo random order like staggered download teardowns
+static void churn_ota_buffers(void)
+{
+    for (size_t i = 0; i < SOAK_OTA_BUFFERS; i++) {
+        ota_buffers[i] = k_malloc(SOAK_OTA_BUFFER_SIZE);
+    }
+    for (size_t i = 0; i < SOAK_OTA_BUFFERS; i++) {
+        size_t slot = prng_next() % SOAK_OTA_BUFFERS;
+        while (!ota_buffers[slot]) {
+            slot = (slot + 1) % SOAK_OTA_BUFFERS;
+        }
+        k_free(ota_buffers[slot]);
+        ota_buffers[slot] = NULL;
+    }
+}
+
+/************************************************
+ *              Metrics reporting               *
+ ***********************************************/
+
+// Probe the largest k_malloc that currently succeeds with a binary search, the measurement the
+// allocation failures actually depend on
+static size_t probe_largest_block(size_t upper_bound)
+{
+    size_t low = 0;
+    size_t high = upper_bound;
+
+    while (low < high) {
+        size_t mid = low + ((high - low + 1) / 2);
+        if (mid < SOAK_PROBE_MIN_SIZE) {
+            break;
+        }
+        void *block = k_malloc(mid);
+        if (block) {
+            k_free(block);
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+static void report_heap(int64_t start_ms, uint32_t cycles)
+{
+    struct sys_memory_stats heap_stats = { 0 };
+    if (sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats) != 0) {
+        return;
+    }
+
+    size_t largest = probe_largest_block(heap_stats.free_bytes);
+    int64_t elapsed_s = (k_uptime_get() - start_ms) / MSEC_PER_SEC;
+    printk("soak,%lld,%u,%zu,%zu,%zu,%zu\n", (long long) elapsed_s, cycles,
+        heap_stats.allocated_bytes, heap_stats.free_bytes, heap_stats.max_allocated_bytes,
+        largest);
+}
+
+/************************************************
+ *                     Main                     *
+ ***********************************************/
+
+int main(void)
+{
+    printk("Edgehog heap fragmentation soak starting, format: "
+           "soak,elapsed_s,cycles,allocated,free,peak,largest_block\n");
+
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+    prepare_lz4_stream();
+#endif
+
+    int64_t start_ms = k_uptime_get();
+    int64_t next_report_ms = start_ms;
+    uint32_t cycles = 0;
+
+    while ((k_uptime_get() - start_ms) < SOAK_DURATION_MS) {
+        churn_transfer_requests();
+#ifdef CONFIG_EDGEHOG_DEVICE_FILE_TRANSFER_COMPRESSION
+        churn_decompression();
+#endif
+        churn_telemetry_entries();
+        churn_held_blocks();
+        churn_ota_buffers();
+        cycles++;
+
+        if (k_uptime_get() >= next_report_ms) {
+            report_heap(start_ms, cycles);
+            next_report_ms += SOAK_REPORT_PERIOD_MS;
+        }
+
+        // Yield between cycles so the run paces like a device, not a tight loop
+        k_sleep(K_MSEC(10));
+    }
+
+    // Release the held population and emit a final snapshot
+    for (size_t i = 0; i < SOAK_HELD_BLOCKS; i++) {
+        k_free(held_blocks[i]);
+        held_blocks[i] = NULL;
+    }
+    report_heap(start_ms, cycles);
+
+    printk("Edgehog heap fragmentation soak done\n");
+    return 0;
+}